@@ -0,0 +1,561 @@
+//
+// Created by peter on 16.10.2026.
+//
+// Frame submission benchmark, compares bytes copied per frame by recorders
+// that store draw calls in their own vectors and serialize them into the
+// task queue, and by mesh and skin instance recorders that record draw calls
+// into the frame packet and serialize only section headers. Render driver
+// checks that both paths deliver the same draw data.
+//
+#include <DebugUtils/DebugLogger.h>
+#include <Engine/EngineConfigBlock.h>
+#include <data_desc/frame_packet.h>
+#include <data_desc/instances/mesh_instance.h>
+#include <ipc/MemoryReader.h>
+#include <ipc/MemoryWriter.h>
+#include <ipc/shared_memory_queue_client.h>
+#include <ipc/shared_memory_segment_pool.h>
+#include <render_client/frame_packet_arena.h>
+#include <render_client/mesh_instance_state_recorder.h>
+#include <render_client/skin_instance_state_recorder.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <span>
+#include <thread>
+#include <vector>
+
+using namespace rh::rw::engine;
+
+constexpr int64_t  gCopyFrameTaskId   = 1;
+constexpr int64_t  gPacketFrameTaskId = 2;
+constexpr uint32_t gQueueSizeMB       = 16;
+constexpr uint32_t gFrameCount        = 200;
+/// recorders grow their arrays during the first frames and may drop draws,
+/// those frames are neither measured nor validated
+constexpr uint32_t gWarmupFrameCount  = 4;
+/// synthetic frame, 10k draws with a hundred skinned ones among them
+constexpr uint32_t gDrawCount         = 10000;
+constexpr uint32_t gSkinDrawCount     = 100;
+constexpr uint32_t gMaterialsPerDraw  = 2;
+constexpr uint32_t gMeshDrawCount     = gDrawCount - gSkinDrawCount;
+constexpr uint32_t gMeshCount         = 512;
+/// every n-th static draw moves each frame, like vehicles and peds do
+constexpr uint32_t gMovingDrawStep    = 10;
+/// typical ped skeleton
+constexpr uint32_t gBonesPerSkin      = 32;
+
+template <typename T> std::span<const T> ToSpan( const std::vector<T> &array )
+{
+    return { array.data(), array.size() };
+}
+
+template <typename T>
+std::span<const T> ToSpan( const rh::engine::ArrayProxy<T> &array )
+{
+    return { array.Data(), array.Size() };
+}
+
+uint64_t Fnv1a( const void *data, uint64_t size,
+                uint64_t hash = 14695981039346656037ull )
+{
+    const auto *bytes = static_cast<const uint8_t *>( data );
+    for ( uint64_t i = 0; i < size; i++ )
+        hash = ( hash ^ bytes[i] ) * 1099511628211ull;
+    return hash;
+}
+
+// list offsets differ between the paths, so only draw contents are hashed
+
+uint64_t DrawDigest( const DrawCallInfo           &info,
+                     std::span<const MaterialData> materials )
+{
+    auto hash = Fnv1a( &info.MeshId, sizeof( info.MeshId ) );
+    hash      = Fnv1a( &info.DrawCallId, sizeof( info.DrawCallId ), hash );
+    hash      = Fnv1a( &info.PipelineId, sizeof( info.PipelineId ), hash );
+    hash      = Fnv1a( &info.LodId, sizeof( info.LodId ), hash );
+    hash = Fnv1a( &info.WorldTransform, sizeof( info.WorldTransform ), hash );
+    return Fnv1a( materials.data(), materials.size_bytes(), hash );
+}
+
+uint64_t SkinDrawDigest( const SkinDrawCallInfo              &info,
+                         std::span<const MaterialData>        materials,
+                         std::span<const DirectX::XMFLOAT4X3> bones )
+{
+    auto hash = Fnv1a( &info.MeshId, sizeof( info.MeshId ) );
+    hash      = Fnv1a( &info.DrawCallId, sizeof( info.DrawCallId ), hash );
+    hash = Fnv1a( &info.WorldTransform, sizeof( info.WorldTransform ), hash );
+    hash = Fnv1a( materials.data(), materials.size_bytes(), hash );
+    return Fnv1a( bones.data(), bones.size_bytes(), hash );
+}
+
+/// Draws may arrive in any order, so frame digest is a sum of draw digests
+uint64_t SkinFrameDigest( std::span<const SkinDrawCallInfo>    draw_calls,
+                          std::span<const MaterialData>        materials,
+                          std::span<const DirectX::XMFLOAT4X3> bones )
+{
+    uint64_t digest = 0;
+    for ( const auto &info : draw_calls )
+        digest += SkinDrawDigest(
+            info,
+            materials.subspan( info.MaterialListStart, info.MaterialListCount ),
+            bones.subspan( info.BoneListStart, info.BoneListCount ) );
+    return digest;
+}
+
+/**
+ * Recorder that keeps draw calls in its own vectors, the way recorders
+ * worked before the frame packet
+ */
+struct VectorMeshRecorder
+{
+    std::vector<MaterialData> Materials;
+    std::vector<DrawCallInfo> DrawCalls;
+    uint64_t                  PendingMaterialCount = 0;
+
+    std::span<MaterialData> AllocateDrawCallMaterials( uint64_t count )
+    {
+        PendingMaterialCount = count;
+        Materials.resize( Materials.size() + count );
+        return { Materials.data() + Materials.size() - count, count };
+    }
+
+    void RecordDrawCall( const DrawCallInfo &info )
+    {
+        auto &draw_call             = DrawCalls.emplace_back( info );
+        draw_call.MaterialListStart = Materials.size() - PendingMaterialCount;
+        draw_call.MaterialListCount = PendingMaterialCount;
+        PendingMaterialCount        = 0;
+    }
+
+    void Clear()
+    {
+        Materials.clear();
+        DrawCalls.clear();
+    }
+};
+
+struct VectorSkinRecorder
+{
+    std::vector<MaterialData>        Materials;
+    std::vector<DirectX::XMFLOAT4X3> Bones;
+    std::vector<SkinDrawCallInfo>    DrawCalls;
+    uint64_t                         PendingMaterialCount = 0;
+    uint64_t                         PendingBoneCount     = 0;
+
+    std::span<MaterialData> AllocateDrawCallMaterials( uint64_t count )
+    {
+        PendingMaterialCount = count;
+        Materials.resize( Materials.size() + count );
+        return { Materials.data() + Materials.size() - count, count };
+    }
+
+    std::span<DirectX::XMFLOAT4X3> AllocateBoneTransforms( uint64_t count )
+    {
+        PendingBoneCount = count;
+        Bones.resize( Bones.size() + count );
+        return { Bones.data() + Bones.size() - count, count };
+    }
+
+    void RecordDrawCall( const SkinDrawCallInfo &info )
+    {
+        auto &draw_call             = DrawCalls.emplace_back( info );
+        draw_call.MaterialListStart = Materials.size() - PendingMaterialCount;
+        draw_call.MaterialListCount = PendingMaterialCount;
+        draw_call.BoneListStart     = Bones.size() - PendingBoneCount;
+        draw_call.BoneListCount     = PendingBoneCount;
+        PendingMaterialCount        = 0;
+        PendingBoneCount            = 0;
+    }
+
+    void Clear()
+    {
+        Materials.clear();
+        Bones.clear();
+        DrawCalls.clear();
+    }
+};
+
+/**
+ * Emulates model pipelines: draw call info is filled on stack and passed to
+ * recorder, materials and bones are written into memory given by recorder
+ * @return digest of recorded frame if validate is set
+ */
+template <typename MeshRecorder, typename SkinRecorder>
+uint64_t RecordFrame( uint32_t frame, MeshRecorder &meshes,
+                      SkinRecorder &skins, bool validate )
+{
+    auto material_of = []( uint32_t draw, uint32_t i )
+    {
+        return MaterialData{ .mTexture     = static_cast<int32_t>( draw % 64 ),
+                             .mColor       = { 255, 255, 255, 255 },
+                             .mSpecTexture = static_cast<int32_t>( i ) - 1,
+                             .specular     = 0.0f };
+    };
+
+    uint64_t digest = 0;
+    for ( uint32_t draw = 0; draw < gMeshDrawCount; draw++ )
+    {
+        auto materials = meshes.AllocateDrawCallMaterials( gMaterialsPerDraw );
+        for ( uint32_t i = 0; i < gMaterialsPerDraw; i++ )
+            materials[i] = material_of( draw, i );
+
+        DrawCallInfo info{};
+        info.MeshId                 = draw % gMeshCount + 1;
+        info.DrawCallId             = draw + 1;
+        info.WorldTransform.m[3][0] = static_cast<float>( draw );
+        if ( draw % gMovingDrawStep == 0 )
+            info.WorldTransform.m[3][1] = static_cast<float>( frame );
+        if ( validate )
+            digest += DrawDigest( info, materials );
+        meshes.RecordDrawCall( info );
+    }
+
+    for ( uint32_t draw = 0; draw < gSkinDrawCount; draw++ )
+    {
+        auto materials = skins.AllocateDrawCallMaterials( gMaterialsPerDraw );
+        for ( uint32_t i = 0; i < gMaterialsPerDraw; i++ )
+            materials[i] = material_of( draw, i );
+        auto bones = skins.AllocateBoneTransforms( gBonesPerSkin );
+        for ( uint32_t i = 0; i < gBonesPerSkin; i++ )
+        {
+            bones[i]         = {};
+            bones[i].m[3][0] = static_cast<float>( draw );
+            bones[i].m[3][1] = static_cast<float>( frame + i );
+        }
+
+        SkinDrawCallInfo info{};
+        info.MeshId                 = draw % gMeshCount + 1;
+        info.DrawCallId             = gMeshDrawCount + draw + 1;
+        info.WorldTransform.m[3][0] = static_cast<float>( draw );
+        if ( validate )
+            digest += SkinDrawDigest( info, materials, bones );
+        skins.RecordDrawCall( info );
+    }
+    return digest;
+}
+
+/// Render driver side state, read by client after frame task completion
+bool                   gValidate = false;
+std::vector<uint64_t>  gDriverDigests;
+uint64_t               gDriverPacketBytes = 0;
+MeshInstanceTable      gMeshTable;
+SharedMemoryTaskQueue *gDriverQueue = nullptr;
+
+template <typename T> std::span<const T> ReadArray( MemoryReader &reader )
+{
+    auto count = *reader.Read<uint64_t>();
+    return { reader.Read<T>( count ), count };
+}
+
+/// Frame serialized by copying recorder vectors into the task payload
+void CopyFrameTaskImpl( MemoryReader &&reader, MemoryWriter && )
+{
+    auto mesh_materials = ReadArray<MaterialData>( reader );
+    auto mesh_draws     = ReadArray<DrawCallInfo>( reader );
+    auto skin_materials = ReadArray<MaterialData>( reader );
+    auto skin_bones     = ReadArray<DirectX::XMFLOAT4X3>( reader );
+    auto skin_draws     = ReadArray<SkinDrawCallInfo>( reader );
+    if ( !gValidate )
+        return;
+
+    uint64_t digest = 0;
+    for ( const auto &info : mesh_draws )
+        digest += DrawDigest( info, mesh_materials.subspan(
+                                        info.MaterialListStart,
+                                        info.MaterialListCount ) );
+    digest += SkinFrameDigest( skin_draws, skin_materials, skin_bones );
+    gDriverDigests.push_back( digest );
+}
+
+/// Bytes of recorded arrays the next sections point to
+template <typename... T> uint64_t SectionBytes( MemoryReader &reader )
+{
+    uint64_t bytes = 0;
+    ( ( bytes += reader.Read<FramePacketSection>()->Count * sizeof( T ) ),
+      ... );
+    return bytes;
+}
+
+/// Frame recorded into the frame packet by mesh and skin recorders
+void PacketFrameTaskImpl( MemoryReader &&reader, MemoryWriter && )
+{
+    const auto      header = *reader.Read<FramePacketHeader>();
+    FramePacketView packet{};
+    if ( auto *segment = gDriverQueue->ResolveSegment( header.SegmentId ) )
+    {
+        packet.Base = SharedMemorySegmentPool::Data( segment );
+        packet.Size = ( std::min )( header.Size, segment->Capacity );
+    }
+
+    MemoryReader sections( reader.CurrentAddress() );
+    gDriverPacketBytes +=
+        SectionBytes<uint32_t, uint32_t, DrawCallInfo, MaterialData>(
+            sections ) +
+        SectionBytes<MaterialData, DirectX::XMFLOAT4X3, SkinDrawCallInfo>(
+            sections );
+
+    auto meshes = MeshInstanceState::Deserialize( reader, packet, gMeshTable );
+    auto skins  = SkinInstanceState::Deserialize( reader, packet );
+    if ( !gValidate )
+        return;
+
+    // resident table has to hold exactly the draws of this frame
+    auto     materials = ToSpan( meshes.Materials );
+    uint64_t digest    = 0;
+    for ( auto slot : meshes.VisibleSlots )
+    {
+        const auto &info = meshes.DrawCalls[slot];
+        digest += DrawDigest( info,
+                              materials.subspan( info.MaterialListStart,
+                                                 info.MaterialListCount ) );
+    }
+    digest += SkinFrameDigest( ToSpan( skins.DrawCalls ),
+                               ToSpan( skins.Materials ),
+                               ToSpan( skins.BoneTransforms ) );
+    gDriverDigests.push_back( digest );
+}
+
+struct BenchmarkResult
+{
+    /// Draw data written by recorders
+    uint64_t RecordedBytes   = 0;
+    /// Task payload written by Serialize
+    uint64_t SerializedBytes = 0;
+    /// Frame packet memory allocated by recorders
+    uint64_t PacketBytes     = 0;
+    double   Elapsed         = 0;
+    /// Digests of recorded frames, filled if validated
+    std::vector<uint64_t> Digests;
+};
+
+/// Frames are pipelined with a single frame in flight, like with default
+/// MaxFramesAhead
+BenchmarkResult RunCopyFrames( SharedMemoryTaskQueue &queue, bool validate )
+{
+    VectorMeshRecorder meshes;
+    VectorSkinRecorder skins;
+
+    BenchmarkResult result{};
+    uint64_t        in_flight = 0;
+    auto            start     = std::chrono::steady_clock::now();
+    for ( uint32_t frame = 0; frame < gFrameCount; frame++ )
+    {
+        const bool measured = frame >= gWarmupFrameCount;
+        if ( frame == gWarmupFrameCount )
+        {
+            queue.WaitForTask( in_flight );
+            start = std::chrono::steady_clock::now();
+        }
+        meshes.Clear();
+        skins.Clear();
+        auto digest = RecordFrame( frame, meshes, skins, validate );
+        if ( validate && measured )
+            result.Digests.push_back( digest );
+
+        if ( in_flight != 0 )
+            queue.WaitForTask( in_flight );
+        uint64_t serialized = 0;
+        in_flight           = queue.SubmitTask(
+            gCopyFrameTaskId, [&]( MemoryWriter &&writer ) {
+                auto write = [&writer]( const auto &array )
+                {
+                    uint64_t count = array.size();
+                    writer.Write( &count );
+                    writer.Write( array.data(), count );
+                };
+                write( meshes.Materials );
+                write( meshes.DrawCalls );
+                write( skins.Materials );
+                write( skins.Bones );
+                write( skins.DrawCalls );
+                serialized = writer.Pos();
+            } );
+        if ( !measured )
+            continue;
+        result.RecordedBytes += ToSpan( meshes.Materials ).size_bytes() +
+                                ToSpan( meshes.DrawCalls ).size_bytes() +
+                                ToSpan( skins.Materials ).size_bytes() +
+                                ToSpan( skins.Bones ).size_bytes() +
+                                ToSpan( skins.DrawCalls ).size_bytes();
+        result.SerializedBytes += serialized;
+    }
+    queue.WaitForTask( in_flight );
+    result.Elapsed = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start )
+                         .count();
+    return result;
+}
+
+BenchmarkResult RunPacketFrames( SharedMemoryTaskQueue &queue, bool validate )
+{
+    FramePacketArena          arena( queue );
+    MeshInstanceStateRecorder meshes;
+    SkinInstanceStateRecorder skins;
+    // same headroom as ClientRenderState::FramePacketSize
+    auto begin_frame = [&]()
+    {
+        arena.Begin( ( meshes.PacketSize() + skins.PacketSize() ) * 2 );
+        meshes.BeginFrame( arena );
+        skins.BeginFrame( arena );
+    };
+
+    BenchmarkResult result{};
+    uint64_t        in_flight = 0;
+    auto            start     = std::chrono::steady_clock::now();
+    begin_frame();
+    for ( uint32_t frame = 0; frame < gFrameCount; frame++ )
+    {
+        const bool measured = frame >= gWarmupFrameCount;
+        if ( frame == gWarmupFrameCount )
+        {
+            queue.WaitForTask( in_flight );
+            start              = std::chrono::steady_clock::now();
+            gDriverPacketBytes = 0;
+        }
+        auto digest = RecordFrame( frame, meshes, skins, validate );
+        if ( validate && measured )
+            result.Digests.push_back( digest );
+
+        if ( in_flight != 0 )
+            queue.WaitForTask( in_flight );
+        uint64_t          serialized = 0;
+        FramePacketHeader header{};
+        in_flight = queue.SubmitTask(
+            gPacketFrameTaskId, [&]( MemoryWriter &&writer ) {
+                // recorders may still grow their arrays while serializing,
+                // so packet header is written last
+                auto &packet_header = writer.Current<FramePacketHeader>();
+                writer.Skip( sizeof( FramePacketHeader ) );
+                meshes.Serialize( writer, arena );
+                skins.Serialize( writer, arena );
+                header        = arena.Header();
+                packet_header = header;
+                serialized    = writer.Pos();
+            } );
+        arena.End( in_flight );
+        begin_frame();
+        if ( !measured )
+            continue;
+        result.SerializedBytes += serialized;
+        result.PacketBytes += header.Size;
+    }
+    queue.WaitForTask( in_flight );
+    result.Elapsed = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start )
+                         .count();
+    result.RecordedBytes = gDriverPacketBytes;
+    return result;
+}
+
+void PrintResult( const char *name, const BenchmarkResult &result )
+{
+    constexpr double frames = gFrameCount - gWarmupFrameCount;
+    std::printf( "%-12s recorded %8.1f KB, serialized %8.1f KB, copied "
+                 "%8.1f KB per frame, %.3f ms per frame\n",
+                 name, result.RecordedBytes / ( 1024.0 * frames ),
+                 result.SerializedBytes / ( 1024.0 * frames ),
+                 ( result.RecordedBytes + result.SerializedBytes ) /
+                     ( 1024.0 * frames ),
+                 result.Elapsed * 1e3 / frames );
+}
+
+/**
+ * Validated run computes digests of every draw, so it isn't timed
+ * @return false if render driver received other draws than were recorded
+ */
+template <typename Run>
+bool Validate( SharedMemoryTaskQueue &queue, Run run,
+               std::vector<uint64_t> &driver_digests )
+{
+    gValidate = true;
+    gDriverDigests.clear();
+    gMeshTable  = {};
+    auto result = run( queue, true );
+    gValidate   = false;
+    if ( gDriverDigests.size() != gFrameCount )
+        return false;
+    driver_digests.assign( gDriverDigests.begin() + gWarmupFrameCount,
+                           gDriverDigests.end() );
+    return driver_digests == result.Digests;
+}
+
+int main()
+{
+    rh::debug::DebugLogger::Init( "", rh::debug::LogLevel::Info );
+
+    SharedMemoryTaskQueueInfo info{ .mName  = "RenderHookFramePacketBench",
+                                    .mSize  = gQueueSizeMB * 1024 * 1024,
+                                    .mOwner = true };
+    SharedMemoryTaskQueue     client_queue( info );
+    info.mOwner = false;
+    SharedMemoryTaskQueue driver_queue( info );
+    gDriverQueue = &driver_queue;
+
+    driver_queue.RegisterTask(
+        gCopyFrameTaskId,
+        std::make_unique<SharedMemoryTask>( CopyFrameTaskImpl ) );
+    driver_queue.RegisterTask(
+        gPacketFrameTaskId,
+        std::make_unique<SharedMemoryTask>( PacketFrameTaskImpl ) );
+
+    std::atomic<bool> is_running{ true };
+    std::thread       driver_thread( [&]() {
+        while ( is_running )
+            driver_queue.TaskLoop();
+    } );
+
+    auto &config = rh::engine::EngineConfigBlock::It;
+    auto  copy_result = RunCopyFrames( client_queue, false );
+    // without persistent instances every draw is sent each frame, like with
+    // vectors, with them only moved draws are
+    config.PersistentMeshInstances = false;
+    gMeshTable                     = {};
+    auto full_result = RunPacketFrames( client_queue, false );
+    config.PersistentMeshInstances = true;
+    gMeshTable                     = {};
+    auto delta_result = RunPacketFrames( client_queue, false );
+    auto overflow_segments =
+        client_queue.GetStats().OverflowMemorySize / ( 1024.0 * 1024.0 );
+
+    std::vector<uint64_t> copy_digests;
+    std::vector<uint64_t> full_digests;
+    std::vector<uint64_t> delta_digests;
+    bool valid = Validate( client_queue, RunCopyFrames, copy_digests );
+    config.PersistentMeshInstances = false;
+    valid &= Validate( client_queue, RunPacketFrames, full_digests );
+    config.PersistentMeshInstances = true;
+    valid &= Validate( client_queue, RunPacketFrames, delta_digests );
+
+    client_queue.SendExitEvent();
+    driver_queue.WaitForExit();
+    is_running = false;
+    driver_thread.join();
+
+    std::printf( "%u frames, %u draws per frame, %u of them skinned, every "
+                 "%u static draw moves\n",
+                 gFrameCount - gWarmupFrameCount, gDrawCount, gSkinDrawCount,
+                 gMovingDrawStep );
+    PrintResult( "vectors:", copy_result );
+    PrintResult( "packet:", full_result );
+    PrintResult( "delta:", delta_result );
+    std::printf( "%.1f KB of frame packet allocated per frame, %.1f MB of "
+                 "frame packet segments\n",
+                 full_result.PacketBytes /
+                     ( 1024.0 * ( gFrameCount - gWarmupFrameCount ) ),
+                 overflow_segments );
+    if ( !valid )
+    {
+        std::printf( "FAILED: render driver received other draws than were "
+                     "recorded\n" );
+        return 1;
+    }
+    if ( copy_digests != full_digests || copy_digests != delta_digests )
+    {
+        std::printf( "FAILED: vector and packet paths delivered different "
+                     "draws\n" );
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,225 @@
+//
+// Created by peter on 16.10.2026.
+//
+// Drives null device through the same calls render driver makes each frame
+// and checks that work is counted, then reports CPU time per frame spent in
+// the device layer itself.
+//
+#include <Engine/Common/ISwapchain.h>
+#include <Engine/NullImpl/NullDeviceState.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace rh::engine;
+
+constexpr uint32_t gFrameCount       = 10000;
+constexpr uint32_t gDrawCallsPerPass = 256;
+constexpr uint32_t gVerticesPerDraw  = 6;
+
+uint32_t gErrors = 0;
+
+void Check( bool condition, const char *what )
+{
+    if ( condition )
+        return;
+    std::printf( "FAILED: %s\n", what );
+    gErrors++;
+}
+
+void TestBuffers( NullDeviceState &device )
+{
+    uint32_t init[4] = { 1, 2, 3, 4 };
+    std::unique_ptr<IBuffer> buffer( device.CreateBuffer(
+        { .mSize        = sizeof( init ),
+          .mUsage       = BufferUsage::ConstantBuffer,
+          .mFlags       = BufferFlags::Dynamic,
+          .mInitDataPtr = init } ) );
+
+    const auto &stats = device.GetStats();
+    Check( stats.BuffersAlive == 1, "buffer is alive" );
+    Check( stats.BufferBytesAlive == sizeof( init ), "buffer bytes counted" );
+
+    uint32_t value = 42;
+    buffer->Update( &value, sizeof( value ), sizeof( uint32_t ) * 2 );
+    auto *data = static_cast<uint32_t *>( buffer->Lock() );
+    Check( data[0] == 1 && data[2] == 42 && data[3] == 4,
+           "buffer keeps CPU visible contents" );
+    buffer->Unlock();
+    Check( stats.BufferUpdates == 2, "buffer updates counted" );
+
+    // out of range update is counted but ignored
+    buffer->Update( &value, sizeof( value ), sizeof( init ) );
+    Check( stats.BufferUpdates == 3, "out of range update counted" );
+
+    buffer.reset();
+    Check( stats.BuffersAlive == 0 && stats.BufferBytesAlive == 0,
+           "buffer release counted" );
+}
+
+void TestImages( NullDeviceState &device )
+{
+    ImageBufferCreateParams params{};
+    params.mDimension = ImageDimensions::d2D;
+    params.mFormat    = ImageBufferFormat::BC1;
+    params.mWidth     = 256;
+    params.mHeight    = 256;
+    params.mMipLevels = 9;
+
+    std::unique_ptr<IImageBuffer> image( device.CreateImageBuffer( params ) );
+    // BC1 mip chain of 256x256 image, mips below 4x4 take a whole block
+    uint64_t expected = 0;
+    for ( uint64_t size = 256; size >= 1; size /= 2 )
+        expected += ( size < 4 ? 4 : size ) * ( size < 4 ? 4 : size ) / 2;
+    Check( device.GetStats().ImageBytesAlive == expected,
+           "compressed mip chain size" );
+    image.reset();
+    Check( device.GetStats().ImagesAlive == 0, "image release counted" );
+}
+
+void TestDescriptors( NullDeviceState &device )
+{
+    std::array bindings = {
+        DescriptorBinding{ .mBindingId      = 0,
+                           .mDescriptorType = DescriptorType::ROBuffer,
+                           .mCount          = 1,
+                           .mShaderStages   = 0,
+                           .mFlags          = 0,
+                           .mRegisterId     = 0 },
+        DescriptorBinding{ .mBindingId      = 3,
+                           .mDescriptorType = DescriptorType::ROTexture,
+                           .mCount          = 1,
+                           .mShaderStages   = 0,
+                           .mFlags          = 0,
+                           .mRegisterId     = 3 } };
+    std::unique_ptr<IDescriptorSetLayout> layout(
+        device.CreateDescriptorSetLayout( { .mBindings = bindings } ) );
+    std::unique_ptr<IDescriptorSetAllocator> allocator(
+        device.CreateDescriptorSetAllocator(
+            { .mDescriptorPools = {}, .mMaxSets = 1 } ) );
+
+    std::array layouts = { layout.get() };
+    std::unique_ptr<IDescriptorSet> set(
+        allocator->AllocateDescriptorSets( { .mLayouts = layouts } )[0] );
+    Check( set->GetType( 3 ) == DescriptorType::ROTexture,
+           "descriptor type taken from layout" );
+    Check( device.GetStats().DescriptorSets == 1, "descriptor sets counted" );
+}
+
+/// Same sequence as FramebufferLoop and forward pass of the renderer
+double RunFrames( NullDeviceState &device, IWindow &window )
+{
+    std::unique_ptr<ICommandBuffer> cmd_buffer( device.CreateCommandBuffer() );
+    std::unique_ptr<ISyncPrimitive> image_acquire(
+        device.CreateSyncPrimitive( SyncPrimitiveType::GPU ) );
+    std::unique_ptr<ISyncPrimitive> render_execute(
+        device.CreateSyncPrimitive( SyncPrimitiveType::GPU ) );
+    std::unique_ptr<IRenderPass> pass( device.CreateRenderPass( {} ) );
+    std::unique_ptr<IBuffer>     vertex_buffer( device.CreateBuffer(
+        { .mSize        = gDrawCallsPerPass * gVerticesPerDraw * 32,
+          .mUsage       = BufferUsage::VertexBuffer,
+          .mFlags       = BufferFlags::Dynamic,
+          .mInitDataPtr = nullptr } ) );
+    std::vector<std::unique_ptr<IFrameBuffer>> framebuffers;
+    std::vector<uint8_t>                       vertices(
+        gDrawCallsPerPass * gVerticesPerDraw * 32, 0x7F );
+
+    using clock      = std::chrono::steady_clock;
+    const auto start = clock::now();
+    for ( uint32_t frame_id = 0; frame_id < gFrameCount; frame_id++ )
+    {
+        auto [swapchain, changed] = window.GetSwapchain();
+        if ( changed )
+            framebuffers.clear();
+        auto frame = swapchain->GetAvaliableFrame( image_acquire.get() );
+        if ( framebuffers.size() <= frame.mImageId )
+            framebuffers.resize( frame.mImageId + 1 );
+        auto &framebuffer = framebuffers[frame.mImageId];
+        if ( framebuffer == nullptr )
+            framebuffer.reset( device.CreateFrameBuffer(
+                { .width      = frame.mWidth,
+                  .height     = frame.mHeight,
+                  .imageViews = { frame.mImageView },
+                  .renderPass = pass.get() } ) );
+
+        vertex_buffer->Update( vertices.data(),
+                               static_cast<uint32_t>( vertices.size() ) );
+        cmd_buffer->BeginRecord();
+        cmd_buffer->BeginRenderPass( { .m_pRenderPass  = pass.get(),
+                                       .m_pFrameBuffer = framebuffer.get(),
+                                       .m_aClearValues = {} } );
+        for ( uint32_t dc = 0; dc < gDrawCallsPerPass; dc++ )
+        {
+            cmd_buffer->BindVertexBuffers(
+                0, { VertexBufferBinding{ vertex_buffer.get(),
+                                          dc * gVerticesPerDraw * 32, 32 } } );
+            cmd_buffer->Draw( gVerticesPerDraw, 1, 0, 0 );
+        }
+        cmd_buffer->EndRenderPass();
+        cmd_buffer->EndRecord();
+
+        device.DispatchToGPU(
+            { CommandBufferSubmitInfo{ cmd_buffer.get(),
+                                       { image_acquire.get() },
+                                       render_execute.get() } } );
+        swapchain->Present( frame.mImageId, render_execute.get() );
+        device.Wait( { cmd_buffer->ExecutionFinishedPrimitive() } );
+
+        // resize once in the middle, like a window mode change
+        if ( frame_id == gFrameCount / 2 )
+            window.SetWindowParams( { .mWidth      = 1280,
+                                      .mHeight     = 720,
+                                      .mFullscreen = 0,
+                                      .mPadd       = 0 } );
+    }
+    return std::chrono::duration<double>( clock::now() - start ).count();
+}
+
+int main()
+{
+    NullDeviceState device( { .mWidth = 1920, .mHeight = 1080 } );
+    Check( device.Init(), "device initialized" );
+
+    unsigned int    mode_id;
+    DisplayModeInfo mode{};
+    Check( device.GetCurrentDisplayMode( mode_id ) &&
+               device.GetDisplayModeInfo( mode_id, mode ) &&
+               mode.width == 1920 && mode.height == 1080,
+           "display mode reports configured size" );
+
+    TestBuffers( device );
+    TestImages( device );
+    TestDescriptors( device );
+
+    std::unique_ptr<IWindow> window(
+        device.CreateDeviceWindow( nullptr, { mode_id, true } ) );
+    device.ResetStats();
+    const auto  time  = RunFrames( device, *window );
+    const auto &stats = device.GetStats();
+
+    Check( stats.PresentedFrames == gFrameCount, "every frame presented" );
+    Check( stats.SubmittedBuffers == gFrameCount, "every frame submitted" );
+    Check( stats.DrawCalls == uint64_t{ gFrameCount } * gDrawCallsPerPass,
+           "draw calls counted" );
+    Check( stats.DrawnVertices == stats.DrawCalls * gVerticesPerDraw,
+           "drawn vertices counted" );
+    // two framebuffers before resize and two after it
+    Check( stats.ObjectsCreated >= 4, "framebuffers recreated after resize" );
+    Check( stats.BuffersAlive == 0 && stats.ImagesAlive == 0,
+           "no resources leaked" );
+
+    std::printf( "%u frames in %.3f ms, %.3f us per frame, %llu commands, "
+                 "%llu MB uploaded\n",
+                 gFrameCount, time * 1e3, time * 1e6 / gFrameCount,
+                 static_cast<unsigned long long>( stats.RecordedCommands ),
+                 static_cast<unsigned long long>( stats.BufferUpdateBytes /
+                                                  ( 1024 * 1024 ) ) );
+
+    window.reset();
+    device.Shutdown();
+    std::printf( "errors %u\n", gErrors );
+    return gErrors == 0 ? 0 : 1;
+}
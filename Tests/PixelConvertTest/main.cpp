@@ -0,0 +1,208 @@
+//
+// Created by peter on 16.10.2026.
+//
+// Checks every pixel conversion kernel level supported by CPU against the
+// scalar kernels on random data, then reports their throughput on a
+// 1024x1024 texture.
+//
+#include <rw_engine/rw_image/pixel_convert.h>
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace rh::rw::engine;
+
+constexpr uint32_t gBenchPixelCount = 1024 * 1024;
+constexpr uint32_t gBenchIterations = 200;
+
+constexpr PackedPixelFormat gPackedFormats[] = {
+    PackedPixelFormat::A1R5G5B5, PackedPixelFormat::X1R5G5B5,
+    PackedPixelFormat::R5G6B5, PackedPixelFormat::A4R4G4B4 };
+
+uint32_t gErrors = 0;
+
+void Check( bool condition, const char *what )
+{
+    if ( condition )
+        return;
+    std::printf( "FAILED: %s\n", what );
+    gErrors++;
+}
+
+const char *LevelName( PixelKernelLevel level )
+{
+    switch ( level )
+    {
+    case PixelKernelLevel::SSE2: return "SSE2";
+    case PixelKernelLevel::AVX2: return "AVX2";
+    default: return "Scalar";
+    }
+}
+
+template <typename T> std::vector<T> RandomData( std::mt19937 &rng, size_t n )
+{
+    std::uniform_int_distribution<uint32_t> dist( 0, 0xFFFFFFFF );
+    std::vector<T>                          data( n );
+    for ( auto &v : data )
+        v = static_cast<T>( dist( rng ) );
+    return data;
+}
+
+void TestScalarReference()
+{
+    SetPixelKernelLevel( PixelKernelLevel::Scalar );
+
+    const uint8_t palette[] = { 1, 2, 3, 4, 10, 20, 30, 40 };
+    const uint8_t indices[] = { 0, 1, 2, 255 };
+    uint32_t      dst[4];
+    ExpandPalette( indices, 4, palette, 2, false, dst );
+    Check( dst[0] == 0x04010203 && dst[1] == 0x280A141E,
+           "palette entries are swizzled to BGRA" );
+    Check( dst[2] == 0 && dst[3] == 0,
+           "indices past palette are transparent black" );
+    ExpandPalette( indices, 2, palette, 2, true, dst );
+    Check( dst[0] == 0xFF010203 && dst[1] == 0xFF0A141E,
+           "opaque palette has full alpha" );
+
+    const uint16_t packed[] = { 0xFFFF, 0x7C00, 0x801F, 0x0000 };
+    ExpandPackedPixels( PackedPixelFormat::A1R5G5B5, packed, 4, dst );
+    Check( dst[0] == 0xFFFFFFFF && dst[1] == 0x00FF0000 &&
+               dst[2] == 0xFF0000FF && dst[3] == 0,
+           "A1R5G5B5 expansion" );
+    ExpandPackedPixels( PackedPixelFormat::X1R5G5B5, packed, 4, dst );
+    Check( dst[1] == 0xFFFF0000 && dst[3] == 0xFF000000,
+           "X1R5G5B5 expansion" );
+    const uint16_t packed565[] = { 0xF800, 0x07E0, 0x001F, 0x0841 };
+    ExpandPackedPixels( PackedPixelFormat::R5G6B5, packed565, 4, dst );
+    Check( dst[0] == 0xFFFF0000 && dst[1] == 0xFF00FF00 &&
+               dst[2] == 0xFF0000FF && dst[3] == 0xFF080808,
+           "R5G6B5 expansion" );
+    const uint16_t packed4444[] = { 0xF0F0, 0x1234 };
+    ExpandPackedPixels( PackedPixelFormat::A4R4G4B4, packed4444, 2, dst );
+    Check( dst[0] == 0xFF00FF00 && dst[1] == 0x11223344,
+           "A4R4G4B4 expansion" );
+
+    const uint32_t pixels[] = { 0xFF000000, 0xFEFFFFFF };
+    Check( !HasTransparentPixels( pixels, 1 ), "opaque pixels" );
+    Check( HasTransparentPixels( pixels, 2 ), "transparent pixel" );
+}
+
+void TestLevel( PixelKernelLevel level, std::mt19937 &rng )
+{
+    // odd sizes cover vector loop tails
+    for ( const size_t n : { 0, 1, 7, 15, 16, 17, 31, 33, 100, 4099 } )
+    {
+        const auto indices = RandomData<uint8_t>( rng, n );
+        const auto palette = RandomData<uint8_t>( rng, 256 * 4 );
+        const auto packed  = RandomData<uint16_t>( rng, n );
+        std::vector<uint32_t> expected( n ), result( n );
+
+        for ( const uint32_t palette_size : { 16u, 256u } )
+        {
+            for ( const bool opaque : { false, true } )
+            {
+                SetPixelKernelLevel( PixelKernelLevel::Scalar );
+                ExpandPalette( indices.data(), n, palette.data(), palette_size,
+                               opaque, expected.data() );
+                SetPixelKernelLevel( level );
+                ExpandPalette( indices.data(), n, palette.data(), palette_size,
+                               opaque, result.data() );
+                Check( expected == result, "palette expansion matches" );
+            }
+        }
+
+        for ( const auto format : gPackedFormats )
+        {
+            SetPixelKernelLevel( PixelKernelLevel::Scalar );
+            ExpandPackedPixels( format, packed.data(), n, expected.data() );
+            SetPixelKernelLevel( level );
+            ExpandPackedPixels( format, packed.data(), n, result.data() );
+            Check( expected == result, "packed pixel expansion matches" );
+        }
+
+        // every position of a single transparent pixel
+        std::vector<uint32_t> pixels( n, 0xFF808080 );
+        SetPixelKernelLevel( level );
+        Check( !HasTransparentPixels( pixels.data(), n ),
+               "opaque image has no transparent pixels" );
+        for ( size_t i = 0; i < n && i < 100; i++ )
+        {
+            pixels[i] = 0xFE808080;
+            Check( HasTransparentPixels( pixels.data(), n ),
+                   "transparent pixel is found" );
+            pixels[i] = 0xFF808080;
+        }
+        if ( n > 0 )
+        {
+            pixels[n - 1] = 0x00FFFFFF;
+            Check( HasTransparentPixels( pixels.data(), n ),
+                   "last transparent pixel is found" );
+        }
+    }
+}
+
+template <typename Task> double MeasureMPixels( Task &&task )
+{
+    using clock      = std::chrono::steady_clock;
+    const auto start = clock::now();
+    for ( uint32_t i = 0; i < gBenchIterations; i++ )
+        task();
+    const auto time = std::chrono::duration<double>( clock::now() - start );
+    return double{ gBenchPixelCount } * gBenchIterations / time.count() /
+           1e6;
+}
+
+void Benchmark( PixelKernelLevel level, std::mt19937 &rng )
+{
+    const auto indices = RandomData<uint8_t>( rng, gBenchPixelCount );
+    const auto palette = RandomData<uint8_t>( rng, 256 * 4 );
+    const auto packed  = RandomData<uint16_t>( rng, gBenchPixelCount );
+    std::vector<uint32_t> dst( gBenchPixelCount );
+    std::vector<uint32_t> opaque( gBenchPixelCount, 0xFF808080 );
+
+    SetPixelKernelLevel( level );
+    const auto palette_speed = MeasureMPixels(
+        [&]
+        {
+            ExpandPalette( indices.data(), gBenchPixelCount, palette.data(),
+                           256, false, dst.data() );
+        } );
+    const auto packed_speed = MeasureMPixels(
+        [&]
+        {
+            ExpandPackedPixels( PackedPixelFormat::R5G6B5, packed.data(),
+                                gBenchPixelCount, dst.data() );
+        } );
+    // opaque image is the worst case, every pixel is checked
+    bool       found       = false;
+    const auto alpha_speed = MeasureMPixels(
+        [&]
+        { found |= HasTransparentPixels( opaque.data(), opaque.size() ); } );
+    Check( !found, "opaque benchmark image" );
+
+    std::printf( "%-6s palette %8.1f MPix/s, 565 %8.1f MPix/s, "
+                 "alpha scan %8.1f MPix/s\n",
+                 LevelName( level ), palette_speed, packed_speed,
+                 alpha_speed );
+}
+
+int main()
+{
+    std::mt19937 rng( 1234 );
+    const auto   supported = GetSupportedPixelKernelLevel();
+    std::printf( "supported kernel level: %s\n", LevelName( supported ) );
+
+    TestScalarReference();
+    for ( auto level = static_cast<uint32_t>( PixelKernelLevel::SSE2 );
+          level <= static_cast<uint32_t>( supported ); level++ )
+        TestLevel( static_cast<PixelKernelLevel>( level ), rng );
+
+    for ( auto level = static_cast<uint32_t>( PixelKernelLevel::Scalar );
+          level <= static_cast<uint32_t>( supported ); level++ )
+        Benchmark( static_cast<PixelKernelLevel>( level ), rng );
+
+    std::printf( "errors %u\n", gErrors );
+    return gErrors == 0 ? 0 : 1;
+}
@@ -0,0 +1,296 @@
+//
+// Created by peter on 16.10.2026.
+//
+// Resource pool benchmark, measures request/free/GC churn of a pool filled
+// with 20k resources, similar to mesh and raster pools during streaming
+// bursts. Free list pool is compared against the previous pool that searched
+// for free slots and garbage by walking the whole pool.
+//
+#include <DebugUtils/DebugLogger.h>
+#include <Engine/ResourcePool.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+
+using rh::engine::ResourcePool;
+
+constexpr uint64_t gPoolSize        = 20000;
+constexpr uint32_t gFrameCount      = 1000;
+/// streaming burst, more resources are freed per frame than GC budget allows
+constexpr uint32_t gChurnPerFrame   = 200;
+constexpr uint64_t gGarbageBudget   = 120;
+constexpr uint32_t gCallbackCount   = 3;
+
+struct BenchResource
+{
+    uint64_t Payload[4]{};
+};
+
+/// Callback state large enough to not fit std::function small buffer
+struct CallbackState
+{
+    uint64_t *Counter;
+    uint64_t  Salt[3];
+};
+
+/// Previous ResourcePool algorithm, kept only for comparison
+class LinearScanPool
+{
+    enum ResourceFlags : uint64_t
+    {
+        Unused,
+        FreeAtNextGC,
+        Used
+    };
+    using Callback = std::function<void( BenchResource &, uint64_t )>;
+
+  public:
+    explicit LinearScanPool( uint64_t size )
+    {
+        mResourcePool.resize( size );
+        mResourcePoolData.resize( size );
+    }
+
+    uint64_t RequestResource( BenchResource resource )
+    {
+        auto res = FindFreeResourceIdx();
+        if ( !res.second )
+        {
+            CollectGarbage( 1 );
+            res = FindFreeResourceIdx();
+        }
+        if ( res.first >= mResourcePool.size() )
+        {
+            mResourcePool.push_back( {} );
+            mResourcePoolData.push_back( {} );
+        }
+        mResourcePoolData[res.first] = resource;
+        mResourcePool[res.first]     = ResourceFlags::Used;
+        for ( auto [id, cb] : mRequestCallbacks )
+            cb( mResourcePoolData[res.first], res.first );
+        mFreeResourceIdx = res.first + 1;
+        return res.first;
+    }
+
+    std::pair<uint64_t, bool> FindFreeResourceIdx()
+    {
+        uint64_t idx = mFreeResourceIdx;
+        while ( idx < mResourcePool.size() )
+        {
+            if ( mResourcePool[idx] == ResourceFlags::Unused )
+                return { idx, true };
+            ++idx;
+        }
+        return { idx, false };
+    }
+
+    void FreeResource( uint64_t idx )
+    {
+        mResourcePool[idx] = ResourceFlags::FreeAtNextGC;
+        mGarbageCount++;
+    }
+
+    void CollectGarbage( uint64_t to_free_resource_count )
+    {
+        if ( mGarbageCount <= 0 )
+            return;
+        int64_t free_idx = -1;
+        for ( uint64_t idx = 0; idx < mResourcePoolData.size(); idx++ )
+        {
+            auto &flags = mResourcePool[idx];
+            if ( flags != ResourceFlags::FreeAtNextGC )
+                continue;
+            if ( free_idx == -1 )
+                free_idx = idx;
+            for ( auto current = mDestructCallbacks.rbegin(),
+                       end     = mDestructCallbacks.rend();
+                  current != end; current++ )
+                ( *current ).second( mResourcePoolData[idx], idx );
+            mResourcePoolData[idx] = {};
+            flags                  = ResourceFlags::Unused;
+            mGarbageCount--;
+            if ( to_free_resource_count-- <= 0 )
+                break;
+        }
+        if ( free_idx == -1 )
+            mFreeResourceIdx = 0;
+        else if ( free_idx < mFreeResourceIdx )
+            mFreeResourceIdx = free_idx;
+    }
+
+    void AddOnRequestCallback( Callback &&cb, uint64_t id )
+    {
+        mRequestCallbacks.emplace_back( id, cb );
+    }
+    void AddOnDestructCallback( Callback &&cb, uint64_t id )
+    {
+        mDestructCallbacks.emplace_back( id, cb );
+    }
+
+  private:
+    uint64_t                                   mGarbageCount    = 0;
+    int64_t                                    mFreeResourceIdx = 0;
+    std::vector<ResourceFlags>                 mResourcePool{};
+    std::vector<BenchResource>                 mResourcePoolData{};
+    std::vector<std::pair<uint64_t, Callback>> mDestructCallbacks{};
+    std::vector<std::pair<uint64_t, Callback>> mRequestCallbacks{};
+};
+
+struct BenchmarkResult
+{
+    double   FillTime  = 0;
+    double   ChurnTime = 0;
+    double   DrainTime = 0;
+    uint64_t Callbacks = 0;
+};
+
+template <typename Pool> void AddCallbacks( Pool &pool, uint64_t &counter )
+{
+    for ( uint32_t i = 0; i < gCallbackCount; i++ )
+    {
+        CallbackState state{ &counter, { i, i, i } };
+        pool.AddOnRequestCallback(
+            [state]( BenchResource &, uint64_t /*id*/ )
+            { *state.Counter += state.Salt[0] + 1; },
+            i + 1 );
+        pool.AddOnDestructCallback(
+            [state]( BenchResource &, uint64_t /*id*/ )
+            { *state.Counter += state.Salt[0] + 1; },
+            i + 1 );
+    }
+}
+
+double Seconds( std::chrono::steady_clock::time_point start )
+{
+    return std::chrono::duration<double>( std::chrono::steady_clock::now() -
+                                          start )
+        .count();
+}
+
+template <typename Pool> BenchmarkResult RunChurn( Pool &pool )
+{
+    BenchmarkResult result{};
+    AddCallbacks( pool, result.Callbacks );
+    std::mt19937_64 rng( 42 );
+
+    auto                  start = std::chrono::steady_clock::now();
+    std::vector<uint64_t> live;
+    live.reserve( gPoolSize );
+    for ( uint64_t i = 0; i < gPoolSize; i++ )
+        live.push_back( pool.RequestResource( BenchResource{ { i } } ) );
+    result.FillTime = Seconds( start );
+
+    start = std::chrono::steady_clock::now();
+    for ( uint32_t frame = 0; frame < gFrameCount; frame++ )
+    {
+        for ( uint32_t i = 0; i < gChurnPerFrame; i++ )
+        {
+            auto idx = rng() % live.size();
+            pool.FreeResource( live[idx] );
+            live[idx] = live.back();
+            live.pop_back();
+        }
+        for ( uint32_t i = 0; i < gChurnPerFrame; i++ )
+            live.push_back( pool.RequestResource( BenchResource{ { i } } ) );
+        pool.CollectGarbage( gGarbageBudget );
+    }
+    result.ChurnTime = Seconds( start );
+
+    start = std::chrono::steady_clock::now();
+    for ( auto id : live )
+        pool.FreeResource( id );
+    for ( uint64_t freed = 0; freed < gPoolSize; freed += gGarbageBudget )
+        pool.CollectGarbage( gGarbageBudget );
+    result.DrainTime = Seconds( start );
+    return result;
+}
+
+/// Freed ids must become stale once collected, even if their slot is reused
+bool CheckStaleIds()
+{
+    ResourcePool<BenchResource> pool( 4, []( BenchResource &, uint64_t ) {} );
+    auto                        first = pool.RequestResource( {} );
+    pool.FreeResource( first );
+    if ( !pool.IsValid( first ) )
+        return false;
+    pool.CollectGarbage( 1 );
+    auto reused = pool.RequestResource( {} );
+    bool valid  = !pool.IsValid( first ) && pool.IsValid( reused ) &&
+                 rh::engine::ResourceSlot( first ) ==
+                     rh::engine::ResourceSlot( reused ) &&
+                 first != reused;
+    pool.FreeResource( reused );
+    pool.CollectGarbage( 1 );
+    return valid;
+}
+
+/// Freed resources must outlive the frames that may still use them
+bool CheckRetireFences()
+{
+    ResourcePool<BenchResource> pool( 4, []( BenchResource &, uint64_t ) {} );
+    pool.SetFrameFences( 2, 1 );
+    auto in_flight = pool.RequestResource( {} );
+    pool.FreeResource( in_flight );
+    if ( pool.CollectGarbage( 1 ) != 0 || !pool.IsValid( in_flight ) )
+        return false;
+    pool.SetFrameFences( 3, 2 );
+    auto next_frame = pool.RequestResource( {} );
+    pool.FreeResource( next_frame );
+    // only the resource of the completed frame may be destroyed
+    bool valid = pool.CollectGarbage( 2 ) == 1 && !pool.IsValid( in_flight ) &&
+                 pool.IsValid( next_frame );
+    pool.SetFrameFences( 3, 3 );
+    valid = valid && pool.CollectGarbage( 1 ) == 1;
+    return valid && pool.GetGarbageCount() == 0;
+}
+
+void PrintResult( const char *name, const BenchmarkResult &result )
+{
+    std::printf( "%-12s fill %8.3f ms, churn %8.3f us per frame, "
+                 "drain %8.3f ms\n",
+                 name, result.FillTime * 1e3,
+                 result.ChurnTime * 1e6 / gFrameCount,
+                 result.DrainTime * 1e3 );
+}
+
+int main()
+{
+    rh::debug::DebugLogger::Init( "", rh::debug::LogLevel::Info );
+
+    BenchmarkResult linear_result;
+    {
+        LinearScanPool pool( gPoolSize );
+        linear_result = RunChurn( pool );
+    }
+    BenchmarkResult free_list_result;
+    {
+        ResourcePool<BenchResource> pool(
+            gPoolSize, []( BenchResource &, uint64_t ) {} );
+        free_list_result = RunChurn( pool );
+    }
+
+    std::printf( "%llu resources, %u frames, %u freed and requested per "
+                 "frame, GC budget %llu\n",
+                 static_cast<unsigned long long>( gPoolSize ), gFrameCount,
+                 gChurnPerFrame,
+                 static_cast<unsigned long long>( gGarbageBudget ) );
+    PrintResult( "linear scan:", linear_result );
+    PrintResult( "free list:", free_list_result );
+
+    if ( !CheckStaleIds() )
+    {
+        std::printf( "FAILED: freed resource id is still valid\n" );
+        return 1;
+    }
+    if ( !CheckRetireFences() )
+    {
+        std::printf( "FAILED: resource destroyed while its frame was in "
+                     "flight\n" );
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,488 @@
+//
+// Created by peter on 16.10.2026.
+//
+// Stress test and round-trip benchmark for SharedMemoryTaskQueue.
+// Client and render driver sides are run on separate threads with separate
+// mappings of the same shared memory, same as in MultiThreadedRenderer mode.
+//
+#include <DebugUtils/DebugLogger.h>
+#include <ipc/shared_memory_queue_client.h>
+#include <ipc/task_replay.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace rh::rw::engine;
+
+constexpr int64_t  gEchoTaskId    = 1;
+constexpr int64_t  gPostTaskId    = 2;
+constexpr int64_t  gQueryTaskId   = 3;
+constexpr int64_t  gStreamTaskId  = 4;
+constexpr int64_t  gSegmentTaskId = 5;
+constexpr uint32_t gQueueSizeMB   = 4;
+constexpr uint32_t gTaskCount     = 200000;
+constexpr uint32_t gMaxTaskWords  = 16 * 1024;
+constexpr uint32_t gBigTaskPeriod = 97;
+/// stream tasks are several times larger than the whole queue
+constexpr uint32_t gStreamTaskCount  = 20;
+constexpr uint32_t gStreamChunkWords = 256 * 1024;
+constexpr uint32_t gStreamChunkCount = 24;
+/// capture/replay test, small enough to keep capture file small
+constexpr uint32_t gCaptureTaskCount  = 1000;
+constexpr uint32_t gCaptureFrameCount = 16;
+constexpr uint32_t gCaptureFrameWords = 64 * 1024;
+
+/// Sums task payload and writes result in place, just like real tasks do
+void EchoTaskImpl( void *memory )
+{
+    MemoryReader reader( memory );
+    auto         word_count = *reader.Read<uint32_t>();
+    auto *       words      = reader.Read<uint32_t>( word_count );
+
+    uint64_t sum = 0;
+    for ( uint32_t i = 0; i < word_count; i++ )
+        sum += words[i];
+
+    MemoryWriter writer( memory );
+    writer.Write( &sum );
+}
+
+/// Render driver side sums, compared between captured and replayed tasks
+uint64_t gStreamSum  = 0;
+uint64_t gSegmentSum = 0;
+
+/// Same as echo task, but payload is split into chunks that may be spilled
+/// into overflow segments
+void StreamTaskImpl( MemoryReader &&reader, MemoryWriter &&writer )
+{
+    auto     chunk_count = *reader.Read<uint32_t>();
+    uint64_t sum         = 0;
+    for ( uint32_t chunk = 0; chunk < chunk_count; chunk++ )
+    {
+        auto  word_count = *reader.Read<uint32_t>();
+        auto *words      = reader.Read<uint32_t>( word_count );
+        for ( uint32_t i = 0; i < word_count; i++ )
+            sum += words[i];
+    }
+    if ( reader.Overflowed() )
+        sum = 0;
+    gStreamSum += sum;
+    writer.Write( &sum );
+}
+
+/// Posted task state, accessed only by render driver thread
+uint64_t gPostedSum   = 0;
+uint64_t gPostedCount = 0;
+
+void PostedTaskImpl( void *memory )
+{
+    MemoryReader reader( memory );
+    gPostedSum += *reader.Read<uint64_t>();
+    gPostedCount++;
+}
+
+void QueryTaskImpl( void *memory )
+{
+    MemoryWriter writer( memory );
+    writer.Write( &gPostedSum );
+    writer.Write( &gPostedCount );
+}
+
+/// Queue segment tasks are resolved with, like frame packets in render task
+SharedMemoryTaskQueue *gSegmentQueue = nullptr;
+
+/// Sums segment referenced by the task, segment is captured like frame
+/// packets are
+void SegmentTaskImpl( MemoryReader &&reader, MemoryWriter && )
+{
+    const auto segment_id = *reader.Read<uint32_t>();
+    const auto word_count = *reader.Read<uint64_t>();
+    auto *     segment    = gSegmentQueue->ResolveSegment( segment_id );
+    if ( segment == nullptr )
+        return;
+    const auto *words = reinterpret_cast<const uint32_t *>(
+        SharedMemorySegmentPool::Data( segment ) );
+    if ( gSegmentQueue->IsCapturing() )
+        gSegmentQueue->CaptureSegment( segment_id, words,
+                                       word_count * sizeof( uint32_t ) );
+    for ( uint64_t i = 0; i < word_count; i++ )
+        gSegmentSum += words[i];
+}
+
+/**
+ * Captures posted, spilled and segment tasks executed by render driver and
+ * replays them, replayed tasks must produce the same render driver state
+ * @return failed check count
+ */
+uint32_t RunCaptureReplayTest( std::mt19937 &rng )
+{
+    const char *capture_path = "shared_memory_queue_test.capture";
+
+    SharedMemoryTaskQueueInfo info{ .mName  = "RenderHookQueueCaptureTest",
+                                    .mSize  = gQueueSizeMB * 1024 * 1024,
+                                    .mOwner = true };
+    SharedMemoryTaskQueue     client_queue( info );
+    info.mOwner = false;
+    SharedMemoryTaskQueue driver_queue( info );
+    driver_queue.RegisterTask(
+        gPostTaskId, std::make_unique<SharedMemoryTask>( PostedTaskImpl ) );
+    driver_queue.RegisterTask(
+        gStreamTaskId, std::make_unique<SharedMemoryTask>( StreamTaskImpl ) );
+    driver_queue.RegisterTask(
+        gSegmentTaskId,
+        std::make_unique<SharedMemoryTask>( SegmentTaskImpl ) );
+    gSegmentQueue = &driver_queue;
+    gPostedSum = gPostedCount = gStreamSum = gSegmentSum = 0;
+
+    if ( !driver_queue.StartCapture( capture_path ) )
+        return 1;
+    std::atomic<bool> is_running{ true };
+    std::thread       driver_thread( [&]() {
+        while ( is_running )
+            driver_queue.TaskLoop();
+    } );
+
+    for ( uint64_t task = 0; task < gCaptureTaskCount; task++ )
+        client_queue.PostTask( gPostTaskId, [task]( MemoryWriter &&writer ) {
+            writer.Write( &task );
+        } );
+    // spilled task, captured payload must include overflow segments
+    std::vector<uint32_t> words( gStreamChunkWords * gStreamChunkCount );
+    for ( auto &word : words )
+        word = rng();
+    client_queue.ExecuteTask( gStreamTaskId, [&]( MemoryWriter &&writer ) {
+        writer.Write( &gStreamChunkCount );
+        for ( uint32_t chunk = 0; chunk < gStreamChunkCount; chunk++ )
+        {
+            writer.Write( &gStreamChunkWords );
+            writer.Write( words.data() + chunk * gStreamChunkWords,
+                          gStreamChunkWords );
+        }
+    } );
+    // chunked task, captured payload must include every chunk
+    client_queue.ExecuteChunkedTask(
+        gStreamTaskId, [&]( MemoryWriter &&writer ) {
+            writer.Write( &gStreamChunkCount );
+            for ( uint32_t chunk = 0; chunk < gStreamChunkCount; chunk++ )
+            {
+                writer.Write( &gStreamChunkWords );
+                writer.Write( words.data() + chunk * gStreamChunkWords,
+                              gStreamChunkWords );
+            }
+        } );
+    // mostly zeroed frames, same segments are reused by following frames
+    for ( uint32_t frame = 0; frame < gCaptureFrameCount; frame++ )
+    {
+        auto *segment = client_queue.AcquireSegment(
+            gCaptureFrameWords * sizeof( uint32_t ) );
+        if ( segment == nullptr )
+            return 1;
+        auto *frame_words = reinterpret_cast<uint32_t *>(
+            SharedMemorySegmentPool::Data( segment ) );
+        std::memset( frame_words, 0, gCaptureFrameWords * sizeof( uint32_t ) );
+        for ( uint32_t i = 0; i < gCaptureFrameWords; i += 64 )
+            frame_words[i] = rng();
+
+        const uint32_t segment_id = segment->Id;
+        const uint64_t word_count = gCaptureFrameWords;
+        auto           sequence   = client_queue.SubmitTask(
+            gSegmentTaskId, [&]( MemoryWriter &&writer ) {
+                writer.Write( &segment_id );
+                writer.Write( &word_count );
+            } );
+        client_queue.ReleaseSegment( segment_id, sequence );
+        client_queue.WaitForTask( sequence );
+    }
+    is_running = false;
+    driver_thread.join();
+    driver_queue.StopCapture();
+
+    const uint64_t captured[] = { gPostedSum, gPostedCount, gStreamSum,
+                                  gSegmentSum };
+    gPostedSum = gPostedCount = gStreamSum = gSegmentSum = 0;
+
+    uint32_t failed_checks = 0;
+    {
+        TaskReplay replay( driver_queue );
+        if ( !replay.Open( capture_path ) )
+            return 1;
+        while ( replay.ReplayNextTask( false ) )
+            ;
+        const uint64_t replayed[] = { gPostedSum, gPostedCount, gStreamSum,
+                                      gSegmentSum };
+        if ( std::memcmp( captured, replayed, sizeof( captured ) ) != 0 ||
+             gPostedCount != gCaptureTaskCount )
+            failed_checks++;
+        std::printf( "%llu captured tasks replayed\n",
+                     static_cast<unsigned long long>( replay.TaskCount() ) );
+    }
+    std::remove( capture_path );
+    return failed_checks;
+}
+
+int main()
+{
+    rh::debug::DebugLogger::Init( "", rh::debug::LogLevel::Info );
+
+    SharedMemoryTaskQueueInfo info{ .mName  = "RenderHookQueueStressTest",
+                                    .mSize  = gQueueSizeMB * 1024 * 1024,
+                                    .mOwner = true };
+    SharedMemoryTaskQueue     client_queue( info );
+    info.mOwner = false;
+    SharedMemoryTaskQueue driver_queue( info );
+
+    driver_queue.RegisterTask(
+        gEchoTaskId, std::make_unique<SharedMemoryTask>( EchoTaskImpl ) );
+    driver_queue.RegisterTask(
+        gPostTaskId, std::make_unique<SharedMemoryTask>( PostedTaskImpl ) );
+    driver_queue.RegisterTask(
+        gQueryTaskId, std::make_unique<SharedMemoryTask>( QueryTaskImpl ) );
+    driver_queue.RegisterTask(
+        gStreamTaskId, std::make_unique<SharedMemoryTask>( StreamTaskImpl ) );
+    driver_queue.RegisterTask(
+        gSegmentTaskId,
+        std::make_unique<SharedMemoryTask>( SegmentTaskImpl ) );
+    gSegmentQueue = &driver_queue;
+
+    std::atomic<bool> is_running{ true };
+    std::thread       driver_thread( [&]() {
+        while ( is_running )
+            driver_queue.TaskLoop();
+    } );
+
+    std::mt19937          rng( 42 );
+    std::vector<uint32_t> words( gMaxTaskWords );
+    uint32_t              failed_tasks = 0;
+    uint64_t              sent_bytes   = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for ( uint32_t task = 0; task < gTaskCount; task++ )
+    {
+        // mostly small tasks with occasional big ones to force ring wraps
+        uint32_t word_count = ( task % gBigTaskPeriod ) == 0
+                                  ? gMaxTaskWords
+                                  : 1 + rng() % 64;
+        uint64_t expected   = 0;
+        for ( uint32_t i = 0; i < word_count; i++ )
+        {
+            words[i] = rng();
+            expected += words[i];
+        }
+        sent_bytes += word_count * sizeof( uint32_t );
+
+        uint64_t result = 0;
+        client_queue.ExecuteTask(
+            gEchoTaskId,
+            [&]( MemoryWriter &&writer ) {
+                writer.Write( &word_count );
+                writer.Write( words.data(), word_count );
+            },
+            [&]( MemoryReader &&reader ) {
+                result = *reader.Read<uint64_t>();
+            } );
+        if ( result != expected )
+            failed_tasks++;
+    }
+    auto elapsed = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start )
+                       .count();
+
+    // fire-and-forget tasks, must be executed before the next executed task
+    uint64_t expected_posted_sum = 0;
+    start                        = std::chrono::steady_clock::now();
+    for ( uint64_t task = 0; task < gTaskCount; task++ )
+    {
+        expected_posted_sum += task;
+        client_queue.PostTask( gPostTaskId, [task]( MemoryWriter &&writer ) {
+            writer.Write( &task );
+        } );
+    }
+    uint64_t posted_sum = 0, posted_count = 0;
+    client_queue.ExecuteTask( gQueryTaskId, EmptySerializer,
+                              [&]( MemoryReader &&reader ) {
+                                  posted_sum   = *reader.Read<uint64_t>();
+                                  posted_count = *reader.Read<uint64_t>();
+                              } );
+    auto posted_elapsed = std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - start )
+                              .count();
+    if ( posted_sum != expected_posted_sum || posted_count != gTaskCount )
+        failed_tasks++;
+
+    // submitted tasks, client waits only for the last one, like for frames
+    uint64_t last_task = 0;
+    start              = std::chrono::steady_clock::now();
+    for ( uint64_t task = 0; task < gTaskCount; task++ )
+    {
+        expected_posted_sum += task;
+        last_task = client_queue.SubmitTask(
+            gPostTaskId,
+            [task]( MemoryWriter &&writer ) { writer.Write( &task ); } );
+    }
+    client_queue.WaitForTask( last_task );
+    auto submit_elapsed = std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - start )
+                              .count();
+    if ( !client_queue.IsTaskCompleted( last_task ) )
+        failed_tasks++;
+    client_queue.ExecuteTask( gQueryTaskId, EmptySerializer,
+                              [&]( MemoryReader &&reader ) {
+                                  posted_sum   = *reader.Read<uint64_t>();
+                                  posted_count = *reader.Read<uint64_t>();
+                              } );
+    if ( posted_sum != expected_posted_sum || posted_count != 2 * gTaskCount )
+        failed_tasks++;
+
+    // tasks larger than the ring, overflow segments must be reused
+    start = std::chrono::steady_clock::now();
+    for ( uint32_t task = 0; task < gStreamTaskCount; task++ )
+    {
+        uint64_t expected = 0;
+        words.resize( gStreamChunkWords * gStreamChunkCount );
+        for ( auto &word : words )
+        {
+            word = rng();
+            expected += word;
+        }
+
+        uint64_t result = 0;
+        client_queue.ExecuteTask(
+            gStreamTaskId,
+            [&]( MemoryWriter &&writer ) {
+                writer.Write( &gStreamChunkCount );
+                for ( uint32_t chunk = 0; chunk < gStreamChunkCount; chunk++ )
+                {
+                    writer.Write( &gStreamChunkWords );
+                    writer.Write( words.data() + chunk * gStreamChunkWords,
+                                  gStreamChunkWords );
+                }
+            },
+            [&]( MemoryReader &&reader ) {
+                result = *reader.Read<uint64_t>();
+            } );
+        if ( result != expected )
+            failed_tasks++;
+    }
+    auto stream_elapsed = std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - start )
+                              .count();
+    const auto &stats = client_queue.GetStats();
+    if ( stats.SpilledTaskCount != gStreamTaskCount )
+        failed_tasks++;
+
+    // same tasks sent in chunks, chunk headers are patched after their data
+    // is reserved, like mip level headers of streamed rasters
+    const auto overflow_size = stats.OverflowMemorySize;
+    start                    = std::chrono::steady_clock::now();
+    for ( uint32_t task = 0; task < gStreamTaskCount; task++ )
+    {
+        uint64_t expected = 0;
+        for ( auto &word : words )
+        {
+            word = rng();
+            expected += word;
+        }
+
+        uint64_t result = 0;
+        client_queue.ExecuteChunkedTask(
+            gStreamTaskId,
+            [&]( MemoryWriter &&writer ) {
+                writer.Write( &gStreamChunkCount );
+                for ( uint32_t chunk = 0; chunk < gStreamChunkCount; chunk++ )
+                {
+                    auto &word_count = writer.Current<uint32_t>();
+                    writer.Skip( sizeof( uint32_t ) );
+                    writer.Write( words.data() + chunk * gStreamChunkWords,
+                                  gStreamChunkWords );
+                    word_count = gStreamChunkWords;
+                }
+            },
+            [&]( MemoryReader &&reader ) {
+                result = *reader.Read<uint64_t>();
+            } );
+        if ( result != expected )
+            failed_tasks++;
+    }
+    auto chunked_elapsed = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - start )
+                               .count();
+    if ( stats.ChunkedTaskCount != gStreamTaskCount ||
+         stats.SpilledTaskCount != gStreamTaskCount ||
+         stats.OverflowMemorySize != overflow_size )
+        failed_tasks++;
+
+    // idle segments are unmapped, render driver has to open segments
+    // acquired after that instead of stale mappings
+    const uint64_t frame_words = words.size();
+    auto           send_frame  = [&]()
+    {
+        auto *segment =
+            client_queue.AcquireSegment( frame_words * sizeof( uint32_t ) );
+        if ( segment == nullptr )
+            return false;
+        auto *frame = reinterpret_cast<uint32_t *>(
+            SharedMemorySegmentPool::Data( segment ) );
+        uint64_t expected = 0;
+        for ( uint64_t i = 0; i < frame_words; i++ )
+        {
+            frame[i] = rng();
+            expected += frame[i];
+        }
+        const uint32_t segment_id = segment->Id;
+        const uint64_t sum_before = gSegmentSum;
+        auto           sequence   = client_queue.SubmitTask(
+            gSegmentTaskId, [&]( MemoryWriter &&writer ) {
+                writer.Write( &segment_id );
+                writer.Write( &frame_words );
+            } );
+        client_queue.ReleaseSegment( segment_id, sequence );
+        client_queue.WaitForTask( sequence );
+        return gSegmentSum - sum_before == expected;
+    };
+    if ( !send_frame() )
+        failed_tasks++;
+    const auto mapped_size = stats.OverflowMemorySize;
+    for ( uint64_t frame = 0; frame < gOverflowSegmentIdleTrims; frame++ )
+        client_queue.TrimOverflowSegments();
+    const auto trimmed_size = stats.OverflowMemorySize;
+    if ( trimmed_size != 0 || trimmed_size >= mapped_size || !send_frame() )
+        failed_tasks++;
+
+    client_queue.SendExitEvent();
+    driver_queue.WaitForExit();
+    is_running = false;
+    driver_thread.join();
+
+    failed_tasks += RunCaptureReplayTest( rng );
+
+    std::printf( "%u tasks, %.1f MB in %.3f s: %.2f us per round trip\n",
+                 gTaskCount, sent_bytes / ( 1024.0 * 1024.0 ), elapsed,
+                 elapsed * 1e6 / gTaskCount );
+    std::printf( "%u posted tasks in %.3f s: %.3f us per task\n", gTaskCount,
+                 posted_elapsed, posted_elapsed * 1e6 / gTaskCount );
+    std::printf( "%u submitted tasks in %.3f s: %.3f us per task\n",
+                 gTaskCount, submit_elapsed,
+                 submit_elapsed * 1e6 / gTaskCount );
+    std::printf( "%u stream tasks in %.3f s, largest task %.1f MB, %.1f MB "
+                 "of overflow segments\n",
+                 gStreamTaskCount, stream_elapsed,
+                 stats.LargestTaskSize / ( 1024.0 * 1024.0 ),
+                 overflow_size / ( 1024.0 * 1024.0 ) );
+    std::printf( "%u chunked tasks in %.3f s, %.1f MB chunks\n",
+                 gStreamTaskCount, chunked_elapsed,
+                 client_queue.TaskChunkSize() / ( 1024.0 * 1024.0 ) );
+    std::printf( "%.1f MB of overflow segments left mapped after trim\n",
+                 trimmed_size / ( 1024.0 * 1024.0 ) );
+    if ( failed_tasks > 0 )
+    {
+        std::printf( "FAILED: %u tasks returned wrong result\n",
+                     failed_tasks );
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,314 @@
+//
+// Created by peter on 16.10.2026.
+//
+// Cooks meshes of DFF models and textures of TXD dictionaries into an asset
+// pack, render client uses cooked assets instead of converting game ones
+// when AssetPackPath is set in renderer config.
+// Usage: asset_cooker <output pack> <img, dff, txd file or directory>...
+// Material emission is read from ./materials like in game, so cooker should
+// be started from game directory.
+//
+#include <DebugUtils/DebugLogger.h>
+#include <common_headers.h>
+#include <rw_engine/rh_backend/material_backend.h>
+#include <rw_engine/rp_clump/rp_clump.h>
+#include <rw_engine/rp_geometry_rw36.h>
+#include <rw_engine/rw_asset_pack/asset_pack.h>
+#include <rw_engine/rw_macro_constexpr.h>
+#include <rw_engine/rw_rh_pipeline.h>
+#include <rw_engine/rw_standard_render_commands/nativetexturereadcmd.h>
+#include <rw_engine/rw_stream/rw_memory_stream.h>
+#include <rw_engine/rw_stream/rw_stream.h>
+#include <rw_engine/rw_texture/rw_texture.h>
+#include <rw_engine/system_funcs/mesh_load_cmd.h>
+#include <rw_engine/system_funcs/rw_device_system_globals.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+using namespace rh::rw::engine;
+using rh::debug::DebugLogger;
+using rh::debug::LogLevel;
+namespace fs = std::filesystem;
+
+constexpr uint64_t gImgSectorSize = 2048;
+
+/// Directory entry of IMG archive, sizes and offsets are in sectors
+struct ImgEntry
+{
+    uint32_t Offset;
+    /// VER2 archives store streaming size and archive size as two uint16
+    uint32_t Size;
+    char     Name[24];
+};
+
+struct CookStats
+{
+    uint64_t ModelCount   = 0;
+    uint64_t MeshCount    = 0;
+    uint64_t TextureCount = 0;
+    uint64_t FailedCount  = 0;
+};
+
+AssetPackWriter gWriter{};
+CookStats       gStats{};
+
+/// Materials only need texture names to find their emission
+RwTexture *ReadTextureName( const char *name, const char *mask )
+{
+    RwTexture *texture = RwTextureCreate( nullptr );
+    if ( texture == nullptr )
+        return nullptr;
+    std::strncpy( texture->name, name, rwTEXTUREBASENAMELENGTH - 1 );
+    std::strncpy( texture->mask, mask, rwTEXTUREBASENAMELENGTH - 1 );
+    return texture;
+}
+
+void InitPlugins()
+{
+    gRwDeviceGlobals.PluginFuncs = {
+        .MaterialRegisterPlugin = []( int32_t size, uint32_t pluginID,
+                                      RwPluginObjectConstructor constructCB,
+                                      RwPluginObjectDestructor  destructCB,
+                                      RwPluginObjectCopy copyCB ) -> int32_t
+        { return sizeof( RpMaterial ); },
+        .RasterRegisterPlugin = []( int32_t size, uint32_t pluginID,
+                                    RwPluginObjectConstructor constructCB,
+                                    RwPluginObjectDestructor  destructCB,
+                                    RwPluginObjectCopy copyCB ) -> int32_t
+        { return sizeof( RwRaster ); } };
+
+    static BackendMaterialPlugin material_plugin(
+        gRwDeviceGlobals.PluginFuncs );
+    RwTextureSetReadCallback( ReadTextureName );
+}
+
+void CookGeometry( RpGeometryInterface *geom_io )
+{
+    if ( geom_io->GetVertexCount() <= 0 )
+        return;
+    const RpMeshHeader *mesh_header = geom_io->GetMeshHeader();
+    if ( mesh_header == nullptr || mesh_header->numMeshes <= 0 )
+        return;
+
+    // emission is applied by "Always" callback in game
+    for ( auto &mesh : geom_io->GetMeshList() )
+        if ( mesh.material )
+            BackendMaterialPlugin::CallAlwaysCb( mesh.material );
+
+    InstancedGeometry geometry{};
+    InstanceGeometry( geom_io, mesh_header, geometry );
+    const auto init_data = geometry.GetInitData();
+    const auto emissive  = LoadMeshCmdImpl::FindEmissiveTriangles( init_data );
+
+    gWriter.AddMesh( GeometrySourceKey( geom_io, mesh_header ), init_data,
+                     emissive );
+    gStats.MeshCount++;
+}
+
+bool CookModel( std::span<const uint8_t> data )
+{
+    RwMemoryStream stream( data );
+    if ( !RwStreamFindChunk( &stream, rwID_CLUMP, nullptr, nullptr ) )
+        return false;
+    RpClump *clump = RpClumpStreamRead( &stream );
+    if ( clump == nullptr )
+        return false;
+
+    RpGeometryRw36 geom_io{};
+    for ( auto *atomic : rwLinkList::Iterator<RpAtomic>( clump->atomicList ) )
+    {
+        if ( atomic == nullptr || atomic->geometry == nullptr )
+            continue;
+        geom_io.Init( atomic->geometry );
+        CookGeometry( &geom_io );
+    }
+    RpClumpDestroy( clump );
+    gStats.ModelCount++;
+    return true;
+}
+
+bool CookTexDictionary( std::span<const uint8_t> data )
+{
+    RwMemoryStream stream( data );
+    uint32_t       size, version;
+    if ( !RwStreamFindChunk( &stream, rwID_TEXDICTIONARY, nullptr, nullptr ) ||
+         !RwStreamFindChunk( &stream, rwID_STRUCT, &size, &version ) )
+        return false;
+
+    struct
+    {
+        uint16_t TextureCount;
+        uint16_t DeviceId;
+    } dict{};
+    if ( size < sizeof( dict ) ||
+         RwStreamRead( &stream, &dict, sizeof( dict ) ) != sizeof( dict ) ||
+         !stream.Skip( size - sizeof( dict ) ) )
+        return false;
+
+    for ( uint32_t i = 0; i < dict.TextureCount; i++ )
+    {
+        if ( !RwStreamFindChunk( &stream, rwID_TEXTURENATIVE, nullptr,
+                                 nullptr ) ||
+             !RwStreamFindChunk( &stream, rwID_STRUCT, &size, &version ) )
+            return false;
+        const auto texture_data = RwStreamReadSpan<uint8_t>( &stream, size );
+        if ( texture_data.size() != size )
+            return false;
+
+        DecodedNativeTexture texture{};
+        if ( !RwNativeTextureReadCmd::Decode( texture_data, texture ) )
+        {
+            DebugLogger::Error( texture.Error );
+            continue;
+        }
+        gWriter.AddTexture( TextureSourceKey( texture_data ), texture );
+        gStats.TextureCount++;
+    }
+    return true;
+}
+
+void CookAsset( const std::string &name, std::span<const uint8_t> data )
+{
+    auto extension = fs::path( name ).extension().string();
+    std::ranges::transform( extension, extension.begin(), ::tolower );
+
+    bool result = true;
+    if ( extension == ".dff" )
+        result = CookModel( data );
+    else if ( extension == ".txd" )
+        result = CookTexDictionary( data );
+    if ( result )
+        return;
+
+    DebugLogger::LogFormat( LogLevel::Warning, "Failed to cook %s",
+                            name.c_str() );
+    gStats.FailedCount++;
+}
+
+bool IsImgVer2( std::span<const uint8_t> img )
+{
+    return img.size() >= 8 && std::memcmp( img.data(), "VER2", 4 ) == 0;
+}
+
+/// @return directory of VER2 archive or of .dir file next to VER1 archive
+std::span<const ImgEntry> ReadImgDirectory( const fs::path          &path,
+                                            std::span<const uint8_t> img,
+                                            RwMappedFile            &dir_file )
+{
+    if ( IsImgVer2( img ) )
+    {
+        uint32_t count;
+        std::memcpy( &count, img.data() + 4, sizeof( count ) );
+        const auto entries = img.subspan( 8 );
+        return { reinterpret_cast<const ImgEntry *>( entries.data() ),
+                 ( std::min )( uint64_t{ count },
+                               entries.size() / sizeof( ImgEntry ) ) };
+    }
+
+    if ( !dir_file.Open( fs::path( path ).replace_extension( ".dir" ) ) )
+        return {};
+    const auto dir = dir_file.Data();
+    return { reinterpret_cast<const ImgEntry *>( dir.data() ),
+             dir.size() / sizeof( ImgEntry ) };
+}
+
+void CookImg( const fs::path &path )
+{
+    RwMappedFile img_file;
+    if ( !img_file.Open( path ) )
+    {
+        DebugLogger::LogFormat( LogLevel::Warning, "Failed to open %s",
+                                path.string().c_str() );
+        return;
+    }
+    const auto   img  = img_file.Data();
+    const bool   ver2 = IsImgVer2( img );
+    RwMappedFile dir_file;
+
+    for ( const auto &entry : ReadImgDirectory( path, img, dir_file ) )
+    {
+        uint64_t size = entry.Size;
+        if ( ver2 )
+        {
+            // archive size is only set if streaming size is not
+            const uint64_t streaming_size = entry.Size & 0xFFFF;
+            size = streaming_size != 0 ? streaming_size : entry.Size >> 16;
+        }
+        const uint64_t offset = entry.Offset * gImgSectorSize;
+        size *= gImgSectorSize;
+        if ( offset > img.size() )
+            continue;
+        size = ( std::min )( size, img.size() - offset );
+
+        const std::string name( entry.Name,
+                                strnlen( entry.Name, sizeof( entry.Name ) ) );
+        CookAsset( name, img.subspan( offset, size ) );
+    }
+}
+
+void CookPath( const fs::path &path )
+{
+    std::error_code ec;
+    if ( fs::is_directory( path, ec ) )
+    {
+        for ( const auto &entry :
+              fs::recursive_directory_iterator( path, ec ) )
+            if ( entry.is_regular_file( ec ) )
+                CookPath( entry.path() );
+        return;
+    }
+
+    auto extension = path.extension().string();
+    std::ranges::transform( extension, extension.begin(), ::tolower );
+    if ( extension == ".img" )
+    {
+        CookImg( path );
+        return;
+    }
+    if ( extension != ".dff" && extension != ".txd" )
+        return;
+
+    RwMappedFile file;
+    if ( file.Open( path ) )
+        CookAsset( path.string(), file.Data() );
+}
+
+int main( int argc, char **argv )
+{
+    DebugLogger::Init( "asset_cooker.log", LogLevel::Info );
+    if ( argc < 3 )
+    {
+        DebugLogger::Error( "Usage: asset_cooker <output pack> "
+                            "<img, dff, txd file or directory>..." );
+        return 1;
+    }
+
+    InitPlugins();
+    for ( int arg = 2; arg < argc; arg++ )
+        CookPath( argv[arg] );
+
+    if ( !gWriter.Write( argv[1] ) )
+    {
+        DebugLogger::LogFormat( LogLevel::Error, "Failed to write %s",
+                                argv[1] );
+        return 1;
+    }
+
+    DebugLogger::LogFormat(
+        LogLevel::Info,
+        "Cooked %llu models, %llu meshes and %llu textures, %llu assets "
+        "failed. Pack has %llu meshes, %llu textures and %.1f MB of data",
+        static_cast<unsigned long long>( gStats.ModelCount ),
+        static_cast<unsigned long long>( gStats.MeshCount ),
+        static_cast<unsigned long long>( gStats.TextureCount ),
+        static_cast<unsigned long long>( gStats.FailedCount ),
+        static_cast<unsigned long long>( gWriter.MeshCount() ),
+        static_cast<unsigned long long>( gWriter.TextureCount() ),
+        static_cast<double>( gWriter.DataSize() ) / ( 1024.0 * 1024.0 ) );
+    DebugLogger::Flush();
+    return 0;
+}
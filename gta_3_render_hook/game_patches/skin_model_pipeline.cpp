@@ -111,7 +111,9 @@ static int32_t SkinD3D8AtomicAllInOneNode( void * /*self*/,
                 ltm->right.y, ltm->up.y, ltm->at.y, ltm->pos.y,
                 ltm->right.z, ltm->up.z, ltm->at.z, ltm->pos.z,
             };
-            PrepareBoneMatrices( info.BoneTransform, atomic, anim );
+            auto bones = renderer.AllocateBoneTransforms(
+                GetBoneMatrixCount( atomic, anim ) );
+            PrepareBoneMatrices( bones, atomic, anim );
 
             renderer.RecordDrawCall( info );
         } );
@@ -112,7 +112,9 @@ static int32_t D3D8SkinAtomicAllInOneNode( void * /*self*/,
                         ltm->right.z, ltm->up.z, ltm->at.z, ltm->pos.z,
                     };
                     static AnimHierarcyRw36 g_anim{};
-                    PrepareBoneMatrices( info.BoneTransform, atomic, g_anim );
+                    auto bones = renderer.AllocateBoneTransforms(
+                        GetBoneMatrixCount( atomic, g_anim ) );
+                    PrepareBoneMatrices( bones, atomic, g_anim );
                     renderer.RecordDrawCall( info );
                 } );
     return 1;
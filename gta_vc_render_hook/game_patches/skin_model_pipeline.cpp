@@ -53,7 +53,9 @@ static int32_t SkinD3D8AtomicAllInOneNode( void * /*self*/,
                         ltm->right.z, ltm->up.z, ltm->at.z, ltm->pos.z,
                     };
 
-                    PrepareBoneMatrices( info.BoneTransform, atomic, g_anim );
+                    auto bones = renderer.AllocateBoneTransforms(
+                        GetBoneMatrixCount( atomic, g_anim ) );
+                    PrepareBoneMatrices( bones, atomic, g_anim );
 
                     renderer.RecordDrawCall( info );
                 } );
@@ -0,0 +1,219 @@
+//
+// Created by peter on 16.10.2026.
+//
+// Replays task capture written by render driver with TaskCapturePath set in
+// renderer config, so render driver can be profiled without the game.
+// Usage: render_driver_replay <capture file> [--realtime]
+// Tasks are replayed as fast as possible, unless --realtime is set, logged
+// frame times include waiting for the captured timing then.
+//
+#include <ConfigUtils/ConfigurationManager.h>
+#include <DebugUtils/DebugLogger.h>
+#include <Engine/EngineConfigBlock.h>
+#include <ipc/ipc_utils.h>
+#include <ipc/shared_memory_queue_client.h>
+#include <ipc/task_replay.h>
+#include <render_driver/gpu_resources/asset_streamer.h>
+#include <render_driver/gpu_resources/resource_mgr.h>
+#include <render_driver/render_driver.h>
+#include <rw_engine/system_funcs/rw_device_system_globals.h>
+#include <rw_game_hooks.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <string>
+
+struct RwMemoryFunctions
+{
+    void *( *rwmalloc )( size_t size, uint32_t hint );
+    void ( *rwfree )( void *mem );
+    void *( *rwrealloc )( void *mem, size_t newSize, uint32_t hint );
+    void *( *rwcalloc )( size_t numObj, size_t sizeObj, uint32_t hint );
+};
+using namespace rh::rw::engine;
+
+struct Globals
+{
+    RwDevice          rwDevice{};
+    RwRwDeviceGlobals rwDeviceGlobals{};
+    RwMemoryFunctions rwMemoryFunctions{};
+};
+
+Globals gInstance{};
+
+struct ReplayStats
+{
+    uint64_t FrameCount = 0;
+    double   FrameTime  = 0;
+    double   MaxFrame   = 0;
+};
+
+LRESULT CALLBACK ReplayWndProc( HWND window, UINT message, WPARAM w_param,
+                                LPARAM l_param )
+{
+    return DefWindowProc( window, message, w_param, l_param );
+}
+
+HWND CreateReplayWindow( HINSTANCE instance )
+{
+    WNDCLASS window_class{};
+    window_class.style         = CS_OWNDC;
+    window_class.lpfnWndProc   = ReplayWndProc;
+    window_class.hInstance     = instance;
+    window_class.lpszClassName = TEXT( "RenderDriverReplay" );
+    RegisterClass( &window_class );
+
+    const auto &config = rh::engine::EngineConfigBlock::It;
+    RECT        rect{ 0, 0, static_cast<LONG>( config.RendererWidth ),
+               static_cast<LONG>( config.RendererHeight ) };
+    AdjustWindowRect( &rect, WS_OVERLAPPEDWINDOW, false );
+
+    auto window = CreateWindow(
+        window_class.lpszClassName, TEXT( "RenderHook replay" ),
+        WS_OVERLAPPEDWINDOW, 20, 20, rect.right - rect.left,
+        rect.bottom - rect.top, nullptr, nullptr, instance, nullptr );
+    if ( window != nullptr )
+        ShowWindow( window, SW_SHOW );
+    return window;
+}
+
+void PumpWindowMessages()
+{
+    MSG msg;
+    while ( PeekMessage( &msg, nullptr, 0, 0, PM_REMOVE ) )
+    {
+        TranslateMessage( &msg );
+        DispatchMessage( &msg );
+    }
+}
+
+int APIENTRY WinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance,
+                      LPSTR lpCmdLine, int nCmdShow )
+{
+    using namespace rh::debug;
+    DebugLogger::Init( "render_driver_replay.log", LogLevel::Info );
+
+    std::string capture_path;
+    bool        realtime = false;
+    for ( int arg = 1; arg < __argc; arg++ )
+    {
+        if ( std::strcmp( __argv[arg], "--realtime" ) == 0 )
+            realtime = true;
+        else
+            capture_path = __argv[arg];
+    }
+    if ( capture_path.empty() )
+    {
+        DebugLogger::Error(
+            "Usage: render_driver_replay <capture file> [--realtime]" );
+        return 1;
+    }
+
+    // there is no client, driver task queue fails to open shared memory and
+    // is used only to dispatch replayed tasks
+    IPCSettings::mMode = IPCRenderMode::CrossProcessRenderer;
+
+    auto cfg_mgr = rh::engine::ConfigurationManager::Instance();
+    cfg_mgr.LoadFromFile( "renderer_config.cfg" );
+    // replay must not overwrite the capture it reads
+    rh::engine::EngineConfigBlock::It.TaskCapturePath.clear();
+
+    RwGameHooks::Patch(
+        { .mRwDevicePtr = reinterpret_cast<INT_PTR>( &gInstance.rwDevice ) } );
+    gRwDeviceGlobals.DeviceGlobalsPtr = &gInstance.rwDeviceGlobals;
+
+    InitRenderer();
+    SystemHandler( rwDEVICESYSTEMREGISTER, gRwDeviceGlobals.DevicePtr,
+                   &gInstance.rwMemoryFunctions, 0 );
+
+    auto window = CreateReplayWindow( hInstance );
+    if ( window == nullptr )
+    {
+        DebugLogger::Error( "Failed to create replay window" );
+        ShutdownRenderer();
+        return 1;
+    }
+
+    // streamed assets are uploaded from captured markers only
+    gRenderDriver->GetAssetStreamer().SetReplayMode();
+
+    TaskReplay replay( gRenderDriver->GetTaskQueue() );
+    if ( !replay.Open( capture_path ) )
+    {
+        ShutdownRenderer();
+        return 1;
+    }
+    // game window is gone, frames are presented to replay window instead
+    replay.SetTaskPatcher(
+        [window]( int64_t id, std::span<uint8_t> payload )
+        {
+            if ( id == SharedMemoryTaskType::CREATE_WINDOW &&
+                 payload.size() >= sizeof( HWND ) )
+                std::memcpy( payload.data(), &window, sizeof( HWND ) );
+        } );
+    replay.SetMarkerHandler(
+        []( int64_t id, std::span<const uint8_t> data )
+        {
+            if ( id == TaskCaptureMarkerType::ASSET_RESERVE ||
+                 id == TaskCaptureMarkerType::ASSET_UPLOAD )
+            {
+                gRenderDriver->GetAssetStreamer().ReplayMarker( id, data );
+                return;
+            }
+            if ( id != TaskCaptureMarkerType::GC_PROGRESS ||
+                 data.size() != sizeof( GCProgress ) )
+                return;
+            GCProgress progress{};
+            std::memcpy( &progress, data.data(), sizeof( GCProgress ) );
+            gRenderDriver->GetResources().ReplayNextGC( progress );
+        } );
+
+    using clock = std::chrono::steady_clock;
+    ReplayStats stats{};
+    bool        window_opened = false;
+    const auto  start         = clock::now();
+    auto        task_start    = start;
+    while ( replay.ReplayNextTask( realtime ) )
+    {
+        const auto task_end = clock::now();
+        switch ( replay.LastTaskId() )
+        {
+        case SharedMemoryTaskType::CREATE_WINDOW: window_opened = true; break;
+        case SharedMemoryTaskType::DESTROY_WINDOW:
+            window_opened = false;
+            break;
+        case SharedMemoryTaskType::RENDER:
+        {
+            const auto frame_time =
+                std::chrono::duration<double>( task_end - task_start )
+                    .count();
+            stats.FrameCount++;
+            stats.FrameTime += frame_time;
+            stats.MaxFrame = ( std::max )( stats.MaxFrame, frame_time );
+            break;
+        }
+        default: break;
+        }
+        PumpWindowMessages();
+        task_start = clock::now();
+    }
+    const auto total_time =
+        std::chrono::duration<double>( clock::now() - start ).count();
+
+    DebugLogger::LogFormat(
+        LogLevel::Info,
+        "Replayed %llu tasks in %.3f s, %llu frames, average frame %.3f ms, "
+        "longest frame %.3f ms",
+        static_cast<unsigned long long>( replay.TaskCount() ), total_time,
+        static_cast<unsigned long long>( stats.FrameCount ),
+        stats.FrameCount > 0 ? stats.FrameTime * 1e3 / stats.FrameCount : 0.0,
+        stats.MaxFrame * 1e3 );
+
+    // capture may end in the middle of the session
+    if ( window_opened )
+        gRenderDriver->CloseMainWindow();
+    ShutdownRenderer();
+    DestroyWindow( window );
+    return 0;
+}
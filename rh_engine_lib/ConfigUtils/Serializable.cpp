@@ -11,6 +11,11 @@ namespace rh::engine
 Serializable::~Serializable() = default;
 Serializable::Serializable( nlohmann::json &impl ) : mImpl( impl ) {}
 
+bool Serializable::Contains( const std::string &name ) const
+{
+    return mImpl.contains( name );
+}
+
 template <> float Serializable::Get( const std::string &name )
 {
     return mImpl.at( name ).get<float>();
@@ -24,6 +29,10 @@ template <> uint32_t Serializable::Get( const std::string &name )
 {
     return mImpl.at( name ).get<uint32_t>();
 }
+template <> std::string Serializable::Get( const std::string &name )
+{
+    return mImpl.at( name ).get<std::string>();
+}
 
 template <> void Serializable::Set( const std::string &name, float v )
 {
@@ -37,5 +46,9 @@ template <> void Serializable::Set( const std::string &name, uint32_t v )
 {
     mImpl[name] = v;
 }
+template <> void Serializable::Set( const std::string &name, std::string v )
+{
+    mImpl[name] = std::move( v );
+}
 
 } // namespace rh::engine
\ No newline at end of file
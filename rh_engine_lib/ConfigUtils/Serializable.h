@@ -16,6 +16,7 @@ class Serializable
     Serializable( nlohmann::json &impl );
     ~Serializable();
 
+    bool                       Contains( const std::string &name ) const;
     template <typename T> T    Get( const std::string &name );
     template <typename T> void Set( const std::string &name, T ) {}
 
@@ -26,8 +27,10 @@ class Serializable
 template <> float    Serializable::Get( const std::string &name );
 template <> bool     Serializable::Get( const std::string &name );
 template <> uint32_t Serializable::Get( const std::string &name );
+template <> std::string Serializable::Get( const std::string &name );
 
 template <> void Serializable::Set( const std::string &name, float );
 template <> void Serializable::Set( const std::string &name, bool );
 template <> void Serializable::Set( const std::string &name, uint32_t );
+template <> void Serializable::Set( const std::string &name, std::string );
 } // namespace rh::engine
\ No newline at end of file
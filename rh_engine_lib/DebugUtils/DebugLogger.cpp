@@ -1,11 +1,28 @@
 #include "DebugLogger.h"
+#ifdef _WIN32
 #include <Windows.h>
+#else
+#include <cstdio>
+#define TEXT( str ) str
+#endif
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
 #include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
 
 using namespace rh::debug;
 
 std::unique_ptr<rh::engine::OutFileStream> DebugLogger::m_pLogStream = nullptr;
+std::unique_ptr<DebugLogger::AsyncWriter> DebugLogger::m_pAsyncWriter = nullptr;
+uint64_t DebugLogger::m_nFileSize    = 0;
+uint64_t DebugLogger::m_nMaxFileSize = 0;
 rh::engine::String DebugLogger::m_sFileName            = TEXT( "rhdebug.log" );
 LogLevel           DebugLogger::m_MinLogLevel          = LogLevel::Info;
 void *             DebugLogger::g_hDebugPipeHandle     = nullptr;
@@ -34,6 +51,8 @@ rh::engine::String ToRHString( const std::wstring &t_str )
 {
 #ifdef UNICODE
     return t_str;
+#elif !defined( _WIN32 )
+    return { t_str.begin(), t_str.end() };
 #else
     rh::engine::String str;
     const auto         res_size = WideCharToMultiByte( CP_ACP, 0, t_str.c_str(),
@@ -66,6 +85,8 @@ std::wstring FromRHString_( const rh::engine::String &t_str )
 {
 #ifdef UNICODE
     return t_str;
+#elif !defined( _WIN32 )
+    return { t_str.begin(), t_str.end() };
 #else
     std::wstring str;
 
@@ -83,15 +104,225 @@ std::wstring FromRHString_( const rh::engine::String &t_str )
 #endif
 }
 
+namespace
+{
+void OutputDebugMessage( const rh::engine::String &msg )
+{
+#ifdef _WIN32
+    OutputDebugString( ( msg + TEXT( "\n" ) ).c_str() );
+#else
+    std::fprintf( stderr, "%s\n", msg.c_str() );
+#endif
+}
+} // namespace
+
+namespace
+{
+/// must be a power of 2
+constexpr uint64_t gLogQueueSize = 8192;
+/// writer thread sleeps this long when there is nothing to write
+constexpr auto     gWriterIdleTime  = std::chrono::milliseconds( 10 );
+constexpr uint32_t gMaxBatchRecords = 1024;
+constexpr uint32_t gLogFileBackups  = 3;
+/// full queue is retried this many times before message is written in place
+constexpr uint32_t gPushRetries = 64;
+} // namespace
+
+/**
+ * Bounded lock-free multi producer queue of log records, based on Dmitry
+ * Vyukov's bounded MPMC queue. Records are consumed by writer thread, or by
+ * any thread holding consumer lock when queue is full or flushed.
+ */
+class DebugLogger::AsyncWriter
+{
+    struct Record
+    {
+        std::atomic<uint64_t> Sequence{ 0 };
+        engine::String        Message;
+        bool                  Error = false;
+    };
+
+  public:
+    AsyncWriter() : mRecords( std::make_unique<Record[]>( gLogQueueSize ) )
+    {
+        for ( uint64_t i = 0; i < gLogQueueSize; i++ )
+            mRecords[i].Sequence.store( i, std::memory_order_relaxed );
+        mThread = std::thread( [this]() { Run(); } );
+    }
+
+    ~AsyncWriter()
+    {
+        mStop.store( true, std::memory_order_release );
+        if ( mThread.joinable() )
+            mThread.join();
+        Drain();
+    }
+
+    void Push( const engine::String &msg, bool error )
+    {
+        for ( uint32_t i = 0; i < gPushRetries; i++ )
+        {
+            if ( TryPush( msg, error ) )
+                return;
+            std::this_thread::yield();
+        }
+        // writer can't keep up, help it, so no message is lost
+        std::lock_guard lock( mConsumerMutex );
+        DrainLocked();
+        WriteMessage( msg, error );
+    }
+
+    /// Writes every queued record on the calling thread
+    void Drain()
+    {
+        // writer thread crashed mid-batch and holds consumer lock
+        if ( std::this_thread::get_id() == mThread.get_id() )
+            return;
+        std::lock_guard lock( mConsumerMutex );
+        DrainLocked();
+    }
+
+    /**
+     * Exit hook variant of Drain, gives up if writer thread was terminated
+     * while writing and left consumer lock locked
+     */
+    void TryDrain()
+    {
+        for ( uint32_t i = 0; i < 100; i++ )
+        {
+            if ( mConsumerMutex.try_lock() )
+            {
+                DrainLocked();
+                mConsumerMutex.unlock();
+                return;
+            }
+            std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        }
+    }
+
+    void Detach()
+    {
+        mStop.store( true, std::memory_order_release );
+        if ( mThread.joinable() )
+            mThread.detach();
+    }
+
+  private:
+    bool TryPush( const engine::String &msg, bool error )
+    {
+        uint64_t pos = mEnqueuePos.load( std::memory_order_relaxed );
+        for ( ;; )
+        {
+            auto &record = mRecords[pos & ( gLogQueueSize - 1 )];
+            const auto seq  = record.Sequence.load( std::memory_order_acquire );
+            const auto diff = static_cast<int64_t>( seq - pos );
+            if ( diff == 0 )
+            {
+                if ( mEnqueuePos.compare_exchange_weak(
+                         pos, pos + 1, std::memory_order_relaxed ) )
+                {
+                    record.Message = msg;
+                    record.Error   = error;
+                    record.Sequence.store( pos + 1,
+                                           std::memory_order_release );
+                    return true;
+                }
+            }
+            else if ( diff < 0 )
+                return false;
+            else
+                pos = mEnqueuePos.load( std::memory_order_relaxed );
+        }
+    }
+
+    /// Consumer lock must be held
+    uint32_t DrainBatch()
+    {
+        uint32_t       count = 0;
+        engine::String batch;
+        for ( ; count < gMaxBatchRecords; count++ )
+        {
+            auto &record = mRecords[mDequeuePos & ( gLogQueueSize - 1 )];
+            if ( record.Sequence.load( std::memory_order_acquire ) !=
+                 mDequeuePos + 1 )
+                break;
+            batch += record.Error ? TEXT( "ERROR: " ) : TEXT( "LOG: " );
+            batch += record.Message;
+            batch += TEXT( "\n" );
+            OutputDebugMessage( record.Message );
+            record.Message.clear();
+            record.Sequence.store( mDequeuePos + gLogQueueSize,
+                                   std::memory_order_release );
+            mDequeuePos++;
+        }
+        // whole batch is a single file write and flush
+        if ( count > 0 )
+            AppendToFile( batch );
+        return count;
+    }
+
+    void DrainLocked()
+    {
+        while ( DrainBatch() > 0 )
+            ;
+    }
+
+    void Run()
+    {
+        while ( !mStop.load( std::memory_order_acquire ) )
+        {
+            uint32_t count;
+            {
+                std::lock_guard lock( mConsumerMutex );
+                count = DrainBatch();
+            }
+            if ( count == 0 )
+                std::this_thread::sleep_for( gWriterIdleTime );
+        }
+    }
+
+    std::unique_ptr<Record[]> mRecords;
+    std::atomic<uint64_t>     mEnqueuePos{ 0 };
+    /// guarded by consumer lock
+    uint64_t          mDequeuePos = 0;
+    std::mutex        mConsumerMutex;
+    std::atomic<bool> mStop{ false };
+    std::thread       mThread;
+};
+
 void DebugLogger::Init( const rh::engine::String &fileName,
-                        LogLevel                  minLogLevel )
+                        LogLevel minLogLevel, uint64_t maxFileSize )
 {
-    m_sFileName   = fileName;
-    m_MinLogLevel = minLogLevel;
+    // writer owns the file while it runs
+    m_pAsyncWriter.reset();
+
+    m_sFileName    = fileName;
+    m_MinLogLevel  = minLogLevel;
+    m_nMaxFileSize = maxFileSize;
+    m_nFileSize    = 0;
 
     if ( !m_sFileName.empty() )
         m_pLogStream =
             std::make_unique<rh::engine::OutFileStream>( m_sFileName );
+
+    static bool exit_hook_registered = false;
+    if ( !exit_hook_registered )
+    {
+        exit_hook_registered = true;
+        std::atexit(
+            []()
+            {
+                if ( !m_pAsyncWriter )
+                    return;
+                // on process exit writer thread may be already terminated,
+                // so it is neither joined nor trusted to drain the queue
+                m_pAsyncWriter->Detach();
+                m_pAsyncWriter->TryDrain();
+                // NOLINTNEXTLINE: detached thread may still reference it
+                m_pAsyncWriter.release();
+            } );
+    }
+    m_pAsyncWriter = std::make_unique<AsyncWriter>();
 }
 
 void DebugLogger::Log( const engine::String &msg, LogLevel logLevel )
@@ -99,38 +330,103 @@ void DebugLogger::Log( const engine::String &msg, LogLevel logLevel )
     if ( logLevel < m_MinLogLevel )
         return;
 
-    if ( m_pLogStream )
-    {
-        if ( !m_pLogStream->is_open() )
-            m_pLogStream->open( m_sFileName,
-                                std::fstream::out | std::fstream::app );
+    if ( m_pAsyncWriter )
+        m_pAsyncWriter->Push( msg, false );
+    else
+        WriteMessage( msg, false );
+}
 
-        *m_pLogStream << TEXT( "LOG: " ) << msg << TEXT( "\n" );
+void DebugLogger::Error( const engine::String &msg )
+{
+    if ( m_pAsyncWriter )
+        m_pAsyncWriter->Push( msg, true );
+    else
+        WriteMessage( msg, true );
+}
 
-        m_pLogStream->flush();
-    }
+void DebugLogger::Flush()
+{
+    if ( m_pAsyncWriter )
+        m_pAsyncWriter->Drain();
+}
 
-    OutputDebugString( ( msg + TEXT( "\n" ) ).c_str() );
+void DebugLogger::WriteMessage( const engine::String &msg, bool error )
+{
+    AppendToFile( ( error ? TEXT( "ERROR: " ) : TEXT( "LOG: " ) ) + msg +
+                  TEXT( "\n" ) );
+    OutputDebugMessage( msg );
 }
 
-void DebugLogger::Error( const engine::String &msg )
+void DebugLogger::AppendToFile( const engine::String &text )
 {
-    if ( m_pLogStream )
-    {
-        if ( !m_pLogStream->is_open() )
-            m_pLogStream->open( m_sFileName,
-                                std::fstream::out | std::fstream::app );
+    if ( !m_pLogStream )
+        return;
+    if ( !m_pLogStream->is_open() )
+        m_pLogStream->open( m_sFileName,
+                            std::fstream::out | std::fstream::app );
+
+    *m_pLogStream << text;
+    m_pLogStream->flush();
+
+    m_nFileSize += text.size();
+    if ( m_nMaxFileSize > 0 && m_nFileSize >= m_nMaxFileSize )
+        RotateFile();
+}
 
-        *m_pLogStream << TEXT( "ERROR: " ) << msg << TEXT( "\n" );
+void DebugLogger::RotateFile()
+{
+    namespace fs = std::filesystem;
+    m_pLogStream->close();
+
+    auto backup_name = []( uint32_t id )
+    { return m_sFileName + TEXT( "." ) + ToRHString( std::to_string( id ) ); };
+
+    // oldest backup is overwritten
+    std::error_code ec;
+    for ( uint32_t id = gLogFileBackups; id > 1; id-- )
+        fs::rename( fs::path( backup_name( id - 1 ) ),
+                    fs::path( backup_name( id ) ), ec );
+    fs::rename( fs::path( m_sFileName ), fs::path( backup_name( 1 ) ), ec );
+
+    m_pLogStream->open( m_sFileName, std::fstream::out | std::fstream::trunc );
+    m_nFileSize = 0;
+}
 
-        m_pLogStream->flush();
+void DebugLogger::LogFormat( LogLevel logLevel, const char *fmt, ... )
+{
+    if ( !IsEnabled( logLevel ) )
+        return;
+
+    std::array<char, 1024> buffer{};
+    va_list                args;
+    va_list                args_copy;
+    va_start( args, fmt );
+    va_copy( args_copy, args );
+    const int size = std::vsnprintf( buffer.data(), buffer.size(), fmt, args );
+    va_end( args );
+
+    std::string msg;
+    if ( size >= 0 && static_cast<size_t>( size ) < buffer.size() )
+        msg.assign( buffer.data(), static_cast<size_t>( size ) );
+    else if ( size >= 0 )
+    {
+        // Use heap buffer for big strings, should be rare
+        msg.resize( static_cast<size_t>( size ) );
+        std::vsnprintf( msg.data(), msg.size() + 1, fmt, args_copy );
     }
+    va_end( args_copy );
 
-    OutputDebugString( ( msg + TEXT( "\n" ) ).c_str() );
+    if ( logLevel == LogLevel::Error )
+        Error( ToRHString( msg ) );
+    else
+        Log( ToRHString( msg ), logLevel );
 }
 
 void *DebugLogger::GetDebugFileHandle()
 {
+#ifndef _WIN32
+    return nullptr;
+#else
     if ( g_hDebugPipeHandle == nullptr )
     {
         SECURITY_ATTRIBUTES saAttr{};
@@ -144,9 +440,11 @@ void *DebugLogger::GetDebugFileHandle()
         SetHandleInformation( g_hDebugPipeReadHandle, HANDLE_FLAG_INHERIT, 0 );
     }
     return g_hDebugPipeHandle;
+#endif
 }
 void DebugLogger::SyncDebugFile()
 {
+#ifdef _WIN32
     DWORD dwRead;
     CHAR  chBuf[4096];
     BOOL  bSuccess = FALSE;
@@ -162,4 +460,5 @@ void DebugLogger::SyncDebugFile()
     }
     CloseHandle( g_hDebugPipeReadHandle );
     g_hDebugPipeReadHandle = nullptr;
+#endif
 }
@@ -6,13 +6,29 @@
  * @date 2018-07-20
  *
  * We use static class DebugLogger to write logs and errors to rhdebug.log
- * file(by default) and IDE console.
+ * file(by default) and IDE console. After Init messages are queued to a
+ * writer thread, so logging threads only pay for one enqueue.
  */
 #pragma once
 #include "Engine/Common/types/string_typedefs.h"
 #include <array>
+#include <cstdint>
 #include <memory>
 
+// lets compiler check printf format strings against their arguments
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define RH_PRINTF_FORMAT( fmt_id, args_id )                                    \
+    __attribute__( ( format( printf, fmt_id, args_id ) ) )
+#else
+#define RH_PRINTF_FORMAT( fmt_id, args_id )
+#endif
+#ifdef _MSC_VER
+#include <sal.h>
+#define RH_PRINTF_FORMAT_STRING _Printf_format_string_
+#else
+#define RH_PRINTF_FORMAT_STRING
+#endif
+
 /// converts from string to RH string
 rh::engine::String ToRHString( const std::string &t_str );
 
@@ -49,14 +65,17 @@ class DebugLogger
 {
   public:
     /**
-     * @brief Initializes DebugLogger
+     * @brief Initializes DebugLogger and starts log writer thread
      *
      * @param fileName - path to log file
      * @param minLogLevel - minimum logging level
+     * @param maxFileSize - log file is rotated once it grows past this size,
+     * previous files are kept as fileName.1 ... fileName.N
      *
      * *If path is empty log won't be written to file.
      */
-    static void Init( const engine::String &fileName, LogLevel minLogLevel );
+    static void Init( const engine::String &fileName, LogLevel minLogLevel,
+                      uint64_t maxFileSize = 64ull * 1024 * 1024 );
 
     /**
      * @brief Prints Log message to console and debug file if min log level is
@@ -68,6 +87,28 @@ class DebugLogger
     static void Log( const engine::String &msg,
                      LogLevel              logLevel = LogLevel::Info );
 
+    /**
+     * @brief Checks if messages of logLevel are written anywhere, so callers
+     * can skip building expensive log messages
+     */
+    static bool IsEnabled( LogLevel logLevel )
+    {
+        return logLevel >= m_MinLogLevel;
+    }
+
+    /**
+     * @brief Prints printf formatted Log message. Format string is checked
+     * at compile time where compiler supports it, arguments are formatted
+     * only if logLevel is enabled, so disabled messages cost one comparison.
+     * Error level messages are written like Error ones.
+     *
+     * @param logLevel - message logging level
+     * @param fmt - printf format string literal
+     */
+    static void LogFormat( LogLevel                            logLevel,
+                           RH_PRINTF_FORMAT_STRING const char *fmt, ... )
+        RH_PRINTF_FORMAT( 2, 3 );
+
     /**
      * @brief Prints formatted Log message to console and debug file
      *
@@ -79,25 +120,7 @@ class DebugLogger
     {
         if ( logLevel < m_MinLogLevel )
             return;
-        static std::array<char, 4096> temp_buff{};
-        std::unique_ptr<char[]>       dyn_buf;
-
-        size_t size = snprintf( nullptr, 0, msg.c_str(), args... ) + 1;
-
-        char *data_ptr;
-
-        // Use bigger heap buffer for big strings, should be rare
-        if ( size > 4096 )
-        {
-            dyn_buf  = std::make_unique<char[]>( size );
-            data_ptr = dyn_buf.get();
-        }
-        else
-            data_ptr = temp_buff.data();
-
-        snprintf( data_ptr, size, msg.c_str(), args... );
-
-        Log( std::string( data_ptr, data_ptr + size - 1 ) );
+        Log( Format( msg, args... ), logLevel );
     }
 
     /**
@@ -109,6 +132,13 @@ class DebugLogger
 
     static void SyncDebugFile();
 
+    /**
+     * @brief Writes every queued message to log file and debug output on the
+     * calling thread, e.g. before the process crashes. Called on exit as
+     * well.
+     */
+    static void Flush();
+
     /**
      * @brief Prints formatted Error message to console and debug file
      *
@@ -117,29 +147,40 @@ class DebugLogger
     template <typename... Args>
     static void ErrorFmt( const engine::String &msg, Args... args )
     {
-        static std::array<char, 4096> temp_buff{};
-        std::unique_ptr<char[]>       dyn_buf;
-
-        size_t size = snprintf( nullptr, 0, msg.c_str(), args... ) + 1;
-
-        char *data_ptr;
-
-        // Use bigger heap buffer for big strings, should be rare
-        if ( size > 4096 )
-        {
-            dyn_buf  = std::make_unique<char[]>( size );
-            data_ptr = dyn_buf.get();
-        }
-        else
-            data_ptr = temp_buff.data();
-
-        snprintf( data_ptr, size, msg.c_str(), args... );
-
-        Error( std::string( data_ptr, data_ptr + size - 1 ) );
+        Error( Format( msg, args... ) );
     }
 
   private:
+    /**
+     * @brief Formats message into a buffer local to the calling thread's
+     * stack, empty if format fails
+     */
+    template <typename... Args>
+    static std::string Format( const engine::String &msg, Args... args )
+    {
+        std::array<char, 1024> buffer{};
+        const int size =
+            snprintf( buffer.data(), buffer.size(), msg.c_str(), args... );
+        if ( size < 0 )
+            return {};
+        if ( static_cast<size_t>( size ) < buffer.size() )
+            return std::string( buffer.data(), static_cast<size_t>( size ) );
+
+        // Use heap buffer for big strings, should be rare
+        std::string result( static_cast<size_t>( size ), '\0' );
+        snprintf( result.data(), result.size() + 1, msg.c_str(), args... );
+        return result;
+    }
+
+    class AsyncWriter;
+    static void WriteMessage( const engine::String &msg, bool error );
+    static void AppendToFile( const engine::String &text );
+    static void RotateFile();
+
     static std::unique_ptr<engine::OutFileStream> m_pLogStream;
+    static std::unique_ptr<AsyncWriter>           m_pAsyncWriter;
+    static uint64_t                               m_nFileSize;
+    static uint64_t                               m_nMaxFileSize;
 
   public:
     static engine::String m_sFileName;
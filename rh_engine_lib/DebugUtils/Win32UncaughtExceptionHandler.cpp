@@ -39,6 +39,9 @@ LONG WINAPI Win32UncaughtExceptionFilter( _EXCEPTION_POINTERS *ExceptionInfo )
                                               fn.data(), mi.lpBaseOfDll );
         }
     }
+    // process may be terminated right after, so queued messages are written
+    // here
+    rh::debug::DebugLogger::Flush();
 
     if ( gOldExceptionHandler )
         return gOldExceptionHandler( ExceptionInfo );
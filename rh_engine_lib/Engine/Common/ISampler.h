@@ -1,5 +1,5 @@
 #pragma once
-#include <Engine\Common\types\sampler.h>
+#include <Engine/Common/types/sampler.h>
 
 namespace rh::engine
 {
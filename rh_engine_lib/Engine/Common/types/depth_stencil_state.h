@@ -1,5 +1,6 @@
 #pragma once
 #include <cstdint>
+#include <cstring>
 #include <memory>
 namespace rh::engine {
 enum class StencilOp : uint8_t;
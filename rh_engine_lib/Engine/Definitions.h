@@ -7,7 +7,9 @@ namespace rh::engine
 enum class RenderingAPI : uint32_t
 {
     DX11,
-    Vulkan
+    Vulkan,
+    // Headless device for CPU side profiling, see NullDeviceState
+    Null
 };
 constexpr bool gDebugEnabled =
 #ifdef _DEBUG
@@ -28,6 +28,20 @@ void EngineConfigBlock::Serialize( Serializable *serializable )
     serializable->Set<uint32_t>( "RenderingAPI", RenderingAPI_id );
     serializable->Set<uint32_t>( "RendererWidth", RendererWidth );
     serializable->Set<uint32_t>( "RendererHeight", RendererHeight );
+    serializable->Set<uint32_t>( "MaxFramesAhead", MaxFramesAhead );
+    serializable->Set<uint32_t>( "GCTimeBudgetUs", GCTimeBudgetUs );
+    serializable->Set<bool>( "AsyncAssetUploads", AsyncAssetUploads );
+    serializable->Set<uint32_t>( "AssetSharedMemorySizeMB",
+                                 AssetSharedMemorySizeMB );
+    serializable->Set<uint32_t>( "AssetUploadTimeBudgetUs",
+                                 AssetUploadTimeBudgetUs );
+    serializable->Set<std::string>( "TaskCapturePath", TaskCapturePath );
+    serializable->Set<bool>( "PersistentMeshInstances",
+                             PersistentMeshInstances );
+    serializable->Set<bool>( "CacheChunkIndices", CacheChunkIndices );
+    serializable->Set<std::string>( "AssetPackPath", AssetPackPath );
+    serializable->Set<std::string>( "GeometryCachePath", GeometryCachePath );
+    serializable->Set<uint32_t>( "GeometryCacheSizeMB", GeometryCacheSizeMB );
 }
 void EngineConfigBlock::Deserialize( Serializable *serializable )
 {
@@ -40,6 +54,34 @@ void EngineConfigBlock::Deserialize( Serializable *serializable )
     RenderingAPI_id    = serializable->Get<uint32_t>( "RenderingAPI" );
     RendererWidth      = serializable->Get<uint32_t>( "RendererWidth" );
     RendererHeight     = serializable->Get<uint32_t>( "RendererHeight" );
+    // optional, older configs don't have it
+    if ( serializable->Contains( "MaxFramesAhead" ) )
+        MaxFramesAhead = serializable->Get<uint32_t>( "MaxFramesAhead" );
+    if ( serializable->Contains( "GCTimeBudgetUs" ) )
+        GCTimeBudgetUs = serializable->Get<uint32_t>( "GCTimeBudgetUs" );
+    if ( serializable->Contains( "AsyncAssetUploads" ) )
+        AsyncAssetUploads = serializable->Get<bool>( "AsyncAssetUploads" );
+    if ( serializable->Contains( "AssetSharedMemorySizeMB" ) )
+        AssetSharedMemorySizeMB =
+            serializable->Get<uint32_t>( "AssetSharedMemorySizeMB" );
+    if ( serializable->Contains( "AssetUploadTimeBudgetUs" ) )
+        AssetUploadTimeBudgetUs =
+            serializable->Get<uint32_t>( "AssetUploadTimeBudgetUs" );
+    if ( serializable->Contains( "TaskCapturePath" ) )
+        TaskCapturePath = serializable->Get<std::string>( "TaskCapturePath" );
+    if ( serializable->Contains( "PersistentMeshInstances" ) )
+        PersistentMeshInstances =
+            serializable->Get<bool>( "PersistentMeshInstances" );
+    if ( serializable->Contains( "CacheChunkIndices" ) )
+        CacheChunkIndices = serializable->Get<bool>( "CacheChunkIndices" );
+    if ( serializable->Contains( "AssetPackPath" ) )
+        AssetPackPath = serializable->Get<std::string>( "AssetPackPath" );
+    if ( serializable->Contains( "GeometryCachePath" ) )
+        GeometryCachePath =
+            serializable->Get<std::string>( "GeometryCachePath" );
+    if ( serializable->Contains( "GeometryCacheSizeMB" ) )
+        GeometryCacheSizeMB =
+            serializable->Get<uint32_t>( "GeometryCacheSizeMB" );
     //}
     /*catch ( const std::exception &ex )
     {
@@ -54,7 +96,19 @@ void EngineConfigBlock::Reset()
     IsWindowed         = gDebugEnabled;
     RendererWidth      = 1920;
     RendererHeight     = 1080;
-    SharedMemorySizeMB = 32;
+    SharedMemorySizeMB = 16;
+    MaxFramesAhead     = 1;
+    GCTimeBudgetUs     = 1000;
+    AsyncAssetUploads       = true;
+    AssetSharedMemorySizeMB = 4;
+    AssetUploadTimeBudgetUs = 2000;
+    TaskCapturePath.clear();
     RenderingAPI_id    = static_cast<uint32_t>( RenderingAPI::DX11 );
+
+    PersistentMeshInstances = true;
+    CacheChunkIndices       = false;
+    AssetPackPath.clear();
+    GeometryCachePath.clear();
+    GeometryCacheSizeMB = 512;
 }
 } // namespace rh::engine
\ No newline at end of file
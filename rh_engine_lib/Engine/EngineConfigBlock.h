@@ -24,9 +24,40 @@ class EngineConfigBlock : public ConfigBlock
   public:
     /// Properties
     bool     IsWindowed{};
-    uint32_t SharedMemorySizeMB = 32;
+    uint32_t SharedMemorySizeMB = 16;
     uint32_t RenderingAPI_id    = 0;
     uint32_t RendererWidth      = 1920;
     uint32_t RendererHeight     = 1080;
+    /// How many frames client may publish before render driver finishes
+    /// them, 0 means synchronous rendering
+    uint32_t MaxFramesAhead     = 1;
+    /// Time render driver may spend destroying freed resources each frame,
+    /// in microseconds
+    uint32_t GCTimeBudgetUs     = 1000;
+    /// Textures and meshes are sent through a separate task queue and
+    /// uploaded between frames, until then a placeholder is used
+    bool     AsyncAssetUploads       = true;
+    /// Assets are sent in chunks, so they don't need to fit into asset queue
+    uint32_t AssetSharedMemorySizeMB = 4;
+    /// Time render driver may spend uploading streamed assets between
+    /// frames, in microseconds
+    uint32_t AssetUploadTimeBudgetUs = 2000;
+    /// Render driver writes every task it executes into this file, so the
+    /// session can be replayed, empty disables capture
+    std::string TaskCapturePath{};
+
+    /// Send only added, changed and removed mesh instances each frame
+    bool PersistentMeshInstances = true;
+    /// Chunk index of DFF and TXD files loaded by the engine is saved next
+    /// to them, so later loads don't index them again
+    bool CacheChunkIndices = false;
+    /// Pack of meshes and textures made by asset_cooker, cooked assets are
+    /// used instead of converting game ones, empty disables it
+    std::string AssetPackPath{};
+    /// Directory where geometry converted at runtime is cached for later
+    /// launches, empty disables it
+    std::string GeometryCachePath{};
+    /// Least recently used cached geometry is deleted past this size
+    uint32_t GeometryCacheSizeMB = 512;
 };
 } // namespace rh::engine
\ No newline at end of file
@@ -2,6 +2,7 @@
 // Created by peter on 28.11.2020.
 //
 #pragma once
+#include <cstddef>
 #include <utility>
 
 namespace rh::engine
@@ -0,0 +1,63 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "NullBuffer.h"
+#include "NullDeviceState.h"
+#include <cstring>
+
+namespace rh::engine
+{
+
+NullBuffer::NullBuffer( const NullBufferCreateInfo &create_info )
+    : mStats( create_info.mStats ), mSize( create_info.mSize )
+{
+    mStats->BuffersCreated++;
+    mStats->BuffersAlive++;
+    mStats->BufferBytesAlive += mSize;
+
+    // even without CPU visible memory lock has to return writable memory,
+    // it is allocated on the first lock then
+    if ( !create_info.mCPUVisible )
+        return;
+    mData.resize( mSize );
+    if ( create_info.mInitDataPtr != nullptr )
+        std::memcpy( mData.data(), create_info.mInitDataPtr, mSize );
+}
+
+NullBuffer::~NullBuffer()
+{
+    mStats->BuffersAlive--;
+    mStats->BufferBytesAlive -= mSize;
+}
+
+void NullBuffer::Update( const void *data, uint32_t size )
+{
+    Update( data, size, 0 );
+}
+
+void NullBuffer::Update( const void *data, uint32_t size, uint32_t offset )
+{
+    mStats->BufferUpdates++;
+    mStats->BufferUpdateBytes += size;
+    if ( mData.empty() || data == nullptr )
+        return;
+    if ( offset > mSize || size > mSize - offset )
+        return;
+    std::memcpy( mData.data() + offset, data, size );
+}
+
+void *NullBuffer::Lock()
+{
+    if ( mData.size() != mSize )
+        mData.resize( mSize );
+    return mData.data();
+}
+
+void NullBuffer::Unlock()
+{
+    mStats->BufferUpdates++;
+    mStats->BufferUpdateBytes += mSize;
+}
+
+} // namespace rh::engine
@@ -0,0 +1,41 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include "Engine/Common/IBuffer.h"
+#include <vector>
+
+namespace rh::engine
+{
+struct NullDeviceStats;
+
+struct NullBufferCreateInfo : BufferCreateInfo
+{
+    // Dependencies...
+    NullDeviceStats *mStats;
+    // Params...
+    bool mCPUVisible;
+};
+
+/**
+ * Buffer of null device, optionally keeps its contents in CPU memory
+ */
+class NullBuffer : public IBuffer
+{
+  public:
+    NullBuffer( const NullBufferCreateInfo &create_info );
+    ~NullBuffer() override;
+    void  Update( const void *data, uint32_t size ) override;
+    void  Update( const void *data, uint32_t size, uint32_t offset ) override;
+    void *Lock() override;
+    void  Unlock() override;
+
+    [[nodiscard]] uint32_t Size() const { return mSize; }
+
+  private:
+    NullDeviceStats *    mStats;
+    uint32_t             mSize;
+    std::vector<uint8_t> mData;
+};
+
+} // namespace rh::engine
@@ -0,0 +1,126 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "NullCommandBuffer.h"
+#include "NullDeviceState.h"
+
+namespace rh::engine
+{
+
+NullCommandBuffer::NullCommandBuffer( NullDeviceStats *stats )
+    : mStats( stats )
+{
+    mStats->ObjectsCreated++;
+}
+
+NullCommandBuffer::~NullCommandBuffer() = default;
+
+void NullCommandBuffer::BeginRecord() { mCommandCount = 0; }
+
+void NullCommandBuffer::EndRecord() {}
+
+void NullCommandBuffer::BeginRenderPass(
+    const RenderPassBeginInfo & /*params*/ )
+{
+    RecordCommand();
+}
+
+void NullCommandBuffer::EndRenderPass() { RecordCommand(); }
+
+void NullCommandBuffer::SetViewports(
+    uint32_t /*start_id*/, const ArrayProxy<ViewPort> & /*viewports*/ )
+{
+    RecordCommand();
+}
+
+void NullCommandBuffer::SetScissors( uint32_t /*start_id*/,
+                                     const ArrayProxy<Scissor> & /*scissors*/ )
+{
+    RecordCommand();
+}
+
+void NullCommandBuffer::BindDescriptorSets(
+    const DescriptorSetBindInfo & /*bind_info*/ )
+{
+    RecordCommand();
+}
+
+void NullCommandBuffer::BindPipeline( IPipeline * /*pipeline*/ )
+{
+    RecordCommand();
+}
+
+void NullCommandBuffer::BindVertexBuffers(
+    uint32_t /*start_id*/, const ArrayProxy<VertexBufferBinding> & /*buffers*/ )
+{
+    RecordCommand();
+}
+
+void NullCommandBuffer::BindIndexBuffer( uint32_t /*offset*/,
+                                         IBuffer * /*buffer*/,
+                                         IndexType /*type*/ )
+{
+    RecordCommand();
+}
+
+void NullCommandBuffer::Draw( uint32_t vertex_count, uint32_t instance_count,
+                              uint32_t /*first_vertex*/,
+                              uint32_t /*first_instance*/ )
+{
+    RecordCommand();
+    mStats->DrawCalls++;
+    mStats->DrawnVertices +=
+        static_cast<uint64_t>( vertex_count ) * instance_count;
+}
+
+void NullCommandBuffer::DrawIndexed( uint32_t index_count,
+                                     uint32_t instance_count,
+                                     uint32_t /*first_index*/,
+                                     uint32_t /*first_vertex*/,
+                                     uint32_t /*first_instance*/ )
+{
+    RecordCommand();
+    mStats->DrawCalls++;
+    mStats->DrawnVertices +=
+        static_cast<uint64_t>( index_count ) * instance_count;
+}
+
+void NullCommandBuffer::CopyBufferToImage(
+    const BufferToImageCopyInfo & /*copy_info*/ )
+{
+    RecordCommand();
+    mStats->CopyCommands++;
+}
+
+void NullCommandBuffer::CopyImageToBuffer(
+    const ImageToBufferCopyInfo & /*copy_info*/ )
+{
+    RecordCommand();
+    mStats->CopyCommands++;
+}
+
+void NullCommandBuffer::CopyImageToImage(
+    const ImageToImageCopyInfo & /*copy_info*/ )
+{
+    RecordCommand();
+    mStats->CopyCommands++;
+}
+
+void NullCommandBuffer::PipelineBarrier( const PipelineBarrierInfo & /*info*/ )
+{
+    RecordCommand();
+}
+
+ISyncPrimitive *NullCommandBuffer::ExecutionFinishedPrimitive()
+{
+    return &mExecutionFinished;
+}
+
+void NullCommandBuffer::RecordCommand()
+{
+    mCommandCount++;
+    mStats->RecordedCommands++;
+}
+
+} // namespace rh::engine
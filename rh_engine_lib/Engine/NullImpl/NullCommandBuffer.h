@@ -0,0 +1,65 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include "Engine/Common/ICommandBuffer.h"
+#include "Engine/Common/ISyncPrimitive.h"
+
+namespace rh::engine
+{
+struct NullDeviceStats;
+
+/**
+ * Sync primitive of null device, all work is finished once it's submitted
+ */
+class NullSyncPrimitive : public ISyncPrimitive
+{
+};
+
+/**
+ * Command buffer that only counts recorded commands
+ */
+class NullCommandBuffer : public ICommandBuffer
+{
+  public:
+    NullCommandBuffer( NullDeviceStats *stats );
+    ~NullCommandBuffer() override;
+
+    void BeginRecord() override;
+    void EndRecord() override;
+    void BeginRenderPass( const RenderPassBeginInfo &params ) override;
+    void EndRenderPass() override;
+    void SetViewports( uint32_t                    start_id,
+                       const ArrayProxy<ViewPort> &viewports ) override;
+    void SetScissors( uint32_t                   start_id,
+                      const ArrayProxy<Scissor> &scissors ) override;
+    void BindDescriptorSets( const DescriptorSetBindInfo &bind_info ) override;
+    void BindPipeline( IPipeline *pipeline ) override;
+    void BindVertexBuffers(
+        uint32_t start_id,
+        const ArrayProxy<VertexBufferBinding> &buffers ) override;
+    void BindIndexBuffer( uint32_t offset, IBuffer *buffer,
+                          IndexType type ) override;
+    void Draw( uint32_t vertex_count, uint32_t instance_count,
+               uint32_t first_vertex, uint32_t first_instance ) override;
+    void DrawIndexed( uint32_t index_count, uint32_t instance_count,
+                      uint32_t first_index, uint32_t first_vertex,
+                      uint32_t first_instance ) override;
+    void CopyBufferToImage( const BufferToImageCopyInfo &copy_info ) override;
+    void CopyImageToBuffer( const ImageToBufferCopyInfo &copy_info ) override;
+    void CopyImageToImage( const ImageToImageCopyInfo &copy_info ) override;
+    void PipelineBarrier( const PipelineBarrierInfo &info ) override;
+    ISyncPrimitive *ExecutionFinishedPrimitive() override;
+
+    /// Commands recorded since last BeginRecord
+    [[nodiscard]] uint64_t CommandCount() const { return mCommandCount; }
+
+  private:
+    void RecordCommand();
+
+    NullDeviceStats * mStats;
+    NullSyncPrimitive mExecutionFinished;
+    uint64_t          mCommandCount = 0;
+};
+
+} // namespace rh::engine
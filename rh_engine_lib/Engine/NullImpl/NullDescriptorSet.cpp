@@ -0,0 +1,48 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "NullDescriptorSet.h"
+#include "NullDeviceState.h"
+#include <algorithm>
+
+namespace rh::engine
+{
+
+NullDescriptorSetLayout::NullDescriptorSetLayout(
+    const DescriptorSetLayoutCreateParams &params )
+    : mBindings( params.mBindings.Data(),
+                 params.mBindings.Data() + params.mBindings.Size() )
+{
+}
+
+DescriptorType NullDescriptorSetLayout::GetType( uint32_t binding_id ) const
+{
+    const auto binding =
+        std::find_if( mBindings.begin(), mBindings.end(),
+                      [binding_id]( const DescriptorBinding &b )
+                      { return b.mBindingId == binding_id; } );
+    // same as vulkan sets, unknown bindings are reported as samplers
+    return binding != mBindings.end() ? binding->mDescriptorType
+                                      : DescriptorType::Sampler;
+}
+
+DescriptorType NullDescriptorSet::GetType( uint32_t binding_id )
+{
+    return mLayout->GetType( binding_id );
+}
+
+std::vector<IDescriptorSet *>
+NullDescriptorSetAllocator::AllocateDescriptorSets(
+    const DescriptorSetsAllocateParams &params )
+{
+    std::vector<IDescriptorSet *> sets;
+    sets.reserve( params.mLayouts.Size() );
+    for ( auto *layout : params.mLayouts )
+        sets.push_back( new NullDescriptorSet(
+            static_cast<NullDescriptorSetLayout *>( layout ) ) );
+    mStats->DescriptorSets += sets.size();
+    return sets;
+}
+
+} // namespace rh::engine
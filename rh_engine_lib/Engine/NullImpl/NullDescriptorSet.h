@@ -0,0 +1,48 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include "Engine/Common/IDescriptorSet.h"
+#include "Engine/Common/IDescriptorSetAllocator.h"
+#include "Engine/Common/IDescriptorSetLayout.h"
+#include <vector>
+
+namespace rh::engine
+{
+struct NullDeviceStats;
+
+class NullDescriptorSetLayout : public IDescriptorSetLayout
+{
+  public:
+    NullDescriptorSetLayout( const DescriptorSetLayoutCreateParams &params );
+    [[nodiscard]] DescriptorType GetType( uint32_t binding_id ) const;
+
+  private:
+    std::vector<DescriptorBinding> mBindings;
+};
+
+class NullDescriptorSet : public IDescriptorSet
+{
+  public:
+    NullDescriptorSet( const NullDescriptorSetLayout *layout )
+        : mLayout( layout )
+    {
+    }
+    DescriptorType GetType( uint32_t binding_id ) override;
+
+  private:
+    const NullDescriptorSetLayout *mLayout;
+};
+
+class NullDescriptorSetAllocator : public IDescriptorSetAllocator
+{
+  public:
+    NullDescriptorSetAllocator( NullDeviceStats *stats ) : mStats( stats ) {}
+    std::vector<IDescriptorSet *> AllocateDescriptorSets(
+        const DescriptorSetsAllocateParams &params ) override;
+
+  private:
+    NullDeviceStats *mStats;
+};
+
+} // namespace rh::engine
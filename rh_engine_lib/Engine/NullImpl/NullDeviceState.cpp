@@ -0,0 +1,259 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "NullDeviceState.h"
+#include "NullBuffer.h"
+#include "NullCommandBuffer.h"
+#include "NullDescriptorSet.h"
+#include "NullImageBuffer.h"
+#include "NullPipeline.h"
+#include "NullWindow.h"
+
+namespace rh::engine
+{
+
+NullDeviceState::NullDeviceState( const NullDeviceCreateInfo &info )
+    : mInfo( info )
+{
+    // the strictest alignment render driver has to handle on real devices
+    mLimits.BufferOffsetMinAlign = 256;
+}
+
+NullDeviceState::~NullDeviceState() = default;
+
+bool NullDeviceState::Init()
+{
+    mMainCmdBuffer = std::make_unique<NullCommandBuffer>( &mStats );
+    return true;
+}
+
+bool NullDeviceState::Shutdown()
+{
+    mMainCmdBuffer.reset();
+    return true;
+}
+
+bool NullDeviceState::GetAdaptersCount( unsigned int &count )
+{
+    count = 1;
+    return true;
+}
+
+bool NullDeviceState::GetAdapterInfo( unsigned int id, String &info )
+{
+    if ( id != 0 )
+        return false;
+#ifdef UNICODE
+    info = L"Null device";
+#else
+    info = "Null device";
+#endif
+    return true;
+}
+
+bool NullDeviceState::GetCurrentAdapter( unsigned int &id )
+{
+    id = 0;
+    return true;
+}
+
+bool NullDeviceState::SetCurrentAdapter( unsigned int id ) { return id == 0; }
+
+bool NullDeviceState::GetOutputCount( unsigned int  adapterId,
+                                      unsigned int &count )
+{
+    count = 1;
+    return adapterId == 0;
+}
+
+bool NullDeviceState::GetOutputInfo( unsigned int id, String &info )
+{
+    if ( id != 0 )
+        return false;
+#ifdef UNICODE
+    info = L"Null output";
+#else
+    info = "Null output";
+#endif
+    return true;
+}
+
+bool NullDeviceState::GetCurrentOutput( unsigned int &id )
+{
+    id = 0;
+    return true;
+}
+
+bool NullDeviceState::SetCurrentOutput( unsigned int id ) { return id == 0; }
+
+bool NullDeviceState::GetDisplayModeCount( unsigned int  outputId,
+                                           unsigned int &count )
+{
+    count = 1;
+    return outputId == 0;
+}
+
+bool NullDeviceState::GetDisplayModeInfo( unsigned int     id,
+                                          DisplayModeInfo &info )
+{
+    if ( id != 0 )
+        return false;
+    info = { .width       = mInfo.mWidth,
+             .height      = mInfo.mHeight,
+             .refreshRate = 60,
+             .padding     = 0 };
+    return true;
+}
+
+bool NullDeviceState::GetCurrentDisplayMode( unsigned int &id )
+{
+    id = 0;
+    return true;
+}
+
+bool NullDeviceState::SetCurrentDisplayMode( unsigned int id )
+{
+    return id == 0;
+}
+
+IWindow *NullDeviceState::CreateDeviceWindow( HWND /*window*/,
+                                              const OutputInfo &info )
+{
+    return new NullWindow( &mStats, { .mWidth      = mInfo.mWidth,
+                                      .mHeight     = mInfo.mHeight,
+                                      .mFullscreen = !info.windowed,
+                                      .mPadd       = 0 } );
+}
+
+const DeviceLimitsInfo &NullDeviceState::GetLimits() { return mLimits; }
+
+ICommandBuffer *NullDeviceState::GetMainCommandBuffer()
+{
+    return mMainCmdBuffer.get();
+}
+
+ICommandBuffer *NullDeviceState::CreateCommandBuffer()
+{
+    return new NullCommandBuffer( &mStats );
+}
+
+ISyncPrimitive *
+NullDeviceState::CreateSyncPrimitive( SyncPrimitiveType /*type*/ )
+{
+    mStats.ObjectsCreated++;
+    return new NullSyncPrimitive();
+}
+
+IDescriptorSetLayout *NullDeviceState::CreateDescriptorSetLayout(
+    const DescriptorSetLayoutCreateParams &params )
+{
+    mStats.ObjectsCreated++;
+    return new NullDescriptorSetLayout( params );
+}
+
+IDescriptorSetAllocator *NullDeviceState::CreateDescriptorSetAllocator(
+    const DescriptorSetAllocatorCreateParams & /*params*/ )
+{
+    mStats.ObjectsCreated++;
+    return new NullDescriptorSetAllocator( &mStats );
+}
+
+IPipelineLayout *NullDeviceState::CreatePipelineLayout(
+    const PipelineLayoutCreateParams & /*params*/ )
+{
+    mStats.ObjectsCreated++;
+    return new NullPipelineLayout();
+}
+
+IFrameBuffer *
+NullDeviceState::CreateFrameBuffer( const FrameBufferCreateParams &params )
+{
+    mStats.ObjectsCreated++;
+    return new NullFrameBuffer( params );
+}
+
+IRenderPass *
+NullDeviceState::CreateRenderPass( const RenderPassCreateParams & /*params*/ )
+{
+    mStats.ObjectsCreated++;
+    return new NullRenderPass();
+}
+
+IPipeline *NullDeviceState::CreateRasterPipeline(
+    const RasterPipelineCreateParams & /*params*/ )
+{
+    mStats.ObjectsCreated++;
+    return new NullPipeline();
+}
+
+IShader *NullDeviceState::CreateShader( const ShaderDesc & /*params*/ )
+{
+    mStats.ObjectsCreated++;
+    return new NullShader();
+}
+
+ISampler *NullDeviceState::CreateSampler( const SamplerDesc & /*params*/ )
+{
+    mStats.ObjectsCreated++;
+    return new NullSampler();
+}
+
+IBuffer *NullDeviceState::CreateBuffer( const BufferCreateInfo &params )
+{
+    NullBufferCreateInfo create_info{ params, &mStats,
+                                      mInfo.mCPUVisibleBuffers };
+    return new NullBuffer( create_info );
+}
+
+IImageBuffer *
+NullDeviceState::CreateImageBuffer( const ImageBufferCreateParams &params )
+{
+    NullImageBufferCreateInfo create_info{ params, &mStats };
+    return new NullImageBuffer( create_info );
+}
+
+IImageView *
+NullDeviceState::CreateImageView( const ImageViewCreateInfo &params )
+{
+    mStats.ObjectsCreated++;
+    return new NullImageView( params );
+}
+
+void NullDeviceState::UpdateDescriptorSets(
+    const DescriptorSetUpdateInfo & /*params*/ )
+{
+    mStats.DescriptorUpdates++;
+}
+
+void NullDeviceState::ExecuteCommandBuffer( ICommandBuffer * /*buffer*/,
+                                            ISyncPrimitive * /*waitFor*/,
+                                            ISyncPrimitive * /*signal*/ )
+{
+    mStats.SubmittedBuffers++;
+}
+
+void NullDeviceState::DispatchToGPU(
+    const ArrayProxy<CommandBufferSubmitInfo> &buffers )
+{
+    mStats.SubmittedBuffers += buffers.Size();
+}
+
+void NullDeviceState::Wait( const ArrayProxy<ISyncPrimitive *> & /*list*/ )
+{
+}
+
+void NullDeviceState::WaitForGPU() {}
+
+void NullDeviceState::ResetStats()
+{
+    // resident resources outlive the measured interval
+    NullDeviceStats stats{};
+    stats.BuffersAlive     = mStats.BuffersAlive;
+    stats.BufferBytesAlive = mStats.BufferBytesAlive;
+    stats.ImagesAlive      = mStats.ImagesAlive;
+    stats.ImageBytesAlive  = mStats.ImageBytesAlive;
+    mStats                 = stats;
+}
+
+} // namespace rh::engine
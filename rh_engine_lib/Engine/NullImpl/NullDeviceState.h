@@ -0,0 +1,117 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include "Engine/Common/IDeviceState.h"
+#include <memory>
+
+namespace rh::engine
+{
+class NullCommandBuffer;
+
+/**
+ * Work submitted to null device, used to compare CPU side cost of the
+ * renderer between runs
+ */
+struct NullDeviceStats
+{
+    uint64_t BuffersCreated    = 0;
+    uint64_t BuffersAlive      = 0;
+    uint64_t BufferBytesAlive  = 0;
+    uint64_t BufferUpdates     = 0;
+    uint64_t BufferUpdateBytes = 0;
+    uint64_t ImagesCreated     = 0;
+    uint64_t ImagesAlive       = 0;
+    uint64_t ImageBytesAlive   = 0;
+    uint64_t ImageUploadBytes  = 0;
+    uint64_t ObjectsCreated    = 0;
+    uint64_t DescriptorSets    = 0;
+    uint64_t DescriptorUpdates = 0;
+    uint64_t RecordedCommands  = 0;
+    uint64_t DrawCalls         = 0;
+    uint64_t DrawnVertices     = 0;
+    uint64_t CopyCommands      = 0;
+    uint64_t SubmittedBuffers  = 0;
+    uint64_t PresentedFrames   = 0;
+};
+
+struct NullDeviceCreateInfo
+{
+    /// Size of the only display mode reported by device
+    uint32_t mWidth  = 1920;
+    uint32_t mHeight = 1080;
+    /// Buffers keep their contents in CPU memory, so code reading locked
+    /// buffers back works as with real device; otherwise updates are only
+    /// counted
+    bool     mCPUVisibleBuffers = true;
+};
+
+/**
+ * @brief Headless device that doesn't talk to any GPU. Every object is a
+ * cheap CPU object that counts calls and bytes into device statistics, so
+ * render driver CPU overhead can be measured without GPU driver noise.
+ */
+class NullDeviceState : public IDeviceState
+{
+  public:
+    NullDeviceState( const NullDeviceCreateInfo &info = {} );
+    ~NullDeviceState() override;
+
+    bool Init() override;
+    bool Shutdown() override;
+    bool GetAdaptersCount( unsigned int &count ) override;
+    bool GetAdapterInfo( unsigned int id, String &info ) override;
+    bool GetCurrentAdapter( unsigned int &id ) override;
+    bool SetCurrentAdapter( unsigned int id ) override;
+    bool GetOutputCount( unsigned int adapterId, unsigned int &count ) override;
+    bool GetOutputInfo( unsigned int id, String &info ) override;
+    bool GetCurrentOutput( unsigned int &id ) override;
+    bool SetCurrentOutput( unsigned int id ) override;
+    bool GetDisplayModeCount( unsigned int  outputId,
+                              unsigned int &count ) override;
+    bool GetDisplayModeInfo( unsigned int id, DisplayModeInfo &info ) override;
+    bool GetCurrentDisplayMode( unsigned int &id ) override;
+    bool SetCurrentDisplayMode( unsigned int id ) override;
+
+    IWindow *CreateDeviceWindow( HWND window, const OutputInfo &info ) override;
+    const DeviceLimitsInfo &GetLimits() override;
+    ICommandBuffer *        GetMainCommandBuffer() override;
+    ICommandBuffer *        CreateCommandBuffer() override;
+    ISyncPrimitive *CreateSyncPrimitive( SyncPrimitiveType type ) override;
+    IDescriptorSetLayout *CreateDescriptorSetLayout(
+        const DescriptorSetLayoutCreateParams &params ) override;
+    IDescriptorSetAllocator *CreateDescriptorSetAllocator(
+        const DescriptorSetAllocatorCreateParams &params ) override;
+    IPipelineLayout *
+    CreatePipelineLayout( const PipelineLayoutCreateParams &params ) override;
+    IFrameBuffer *
+    CreateFrameBuffer( const FrameBufferCreateParams &params ) override;
+    IRenderPass *
+    CreateRenderPass( const RenderPassCreateParams &params ) override;
+    IPipeline *
+    CreateRasterPipeline( const RasterPipelineCreateParams &params ) override;
+    IShader *     CreateShader( const ShaderDesc &params ) override;
+    ISampler *    CreateSampler( const SamplerDesc &params ) override;
+    IBuffer *     CreateBuffer( const BufferCreateInfo &params ) override;
+    IImageBuffer *
+    CreateImageBuffer( const ImageBufferCreateParams &params ) override;
+    IImageView *CreateImageView( const ImageViewCreateInfo &params ) override;
+    void
+    UpdateDescriptorSets( const DescriptorSetUpdateInfo &params ) override;
+    void ExecuteCommandBuffer( ICommandBuffer *buffer, ISyncPrimitive *waitFor,
+                               ISyncPrimitive *signal ) override;
+    void DispatchToGPU(
+        const ArrayProxy<CommandBufferSubmitInfo> &buffers ) override;
+    void Wait( const ArrayProxy<ISyncPrimitive *> &primitiveList ) override;
+    void WaitForGPU() override;
+
+    [[nodiscard]] const NullDeviceStats &GetStats() const { return mStats; }
+    void                                 ResetStats();
+
+  private:
+    NullDeviceCreateInfo               mInfo;
+    NullDeviceStats                    mStats{};
+    DeviceLimitsInfo                   mLimits{};
+    std::unique_ptr<NullCommandBuffer> mMainCmdBuffer;
+};
+} // namespace rh::engine
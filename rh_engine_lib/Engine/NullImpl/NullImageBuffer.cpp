@@ -0,0 +1,83 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "NullImageBuffer.h"
+#include "NullDeviceState.h"
+#include <algorithm>
+
+namespace rh::engine
+{
+namespace
+{
+/// Bits per pixel, block compressed formats are 4x4 pixel blocks
+uint32_t FormatBitsPerPixel( ImageBufferFormat format )
+{
+    switch ( format )
+    {
+    case ImageBufferFormat::BC1:
+    case ImageBufferFormat::BC4: return 4;
+    case ImageBufferFormat::BC2:
+    case ImageBufferFormat::BC3:
+    case ImageBufferFormat::BC5:
+    case ImageBufferFormat::BC6H:
+    case ImageBufferFormat::BC7:
+    case ImageBufferFormat::R8:
+    case ImageBufferFormat::A8:
+    case ImageBufferFormat::R8Uint: return 8;
+    case ImageBufferFormat::RG8:
+    case ImageBufferFormat::R16:
+    case ImageBufferFormat::B5G6R5:
+    case ImageBufferFormat::BGR5A1:
+    case ImageBufferFormat::BGRA4: return 16;
+    case ImageBufferFormat::BGR8: return 24;
+    case ImageBufferFormat::RGBA32: return 128;
+    case ImageBufferFormat::RGB32: return 96;
+    case ImageBufferFormat::RGBA16:
+    case ImageBufferFormat::RG32:
+    case ImageBufferFormat::R32G8: return 64;
+    default: return 32;
+    }
+}
+
+bool IsBlockCompressed( ImageBufferFormat format )
+{
+    return format >= ImageBufferFormat::BC1 &&
+           format <= ImageBufferFormat::BC7;
+}
+} // namespace
+
+NullImageBuffer::NullImageBuffer( const NullImageBufferCreateInfo &create_info )
+    : mStats( create_info.mStats )
+{
+    const auto bpp        = FormatBitsPerPixel( create_info.mFormat );
+    const auto compressed = IsBlockCompressed( create_info.mFormat );
+    uint64_t   width      = create_info.mWidth;
+    uint64_t   height     = create_info.mHeight;
+    uint64_t   depth      = create_info.mDepth;
+    for ( uint32_t mip = 0; mip < create_info.mMipLevels; mip++ )
+    {
+        // compressed mips are stored in whole blocks
+        const auto w = compressed ? ( width + 3 ) & ~3ull : width;
+        const auto h = compressed ? ( height + 3 ) & ~3ull : height;
+        mSize += w * h * depth * bpp / 8;
+        width  = ( std::max )( width / 2, uint64_t{ 1 } );
+        height = ( std::max )( height / 2, uint64_t{ 1 } );
+        depth  = ( std::max )( depth / 2, uint64_t{ 1 } );
+    }
+    mSize *= create_info.mArrayLayers;
+
+    mStats->ImagesCreated++;
+    mStats->ImagesAlive++;
+    mStats->ImageBytesAlive += mSize;
+    for ( const auto &init_data : create_info.mPreinitData )
+        mStats->ImageUploadBytes += init_data.mSize;
+}
+
+NullImageBuffer::~NullImageBuffer()
+{
+    mStats->ImagesAlive--;
+    mStats->ImageBytesAlive -= mSize;
+}
+
+} // namespace rh::engine
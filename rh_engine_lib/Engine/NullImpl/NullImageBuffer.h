@@ -0,0 +1,54 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include "Engine/Common/IImageBuffer.h"
+#include "Engine/Common/IImageView.h"
+#include "Engine/Common/ISampler.h"
+
+namespace rh::engine
+{
+struct NullDeviceStats;
+
+struct NullImageBufferCreateInfo : ImageBufferCreateParams
+{
+    // Dependencies...
+    NullDeviceStats *mStats;
+};
+
+/**
+ * Image of null device, only its size is tracked, pixel data is dropped
+ */
+class NullImageBuffer : public IImageBuffer
+{
+  public:
+    NullImageBuffer( const NullImageBufferCreateInfo &create_info );
+    ~NullImageBuffer() override;
+
+    /// Size image would occupy in GPU memory with all mip levels and layers
+    [[nodiscard]] uint64_t Size() const { return mSize; }
+
+  private:
+    NullDeviceStats *mStats;
+    uint64_t         mSize = 0;
+};
+
+class NullImageView : public IImageView
+{
+  public:
+    NullImageView() = default;
+    NullImageView( const ImageViewCreateInfo &create_info )
+        : mBuffer( create_info.mBuffer )
+    {
+    }
+    [[nodiscard]] IImageBuffer *GetBuffer() const { return mBuffer; }
+
+  private:
+    IImageBuffer *mBuffer = nullptr;
+};
+
+class NullSampler : public ISampler
+{
+};
+
+} // namespace rh::engine
@@ -0,0 +1,44 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include "Engine/Common/IFrameBuffer.h"
+#include "Engine/Common/IPipeline.h"
+#include "Engine/Common/IPipelineLayout.h"
+#include "Engine/Common/IRenderPass.h"
+#include "Engine/Common/IShader.h"
+
+namespace rh::engine
+{
+/// Pipeline state objects of null device hold no state
+
+class NullShader : public IShader
+{
+};
+
+class NullPipelineLayout : public IPipelineLayout
+{
+};
+
+class NullPipeline : public IPipeline
+{
+};
+
+class NullRenderPass : public IRenderPass
+{
+};
+
+class NullFrameBuffer : public IFrameBuffer
+{
+  public:
+    NullFrameBuffer( const FrameBufferCreateParams &params )
+        : mInfo{ params.width, params.height }
+    {
+    }
+    const FrameBufferInfo &GetInfo() const override { return mInfo; }
+
+  private:
+    FrameBufferInfo mInfo;
+};
+
+} // namespace rh::engine
@@ -0,0 +1,59 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "NullWindow.h"
+#include "NullDeviceState.h"
+
+namespace rh::engine
+{
+
+NullSwapchain::NullSwapchain( NullDeviceStats *   stats,
+                              const WindowParams &params )
+    : mStats( stats ), mWidth( params.mWidth ), mHeight( params.mHeight )
+{
+}
+
+SwapchainFrame NullSwapchain::GetAvaliableFrame( ISyncPrimitive * /*signal*/ )
+{
+    return { .mImageView = &mImageViews[mCurrentImage],
+             .mImageId   = mCurrentImage,
+             .mWidth     = mWidth,
+             .mHeight    = mHeight };
+}
+
+bool NullSwapchain::Present( uint32_t        swapchain_img,
+                             ISyncPrimitive * /*waitFor*/ )
+{
+    mStats->PresentedFrames++;
+    mCurrentImage = ( swapchain_img + 1 ) % gNullSwapchainImageCount;
+    return true;
+}
+
+NullWindow::NullWindow( NullDeviceStats *stats, const WindowParams &params )
+    : mStats( stats ), mParams( params )
+{
+}
+
+NullWindow::~NullWindow() { delete mSwapchain; }
+
+bool NullWindow::SetWindowParams( const WindowParams &params )
+{
+    mParams = params;
+    // swapchain is recreated on next request, same as on real device
+    delete mSwapchain;
+    mSwapchain = nullptr;
+    return true;
+}
+
+const WindowParams &NullWindow::GetWindowParams() { return mParams; }
+
+SwapchainRequestResult NullWindow::GetSwapchain()
+{
+    if ( mSwapchain != nullptr )
+        return { mSwapchain, false };
+    mSwapchain = new NullSwapchain( mStats, mParams );
+    return { mSwapchain, true };
+}
+
+} // namespace rh::engine
@@ -0,0 +1,54 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include "Engine/Common/ISwapchain.h"
+#include "Engine/Common/IWindow.h"
+#include "NullImageBuffer.h"
+#include <array>
+
+namespace rh::engine
+{
+struct NullDeviceStats;
+
+constexpr uint32_t gNullSwapchainImageCount = 2;
+
+/**
+ * Swapchain without any presentation surface, cycles through its images
+ */
+class NullSwapchain : public ISwapchain
+{
+  public:
+    NullSwapchain( NullDeviceStats *stats, const WindowParams &params );
+
+    SwapchainFrame GetAvaliableFrame( ISyncPrimitive *signal ) override;
+    bool Present( uint32_t swapchain_img, ISyncPrimitive *waitFor ) override;
+
+  private:
+    NullDeviceStats *mStats;
+    uint32_t         mWidth;
+    uint32_t         mHeight;
+    uint32_t         mCurrentImage = 0;
+    std::array<NullImageView, gNullSwapchainImageCount> mImageViews;
+};
+
+/**
+ * Window of null device, native window handle is ignored
+ */
+class NullWindow : public IWindow
+{
+  public:
+    NullWindow( NullDeviceStats *stats, const WindowParams &params );
+    ~NullWindow() override;
+
+    bool SetWindowParams( const WindowParams &params ) override;
+    const WindowParams &   GetWindowParams() override;
+    SwapchainRequestResult GetSwapchain() override;
+
+  private:
+    NullDeviceStats *mStats;
+    WindowParams     mParams;
+    NullSwapchain *  mSwapchain = nullptr;
+};
+
+} // namespace rh::engine
@@ -3,16 +3,42 @@
 //
 #pragma once
 #include <DebugUtils/DebugLogger.h>
+#include <cassert>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <vector>
 
 namespace rh::engine
 {
 
+/**
+ * Resource id layout: slot index in the low 24 bits, slot generation in the
+ * next 7 bits. Generation is bumped every time a slot is released, so ids of
+ * released resources can be told apart from the ones reusing their slot.
+ * Ids stay positive 32-bit values, since material data stores raster ids as
+ * int32, and generations start at 1, so a valid id is never 0.
+ */
+constexpr uint64_t gResourceSlotBits      = 24;
+constexpr uint64_t gResourceSlotLimit     = 1ull << gResourceSlotBits;
+constexpr uint32_t gResourceGenerationMax = 0x7F;
+
+constexpr uint64_t ResourceSlot( uint64_t id )
+{
+    return id & ( gResourceSlotLimit - 1 );
+}
+constexpr uint32_t ResourceGeneration( uint64_t id )
+{
+    return static_cast<uint32_t>( id >> gResourceSlotBits );
+}
+constexpr uint64_t MakeResourceId( uint64_t slot, uint32_t generation )
+{
+    return ( static_cast<uint64_t>( generation ) << gResourceSlotBits ) | slot;
+}
+
 template <typename T> class ResourcePool
 {
-    enum ResourceFlags : uint64_t
+    enum ResourceFlags : uint32_t
     {
         Unused,
         FreeAtNextGC,
@@ -21,190 +47,288 @@ template <typename T> class ResourcePool
     };
     using Callback = std::function<void( T &, uint64_t )>;
 
-    /*struct ResourceInfo
+    static constexpr uint32_t gNoFreeSlot = 0xFFFFFFFF;
+
+    struct ResourceInfo
     {
-        ResourceFlags mFlags = ResourceFlags::Unused;
-    };*/
+        uint32_t      mGeneration = 1;
+        ResourceFlags mFlags      = ResourceFlags::Unused;
+        /// Next slot of the free list, valid for unused slots only
+        uint32_t      mNextFree   = gNoFreeSlot;
+        /// Reserved, holds placeholder data until resolved
+        bool          mPending    = false;
+    };
+
+    struct RetiredResource
+    {
+        uint32_t mSlot;
+        /// Last frame that may use the resource
+        uint64_t mFrame;
+    };
 
   public:
     ResourcePool( uint64_t size, Callback destruct )
     {
         mDestructCallbacks.emplace_back( 0, destruct );
-        mResourcePool.resize( size );
-        mResourcePoolData.resize( size );
+        mResourcePool.reserve( size );
+        mResourcePoolData.reserve( size );
+        // free list is built so slots are handed out in order
+        for ( uint64_t idx = 0; idx < size; idx++ )
+            AddSlot();
+        for ( uint64_t idx = size; idx > 0; idx-- )
+            PushFreeSlot( static_cast<uint32_t>( idx - 1 ) );
     }
     ~ResourcePool() { CleanResources(); }
 
-    T &GetResource( uint64_t idx ) { return mResourcePoolData[idx]; }
+    T &GetResource( uint64_t id )
+    {
+        assert( IsValid( id ) );
+        return mResourcePoolData[ResourceSlot( id )];
+    }
+
+    const T &GetResource( uint64_t id ) const
+    {
+        assert( IsValid( id ) );
+        return mResourcePoolData[ResourceSlot( id )];
+    }
 
-    const T &GetResource( uint64_t idx ) const
+    /// @return false if resource was released or id never came from the pool
+    bool IsValid( uint64_t id ) const
     {
-        return mResourcePoolData[idx];
+        const auto slot = ResourceSlot( id );
+        if ( slot >= mResourcePool.size() )
+            return false;
+        const auto &info = mResourcePool[slot];
+        return info.mFlags != ResourceFlags::Unused &&
+               info.mGeneration == ResourceGeneration( id );
     }
 
     uint64_t RequestResource( T resource, bool very_important = false )
     {
-        if ( mFreeResourceIdx <= mResourcePool.size() )
-        {
-            // search for first unused resource
-            auto res = FindFreeResourceIdx();
-            if ( !res.second )
-            {
-                // try to free a resource
-                CollectGarbage( 1 );
-                res = FindFreeResourceIdx();
-            }
-            // out of pool memory
-            if ( res.first >= mResourcePool.size() )
-            {
-                mResourcePool.push_back( {} );
-                mResourcePoolData.push_back( {} );
-            }
-            mResourcePoolData[res.first] = std::move( resource );
-            mResourcePool[res.first] =
-                very_important ? ResourceFlags::Immortal : ResourceFlags::Used;
-            if ( !mRequestCallbacks.empty() )
-            {
-                for ( auto [id, cb] : mRequestCallbacks )
-                    cb( mResourcePoolData[res.first], res.first );
-            }
-            mFreeResourceIdx = res.first + 1;
-            // good path
-            return res.first;
-        }
-        else // out of pool memory
-        {
-            mResourcePool.push_back( very_important ? ResourceFlags::Immortal
-                                                    : ResourceFlags::Used );
-            mResourcePoolData.push_back( std::move( resource ) );
-            if ( !mRequestCallbacks.empty() )
-            {
-                auto idx = mResourcePoolData.size() - 1;
-                for ( auto [id, cb] : mRequestCallbacks )
-                    cb( mResourcePoolData[idx], idx );
-            }
-            return mFreeResourceIdx++;
-        }
+        const auto slot = AcquireSlot( very_important );
+        auto &     data = mResourcePoolData[slot];
+        data            = std::move( resource );
+        const auto id = MakeResourceId( slot, mResourcePool[slot].mGeneration );
+        for ( const auto &[cb_id, cb] : mRequestCallbacks )
+            cb( data, id );
+        return id;
+    }
+
+    /**
+     * Allocates id of a resource that is created later, e.g. streamed
+     * asset. Pending resource holds placeholder data, request callbacks are
+     * dispatched once it's resolved and destruct callbacks are skipped if it
+     * is freed before that.
+     */
+    uint64_t ReserveResource( T placeholder, bool very_important = false )
+    {
+        const auto slot         = AcquireSlot( very_important );
+        auto &     info         = mResourcePool[slot];
+        info.mPending           = true;
+        mResourcePoolData[slot] = std::move( placeholder );
+        return MakeResourceId( slot, info.mGeneration );
+    }
+
+    /// @return true if resource is reserved, not freed and not resolved yet
+    bool IsPending( uint64_t id ) const
+    {
+        if ( !IsValid( id ) )
+            return false;
+        const auto &info = mResourcePool[ResourceSlot( id )];
+        return info.mPending && info.mFlags != ResourceFlags::FreeAtNextGC;
+    }
+
+    /// @return true if resource holds its actual data, not a placeholder
+    bool IsReady( uint64_t id ) const
+    {
+        return IsValid( id ) && !mResourcePool[ResourceSlot( id )].mPending;
+    }
+
+    /**
+     * Replaces placeholder of a pending resource and dispatches request
+     * callbacks
+     * @return false if resource was freed before it was resolved
+     */
+    bool ResolveResource( uint64_t id, T resource )
+    {
+        if ( !IsPending( id ) )
+            return false;
+        const auto slot = ResourceSlot( id );
+        mResourcePool[slot].mPending = false;
+
+        auto &data = mResourcePoolData[slot];
+        data       = std::move( resource );
+        for ( const auto &[cb_id, cb] : mRequestCallbacks )
+            cb( data, id );
+        return true;
     }
 
-    std::pair<uint64_t, bool> FindFreeResourceIdx()
+    void FreeResource( uint64_t id )
     {
-        uint64_t idx                 = mFreeResourceIdx;
-        bool     found_free_resource = false;
-        while ( idx < mResourcePool.size() )
+        if ( !IsValid( id ) )
         {
-            found_free_resource =
-                ( mResourcePool[idx] == ResourceFlags::Unused );
-            if ( found_free_resource )
-                break;
-            ++idx;
+            debug::DebugLogger::LogFormat(
+                debug::LogLevel::Error,
+                "Attempt to free stale resource id %llx",
+                static_cast<unsigned long long>( id ) );
+            return;
         }
-        return { idx, found_free_resource };
+        auto &info = mResourcePool[ResourceSlot( id )];
+        if ( info.mFlags == ResourceFlags::FreeAtNextGC )
+            return;
+        info.mFlags = ResourceFlags::FreeAtNextGC;
+        mGarbage.push_back(
+            { static_cast<uint32_t>( ResourceSlot( id ) ), mRecordedFrame } );
     }
 
-    void FreeResource( uint64_t idx )
+    /**
+     * Updates frame fences used to retire freed resources
+     * @param recorded_frame - last frame that may use resources freed from
+     * now on, usually the frame being recorded
+     * @param completed_frame - last frame GPU has finished executing
+     */
+    void SetFrameFences( uint64_t recorded_frame, uint64_t completed_frame )
     {
-        mResourcePool[idx] = ResourceFlags::FreeAtNextGC;
-        // mFreeResourceIdx   = idx;
-        mGarbageCount++;
+        mRecordedFrame  = recorded_frame;
+        mCompletedFrame = completed_frame;
     }
 
     void CleanResources()
     {
-        std::vector<uint32_t> used_resources;
-        used_resources.reserve( mResourcePool.size() );
-        uint32_t idx = 0;
-        for ( auto &resource : mResourcePool )
+        for ( uint64_t slot = 0; slot < mResourcePool.size(); slot++ )
         {
-            if ( resource != ResourceFlags::FreeAtNextGC &&
-                 resource != ResourceFlags::Unused )
+            auto &info = mResourcePool[slot];
+            if ( info.mFlags == ResourceFlags::Unused )
+                continue;
+            if ( info.mFlags != ResourceFlags::FreeAtNextGC )
                 debug::DebugLogger::Log(
                     "Resource was not freed before exit!" );
-            if ( resource != ResourceFlags::Unused )
-                used_resources.push_back( idx );
-            resource = ResourceFlags::Unused;
-            idx++;
-        }
-        for ( auto i : used_resources )
-        {
-            auto &resource = mResourcePoolData[i];
-            if ( !mDestructCallbacks.empty() )
-            {
-                for ( auto current = mDestructCallbacks.rbegin(),
-                           end     = mDestructCallbacks.rend();
-                      current != end; current++ )
-                    ( *current ).second( resource, i );
-            }
+            DispatchDestruct( slot );
+            info.mFlags      = ResourceFlags::Unused;
+            info.mPending    = false;
+            info.mGeneration = info.mGeneration % gResourceGenerationMax + 1;
         }
-        mGarbageCount    = 0;
-        mFreeResourceIdx = 0;
+        mGarbage.clear();
+        // rebuild free list, so pool can be reused after cleanup
+        mFreeSlot = gNoFreeSlot;
+        for ( uint64_t slot = mResourcePool.size(); slot > 0; slot-- )
+            PushFreeSlot( static_cast<uint32_t>( slot - 1 ) );
     }
 
-    void CollectGarbage( uint64_t to_free_resource_count )
+    /**
+     * Destroys freed resources no longer used by in-flight frames, oldest
+     * first
+     * @param to_free_resource_count - max resource count to destroy
+     * @return destroyed resource count
+     */
+    uint64_t CollectGarbage( uint64_t to_free_resource_count )
     {
-        if ( mGarbageCount <= 0 )
-            return;
-        ;
-        int64_t free_idx = -1;
-
-        for ( uint64_t idx = 0; idx < mResourcePoolData.size(); idx++ )
+        uint64_t freed = 0;
+        // garbage is ordered by frame, so the rest is in flight as well
+        while ( freed < to_free_resource_count && HasCollectableGarbage() )
         {
-            auto &flags = mResourcePool[idx];
-            if ( flags != ResourceFlags::FreeAtNextGC )
-                continue;
+            const auto slot = mGarbage.front().mSlot;
+            mGarbage.pop_front();
 
-            auto &resource = mResourcePoolData[idx];
-            if ( free_idx == -1 )
-                free_idx = idx;
-
-            if ( !mDestructCallbacks.empty() )
-            {
-                for ( auto current = mDestructCallbacks.rbegin(),
-                           end     = mDestructCallbacks.rend();
-                      current != end; current++ )
-                    ( *current ).second( resource, idx );
-            }
-            resource = {};
-            flags    = ResourceFlags::Unused;
-            mGarbageCount--;
-            if ( to_free_resource_count-- <= 0 )
-                break;
+            DispatchDestruct( slot );
+            mResourcePoolData[slot] = {};
+            auto &info              = mResourcePool[slot];
+            info.mFlags             = ResourceFlags::Unused;
+            info.mPending           = false;
+            // ids of the destroyed resource become stale
+            info.mGeneration = info.mGeneration % gResourceGenerationMax + 1;
+            PushFreeSlot( slot );
+            freed++;
         }
-        if ( free_idx == -1 )
-            mFreeResourceIdx = 0;
-        else if ( free_idx < mFreeResourceIdx )
-            mFreeResourceIdx = free_idx;
+        return freed;
     }
 
+    /// Freed resource count, including ones still used by in-flight frames
+    uint64_t GetGarbageCount() const { return mGarbage.size(); }
+
     T *      GetStorage() { return mResourcePoolData.data(); }
+    /// Slot count, every slot index is below it
     uint64_t GetSize() { return mResourcePoolData.size(); }
 
     void AddOnRequestCallback( Callback &&cb, uint64_t id )
     {
-        mRequestCallbacks.emplace_back( id, cb );
+        mRequestCallbacks.emplace_back( id, std::move( cb ) );
     }
 
     void AddOnDestructCallback( Callback &&cb, uint64_t id )
     {
-        mDestructCallbacks.emplace_back( id, cb );
+        mDestructCallbacks.emplace_back( id, std::move( cb ) );
     }
 
     void RemoveOnRequestCallback( uint64_t id )
     {
         std::erase_if( mRequestCallbacks,
-                       [id]( auto x ) { return x.first == id; } );
+                       [id]( const auto &x ) { return x.first == id; } );
     }
 
     void RemoveOnDestructCallback( uint64_t id )
     {
         std::erase_if( mDestructCallbacks,
-                       [id]( auto x ) { return x.first == id; } );
+                       [id]( const auto &x ) { return x.first == id; } );
     }
 
   private:
-    uint64_t                                   mGarbageCount    = 0;
-    int64_t                                    mFreeResourceIdx = 0;
-    std::vector<ResourceFlags>                 mResourcePool{};
+    uint32_t AcquireSlot( bool very_important )
+    {
+        if ( mFreeSlot == gNoFreeSlot && HasCollectableGarbage() )
+            // try to free a resource
+            CollectGarbage( 1 );
+        // out of pool memory
+        if ( mFreeSlot == gNoFreeSlot )
+            PushFreeSlot( AddSlot() );
+
+        const auto slot = mFreeSlot;
+        auto &     info = mResourcePool[slot];
+        mFreeSlot       = info.mNextFree;
+        info.mNextFree  = gNoFreeSlot;
+        info.mFlags =
+            very_important ? ResourceFlags::Immortal : ResourceFlags::Used;
+        return slot;
+    }
+
+    uint32_t AddSlot()
+    {
+        assert( mResourcePool.size() < gResourceSlotLimit );
+        mResourcePool.push_back( {} );
+        mResourcePoolData.push_back( {} );
+        return static_cast<uint32_t>( mResourcePool.size() - 1 );
+    }
+
+    void PushFreeSlot( uint32_t slot )
+    {
+        mResourcePool[slot].mNextFree = mFreeSlot;
+        mFreeSlot                     = slot;
+    }
+
+    bool HasCollectableGarbage() const
+    {
+        return !mGarbage.empty() && mGarbage.front().mFrame <= mCompletedFrame;
+    }
+
+    void DispatchDestruct( uint64_t slot )
+    {
+        // placeholder of pending resource is owned by whoever reserved it
+        if ( mResourcePool[slot].mPending )
+            return;
+        auto &     resource = mResourcePoolData[slot];
+        const auto id = MakeResourceId( slot, mResourcePool[slot].mGeneration );
+        for ( auto current = mDestructCallbacks.rbegin(),
+                   end     = mDestructCallbacks.rend();
+              current != end; current++ )
+            current->second( resource, id );
+    }
+
+    /// Head of the intrusive free list
+    uint32_t                                   mFreeSlot       = gNoFreeSlot;
+    uint64_t                                   mRecordedFrame  = 0;
+    uint64_t                                   mCompletedFrame = 0;
+    std::deque<RetiredResource>                mGarbage{};
+    std::vector<ResourceInfo>                  mResourcePool{};
     std::vector<T>                             mResourcePoolData{};
     std::vector<std::pair<uint64_t, Callback>> mDestructCallbacks{};
     std::vector<std::pair<uint64_t, Callback>> mRequestCallbacks{};
@@ -0,0 +1,24 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include <algorithm>
+#include <cstdint>
+
+namespace rh::rw::engine
+{
+
+constexpr uint64_t gMinGrowCapacity = 64;
+
+/**
+ * Capacity policy shared by frame recorders and render driver buffers that
+ * mirror them: capacity at least doubles, so a buffer is reallocated only a
+ * few times until it fits the busiest frame.
+ * @param required - entry count that has to fit
+ */
+constexpr uint64_t GrowCapacity( uint64_t capacity, uint64_t required )
+{
+    return ( std::max )( { required, capacity * 2, gMinGrowCapacity } );
+}
+
+} // namespace rh::rw::engine
@@ -2,22 +2,26 @@
 // Created by peter on 18.02.2021.
 //
 #include "frame_info.h"
+#include <data_desc/frame_packet.h>
 #include <ipc/MemoryReader.h>
 
 namespace rh::rw::engine
 {
 
-FrameState FrameState::Deserialize( MemoryReader &reader )
+FrameState FrameState::Deserialize( MemoryReader          &reader,
+                                   const FramePacketView &packet,
+                                   MeshInstanceTable     &mesh_instances )
 {
     FrameState state{};
     state.ImGuiInput    = reader.Read<ImGuiInputState>();
     state.Viewport      = reader.Read<MainViewportState>();
     state.Sky           = reader.Read<SkyState>();
-    state.Lights        = AnalyticLightsState::Deserialize( reader );
-    state.Im2D          = Im2DRenderState::Deserialize( reader );
-    state.Im3D          = Im3DRenderState::Deserialize( reader );
-    state.MeshInstances = MeshInstanceState::Deserialize( reader );
-    state.SkinInstances = SkinInstanceState::Deserialize( reader );
+    state.Lights        = AnalyticLightsState::Deserialize( reader, packet );
+    state.Im2D          = Im2DRenderState::Deserialize( reader, packet );
+    state.Im3D          = Im3DRenderState::Deserialize( reader, packet );
+    state.MeshInstances =
+        MeshInstanceState::Deserialize( reader, packet, mesh_instances );
+    state.SkinInstances = SkinInstanceState::Deserialize( reader, packet );
     return state;
 }
 } // namespace rh::rw::engine
\ No newline at end of file
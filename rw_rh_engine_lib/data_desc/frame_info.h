@@ -26,7 +26,15 @@ struct FrameState
     Im3DRenderState     Im3D;
     MeshInstanceState   MeshInstances;
     SkinInstanceState   SkinInstances;
-    static FrameState   Deserialize( MemoryReader &reader );
+
+    /**
+     * @param packet - frame packet that recorded arrays are stored in
+     * @param mesh_instances - resident instance table the frame delta is
+     * applied to
+     */
+    static FrameState Deserialize( MemoryReader          &reader,
+                                   const FramePacketView &packet,
+                                   MeshInstanceTable     &mesh_instances );
 };
 
 } // namespace rh::rw::engine
\ No newline at end of file
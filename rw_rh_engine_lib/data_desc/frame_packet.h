@@ -0,0 +1,61 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include <Engine/Common/ArrayProxy.h>
+#include <cstdint>
+#include <ipc/MemoryReader.h>
+#include <ipc/shared_memory_ring.h>
+
+namespace rh::rw::engine
+{
+/**
+ * Frame packet is a shared memory segment that frame recorders write their
+ * arrays into, render task payload only stores headers of those arrays.
+ */
+struct FramePacketHeader
+{
+    uint32_t SegmentId = gNoOverflowSegment;
+    uint32_t Padding   = 0;
+    /// Bytes of segment used by current frame
+    uint64_t Size = 0;
+};
+
+/**
+ * Array stored in the frame packet, Offset is relative to segment data
+ */
+struct FramePacketSection
+{
+    uint64_t Offset = 0;
+    uint64_t Count  = 0;
+};
+
+/**
+ * Render driver view into the frame packet
+ */
+struct FramePacketView
+{
+    const uint8_t *Base = nullptr;
+    uint64_t       Size = 0;
+
+    /**
+     * Reads section header and returns array it points to
+     * @return empty array if section is out of packet bounds
+     */
+    template <typename T>
+    [[nodiscard]] rh::engine::ArrayProxy<T> Read( MemoryReader &reader ) const
+    {
+        const auto section = *reader.Read<FramePacketSection>();
+        if ( section.Count == 0 )
+            return {};
+        if ( Base == nullptr || section.Offset > Size ||
+             section.Offset % alignof( T ) != 0 ||
+             section.Count > ( Size - section.Offset ) / sizeof( T ) )
+            return {};
+        return rh::engine::ArrayProxy<T>(
+            reinterpret_cast<const T *>( Base + section.Offset ),
+            static_cast<size_t>( section.Count ) );
+    }
+};
+
+} // namespace rh::rw::engine
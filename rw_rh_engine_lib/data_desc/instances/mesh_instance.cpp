@@ -3,22 +3,136 @@
 //
 
 #include "mesh_instance.h"
+#include <algorithm>
+#include <data_desc/frame_packet.h>
 #include <ipc/MemoryReader.h>
 
 namespace rh::rw::engine
 {
-MeshInstanceState MeshInstanceState::Deserialize( MemoryReader &reader )
+MeshInstanceState
+MeshInstanceState::Deserialize( MemoryReader          &reader,
+                                const FramePacketView &packet,
+                                MeshInstanceTable     &table )
 {
+    auto removed_slots = packet.Read<uint32_t>( reader );
+    auto update_slots  = packet.Read<uint32_t>( reader );
+    auto updates       = packet.Read<DrawCallInfo>( reader );
+    auto materials     = packet.Read<MaterialData>( reader );
+    table.Apply( removed_slots, update_slots, updates, materials );
+
     MeshInstanceState result{};
-    auto              dc_count = *reader.Read<uint64_t>();
-    if ( dc_count <= 0 )
-        return result;
-
-    auto material_count = *reader.Read<uint64_t>();
-    result.Materials    = rh::engine::ArrayProxy(
-        reader.Read<MaterialData>( material_count ), material_count );
-    result.DrawCalls = rh::engine::ArrayProxy(
-        reader.Read<DrawCallInfo>( dc_count ), dc_count );
+    result.Materials    = table.Materials();
+    result.DrawCalls    = table.Instances();
+    result.VisibleSlots = table.VisibleSlots();
+    result.DirtySlots   = table.DirtySlots();
     return result;
 }
+
+void MeshInstanceTable::Apply(
+    const rh::engine::ArrayProxy<uint32_t>     &removed_slots,
+    const rh::engine::ArrayProxy<uint32_t>     &update_slots,
+    const rh::engine::ArrayProxy<DrawCallInfo> &updates,
+    const rh::engine::ArrayProxy<MaterialData> &materials )
+{
+    mDirtySlots.clear();
+
+    for ( auto slot : removed_slots )
+    {
+        // frames are published more than once while paused, so removal of a
+        // free slot is not an error
+        if ( slot >= mInstances.size() ||
+             mVisibleIndex[slot] == gNoMeshInstanceSlot )
+            continue;
+        auto index                          = mVisibleIndex[slot];
+        mVisibleSlots[index]                = mVisibleSlots.back();
+        mVisibleIndex[mVisibleSlots[index]] = index;
+        mVisibleSlots.pop_back();
+        mVisibleIndex[slot] = gNoMeshInstanceSlot;
+        mWastedMaterials += mMaterialCapacity[slot];
+        mMaterialCapacity[slot] = 0;
+    }
+
+    const auto update_count =
+        ( std::min )( update_slots.Size(), updates.Size() );
+    // client takes the lowest free slot, so table grows at most by update
+    // count per frame
+    const auto slot_limit = mInstances.size() + update_count;
+    for ( size_t i = 0; i < update_count; i++ )
+    {
+        const auto  slot   = update_slots[i];
+        const auto &update = updates[i];
+        if ( slot >= slot_limit ||
+             update.MaterialListStart > materials.Size() ||
+             update.MaterialListCount >
+                 materials.Size() - update.MaterialListStart )
+            continue;
+        if ( slot >= mInstances.size() )
+        {
+            mInstances.resize( slot + 1 );
+            mMaterialCapacity.resize( slot + 1, 0 );
+            mVisibleIndex.resize( slot + 1, gNoMeshInstanceSlot );
+        }
+
+        auto material_start = mInstances[slot].MaterialListStart;
+        mInstances[slot]    = update;
+        StoreMaterials( slot, material_start,
+                        materials.Data() + update.MaterialListStart,
+                        update.MaterialListCount );
+        if ( mVisibleIndex[slot] == gNoMeshInstanceSlot )
+        {
+            mVisibleIndex[slot] = static_cast<uint32_t>( mVisibleSlots.size() );
+            mVisibleSlots.push_back( slot );
+        }
+        mDirtySlots.push_back( slot );
+    }
+
+    // material lists are compacted once most of the array is wasted, so it
+    // stays within twice the visible material count
+    constexpr uint64_t min_wasted_materials = 4096;
+    if ( mWastedMaterials > min_wasted_materials &&
+         mWastedMaterials > mMaterials.size() / 2 )
+        CompactMaterials();
+}
+
+void MeshInstanceTable::StoreMaterials( uint32_t slot, uint64_t start,
+                                        const MaterialData *materials,
+                                        uint64_t            count )
+{
+    // changed instance reuses its material list if the new one fits
+    if ( count > mMaterialCapacity[slot] )
+    {
+        mWastedMaterials += mMaterialCapacity[slot];
+        start = mMaterials.size();
+        mMaterials.resize( mMaterials.size() + count );
+        mMaterialCapacity[slot] = static_cast<uint32_t>( count );
+    }
+    // slot without material list has no valid start
+    if ( mMaterialCapacity[slot] == 0 )
+        start = 0;
+    auto &instance             = mInstances[slot];
+    instance.MaterialListStart = start;
+    instance.MaterialListCount = count;
+    std::copy( materials, materials + count, mMaterials.begin() + start );
+}
+
+void MeshInstanceTable::CompactMaterials()
+{
+    std::vector<MaterialData> materials;
+    materials.reserve( mMaterials.size() - mWastedMaterials );
+    for ( auto slot : mVisibleSlots )
+    {
+        auto &instance = mInstances[slot];
+        auto  start    = mMaterials.begin() + instance.MaterialListStart;
+        instance.MaterialListStart = materials.size();
+        materials.insert( materials.end(), start,
+                          start + instance.MaterialListCount );
+        mMaterialCapacity[slot] =
+            static_cast<uint32_t>( instance.MaterialListCount );
+    }
+    mMaterials       = std::move( materials );
+    mWastedMaterials = 0;
+    // every material list has moved
+    mDirtySlots = mVisibleSlots;
+}
+
 } // namespace rh::rw::engine
\ No newline at end of file
@@ -23,15 +23,83 @@ struct DrawCallInfo
 
 class MemoryWriter;
 class MemoryReader;
+struct FramePacketView;
+
+/// Mesh instances are stored in slots that persist between frames
+constexpr uint32_t gNoMeshInstanceSlot = 0xFFFFFFFF;
+
+/**
+ * Render driver side mesh instance table. Client sends only added, changed
+ * and removed instances, so static world geometry is sent once when it
+ * becomes visible. Instances and their materials are indexed by slot.
+ */
+class MeshInstanceTable
+{
+  public:
+    /**
+     * Applies frame delta, removals go first so slots may be reused by
+     * updates of the same frame
+     * @param updates - instances with materials list offsets relative to
+     * materials array
+     */
+    void Apply( const rh::engine::ArrayProxy<uint32_t>     &removed_slots,
+                const rh::engine::ArrayProxy<uint32_t>     &update_slots,
+                const rh::engine::ArrayProxy<DrawCallInfo> &updates,
+                const rh::engine::ArrayProxy<MaterialData> &materials );
+
+    /// Instances indexed by slot, free slots are not in visible list
+    [[nodiscard]] const std::vector<DrawCallInfo> &Instances() const
+    {
+        return mInstances;
+    }
+    [[nodiscard]] const std::vector<MaterialData> &Materials() const
+    {
+        return mMaterials;
+    }
+    [[nodiscard]] const std::vector<uint32_t> &VisibleSlots() const
+    {
+        return mVisibleSlots;
+    }
+    /// Slots added or changed by the last delta
+    [[nodiscard]] const std::vector<uint32_t> &DirtySlots() const
+    {
+        return mDirtySlots;
+    }
+
+  private:
+    void StoreMaterials( uint32_t slot, uint64_t start,
+                         const MaterialData *materials, uint64_t count );
+    void CompactMaterials();
+
+    std::vector<DrawCallInfo> mInstances;
+    std::vector<MaterialData> mMaterials;
+    /// Material list capacity of each slot, lists are reused in place
+    std::vector<uint32_t>     mMaterialCapacity;
+    std::vector<uint32_t>     mVisibleSlots;
+    /// Position of each slot in visible list
+    std::vector<uint32_t>     mVisibleIndex;
+    std::vector<uint32_t>     mDirtySlots;
+    uint64_t                  mWastedMaterials = 0;
+};
 
 /**
- * Memory view into current frame im3d render state
+ * Memory view into current frame mesh instance state
  */
 struct MeshInstanceState
 {
     rh::engine::ArrayProxy<MaterialData> Materials;
+    /// Resident instances indexed by slot
     rh::engine::ArrayProxy<DrawCallInfo> DrawCalls;
-    static MeshInstanceState             Deserialize( MemoryReader &reader );
+    rh::engine::ArrayProxy<uint32_t>     VisibleSlots;
+    /// Slots added or changed in current frame
+    rh::engine::ArrayProxy<uint32_t>     DirtySlots;
+
+    /**
+     * Applies instance delta of the frame to resident table
+     */
+    static MeshInstanceState Deserialize( MemoryReader          &reader,
+                                          const FramePacketView &packet,
+                                          MeshInstanceTable     &table );
 };
 
 } // namespace rh::rw::engine
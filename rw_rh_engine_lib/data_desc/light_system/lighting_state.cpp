@@ -2,18 +2,17 @@
 // Created by peter on 18.02.2021.
 //
 #include "lighting_state.h"
+#include <data_desc/frame_packet.h>
 #include <ipc/MemoryReader.h>
 
 namespace rh::rw::engine
 {
-AnalyticLightsState AnalyticLightsState::Deserialize( MemoryReader &reader )
+AnalyticLightsState
+AnalyticLightsState::Deserialize( MemoryReader          &reader,
+                                  const FramePacketView &packet )
 {
     AnalyticLightsState result{};
-    auto                point_light_count = *reader.Read<uint64_t>();
-    if ( point_light_count <= 0 )
-        return result;
-    result.PointLights = rh::engine::ArrayProxy(
-        reader.Read<PointLight>( point_light_count ), point_light_count );
+    result.PointLights = packet.Read<PointLight>( reader );
     return result;
 }
 } // namespace rh::rw::engine
\ No newline at end of file
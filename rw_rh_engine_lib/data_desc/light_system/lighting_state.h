@@ -7,9 +7,12 @@
 namespace rh::rw::engine
 {
 class MemoryReader;
+struct FramePacketView;
 struct AnalyticLightsState
 {
     rh::engine::ArrayProxy<PointLight> PointLights;
-    static AnalyticLightsState         Deserialize( MemoryReader &reader );
+
+    static AnalyticLightsState Deserialize( MemoryReader          &reader,
+                                            const FramePacketView &packet );
 };
 } // namespace rh::rw::engine
\ No newline at end of file
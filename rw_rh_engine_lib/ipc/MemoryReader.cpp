@@ -3,3 +3,28 @@
 //
 
 #include "MemoryReader.h"
+#include <DebugUtils/DebugLogger.h>
+
+namespace rh::rw::engine
+{
+
+void MemoryReader::Overflow( uint64_t count )
+{
+    if ( !overflowed )
+        debug::DebugLogger::ErrorFmt(
+            "Memory reader overflow: failed to read %llu bytes at %llu, "
+            "segment size is %llu!",
+            static_cast<unsigned long long>( count ),
+            static_cast<unsigned long long>( Pos() ),
+            static_cast<unsigned long long>( size ) );
+    overflowed = true;
+
+    // consumers get zeroes instead of reading past the mapping
+    discarded.push_back( std::make_unique<char[]>( count ) );
+    segment_start += offset;
+    memory = discarded.back().get();
+    size   = count;
+    offset = 0;
+}
+
+} // namespace rh::rw::engine
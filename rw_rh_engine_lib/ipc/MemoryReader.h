@@ -2,20 +2,62 @@
 // Created by peter on 25.06.2020.
 //
 #pragma once
+#include "MemorySegment.h"
 #include <cstdint>
+#include <memory>
+#include <vector>
 namespace rh::rw::engine
 {
+/**
+ * Sequential reader of data written by MemoryWriter, follows spilled
+ * segments in the same order they were written
+ */
 class MemoryReader
 {
   private:
-    uint64_t offset = 0;
-    void *   memory = nullptr;
+    uint64_t           offset        = 0;
+    uint64_t           segment_start = 0;
+    void *             memory        = nullptr;
+    uint64_t           size          = gUnboundedMemorySize;
+    MemorySpillSource *source        = nullptr;
+    bool               overflowed    = false;
+    std::vector<std::unique_ptr<char[]>> discarded{};
+
+    void Overflow( uint64_t count );
+
+    void Fetch( uint64_t count )
+    {
+        if ( offset + count <= size )
+            return;
+        // writer spills only at the start of a write, so we must be exactly
+        // at the end of current segment
+        MemorySegment next{};
+        if ( !overflowed && source != nullptr && offset == size &&
+             source->Next( next ) && count <= next.Size )
+        {
+            segment_start += offset;
+            memory = next.Memory;
+            size   = next.Size;
+            offset = 0;
+            return;
+        }
+        Overflow( count );
+    }
 
   public:
-    MemoryReader( void *_memory ) : memory( _memory ) {}
-    void                                   Skip( uint64_t p ) { offset += p; }
+    MemoryReader( void *_memory, uint64_t _size = gUnboundedMemorySize,
+                  MemorySpillSource *_source = nullptr )
+        : memory( _memory ), size( _size ), source( _source )
+    {
+    }
+    void Skip( uint64_t p )
+    {
+        Fetch( p );
+        offset += p;
+    }
     template <typename T> [[nodiscard]] T *Read()
     {
+        Fetch( sizeof( T ) );
         T *start = static_cast<T *>(
             static_cast<void *>( static_cast<char *>( memory ) + offset ) );
         offset += sizeof( T );
@@ -23,15 +65,18 @@ class MemoryReader
     }
     template <typename T> [[nodiscard]] T *Read( uint64_t count )
     {
+        Fetch( sizeof( T ) * count );
         T *start = static_cast<T *>(
             static_cast<void *>( static_cast<char *>( memory ) + offset ) );
         offset += sizeof( T ) * count;
         return start;
     }
-    [[nodiscard]] uint64_t Pos() { return offset; }
+    /// Logical position, includes data read from previous segments
+    [[nodiscard]] uint64_t Pos() { return segment_start + offset; }
     [[nodiscard]] void *   CurrentAddress()
     {
         return static_cast<void *>( static_cast<char *>( memory ) + offset );
     }
+    [[nodiscard]] bool Overflowed() { return overflowed; }
 };
 } // namespace rh::rw::engine
@@ -0,0 +1,43 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include <cstdint>
+namespace rh::rw::engine
+{
+constexpr uint64_t gUnboundedMemorySize = UINT64_MAX;
+
+struct MemorySegment
+{
+    void *   Memory = nullptr;
+    uint64_t Size   = 0;
+};
+
+/**
+ * Provides MemoryWriter with extra memory once current segment is full.
+ * Data written before the spill stays in previous segment, so every single
+ * write remains contiguous.
+ */
+class MemorySpillAllocator
+{
+  public:
+    virtual ~MemorySpillAllocator() = default;
+    /**
+     * @param used - bytes used in current segment
+     * @param size - minimal size of the next segment
+     */
+    virtual bool Spill( uint64_t used, uint64_t size, MemorySegment &next ) = 0;
+};
+
+/**
+ * Provides MemoryReader with next segment of spilled data, segment Size is
+ * the amount of bytes written into it
+ */
+class MemorySpillSource
+{
+  public:
+    virtual ~MemorySpillSource()             = default;
+    virtual bool Next( MemorySegment &next ) = 0;
+};
+
+} // namespace rh::rw::engine
@@ -3,3 +3,29 @@
 //
 
 #include "MemoryWriter.h"
+#include <DebugUtils/DebugLogger.h>
+
+namespace rh::rw::engine
+{
+
+void MemoryWriter::Overflow( uint64_t size )
+{
+    if ( !overflowed )
+        debug::DebugLogger::ErrorFmt(
+            "Memory writer overflow: failed to write %llu bytes at %llu, "
+            "capacity is %llu. Data is discarded!",
+            static_cast<unsigned long long>( size ),
+            static_cast<unsigned long long>( Pos() ),
+            static_cast<unsigned long long>( capacity ) );
+    overflowed = true;
+
+    // keep previously returned pointers valid, so every overflow gets its
+    // own buffer
+    discarded.push_back( std::make_unique<char[]>( size ) );
+    segment_start += offset;
+    memory   = discarded.back().get();
+    capacity = size;
+    offset   = 0;
+}
+
+} // namespace rh::rw::engine
@@ -2,51 +2,123 @@
 // Created by peter on 25.06.2020.
 //
 #pragma once
+#include "MemorySegment.h"
 #include <Engine/Common/ArrayProxy.h>
-#include <Windows.h>
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
 namespace rh::rw::engine
 {
+/**
+ * Sequential writer into a memory segment of limited capacity.
+ * Once data doesn't fit it spills into the next segment provided by spill
+ * allocator, or into a discard buffer if there is none.
+ */
 class MemoryWriter
 {
   private:
-    uint64_t offset = 0;
-    void *   memory = nullptr;
+    uint64_t              offset        = 0;
+    uint64_t              segment_start = 0;
+    void *                memory        = nullptr;
+    uint64_t              capacity      = gUnboundedMemorySize;
+    MemorySpillAllocator *spill         = nullptr;
+    bool                  overflowed    = false;
+    std::vector<std::unique_ptr<char[]>> discarded{};
+
+    void Overflow( uint64_t size );
 
   public:
-    MemoryWriter( void *_memory ) : memory( _memory ) {}
+    MemoryWriter( void *_memory, uint64_t _capacity = gUnboundedMemorySize,
+                  MemorySpillAllocator *_spill = nullptr )
+        : memory( _memory ), capacity( _capacity ), spill( _spill )
+    {
+    }
+
+    /**
+     * Makes sure that next size bytes are contiguous, should be called
+     * before writing through CurrentPtr
+     * @return false if writer has overflowed and data will be discarded
+     */
+    bool Reserve( uint64_t size )
+    {
+        if ( offset + size <= capacity )
+            return true;
+        MemorySegment next{};
+        if ( !overflowed && spill != nullptr &&
+             spill->Spill( offset, size, next ) )
+        {
+            segment_start += offset;
+            memory   = next.Memory;
+            capacity = next.Size;
+            offset   = 0;
+            return true;
+        }
+        Overflow( size );
+        return false;
+    }
 
-    void Skip( uint64_t p ) { offset += p; }
+    void Skip( uint64_t p )
+    {
+        Reserve( p );
+        offset += p;
+    }
+    /// Seek inside of reserved region
     void SeekFromCurrent( int64_t p ) { offset += p; }
 
     template <typename T> void Write( T *data )
     {
-        CopyMemory( static_cast<char *>( memory ) + offset, data, sizeof( T ) );
+        Reserve( sizeof( T ) );
+        std::memcpy( static_cast<char *>( memory ) + offset, data,
+                     sizeof( T ) );
         offset += sizeof( T );
     }
     template <typename T> void Write( T *data, uint64_t count )
     {
-        CopyMemory( static_cast<char *>( memory ) + offset, data,
-                    sizeof( T ) * count );
+        Reserve( sizeof( T ) * count );
+        std::memcpy( static_cast<char *>( memory ) + offset, data,
+                     sizeof( T ) * count );
         offset += sizeof( T ) * count;
     }
     template <typename T> void Write( const rh::engine::ArrayProxy<T> &data )
     {
-        CopyMemory( static_cast<char *>( memory ) + offset, data.Data(),
-                    sizeof( T ) * data.Size() );
+        Reserve( sizeof( T ) * data.Size() );
+        std::memcpy( static_cast<char *>( memory ) + offset, data.Data(),
+                     sizeof( T ) * data.Size() );
         offset += sizeof( T ) * data.Size();
     }
+    /**
+     * Writes array in parts of at most max_size bytes, so spill allocator is
+     * never asked for more memory than that. Array can be read back at once
+     * only if spilled segments are joined, e.g. in chunked tasks.
+     */
+    template <typename T>
+    void WriteSplit( const T *data, uint64_t count, uint64_t max_size )
+    {
+        const auto *bytes = reinterpret_cast<const uint8_t *>( data );
+        uint64_t    size  = sizeof( T ) * count;
+        for ( uint64_t offset = 0; offset < size; offset += max_size )
+            Write( bytes + offset, ( std::min )( max_size, size - offset ) );
+    }
     template <typename T> T &Current()
     {
+        Reserve( sizeof( T ) );
         return *reinterpret_cast<T *>(
             ( static_cast<char *>( memory ) + offset ) );
     }
 
     template <typename T> T *CurrentPtr()
     {
+        Reserve( sizeof( T ) );
         return reinterpret_cast<T *>(
             ( static_cast<char *>( memory ) + offset ) );
     }
-    uint64_t Pos() { return offset; }
+    /// Logical position, includes data written to previous segments
+    uint64_t Pos() { return segment_start + offset; }
+    /// Position inside of current segment
+    uint64_t SegmentPos() { return offset; }
+    bool     Spilled() { return segment_start > 0; }
+    bool     Overflowed() { return overflowed; }
 };
-} // namespace rh::rw::engine
\ No newline at end of file
+} // namespace rh::rw::engine
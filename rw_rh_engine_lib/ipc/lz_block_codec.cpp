@@ -0,0 +1,133 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "lz_block_codec.h"
+#include <cstring>
+
+namespace rh::rw::engine
+{
+namespace
+{
+constexpr uint32_t gHashBits     = 16;
+constexpr uint64_t gMinMatchSize = 4;
+constexpr uint64_t gNoPosition   = UINT64_MAX;
+
+uint32_t LoadSequence( const uint8_t *src )
+{
+    uint32_t value;
+    std::memcpy( &value, src, sizeof( value ) );
+    return value;
+}
+
+uint32_t HashSequence( uint32_t sequence )
+{
+    return ( sequence * 2654435761u ) >> ( 32 - gHashBits );
+}
+
+void WriteVarInt( std::vector<uint8_t> &dst, uint64_t value )
+{
+    while ( value >= 0x80 )
+    {
+        dst.push_back( static_cast<uint8_t>( value | 0x80 ) );
+        value >>= 7;
+    }
+    dst.push_back( static_cast<uint8_t>( value ) );
+}
+
+bool ReadVarInt( const uint8_t *&src, const uint8_t *end, uint64_t &value )
+{
+    value = 0;
+    for ( uint32_t shift = 0; shift < 64; shift += 7 )
+    {
+        if ( src == end )
+            return false;
+        const uint8_t byte = *src++;
+        value |= static_cast<uint64_t>( byte & 0x7F ) << shift;
+        if ( ( byte & 0x80 ) == 0 )
+            return true;
+    }
+    return false;
+}
+
+void WriteLiterals( std::vector<uint8_t> &dst, const uint8_t *src,
+                    uint64_t count )
+{
+    WriteVarInt( dst, count );
+    dst.insert( dst.end(), src, src + count );
+}
+} // namespace
+
+LzBlockEncoder::LzBlockEncoder()
+    : mHashTable( 1ull << gHashBits, gNoPosition )
+{
+}
+
+void LzBlockEncoder::Compress( const uint8_t *src, uint64_t size,
+                               std::vector<uint8_t> &dst )
+{
+    uint64_t pos           = 0;
+    uint64_t literal_start = 0;
+    while ( pos + gMinMatchSize <= size )
+    {
+        const auto sequence  = LoadSequence( src + pos );
+        auto &     entry     = mHashTable[HashSequence( sequence )];
+        const auto candidate = entry;
+        entry                = mBase + pos;
+
+        // entries of previous blocks are below block base
+        if ( candidate == gNoPosition || candidate < mBase ||
+             LoadSequence( src + candidate - mBase ) != sequence )
+        {
+            pos++;
+            continue;
+        }
+        const auto match_pos  = candidate - mBase;
+        uint64_t   match_size = gMinMatchSize;
+        while ( pos + match_size < size &&
+                src[match_pos + match_size] == src[pos + match_size] )
+            match_size++;
+
+        WriteLiterals( dst, src + literal_start, pos - literal_start );
+        WriteVarInt( dst, match_size - gMinMatchSize );
+        WriteVarInt( dst, pos - match_pos );
+        pos += match_size;
+        literal_start = pos;
+    }
+    // block always ends with a literal run, even an empty one
+    WriteLiterals( dst, src + literal_start, size - literal_start );
+    mBase += size;
+}
+
+bool LzDecompress( const uint8_t *src, uint64_t src_size, uint8_t *dst,
+                   uint64_t dst_size )
+{
+    const auto *end = src + src_size;
+    uint64_t    pos = 0;
+    while ( true )
+    {
+        uint64_t literal_count;
+        if ( !ReadVarInt( src, end, literal_count ) ||
+             literal_count > static_cast<uint64_t>( end - src ) ||
+             literal_count > dst_size - pos )
+            return false;
+        std::memcpy( dst + pos, src, literal_count );
+        src += literal_count;
+        pos += literal_count;
+        if ( pos == dst_size )
+            return src == end;
+
+        uint64_t match_size, offset;
+        if ( !ReadVarInt( src, end, match_size ) ||
+             !ReadVarInt( src, end, offset ) )
+            return false;
+        match_size += gMinMatchSize;
+        if ( offset == 0 || offset > pos || match_size > dst_size - pos )
+            return false;
+        // match may overlap itself, e.g. runs of zeroes
+        for ( uint64_t i = 0; i < match_size; i++, pos++ )
+            dst[pos] = dst[pos - offset];
+    }
+}
+
+} // namespace rh::rw::engine
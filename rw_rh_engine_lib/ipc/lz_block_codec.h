@@ -0,0 +1,40 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace rh::rw::engine
+{
+
+/**
+ * Byte oriented LZ77 encoder for task captures. Block is a sequence of
+ * literal runs followed by back references into already decoded data, which
+ * handles zero filled and repeated arrays of frame packets well.
+ * Hash table is kept between blocks and invalidated by block base position,
+ * so encoding a lot of small payloads doesn't pay for table reset.
+ */
+class LzBlockEncoder
+{
+  public:
+    LzBlockEncoder();
+
+    /// Appends compressed block to dst
+    void Compress( const uint8_t *src, uint64_t size,
+                   std::vector<uint8_t> &dst );
+
+  private:
+    std::vector<uint64_t> mHashTable;
+    uint64_t              mBase = 0;
+};
+
+/**
+ * Decodes block written by LzBlockEncoder
+ * @param dst_size - uncompressed block size
+ * @return false if block is corrupted
+ */
+bool LzDecompress( const uint8_t *src, uint64_t src_size, uint8_t *dst,
+                   uint64_t dst_size );
+
+} // namespace rh::rw::engine
@@ -0,0 +1,105 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "shared_memory_doorbell.h"
+#include <DebugUtils/DebugLogger.h>
+#include <climits>
+#include <thread>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined( _M_IX86 ) || defined( _M_X64 ) || defined( __i386__ ) ||         \
+    defined( __x86_64__ )
+#include <immintrin.h>
+#define RH_CPU_RELAX() _mm_pause()
+#else
+#define RH_CPU_RELAX() std::this_thread::yield()
+#endif
+
+namespace rh::rw::engine
+{
+
+SharedMemoryDoorbell::~SharedMemoryDoorbell()
+{
+#ifdef _WIN32
+    if ( mEvent )
+        CloseHandle( mEvent );
+#endif
+}
+
+bool SharedMemoryDoorbell::Init( SharedMemoryDoorbellState *state,
+                                 const std::string &        name )
+{
+    mState = state;
+    // spinning on a single core only delays the other side
+    mSpinCount =
+        std::thread::hardware_concurrency() > 1 ? gDoorbellSpinCount : 0;
+#ifdef _WIN32
+    SECURITY_ATTRIBUTES event_attr{};
+    event_attr.nLength        = sizeof( SECURITY_ATTRIBUTES );
+    event_attr.bInheritHandle = true;
+
+    // creates event or opens existing one if other side was first
+    mEvent = CreateEvent( &event_attr, FALSE, FALSE, name.c_str() );
+    if ( mEvent == nullptr )
+    {
+        auto error_code = static_cast<uint32_t>( GetLastError() );
+        debug::DebugLogger::ErrorFmt( "Failed to create %s event! Error "
+                                      "code:%u",
+                                      name.c_str(), error_code );
+        return false;
+    }
+    debug::DebugLogger::LogFmt( "Created %s event", debug::LogLevel::Info,
+                                name.c_str() );
+#else
+    // futex lives in shared memory itself, nothing to create
+    (void)name;
+#endif
+    return true;
+}
+
+void SharedMemoryDoorbell::Signal()
+{
+    mState->Counter.fetch_add( 1 );
+    if ( mState->Waiters.load() == 0 )
+        return;
+#ifdef _WIN32
+    SetEvent( mEvent );
+#else
+    syscall( SYS_futex, reinterpret_cast<uint32_t *>( &mState->Counter ),
+             FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0 );
+#endif
+}
+
+void SharedMemoryDoorbell::CpuRelax() { RH_CPU_RELAX(); }
+
+void SharedMemoryDoorbell::Block( uint32_t counter, uint32_t timeout_ms )
+{
+#ifdef _WIN32
+    // auto-reset event may be left signaled by a previous wake-up, it's fine
+    // since every wait re-checks its predicate
+    (void)counter;
+    WaitForSingleObject( mEvent, timeout_ms == gDoorbellInfiniteWait
+                                     ? INFINITE
+                                     : timeout_ms );
+#else
+    timespec  timeout{ static_cast<time_t>( timeout_ms / 1000 ),
+                      static_cast<long>( timeout_ms % 1000 ) * 1000000L };
+    timespec *timeout_ptr =
+        timeout_ms == gDoorbellInfiniteWait ? nullptr : &timeout;
+    // returns immediately if counter was changed since we've checked it
+    syscall( SYS_futex, reinterpret_cast<uint32_t *>( &mState->Counter ),
+             FUTEX_WAIT, counter, timeout_ptr, nullptr, 0 );
+#endif
+}
+
+} // namespace rh::rw::engine
@@ -0,0 +1,70 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include "shared_memory_ring.h"
+#include <cstdint>
+#include <string>
+
+namespace rh::rw::engine
+{
+constexpr uint32_t gDoorbellSpinCount    = 4096;
+constexpr uint32_t gDoorbellInfiniteWait = 0xFFFFFFFF;
+
+/**
+ * Cross-process wake-up primitive for SharedMemoryTaskQueue.
+ * Waiting side spins for a while and then sleeps on named event(Win32) or
+ * futex(Linux) placed inside shared memory.
+ */
+class SharedMemoryDoorbell
+{
+  public:
+    SharedMemoryDoorbell() = default;
+    ~SharedMemoryDoorbell();
+    SharedMemoryDoorbell( const SharedMemoryDoorbell & ) = delete;
+    SharedMemoryDoorbell &operator=( const SharedMemoryDoorbell & ) = delete;
+
+    bool Init( SharedMemoryDoorbellState *state, const std::string &name );
+
+    /**
+     * Wakes up waiting side, should be called after publishing new data
+     */
+    void Signal();
+
+    /**
+     * Waits until ready returns true or timeout is reached
+     * @return last ready() result
+     */
+    template <typename Predicate>
+    bool WaitUntil( Predicate &&ready, uint32_t timeout_ms )
+    {
+        for ( uint32_t i = 0; i < mSpinCount; i++ )
+        {
+            if ( ready() )
+                return true;
+            CpuRelax();
+        }
+        // counter must be loaded before the last check, otherwise we may
+        // miss a signal between check and sleep
+        auto counter = mState->Counter.load();
+        mState->Waiters.fetch_add( 1 );
+        bool result = ready();
+        if ( !result )
+        {
+            Block( counter, timeout_ms );
+            result = ready();
+        }
+        mState->Waiters.fetch_sub( 1 );
+        return result;
+    }
+
+  private:
+    static void CpuRelax();
+    void        Block( uint32_t counter, uint32_t timeout_ms );
+
+    SharedMemoryDoorbellState *mState     = nullptr;
+    void *                     mEvent     = nullptr;
+    uint32_t                   mSpinCount = gDoorbellSpinCount;
+};
+
+} // namespace rh::rw::engine
@@ -4,9 +4,22 @@
 
 #include "shared_memory_queue_client.h"
 #include <DebugUtils/DebugLogger.h>
-#include <Windows.h>
+#include <algorithm>
 #include <cassert>
-#include <sstream>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <span>
+#include <thread>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 namespace rh::rw
 {
@@ -14,26 +27,254 @@ engine::IPCRenderMode engine::IPCSettings::mMode =
     IPCRenderMode::MultiThreadedRenderer;
 std::string engine::IPCSettings::mProcessName{};
 
+namespace
+{
+constexpr uint32_t gTaskLoopIdleTimeMs = 1000;
+constexpr uint32_t gClientWaitTimeMs   = 100;
+constexpr auto     gLayoutWaitTimeout  = std::chrono::seconds( 10 );
+constexpr uint64_t gPostedTaskBatchSize = 64 * 1024;
+constexpr uint64_t gMaxPostedTaskSize   = 1024;
+constexpr uint64_t gTaskChunkSize       = 1024 * 1024;
+/// render driver keeps chunked task staging memory up to this size
+constexpr uint64_t gMaxRetainedChunkedPayload = 16 * 1024 * 1024;
+
+/// client must keep processing window messages while waiting for driver
+void PumpClientWindowMessages()
+{
+#ifdef _WIN32
+    MSG m;
+    while ( PeekMessage( &m, nullptr, 0, 0, PM_REMOVE ) )
+    {
+        TranslateMessage( &m );
+        DispatchMessage( &m );
+    }
+#endif
+}
+
+/**
+ * Client side, chains overflow segments of a single task record
+ */
+class TaskPayloadSpill final : public engine::MemorySpillAllocator
+{
+  public:
+    TaskPayloadSpill( engine::SharedMemorySegmentPool &pool,
+                      engine::TaskRecordHeader &record, uint64_t completed )
+        : mPool( pool ), mRecord( record ), mCompletedTasks( completed )
+    {
+    }
+
+    bool Spill( uint64_t used, uint64_t size,
+                engine::MemorySegment &next ) override
+    {
+        // segment is free once render driver finishes this task
+        auto *segment =
+            mPool.Acquire( size, mRecord.Sequence + 1, mCompletedTasks );
+        if ( segment == nullptr )
+            return false;
+
+        if ( mLast != nullptr )
+        {
+            mLast->End  = used;
+            mLast->Next = segment->Id;
+        }
+        else
+        {
+            mRecord.SpillOffset     = used;
+            mRecord.OverflowSegment = segment->Id;
+        }
+        mLast = segment;
+        next  = { engine::SharedMemorySegmentPool::Data( segment ),
+                 segment->Capacity };
+        return true;
+    }
+
+    void Finish( uint64_t used )
+    {
+        if ( mLast != nullptr )
+            mLast->End = used;
+    }
+
+  private:
+    engine::SharedMemorySegmentPool &mPool;
+    engine::TaskRecordHeader &       mRecord;
+    uint64_t                         mCompletedTasks;
+    engine::OverflowSegmentHeader *  mLast = nullptr;
+};
+
+/**
+ * Render driver side, follows overflow segments of a single task record
+ */
+class TaskPayloadSource final : public engine::MemorySpillSource
+{
+  public:
+    TaskPayloadSource( engine::SharedMemorySegmentPool &pool, uint32_t first )
+        : mPool( pool ), mNext( first )
+    {
+    }
+
+    bool Next( engine::MemorySegment &next ) override
+    {
+        if ( mNext == engine::gNoOverflowSegment )
+            return false;
+        auto *segment = mPool.Resolve( mNext );
+        if ( segment == nullptr )
+            return false;
+        mNext = segment->Next;
+        next  = { engine::SharedMemorySegmentPool::Data( segment ),
+                 ( std::min )( segment->End, segment->Capacity ) };
+        return true;
+    }
+
+  private:
+    engine::SharedMemorySegmentPool &mPool;
+    uint32_t                         mNext;
+};
+
+/**
+ * Client side, sends chunked task payload while it's serialized. Filled
+ * buffer is sent on the next spill, so the data written right before a
+ * spill may still be patched.
+ */
+class TaskChunkSpill final : public engine::MemorySpillAllocator
+{
+  public:
+    using SendFunc = std::function<void( const uint8_t *data, uint64_t size )>;
+
+    TaskChunkSpill( std::vector<uint8_t> ( &buffers )[2], uint64_t chunk_size,
+                    SendFunc &&send )
+        : mBuffers( buffers ), mChunkSize( chunk_size ),
+          mSend( std::move( send ) )
+    {
+        for ( auto &buffer : mBuffers )
+            if ( buffer.size() < mChunkSize )
+                buffer.resize( mChunkSize );
+    }
+
+    [[nodiscard]] engine::MemorySegment First()
+    {
+        return { mBuffers[0].data(), mBuffers[0].size() };
+    }
+
+    bool Spill( uint64_t used, uint64_t size,
+                engine::MemorySegment &next ) override
+    {
+        SendPending();
+        mPendingSize = used;
+        mCurrent     = 1 - mCurrent;
+
+        // single write larger than a chunk gets its own buffer, it's sent
+        // in several chunks later
+        auto &buffer = mBuffers[mCurrent];
+        if ( buffer.size() < size )
+            buffer.resize( size );
+        next = { buffer.data(), buffer.size() };
+        return true;
+    }
+
+    /**
+     * Sends everything but the last chunk, that one is sent with the task
+     * record itself
+     * @return last chunk of the payload
+     */
+    std::span<const uint8_t> Finish( uint64_t used )
+    {
+        SendPending();
+        const uint64_t tail = used == 0 ? 0 : ( used - 1 ) % mChunkSize + 1;
+        Send( mBuffers[mCurrent].data(), used - tail );
+        return { mBuffers[mCurrent].data() + used - tail, tail };
+    }
+
+    /// Releases buffers grown for oversized writes
+    void Trim()
+    {
+        for ( auto &buffer : mBuffers )
+        {
+            if ( buffer.size() <= mChunkSize )
+                continue;
+            buffer.resize( mChunkSize );
+            buffer.shrink_to_fit();
+        }
+    }
+
+  private:
+    void SendPending()
+    {
+        Send( mBuffers[1 - mCurrent].data(), mPendingSize );
+        mPendingSize = 0;
+    }
+
+    void Send( const uint8_t *data, uint64_t size )
+    {
+        for ( uint64_t offset = 0; offset < size; offset += mChunkSize )
+            mSend( data + offset, ( std::min )( mChunkSize, size - offset ) );
+    }
+
+    std::vector<uint8_t> ( &mBuffers )[2];
+    uint64_t             mChunkSize;
+    SendFunc             mSend;
+    uint32_t             mCurrent     = 0;
+    uint64_t             mPendingSize = 0;
+};
+} // namespace
+
 engine::SharedMemoryTaskQueue::SharedMemoryTaskQueue(
     const SharedMemoryTaskQueueInfo &info )
+    : mOverflowSegments( info.mName )
+{
+    bool created = false;
+    if ( !MapSharedMemory( info, created ) )
+        return;
+
+    mHeader = static_cast<SharedMemoryQueueHeader *>( mMappedMemory );
+    if ( created )
+        InitLayout();
+    else if ( !WaitForLayout() )
+    {
+        debug::DebugLogger::Error( "Shared memory task queue layout is not "
+                                   "initialized, x86 to x64 render mode is "
+                                   "unavailable!" );
+        UnmapSharedMemory();
+        mHeader = nullptr;
+        return;
+    }
+
+    auto *base      = static_cast<uint8_t *>( mMappedMemory );
+    mSubmitRing     = base + mHeader->SubmitRingOffset;
+    mCompletionRing = reinterpret_cast<TaskCompletion *>(
+        base + mHeader->CompletionRingOffset );
+
+    mTaskDoorbell.Init( &mHeader->TaskDoorbell, info.mName + "TaskDoorbell" );
+    mCompletionDoorbell.Init( &mHeader->CompletionDoorbell,
+                              info.mName + "CompletionDoorbell" );
+    mExitDoorbell.Init( &mHeader->ExitDoorbell, info.mName + "ExitEvent" );
+}
+
+engine::SharedMemoryTaskQueue::~SharedMemoryTaskQueue()
 {
+    UnmapSharedMemory();
+}
 
-    // Create synchronisation primitives
-    SECURITY_ATTRIBUTES event_attr{};
-    event_attr.nLength        = sizeof( SECURITY_ATTRIBUTES );
-    event_attr.bInheritHandle = true;
+bool engine::SharedMemoryTaskQueue::MapSharedMemory(
+    const SharedMemoryTaskQueueInfo &info, bool &created )
+{
+    mMappedSize = info.mSize;
+#ifdef _WIN32
+    SECURITY_ATTRIBUTES mapping_attr{};
+    mapping_attr.nLength        = sizeof( SECURITY_ATTRIBUTES );
+    mapping_attr.bInheritHandle = true;
 
-    std::stringstream ss{};
     // Create shared memory for IPC
     if ( info.mOwner )
     {
         mSharedMemory = CreateFileMapping(
             INVALID_HANDLE_VALUE, // use paging file
-            &event_attr,          // default security
+            &mapping_attr,        // default security
             PAGE_READWRITE,       // read/write access
             0,                    // maximum object size (high-order DWORD)
             info.mSize,           // maximum object size (low-order DWORD)
             info.mName.c_str() ); // name of mapping object
+        created = mSharedMemory != nullptr &&
+                  GetLastError() != ERROR_ALREADY_EXISTS;
     }
     else
     {
@@ -44,22 +285,18 @@ engine::SharedMemoryTaskQueue::SharedMemoryTaskQueue(
     }
     if ( mSharedMemory == nullptr )
     {
-
-        std::string error_msg =
+        debug::DebugLogger::ErrorFmt(
             info.mOwner ? "Failed to create shared memory, x86 to x64 "
-                          "render mode is unavailable! Error code:"
+                          "render mode is unavailable! Error code:%u"
                         : "Failed to open shared memory, x86 to x64 "
-                          "render mode is unavailable! Error code:";
-        ss << error_msg << GetLastError();
-
-        debug::DebugLogger::Log( ss.str(), debug::LogLevel::Error );
-        return;
+                          "render mode is unavailable! Error code:%u",
+            static_cast<uint32_t>( GetLastError() ) );
+        return false;
     }
-    std::string log_msg = info.mOwner ? "Succesfuly create shared memory "
-                                      : "Succesfuly opened shared memory ";
-    ss << log_msg << info.mName;
-    debug::DebugLogger::Log( ss.str(), debug::LogLevel::Info );
-    ss.str( "" );
+    debug::DebugLogger::LogFmt( info.mOwner
+                                    ? "Succesfuly create shared memory %s"
+                                    : "Succesfuly opened shared memory %s",
+                                debug::LogLevel::Info, info.mName.c_str() );
 
     // Map shared memory view
     mMappedMemory = MapViewOfFile( mSharedMemory,       // handle to map object
@@ -68,180 +305,691 @@ engine::SharedMemoryTaskQueue::SharedMemoryTaskQueue(
 
     if ( mMappedMemory == nullptr )
     {
+        debug::DebugLogger::ErrorFmt(
+            "Failed to map shared memory, x86 to x64 render mode is "
+            "unavailable! Error code:%u",
+            static_cast<uint32_t>( GetLastError() ) );
 
-        ss << "Failed to map shared memory, x86 to x64 "
-              "render mode is unavailable! Error code:"
-           << GetLastError();
+        CloseHandle( mSharedMemory );
+        mSharedMemory = nullptr;
+        return false;
+    }
+#else
+    mSharedMemoryName = "/" + info.mName;
+    if ( info.mOwner )
+    {
+        mSharedMemory = shm_open( mSharedMemoryName.c_str(),
+                                  O_CREAT | O_EXCL | O_RDWR, 0600 );
+        created       = mSharedMemory >= 0;
+        // other side may have created it already
+        if ( !created && errno == EEXIST )
+            mSharedMemory =
+                shm_open( mSharedMemoryName.c_str(), O_RDWR, 0600 );
+        else if ( created &&
+                  ftruncate( mSharedMemory,
+                             static_cast<off_t>( info.mSize ) ) != 0 )
+        {
+            close( mSharedMemory );
+            shm_unlink( mSharedMemoryName.c_str() );
+            mSharedMemory = -1;
+        }
+        mUnlinkOnClose = created;
+    }
+    else
+        mSharedMemory = shm_open( mSharedMemoryName.c_str(), O_RDWR, 0600 );
 
-        debug::DebugLogger::Log( ss.str(), debug::LogLevel::Error );
+    if ( mSharedMemory < 0 )
+    {
+        debug::DebugLogger::ErrorFmt(
+            info.mOwner ? "Failed to create shared memory, x86 to x64 "
+                          "render mode is unavailable! Error:%s"
+                        : "Failed to open shared memory, x86 to x64 "
+                          "render mode is unavailable! Error:%s",
+            std::strerror( errno ) );
+        return false;
+    }
+    debug::DebugLogger::LogFmt( info.mOwner
+                                    ? "Succesfuly create shared memory %s"
+                                    : "Succesfuly opened shared memory %s",
+                                debug::LogLevel::Info, info.mName.c_str() );
+
+    mMappedMemory = mmap( nullptr, info.mSize, PROT_READ | PROT_WRITE,
+                          MAP_SHARED, mSharedMemory, 0 );
+    if ( mMappedMemory == MAP_FAILED )
+    {
+        mMappedMemory = nullptr;
+        debug::DebugLogger::ErrorFmt(
+            "Failed to map shared memory, x86 to x64 render mode is "
+            "unavailable! Error:%s",
+            std::strerror( errno ) );
+
+        close( mSharedMemory );
+        if ( mUnlinkOnClose )
+            shm_unlink( mSharedMemoryName.c_str() );
+        mSharedMemory = -1;
+        return false;
+    }
+#endif
+    debug::DebugLogger::LogFmt( "Succesfuly mapped shared memory %s",
+                                debug::LogLevel::Info, info.mName.c_str() );
+    return true;
+}
 
+void engine::SharedMemoryTaskQueue::UnmapSharedMemory()
+{
+#ifdef _WIN32
+    if ( mMappedMemory )
+        UnmapViewOfFile( mMappedMemory );
+    if ( mSharedMemory )
         CloseHandle( mSharedMemory );
-        return;
+    mSharedMemory = nullptr;
+#else
+    if ( mMappedMemory )
+        munmap( mMappedMemory, mMappedSize );
+    if ( mSharedMemory >= 0 )
+        close( mSharedMemory );
+    if ( mUnlinkOnClose )
+        shm_unlink( mSharedMemoryName.c_str() );
+    mSharedMemory  = -1;
+    mUnlinkOnClose = false;
+#endif
+    mMappedMemory = nullptr;
+}
+
+void engine::SharedMemoryTaskQueue::InitLayout()
+{
+    auto *header = new ( mMappedMemory ) SharedMemoryQueueHeader{};
+
+    header->Version                = gSharedMemoryQueueVersion;
+    header->CompletionRingCapacity = gCompletionRingCapacity;
+    header->CompletionRingOffset =
+        AlignSharedMemoryOffset( sizeof( SharedMemoryQueueHeader ) );
+    header->SubmitRingOffset = AlignSharedMemoryOffset(
+        header->CompletionRingOffset +
+        gCompletionRingCapacity * sizeof( TaskCompletion ) );
+    assert( header->SubmitRingOffset < mMappedSize );
+    header->SubmitRingSize = ( mMappedSize - header->SubmitRingOffset ) &
+                             ~( gSharedMemoryQueueAlignment - 1 );
+
+    // publish layout to the other side
+    header->Magic.store( gSharedMemoryQueueMagic, std::memory_order_release );
+}
+
+bool engine::SharedMemoryTaskQueue::WaitForLayout()
+{
+    auto start = std::chrono::steady_clock::now();
+    while ( mHeader->Magic.load( std::memory_order_acquire ) !=
+            gSharedMemoryQueueMagic )
+    {
+        if ( std::chrono::steady_clock::now() - start > gLayoutWaitTimeout )
+            return false;
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
     }
+    return mHeader->Version == gSharedMemoryQueueVersion;
+}
 
-    ss << "Succesfuly mapped shared memory " << info.mName;
+uint8_t *engine::SharedMemoryTaskQueue::WriteTaskRecord(
+    int64_t id, uint32_t flags,
+    const std::function<void( MemoryWriter && )> &serializer )
+{
+    const uint64_t ring_size = mHeader->SubmitRingSize;
+    // every record reserves up to half of the ring as contiguous space,
+    // this way serializer never has to care about wrapping
+    const uint64_t max_record_size = ring_size / 2;
+
+    auto &head = mHeader->SubmitHead.Value;
+    auto &tail = mHeader->SubmitTail.Value;
+
+    uint64_t write_pos   = tail.load( std::memory_order_relaxed );
+    uint64_t ring_offset = write_pos % ring_size;
+    uint64_t record_pos  = write_pos;
+    if ( ring_offset + max_record_size > ring_size )
+        record_pos += ring_size - ring_offset;
+
+    // wait for render driver to free enough space
+    auto has_space = [&head, record_pos, max_record_size, ring_size]() {
+        return record_pos + max_record_size -
+                   head.load( std::memory_order_acquire ) <=
+               ring_size;
+    };
+    while ( !mCompletionDoorbell.WaitUntil( has_space, gClientWaitTimeMs ) )
+        PumpClientWindowMessages();
 
-    debug::DebugLogger::Log( ss.str(), debug::LogLevel::Info );
-    ss.str( "" );
+    if ( record_pos != write_pos )
+    {
+        auto *wrap_marker =
+            reinterpret_cast<TaskRecordHeader *>( mSubmitRing + ring_offset );
+        *wrap_marker = TaskRecordHeader{ .Size  = record_pos - write_pos,
+                                         .Flags = TaskRecordFlags::WrapMarker };
+    }
 
-    auto task_start_name  = info.mName + "TaskStartEvent";
-    auto task_finish_name = info.mName + "TaskFinishEvent";
-    auto exit_event_name  = info.mName + "ExitEvent";
-    auto task_mutex       = info.mName + "Mtx";
+    auto *record = reinterpret_cast<TaskRecordHeader *>(
+        mSubmitRing + record_pos % ring_size );
+    auto *payload = reinterpret_cast<uint8_t *>( record + 1 );
+
+    TaskRecordHeader record_info{ .TaskId   = id,
+                                  .Sequence = mNextSequence,
+                                  .Flags    = flags };
+    // payload that doesn't fit into the ring goes to overflow segments
+    TaskPayloadSpill spill(
+        mOverflowSegments, record_info,
+        mHeader->CompletedTasks.Value.load( std::memory_order_acquire ) );
+    MemoryWriter writer( payload, MaxInlinePayloadSize(), &spill );
+    serializer( std::move( writer ) );
+    spill.Finish( writer.SegmentPos() );
+
+    uint64_t inline_size =
+        writer.Spilled() ? record_info.SpillOffset : writer.Pos();
+    uint64_t record_size =
+        AlignSharedMemoryOffset( sizeof( TaskRecordHeader ) + inline_size );
+    assert( record_size <= max_record_size );
+
+    mStats.LastTaskSize    = writer.Pos();
+    mStats.LargestTaskSize = ( std::max )( mStats.LargestTaskSize,
+                                           mStats.LastTaskSize );
+    if ( writer.Spilled() )
+        mStats.SpilledTaskCount++;
+    mStats.OverflowMemorySize = mOverflowSegments.TotalSize();
+
+    record_info.Size = record_size;
+    mNextSequence++;
+    *record = record_info;
+
+    tail.store( record_pos + record_size, std::memory_order_release );
+    mTaskDoorbell.Signal();
+    return payload;
+}
 
-    auto create_event_safe_lambda = [&ss]( SECURITY_ATTRIBUTES event_attr,
-                                           const std::string & name ) {
-        auto event = CreateEvent( &event_attr, FALSE, FALSE, name.c_str() );
-        if ( event == nullptr )
-        {
-            ss << "Failed to create " << name
-               << "event! Error code:" << GetLastError();
+void engine::SharedMemoryTaskQueue::PushCompletion(
+    const TaskRecordHeader &record, const uint8_t *payload )
+{
+    auto &tail = mHeader->CompletionTail.Value;
+
+    uint64_t write_pos = tail.load( std::memory_order_relaxed );
+    // client waits for every reply before sending next task, so completion
+    // ring can't overflow
+    assert( write_pos - mHeader->CompletionHead.Value.load(
+                            std::memory_order_acquire ) <
+            mHeader->CompletionRingCapacity );
+
+    auto payload_offset = static_cast<uint64_t>(
+        payload - static_cast<uint8_t *>( mMappedMemory ) );
+    mCompletionRing[write_pos % mHeader->CompletionRingCapacity] =
+        TaskCompletion{ .Sequence      = record.Sequence,
+                        .TaskId        = record.TaskId,
+                        .PayloadOffset = payload_offset };
+    tail.store( write_pos + 1, std::memory_order_release );
+}
 
-            debug::DebugLogger::Log( ss.str(), debug::LogLevel::Error );
-        }
-        else
-        {
-            ss << "Created " << name << " event";
-            debug::DebugLogger::Log( ss.str(), debug::LogLevel::Info );
-        }
+[[maybe_unused]] void engine::SharedMemoryTaskQueue::ExecuteTask(
+    int64_t id, std::function<void( MemoryWriter &&reader )> &&serializer,
+    std::function<void( MemoryReader &&writer )> &&deserializer )
+{
+    if ( mHeader == nullptr )
+        return;
+    std::lock_guard producer_lock( mProducerMutex );
 
-        ss.str( "" );
-        return event;
-    };
+    // posted tasks must be executed before this one
+    FlushPostedTasksLocked();
+    ExecuteTaskLocked( id, 0, serializer, deserializer );
+}
 
-    auto create_mutex_safe_lambda = [&ss]( SECURITY_ATTRIBUTES event_attr,
-                                           const std::string & name ) {
-        auto mtx = CreateMutex( &event_attr, FALSE, name.c_str() );
-        if ( mtx == nullptr )
-        {
-            ss << "Failed to create " << name << "mutex"
-               << "Error code:" << GetLastError();
+[[maybe_unused]] void engine::SharedMemoryTaskQueue::ExecuteChunkedTask(
+    int64_t id, std::function<void( MemoryWriter && )> &&serializer,
+    std::function<void( MemoryReader && )> &&deserializer )
+{
+    if ( mHeader == nullptr )
+        return;
+    std::lock_guard producer_lock( mProducerMutex );
+
+    FlushPostedTasksLocked();
+
+    // producer lock is held till the last chunk is sent, so render driver
+    // gets chunks of a single task at a time
+    TaskChunkSpill spill( mChunkBuffers, TaskChunkSize(),
+                          [this]( const uint8_t *data, uint64_t size ) {
+                              WriteTaskRecord(
+                                  SharedMemoryTaskType::TASK_CHUNK,
+                                  TaskRecordFlags::NoReply,
+                                  [data, size]( MemoryWriter &&writer ) {
+                                      writer.Write( &size );
+                                      writer.Write( data, size );
+                                  } );
+                          } );
+    const auto   first = spill.First();
+    MemoryWriter writer( first.Memory, first.Size, &spill );
+    serializer( std::move( writer ) );
+    const auto task_size  = writer.Pos();
+    const auto last_chunk = spill.Finish( writer.SegmentPos() );
+
+    ExecuteTaskLocked(
+        id, TaskRecordFlags::Chunked,
+        [last_chunk]( MemoryWriter &&writer ) {
+            uint64_t size = last_chunk.size();
+            writer.Write( &size );
+            writer.Write( last_chunk.data(), size );
+        },
+        deserializer );
+    spill.Trim();
+
+    mStats.LastTaskSize    = task_size;
+    mStats.LargestTaskSize = ( std::max )( mStats.LargestTaskSize,
+                                           mStats.LastTaskSize );
+    mStats.ChunkedTaskCount++;
+}
 
-            debug::DebugLogger::Log( ss.str(), debug::LogLevel::Error );
-        }
-        else
-        {
-            ss << "Created " << name << " mutex";
-            debug::DebugLogger::Log( ss.str(), debug::LogLevel::Info );
-        }
+void engine::SharedMemoryTaskQueue::ExecuteTaskLocked(
+    int64_t id, uint32_t flags,
+    const std::function<void( MemoryWriter && )> &serializer,
+    const std::function<void( MemoryReader && )> &deserializer )
+{
+    [[maybe_unused]] auto *payload = WriteTaskRecord( id, flags, serializer );
+    uint64_t               sequence = mNextSequence - 1;
+
+    auto &head = mHeader->CompletionHead.Value;
+    auto &tail = mHeader->CompletionTail.Value;
 
-        ss.str( "" );
-        return mtx;
+    uint64_t read_pos       = head.load( std::memory_order_relaxed );
+    auto     has_completion = [&tail, read_pos]() {
+        return tail.load( std::memory_order_acquire ) != read_pos;
     };
+    while ( !mCompletionDoorbell.WaitUntil( has_completion,
+                                            gClientWaitTimeMs ) )
+        PumpClientWindowMessages();
+
+    const auto &completion =
+        mCompletionRing[read_pos % mHeader->CompletionRingCapacity];
+    assert( completion.Sequence == sequence && completion.TaskId == id );
+    assert( static_cast<uint8_t *>( mMappedMemory ) +
+                completion.PayloadOffset ==
+            payload );
+    (void)sequence;
+
+    // reply is written in place of the task payload, render driver won't
+    // touch it until we send a new task
+    deserializer( MemoryReader( static_cast<uint8_t *>( mMappedMemory ) +
+                                    completion.PayloadOffset,
+                                MaxInlinePayloadSize() ) );
+    head.store( read_pos + 1, std::memory_order_release );
+}
 
-    auto open_event_safe_lambda = [&ss]( SECURITY_ATTRIBUTES event_attr,
-                                         const std::string & name ) {
-        auto event = OpenEvent( EVENT_ALL_ACCESS, FALSE, name.c_str() );
-        if ( event == nullptr )
-        {
-            ss << "Failed to open " << name
-               << "event! Error code:" << GetLastError();
+[[maybe_unused]] void engine::SharedMemoryTaskQueue::PostTask(
+    int64_t id, std::function<void( MemoryWriter && )> &&serializer )
+{
+    if ( mHeader == nullptr )
+        return;
+    std::lock_guard producer_lock( mProducerMutex );
 
-            debug::DebugLogger::Log( ss.str(), debug::LogLevel::Error );
-        }
-        else
-        {
-            ss << "Opened " << name << " event";
-            debug::DebugLogger::Log( ss.str(), debug::LogLevel::Info );
-        }
+    if ( mPostedTasks.empty() )
+        mPostedTasks.resize( gPostedTaskBatchSize );
+    if ( mPostedTasksSize + gMaxPostedTaskSize > mPostedTasks.size() )
+        FlushPostedTasksLocked();
 
-        ss.str( "" );
-        return event;
-    };
+    auto *entry = mPostedTasks.data() + mPostedTasksSize;
 
-    auto open_mutex_safe_lambda = [&ss]( SECURITY_ATTRIBUTES event_attr,
-                                         const std::string & name ) {
-        auto mtx = OpenMutex( MUTEX_ALL_ACCESS, FALSE, name.c_str() );
-        if ( mtx == nullptr )
-        {
-            ss << "Failed to open " << name << "mutex"
-               << "Error code:" << GetLastError();
+    MemoryWriter writer( entry + sizeof( PostedTaskHeader ),
+                         gMaxPostedTaskSize - sizeof( PostedTaskHeader ) );
+    serializer( std::move( writer ) );
+    // writer has already reported it
+    if ( writer.Overflowed() )
+        return;
 
-            debug::DebugLogger::Log( ss.str(), debug::LogLevel::Error );
-        }
-        else
-        {
-            ss << "Opened " << name << " mutex";
-            debug::DebugLogger::Log( ss.str(), debug::LogLevel::Info );
-        }
+    uint64_t entry_size = sizeof( PostedTaskHeader ) + writer.Pos();
+    PostedTaskHeader header{ .TaskId = id, .Size = ( entry_size + 7 ) & ~7ull };
+    std::memcpy( entry, &header, sizeof( PostedTaskHeader ) );
+
+    mPostedTasksSize += header.Size;
+    mPostedTaskCount++;
+}
+
+[[maybe_unused]] uint64_t engine::SharedMemoryTaskQueue::SubmitTask(
+    int64_t id, std::function<void( MemoryWriter && )> &&serializer )
+{
+    if ( mHeader == nullptr )
+        return 0;
+    std::lock_guard producer_lock( mProducerMutex );
+
+    FlushPostedTasksLocked();
+    WriteTaskRecord( id, TaskRecordFlags::NoReply, serializer );
+    return mNextSequence - 1;
+}
+
+[[maybe_unused]] bool
+engine::SharedMemoryTaskQueue::IsTaskCompleted( uint64_t sequence ) const
+{
+    if ( mHeader == nullptr )
+        return true;
+    return mHeader->CompletedTasks.Value.load( std::memory_order_acquire ) >
+           sequence;
+}
 
-        ss.str( "" );
-        return mtx;
+[[maybe_unused]] void
+engine::SharedMemoryTaskQueue::WaitForTask( uint64_t sequence )
+{
+    // producer lock is not required, other tasks may be submitted meanwhile
+    auto is_completed = [this, sequence]() {
+        return IsTaskCompleted( sequence );
     };
+    while ( !mCompletionDoorbell.WaitUntil( is_completed, gClientWaitTimeMs ) )
+        PumpClientWindowMessages();
+}
 
-    if ( info.mOwner )
+[[maybe_unused]] engine::OverflowSegmentHeader *
+engine::SharedMemoryTaskQueue::AcquireSegment( uint64_t size )
+{
+    if ( mHeader == nullptr )
+        return nullptr;
+    std::lock_guard producer_lock( mProducerMutex );
+    auto *segment = mOverflowSegments.Acquire(
+        size, UINT64_MAX,
+        mHeader->CompletedTasks.Value.load( std::memory_order_acquire ) );
+    mStats.OverflowMemorySize = mOverflowSegments.TotalSize();
+    return segment;
+}
+
+[[maybe_unused]] void
+engine::SharedMemoryTaskQueue::ReleaseSegment( uint32_t id, uint64_t sequence )
+{
+    if ( mHeader == nullptr )
+        return;
+    std::lock_guard producer_lock( mProducerMutex );
+    mOverflowSegments.Release( id, sequence + 1 );
+}
+
+[[maybe_unused]] engine::OverflowSegmentHeader *
+engine::SharedMemoryTaskQueue::ResolveSegment( uint32_t id )
+{
+    if ( !mReplaySegments.empty() )
     {
-        mTaskStartEvent =
-            create_event_safe_lambda( event_attr, task_start_name );
+        auto segment = mReplaySegments.find( id );
+        if ( segment != mReplaySegments.end() )
+            return segment->second;
+    }
+    if ( mHeader == nullptr )
+        return nullptr;
+    return mOverflowSegments.Resolve( id );
+}
 
-        mTaskFinishEvent =
-            create_event_safe_lambda( event_attr, task_finish_name );
+[[maybe_unused]] void engine::SharedMemoryTaskQueue::TrimOverflowSegments()
+{
+    if ( mHeader == nullptr )
+        return;
+    std::lock_guard producer_lock( mProducerMutex );
+    if ( mOverflowSegments.Trim( mHeader->CompletedTasks.Value.load(
+             std::memory_order_acquire ) ) > 0 )
+        mStats.OverflowMemorySize = mOverflowSegments.TotalSize();
+}
 
-        mExitEvent = create_event_safe_lambda( event_attr, exit_event_name );
+[[maybe_unused]] void engine::SharedMemoryTaskQueue::FlushPostedTasks()
+{
+    if ( mHeader == nullptr )
+        return;
+    std::lock_guard producer_lock( mProducerMutex );
+    FlushPostedTasksLocked();
+}
 
-        mMemoryMutex = create_mutex_safe_lambda( event_attr, task_mutex );
-    }
-    else
+void engine::SharedMemoryTaskQueue::StageTaskChunk( const uint8_t *payload )
+{
+    // record size is aligned, so chunk starts with its exact size
+    uint64_t size;
+    std::memcpy( &size, payload, sizeof( size ) );
+    payload += sizeof( size );
+    mChunkedPayload.insert( mChunkedPayload.end(), payload, payload + size );
+}
+
+void engine::SharedMemoryTaskQueue::ExecuteTaskRecord(
+    const TaskRecordHeader &record, uint8_t *payload, uint64_t inline_size )
+{
+    const bool has_reply = ( record.Flags & TaskRecordFlags::NoReply ) == 0;
+    const bool chunked   = ( record.Flags & TaskRecordFlags::Chunked ) != 0;
+    // client keeps half of the ring reserved until it reads the reply, tasks
+    // without reply own only their record
+    uint64_t reply_capacity = has_reply
+                                  ? MaxInlinePayloadSize()
+                                  : record.Size - sizeof( TaskRecordHeader );
+
+    // reply overwrites the payload, so it's copied before execution and
+    // written after, following records the task has captured; chunked
+    // payload is staged outside of the ring and is captured as is
+    uint64_t capture_time = 0;
+    if ( chunked )
+        StageTaskChunk( payload );
+    if ( IsCapturing() )
     {
-        mTaskStartEvent = open_event_safe_lambda( event_attr, task_start_name );
+        capture_time = mCapture.Now();
+        if ( !chunked )
+            CopyCapturedPayload( record, payload, inline_size );
+    }
 
-        mTaskFinishEvent =
-            open_event_safe_lambda( event_attr, task_finish_name );
+    TaskPayloadSource spilled_payload( mOverflowSegments,
+                                       record.OverflowSegment );
+    ExecuteRegisteredTask(
+        record.TaskId,
+        chunked ? MemoryReader( mChunkedPayload.data(),
+                                mChunkedPayload.size() )
+                : MemoryReader( payload, inline_size, &spilled_payload ),
+        MemoryWriter( payload, reply_capacity ) );
 
-        mExitEvent = open_event_safe_lambda( event_attr, exit_event_name );
+    if ( IsCapturing() )
+    {
+        const auto &captured = chunked ? mChunkedPayload : mCapturedPayload;
+        mCapture.Write( TaskCaptureRecordType::Task,
+                        has_reply ? TaskCaptureRecordFlags::HasReply
+                                  : TaskCaptureRecordFlags{},
+                        record.TaskId, capture_time, captured.data(),
+                        captured.size() );
+    }
 
-        mMemoryMutex = open_mutex_safe_lambda( event_attr, task_mutex );
+    if ( chunked )
+    {
+        mChunkedPayload.clear();
+        if ( mChunkedPayload.capacity() > gMaxRetainedChunkedPayload )
+            mChunkedPayload.shrink_to_fit();
     }
+    if ( has_reply )
+        PushCompletion( record, payload );
 }
-engine::SharedMemoryTaskQueue::~SharedMemoryTaskQueue()
+
+void engine::SharedMemoryTaskQueue::FlushPostedTasksLocked()
 {
-    CloseHandle( mExitEvent );
-    CloseHandle( mMemoryMutex );
-    CloseHandle( mTaskStartEvent );
-    CloseHandle( mTaskFinishEvent );
-    UnmapViewOfFile( mMappedMemory );
-    CloseHandle( mSharedMemory );
+    if ( mPostedTaskCount == 0 )
+        return;
+
+    WriteTaskRecord( SharedMemoryTaskType::POSTED_TASK_BATCH,
+                     TaskRecordFlags::NoReply,
+                     [this]( MemoryWriter &&writer ) {
+                         uint64_t task_count = mPostedTaskCount;
+                         writer.Write( &task_count );
+                         writer.Write( &mPostedTasksSize );
+                         writer.Write( mPostedTasks.data(), mPostedTasksSize );
+                     } );
+
+    mPostedTasksSize = 0;
+    mPostedTaskCount = 0;
 }
 
-[[maybe_unused]] void engine::SharedMemoryTaskQueue::ExecuteTask(
-    int64_t id, std::function<void( MemoryWriter &&reader )> &&serializer,
-    std::function<void( MemoryReader &&writer )> &&deserializer )
+void engine::SharedMemoryTaskQueue::ExecuteTaskBatch( MemoryReader &reader )
 {
-    WaitForSingleObject( mMemoryMutex, INFINITE );
+    auto  task_count = *reader.Read<uint64_t>();
+    auto  batch_size = *reader.Read<uint64_t>();
+    auto *batch      = reader.Read<uint8_t>( batch_size );
 
-    *static_cast<int64_t *>( mMappedMemory ) = id;
-    serializer( static_cast<char *>( mMappedMemory ) + sizeof( int64_t ) );
-    SetEvent( mTaskStartEvent );
+    MemoryReader batch_reader( batch, batch_size );
+    for ( uint64_t i = 0; i < task_count; i++ )
+    {
+        auto  header = *batch_reader.Read<PostedTaskHeader>();
+        auto  size   = header.Size - sizeof( PostedTaskHeader );
+        auto *entry  = batch_reader.Read<uint8_t>( size );
+        // posted tasks have no reply
+        ExecuteRegisteredTask( header.TaskId, MemoryReader( entry, size ),
+                               MemoryWriter( entry, 0 ) );
+    }
+}
 
-    DWORD wait_res = WaitForSingleObject( mTaskFinishEvent, 100 );
-    while ( wait_res == WAIT_TIMEOUT )
+void engine::SharedMemoryTaskQueue::ExecuteRegisteredTask(
+    int64_t id, MemoryReader &&reader, MemoryWriter &&writer )
+{
+    if ( id == SharedMemoryTaskType::POSTED_TASK_BATCH )
     {
-        // skip msgs
-        MSG m;
-        while ( PeekMessage( &m, nullptr, 0, 0, PM_REMOVE ) )
-        {
-            TranslateMessage( &m );
-            DispatchMessage( &m );
-        }
-        wait_res = WaitForSingleObject( mTaskFinishEvent, 100 );
+        ExecuteTaskBatch( reader );
+        return;
+    }
+    auto task = mTaskMap.find( id );
+    if ( task == mTaskMap.end() )
+    {
+        debug::DebugLogger::ErrorFmt( "Unknown shared memory task %lld",
+                                      static_cast<long long>( id ) );
+        return;
+    }
+    if ( task->second->mExecuteStream )
+        task->second->mExecuteStream( std::move( reader ),
+                                      std::move( writer ) );
+    else
+        task->second->mExecute( reader.CurrentAddress() );
+}
+
+void engine::SharedMemoryTaskQueue::CopyCapturedPayload(
+    const TaskRecordHeader &record, const uint8_t *payload,
+    uint64_t inline_size )
+{
+    mCapturedPayload.assign( payload, payload + inline_size );
+    // spilled part is stored right after the inline one, reader doesn't
+    // care where segment boundaries were
+    TaskPayloadSource spilled_payload( mOverflowSegments,
+                                       record.OverflowSegment );
+    MemorySegment     segment{};
+    while ( spilled_payload.Next( segment ) )
+    {
+        const auto *data = static_cast<const uint8_t *>( segment.Memory );
+        mCapturedPayload.insert( mCapturedPayload.end(), data,
+                                 data + segment.Size );
     }
+}
+
+[[maybe_unused]] bool
+engine::SharedMemoryTaskQueue::StartCapture( const std::string &path )
+{
+    return mCapture.Open( path,
+                          mHeader != nullptr ? MaxInlinePayloadSize() : 0 );
+}
+
+[[maybe_unused]] void engine::SharedMemoryTaskQueue::StopCapture()
+{
+    mCapture.Close();
+}
+
+[[maybe_unused]] void engine::SharedMemoryTaskQueue::CaptureSegment(
+    uint32_t id, const void *data, uint64_t size )
+{
+    mCapture.Write( TaskCaptureRecordType::Segment, 0, id, mCapture.Now(),
+                    data, size );
+}
+
+[[maybe_unused]] void engine::SharedMemoryTaskQueue::CaptureMarker(
+    int64_t id, const void *data, uint64_t size )
+{
+    mCapture.Write( TaskCaptureRecordType::Marker, 0, id, mCapture.Now(),
+                    data, size );
+}
+
+[[maybe_unused]] void
+engine::SharedMemoryTaskQueue::ReplayTask( int64_t id, void *payload,
+                                           uint64_t size,
+                                           uint64_t reply_capacity )
+{
+    ExecuteRegisteredTask( id, MemoryReader( payload, size ),
+                           MemoryWriter( payload, reply_capacity ) );
+}
 
-    assert( *static_cast<int64_t *>( mMappedMemory ) == id );
-    deserializer( static_cast<char *>( mMappedMemory ) + sizeof( int64_t ) );
+[[maybe_unused]] void
+engine::SharedMemoryTaskQueue::ReplaySegment( uint32_t               id,
+                                              OverflowSegmentHeader *segment )
+{
+    if ( segment != nullptr )
+        mReplaySegments[id] = segment;
+    else
+        mReplaySegments.erase( id );
+}
+
+uint64_t engine::SharedMemoryTaskQueue::MaxInlinePayloadSize() const
+{
+    // every record reserves half of the ring
+    return mHeader->SubmitRingSize / 2 - sizeof( TaskRecordHeader );
+}
 
-    ReleaseMutex( mMemoryMutex );
+uint64_t engine::SharedMemoryTaskQueue::TaskChunkSize() const
+{
+    // chunk record starts with chunk size
+    return ( std::min )( gTaskChunkSize,
+                         MaxInlinePayloadSize() - sizeof( uint64_t ) );
 }
+
 [[maybe_unused]] void engine::SharedMemoryTaskQueue::TaskLoop()
 {
-    auto idle_time = 1000L;
-    if ( WaitForSingleObject( mTaskStartEvent, idle_time ) == WAIT_OBJECT_0 )
+    TaskLoop( gTaskLoopIdleTimeMs );
+}
+
+[[maybe_unused]] void
+engine::SharedMemoryTaskQueue::TaskLoop( uint32_t idle_time_ms )
+{
+    if ( mHeader == nullptr )
     {
-        int64_t task_id = *static_cast<int64_t *>( mMappedMemory );
-        mTaskMap[task_id]->mExecute( static_cast<char *>( mMappedMemory ) +
-                                     sizeof( int64_t ) );
-        SetEvent( mTaskFinishEvent );
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds( idle_time_ms ) );
+        return;
+    }
+    auto &head = mHeader->SubmitHead.Value;
+    auto &tail = mHeader->SubmitTail.Value;
+
+    uint64_t read_pos  = head.load( std::memory_order_relaxed );
+    auto     has_tasks = [&tail, read_pos]() {
+        return tail.load( std::memory_order_acquire ) != read_pos;
+    };
+    if ( !mTaskDoorbell.WaitUntil( has_tasks, idle_time_ms ) )
+        return;
+
+    const uint64_t ring_size = mHeader->SubmitRingSize;
+    uint64_t       write_pos = tail.load( std::memory_order_acquire );
+
+    // drain every published task
+    while ( read_pos != write_pos )
+    {
+        auto *record = reinterpret_cast<TaskRecordHeader *>(
+            mSubmitRing + read_pos % ring_size );
+        auto record_info = *record;
+
+        if ( ( record_info.Flags & TaskRecordFlags::WrapMarker ) == 0 )
+        {
+            auto *   payload = reinterpret_cast<uint8_t *>( record + 1 );
+            uint64_t inline_size =
+                record_info.OverflowSegment == gNoOverflowSegment
+                    ? record_info.Size - sizeof( TaskRecordHeader )
+                    : record_info.SpillOffset;
+            // chunks are staged until the chunked task itself arrives
+            if ( record_info.TaskId == SharedMemoryTaskType::TASK_CHUNK )
+                StageTaskChunk( payload );
+            else
+                ExecuteTaskRecord( record_info, payload, inline_size );
+            mHeader->CompletedTasks.Value.store( record_info.Sequence + 1,
+                                                 std::memory_order_release );
+        }
+
+        read_pos += record_info.Size;
+        head.store( read_pos, std::memory_order_release );
+        // wakes client waiting for reply, free space or submitted task
+        mCompletionDoorbell.Signal();
+
+        if ( read_pos == write_pos )
+            write_pos = tail.load( std::memory_order_acquire );
     }
 }
+
+[[maybe_unused]] void engine::SharedMemoryTaskQueue::WakeTaskLoop()
+{
+    if ( mHeader != nullptr )
+        mTaskDoorbell.Signal();
+}
+
 [[maybe_unused]] void engine::SharedMemoryTaskQueue::RegisterTask(
     int64_t id, std::unique_ptr<SharedMemoryTask> &&task )
 {
@@ -250,12 +998,21 @@ engine::SharedMemoryTaskQueue::~SharedMemoryTaskQueue()
 
 [[maybe_unused]] void engine::SharedMemoryTaskQueue::WaitForExit()
 {
-    WaitForSingleObject( mExitEvent, INFINITE );
+    if ( mHeader == nullptr )
+        return;
+    auto exit_requested = [this]() {
+        return mHeader->ExitRequested.load( std::memory_order_acquire ) != 0;
+    };
+    while ( !mExitDoorbell.WaitUntil( exit_requested, gDoorbellInfiniteWait ) )
+        ;
 }
 
 [[maybe_unused]] void engine::SharedMemoryTaskQueue::SendExitEvent()
 {
-    SetEvent( mExitEvent );
+    if ( mHeader == nullptr )
+        return;
+    mHeader->ExitRequested.store( 1, std::memory_order_release );
+    mExitDoorbell.Signal();
 }
 
-} // namespace rh::rw
\ No newline at end of file
+} // namespace rh::rw
@@ -5,10 +5,20 @@
 #pragma once
 #include "MemoryReader.h"
 #include "MemoryWriter.h"
+#include "shared_memory_doorbell.h"
+#include "shared_memory_ring.h"
+#include "shared_memory_segment_pool.h"
+#include "task_capture.h"
+#ifdef _WIN32
 #include <Windows.h>
+#endif
 #include <cstdint>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 namespace rh::rw::engine
 {
 struct SharedMemoryTaskQueueInfo
@@ -39,25 +49,67 @@ enum SharedMemoryTaskType : int64_t
     SKINNED_MESH_LOAD,
     SKINNED_MESH_UNLOAD,
     RENDER,
-    RASTER_LOCK
+    RASTER_LOCK,
+    /// Internal task, contains tasks sent with PostTask
+    POSTED_TASK_BATCH,
+    /// Internal task, contains part of the payload of the next chunked task
+    TASK_CHUNK,
+    /// Reserves mesh ids, so client may batch mesh loads
+    MESH_RESERVE,
+    /// Loads several meshes with ids reserved by MESH_RESERVE
+    MESH_LOAD_BATCH
 };
 
 class SharedMemoryTask
 {
   public:
-    explicit SharedMemoryTask( std::function<void( void *memory )> &&execute )
+    /// Handler gets only the part of payload stored inside the task ring
+    using ExecuteFunc = std::function<void( void *memory )>;
+    /// Handler for tasks with payload that may not fit into the task ring,
+    /// reader follows spilled payload segments, writer is bounded by reply
+    /// capacity
+    using ExecuteStreamFunc =
+        std::function<void( MemoryReader &&reader, MemoryWriter &&writer )>;
+
+    explicit SharedMemoryTask( ExecuteFunc &&execute )
         : mExecute( std::move( execute ) )
     {
     }
+    explicit SharedMemoryTask( ExecuteStreamFunc &&execute )
+        : mExecuteStream( std::move( execute ) )
+    {
+    }
 
   private:
-    std::function<void( void *memory )> mExecute;
+    ExecuteFunc       mExecute;
+    ExecuteStreamFunc mExecuteStream;
     friend class SharedMemoryTaskQueue;
 };
 
+struct SharedMemoryQueueStats
+{
+    /// Payload size of the last task, including spilled part
+    uint64_t LastTaskSize = 0;
+    /// Largest task payload size, including spilled part
+    uint64_t LargestTaskSize = 0;
+    /// Tasks that didn't fit into the task ring
+    uint64_t SpilledTaskCount   = 0;
+    /// Tasks sent in chunks with ExecuteChunkedTask
+    uint64_t ChunkedTaskCount   = 0;
+    /// Size of currently mapped overflow segments
+    uint64_t OverflowMemorySize = 0;
+};
+
 constexpr auto EmptySerializer   = []( MemoryWriter && ) {};
 constexpr auto EmptyDeserializer = []( MemoryReader && ) {};
 
+/**
+ * Cross-process task queue.
+ * Tasks are written by client into a lock-free SPSC ring of variable length
+ * records, render driver executes them in order and reports finished tasks
+ * that require a reply through a completion ring. Task replies are written in
+ * place of the task payload.
+ */
 class SharedMemoryTaskQueue
 {
   public:
@@ -71,19 +123,181 @@ class SharedMemoryTaskQueue
         std::function<void( MemoryWriter && )> &&serializer = EmptySerializer,
         std::function<void( MemoryReader && )> &&deserializer =
             EmptyDeserializer );
+    /**
+     * Same as ExecuteTask, but payload is sent to render driver in chunks
+     * while it's serialized, so it may be larger than the whole shared
+     * memory region and never needs overflow segments. Render driver joins
+     * the chunks, task handler gets the whole payload as a single segment.
+     * Memory written before the writer spills stays valid until the next
+     * spill, so a header may be filled after data following it is reserved.
+     */
+    [[maybe_unused]] void ExecuteChunkedTask(
+        int64_t                                  id,
+        std::function<void( MemoryWriter && )> &&serializer,
+        std::function<void( MemoryReader && )> &&deserializer =
+            EmptyDeserializer );
+    /**
+     * Queues a task without reply, e.g. resource unload. Posted tasks are
+     * sent as a single batch right before the next executed task or once
+     * the batch is full, and are executed in the order they were posted.
+     */
+    [[maybe_unused]] void
+    PostTask( int64_t                                  id,
+              std::function<void( MemoryWriter && )> &&serializer );
+    [[maybe_unused]] void FlushPostedTasks();
+    /**
+     * Publishes a task without reply and returns immediately, task payload
+     * stays in the ring until render driver finishes it, so it may be
+     * consumed in place.
+     * @return task sequence number, to be used with WaitForTask
+     */
+    [[maybe_unused]] uint64_t
+    SubmitTask( int64_t                                  id,
+                std::function<void( MemoryWriter && )> &&serializer );
+    /**
+     * Blocks until render driver finishes task with given sequence number
+     * and every task submitted before it
+     */
+    [[maybe_unused]] void WaitForTask( uint64_t sequence );
+    [[maybe_unused]] bool IsTaskCompleted( uint64_t sequence ) const;
     [[maybe_unused]] void TaskLoop();
+    /**
+     * Render driver side, executes published tasks
+     * @param idle_time_ms - max time to wait for a task if none is published
+     */
+    [[maybe_unused]] void TaskLoop( uint32_t idle_time_ms );
+    /**
+     * Render driver side, makes waiting TaskLoop return early, so the
+     * driver thread can serve work queued by other threads
+     */
+    [[maybe_unused]] void WakeTaskLoop();
 
     [[maybe_unused]] void WaitForExit();
     [[maybe_unused]] void SendExitEvent();
 
+    /**
+     * Client side, acquires shared memory segment that outlives a single
+     * task, e.g. frame packet storage. Segment stays owned by client until
+     * ReleaseSegment is called.
+     */
+    [[maybe_unused]] OverflowSegmentHeader *AcquireSegment( uint64_t size );
+    /**
+     * Client side, segment may be reused once task with given sequence
+     * number is completed
+     */
+    [[maybe_unused]] void ReleaseSegment( uint32_t id, uint64_t sequence );
+    /// Render driver side, maps segment acquired by client
+    [[maybe_unused]] OverflowSegmentHeader *ResolveSegment( uint32_t id );
+    /**
+     * Client side, called once per frame, unmaps overflow segments that
+     * stayed idle for gOverflowSegmentIdleTrims frames
+     */
+    [[maybe_unused]] void TrimOverflowSegments();
+
+    /// Client side statistics, may be used to size the shared memory region
+    [[nodiscard]] const SharedMemoryQueueStats &GetStats() const
+    {
+        return mStats;
+    }
+    /// Largest payload that fits into the task ring without spilling
+    [[nodiscard]] uint64_t MaxInlinePayloadSize() const;
+    /// Payload size of a single chunk sent by ExecuteChunkedTask
+    [[nodiscard]] uint64_t TaskChunkSize() const;
+
+    /**
+     * Render driver side, writes every executed task into a capture file, so
+     * the session can be replayed without the game
+     * @return false if capture file can't be created
+     */
+    [[maybe_unused]] bool StartCapture( const std::string &path );
+    [[maybe_unused]] void StopCapture();
+    [[nodiscard]] bool    IsCapturing() const { return mCapture.IsOpen(); }
+    /**
+     * Render driver side, captures segment read by the task being executed,
+     * e.g. frame packet
+     */
+    [[maybe_unused]] void CaptureSegment( uint32_t id, const void *data,
+                                          uint64_t size );
+    /**
+     * Render driver side, captures driver state needed to replay the task
+     * being executed
+     */
+    [[maybe_unused]] void CaptureMarker( int64_t id, const void *data,
+                                         uint64_t size );
+
+    /**
+     * Replay side, executes captured task with registered handler
+     * @param payload - task payload, reply is written in place of it
+     * @param reply_capacity - payload memory size
+     */
+    [[maybe_unused]] void ReplayTask( int64_t id, void *payload,
+                                      uint64_t size, uint64_t reply_capacity );
+    /**
+     * Replay side, segment is resolved from replay memory instead of shared
+     * memory, nullptr removes it
+     */
+    [[maybe_unused]] void ReplaySegment( uint32_t               id,
+                                         OverflowSegmentHeader *segment );
+
   private:
-    void * mMappedMemory{};
+    bool MapSharedMemory( const SharedMemoryTaskQueueInfo &info,
+                          bool &                           created );
+    void UnmapSharedMemory();
+    void InitLayout();
+    bool WaitForLayout();
+
+    uint8_t *WriteTaskRecord(
+        int64_t id, uint32_t flags,
+        const std::function<void( MemoryWriter && )> &serializer );
+    void PushCompletion( const TaskRecordHeader &record,
+                         const uint8_t *         payload );
+    void ExecuteTaskLocked(
+        int64_t id, uint32_t flags,
+        const std::function<void( MemoryWriter && )> &serializer,
+        const std::function<void( MemoryReader && )> &deserializer );
+    void StageTaskChunk( const uint8_t *payload );
+    void ExecuteTaskRecord( const TaskRecordHeader &record, uint8_t *payload,
+                            uint64_t inline_size );
+    void FlushPostedTasksLocked();
+    void ExecuteTaskBatch( MemoryReader &reader );
+    void ExecuteRegisteredTask( int64_t id, MemoryReader &&reader,
+                                MemoryWriter &&writer );
+    void CopyCapturedPayload( const TaskRecordHeader &record,
+                              const uint8_t *payload, uint64_t inline_size );
+
+    void *   mMappedMemory{};
+    uint64_t mMappedSize{};
+#ifdef _WIN32
     HANDLE mSharedMemory{};
-    HANDLE mMemoryMutex{};
-    HANDLE mTaskStartEvent{};
-    HANDLE mTaskFinishEvent{};
-    HANDLE mExitEvent{};
+#else
+    int         mSharedMemory = -1;
+    std::string mSharedMemoryName{};
+    bool        mUnlinkOnClose = false;
+#endif
+    SharedMemoryQueueHeader *mHeader{};
+    uint8_t *                mSubmitRing{};
+    TaskCompletion *         mCompletionRing{};
+    SharedMemoryDoorbell     mTaskDoorbell;
+    SharedMemoryDoorbell     mCompletionDoorbell;
+    SharedMemoryDoorbell     mExitDoorbell;
+    SharedMemorySegmentPool  mOverflowSegments;
+    SharedMemoryQueueStats   mStats{};
+    /// serializes in-process producers, ring itself is single producer
+    std::mutex mProducerMutex;
+    uint64_t   mNextSequence = 0;
+    /// client side batch of posted tasks
+    std::vector<uint8_t> mPostedTasks{};
+    uint64_t             mPostedTasksSize  = 0;
+    uint32_t             mPostedTaskCount  = 0;
+    /// client side chunk buffers, chunk is sent one spill after it's filled
+    std::vector<uint8_t> mChunkBuffers[2]{};
+    /// render driver side payload of the chunked task being received
+    std::vector<uint8_t> mChunkedPayload{};
     std::unordered_map<int64_t, std::unique_ptr<SharedMemoryTask>> mTaskMap;
+    /// render driver side capture of executed tasks
+    TaskCaptureWriter    mCapture;
+    std::vector<uint8_t> mCapturedPayload{};
+    std::unordered_map<uint32_t, OverflowSegmentHeader *> mReplaySegments;
 };
 
 enum class IPCRenderMode
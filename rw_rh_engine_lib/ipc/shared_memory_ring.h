@@ -0,0 +1,153 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+namespace rh::rw::engine
+{
+/**
+ * Layout of SharedMemoryTaskQueue mapped region. It is shared between x86
+ * client and x64 render driver, so it must contain only fixed size types and
+ * offsets, no pointers.
+ *
+ * [SharedMemoryQueueHeader][TaskCompletion ring][task record ring]
+ */
+constexpr uint32_t gSharedMemoryQueueMagic     = 0x51484852; // RHHQ
+constexpr uint32_t gSharedMemoryQueueVersion   = 4;
+constexpr uint64_t gSharedMemoryQueueAlignment = 64;
+constexpr uint64_t gCompletionRingCapacity     = 256;
+
+static_assert( std::atomic<uint64_t>::is_always_lock_free,
+               "64 bit atomics must be lock free to be used across "
+               "processes" );
+static_assert( std::atomic<uint32_t>::is_always_lock_free,
+               "32 bit atomics must be lock free to be used across "
+               "processes" );
+
+constexpr uint64_t AlignSharedMemoryOffset( uint64_t offset )
+{
+    return ( offset + gSharedMemoryQueueAlignment - 1 ) &
+           ~( gSharedMemoryQueueAlignment - 1 );
+}
+
+/**
+ * Wake-up counter, waiters sleep on Counter value(futex) or on named event
+ * with the same name suffix, Waiters is used to skip wake-up syscalls when
+ * nobody sleeps
+ */
+struct alignas( 64 ) SharedMemoryDoorbellState
+{
+    std::atomic<uint32_t> Counter;
+    std::atomic<uint32_t> Waiters;
+};
+
+/**
+ * Monotonic ring position, each cursor is written by a single side only, so
+ * we keep them on separate cache lines
+ */
+struct alignas( 64 ) SharedMemoryRingCursor
+{
+    std::atomic<uint64_t> Value;
+};
+
+struct SharedMemoryQueueHeader
+{
+    std::atomic<uint32_t> Magic;
+    uint32_t              Version;
+    uint64_t              SubmitRingOffset;
+    uint64_t              SubmitRingSize;
+    uint64_t              CompletionRingOffset;
+    uint64_t              CompletionRingCapacity;
+    std::atomic<uint32_t> ExitRequested;
+
+    /// Task ring, tail is written by client, head by render driver
+    SharedMemoryRingCursor SubmitHead;
+    SharedMemoryRingCursor SubmitTail;
+    /// Completion ring, tail is written by render driver, head by client
+    SharedMemoryRingCursor CompletionHead;
+    SharedMemoryRingCursor CompletionTail;
+    /// Sequence of the last executed task + 1, written by render driver
+    SharedMemoryRingCursor CompletedTasks;
+
+    SharedMemoryDoorbellState TaskDoorbell;
+    SharedMemoryDoorbellState CompletionDoorbell;
+    SharedMemoryDoorbellState ExitDoorbell;
+};
+
+enum TaskRecordFlags : uint32_t
+{
+    /// Padding till the end of the ring, reader should skip to ring start
+    WrapMarker = 1,
+    /// Task has no reply, render driver won't write completion
+    NoReply = 2,
+    /// Last part of a task sent in TASK_CHUNK records, payload of the
+    /// preceding chunks goes before the one stored in this record
+    Chunked = 4,
+};
+
+constexpr uint32_t gNoOverflowSegment = 0xFFFFFFFF;
+constexpr uint64_t gNoSpillOffset     = UINT64_MAX;
+
+/**
+ * Variable length task record header, followed by serialized task payload.
+ * Size includes header and is aligned to gSharedMemoryQueueAlignment.
+ * Payload that doesn't fit into the record continues in overflow segments
+ * starting from OverflowSegment, SpillOffset is the amount of payload bytes
+ * stored in the record itself.
+ */
+struct TaskRecordHeader
+{
+    uint64_t Size            = 0;
+    int64_t  TaskId          = 0;
+    uint64_t Sequence        = 0;
+    uint32_t Flags           = 0;
+    uint32_t OverflowSegment = gNoOverflowSegment;
+    uint64_t SpillOffset     = gNoSpillOffset;
+    uint64_t Padding[3]      = {};
+};
+
+/**
+ * Header of on-demand shared memory segment used for task payload overflow,
+ * followed by Capacity bytes of payload. Segments of a single task are
+ * chained through Next, End is the amount of payload bytes stored in this
+ * segment.
+ */
+struct alignas( 64 ) OverflowSegmentHeader
+{
+    uint64_t Capacity = 0;
+    uint64_t End      = gNoSpillOffset;
+    uint32_t Id       = gNoOverflowSegment;
+    uint32_t Next     = gNoOverflowSegment;
+    /// Set by client before it unmaps the segment, render driver unmaps it
+    /// as well
+    uint32_t Retired = 0;
+};
+
+/**
+ * Task completion, reply is written in place of the task payload located at
+ * PayloadOffset from the start of mapped region
+ */
+struct TaskCompletion
+{
+    uint64_t Sequence      = 0;
+    int64_t  TaskId        = 0;
+    uint64_t PayloadOffset = 0;
+    uint64_t Padding       = 0;
+};
+
+/**
+ * Header of a single task inside posted task batch, Size includes header and
+ * is aligned to 8 bytes
+ */
+struct PostedTaskHeader
+{
+    int64_t  TaskId = 0;
+    uint64_t Size   = 0;
+};
+
+static_assert( sizeof( TaskRecordHeader ) == 64 );
+static_assert( sizeof( TaskCompletion ) == 32 );
+
+} // namespace rh::rw::engine
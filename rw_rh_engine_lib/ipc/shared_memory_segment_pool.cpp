@@ -0,0 +1,296 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "shared_memory_segment_pool.h"
+#include <DebugUtils/DebugLogger.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <new>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rh::rw::engine
+{
+
+SharedMemorySegmentPool::SharedMemorySegmentPool( std::string name )
+    : mName( std::move( name ) )
+{
+}
+
+SharedMemorySegmentPool::~SharedMemorySegmentPool()
+{
+    for ( auto &[id, segment] : mSegments )
+    {
+        Unmap( segment );
+#ifndef _WIN32
+        if ( mOwner )
+            shm_unlink( SegmentName( id ).c_str() );
+#endif
+    }
+}
+
+std::string SharedMemorySegmentPool::SegmentName( uint32_t id ) const
+{
+#ifdef _WIN32
+    return mName + "Overflow" + std::to_string( id );
+#else
+    return "/" + mName + "Overflow" + std::to_string( id );
+#endif
+}
+
+OverflowSegmentHeader *SharedMemorySegmentPool::Acquire(
+    uint64_t size, uint64_t busy_until, uint64_t completed_tasks )
+{
+    // best fit among segments that are no longer used by render driver
+    Segment *best = nullptr;
+    for ( auto &[id, segment] : mSegments )
+    {
+        if ( segment.BusyUntil > completed_tasks ||
+             segment.Header->Capacity < size )
+            continue;
+        if ( best == nullptr ||
+             segment.Header->Capacity < best->Header->Capacity )
+            best = &segment;
+    }
+
+    if ( best == nullptr )
+    {
+        if ( mSegments.size() >= gMaxOverflowSegments )
+        {
+            debug::DebugLogger::ErrorFmt(
+                "Failed to allocate %llu bytes overflow segment, all %u "
+                "segments are in use",
+                static_cast<unsigned long long>( size ),
+                gMaxOverflowSegments );
+            return nullptr;
+        }
+        constexpr uint64_t granularity = 1024 * 1024;
+        uint64_t           capacity =
+            ( size + granularity - 1 ) & ~( granularity - 1 );
+        capacity = ( std::max )( capacity, gMinOverflowSegmentSize );
+
+        Segment segment{};
+        if ( !Create( mNextId, capacity, segment ) )
+            return nullptr;
+        best = &( mSegments[mNextId++] = segment );
+    }
+
+    best->BusyUntil    = busy_until;
+    best->LastUse      = mTrimCount;
+    best->Header->End  = gNoSpillOffset;
+    best->Header->Next = gNoOverflowSegment;
+    return best->Header;
+}
+
+void SharedMemorySegmentPool::Release( uint32_t id, uint64_t busy_until )
+{
+    assert( mSegments.contains( id ) );
+    mSegments[id].BusyUntil = busy_until;
+}
+
+uint64_t SharedMemorySegmentPool::Trim( uint64_t completed_tasks )
+{
+    mTrimCount++;
+    uint64_t unmapped_size = 0;
+    for ( auto it = mSegments.begin(); it != mSegments.end(); )
+    {
+        auto &[id, segment] = *it;
+        if ( segment.BusyUntil > completed_tasks ||
+             mTrimCount - segment.LastUse < gOverflowSegmentIdleTrims )
+        {
+            ++it;
+            continue;
+        }
+        debug::DebugLogger::LogFmt(
+            "Unmapped idle %llu bytes overflow segment %s",
+            debug::LogLevel::Info,
+            static_cast<unsigned long long>( segment.MappedSize ),
+            SegmentName( id ).c_str() );
+        // render driver has finished every task that used the segment, so
+        // it's safe to drop
+        segment.Header->Retired = 1;
+        unmapped_size += segment.MappedSize;
+        Unmap( segment );
+#ifndef _WIN32
+        shm_unlink( SegmentName( id ).c_str() );
+#endif
+        it = mSegments.erase( it );
+    }
+    return unmapped_size;
+}
+
+OverflowSegmentHeader *SharedMemorySegmentPool::Resolve( uint32_t id )
+{
+    auto it = mSegments.find( id );
+    if ( it != mSegments.end() )
+        return it->second.Header;
+
+    // new segment may replace segments retired by client
+    DropRetired();
+    if ( mSegments.size() >= gMaxOverflowSegments )
+        return nullptr;
+    Segment segment{};
+    if ( !Open( id, segment ) )
+        return nullptr;
+    return ( mSegments[id] = segment ).Header;
+}
+
+void SharedMemorySegmentPool::DropRetired()
+{
+    for ( auto it = mSegments.begin(); it != mSegments.end(); )
+    {
+        if ( !it->second.Header->Retired )
+        {
+            ++it;
+            continue;
+        }
+        Unmap( it->second );
+        it = mSegments.erase( it );
+    }
+}
+
+uint64_t SharedMemorySegmentPool::TotalSize() const
+{
+    uint64_t size = 0;
+    for ( const auto &[id, segment] : mSegments )
+        size += segment.MappedSize;
+    return size;
+}
+
+uint32_t SharedMemorySegmentPool::SegmentCount() const
+{
+    return static_cast<uint32_t>( mSegments.size() );
+}
+
+bool SharedMemorySegmentPool::Create( uint32_t id, uint64_t capacity,
+                                      Segment &segment )
+{
+    auto     name        = SegmentName( id );
+    uint64_t mapped_size = sizeof( OverflowSegmentHeader ) + capacity;
+    void *   memory      = nullptr;
+    mOwner               = true;
+#ifdef _WIN32
+    segment.Handle = CreateFileMapping(
+        INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+        static_cast<DWORD>( mapped_size >> 32 ),
+        static_cast<DWORD>( mapped_size & 0xFFFFFFFF ), name.c_str() );
+    if ( segment.Handle != nullptr )
+        memory = MapViewOfFile( segment.Handle, FILE_MAP_ALL_ACCESS, 0, 0,
+                                mapped_size );
+    if ( memory == nullptr )
+    {
+        debug::DebugLogger::ErrorFmt(
+            "Failed to create overflow segment %s, error code:%u",
+            name.c_str(), static_cast<uint32_t>( GetLastError() ) );
+        if ( segment.Handle != nullptr )
+            CloseHandle( segment.Handle );
+        segment.Handle = nullptr;
+        return false;
+    }
+#else
+    // segment may be left by a crashed process
+    shm_unlink( name.c_str() );
+    int fd = shm_open( name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600 );
+    if ( fd >= 0 && ftruncate( fd, static_cast<off_t>( mapped_size ) ) == 0 )
+        memory = mmap( nullptr, mapped_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED, fd, 0 );
+    if ( memory == nullptr || memory == MAP_FAILED )
+    {
+        debug::DebugLogger::ErrorFmt(
+            "Failed to create overflow segment %s, error:%s", name.c_str(),
+            std::strerror( errno ) );
+        if ( fd >= 0 )
+        {
+            close( fd );
+            shm_unlink( name.c_str() );
+        }
+        return false;
+    }
+    // mapping stays valid after descriptor is closed
+    close( fd );
+#endif
+    segment.Header     = new ( memory ) OverflowSegmentHeader{};
+    segment.MappedSize = mapped_size;
+    segment.Header->Capacity = capacity;
+    segment.Header->Id       = id;
+
+    debug::DebugLogger::LogFmt( "Created %llu bytes overflow segment %s",
+                                debug::LogLevel::Info,
+                                static_cast<unsigned long long>( mapped_size ),
+                                name.c_str() );
+    return true;
+}
+
+bool SharedMemorySegmentPool::Open( uint32_t id, Segment &segment )
+{
+    auto     name        = SegmentName( id );
+    void *   memory      = nullptr;
+    uint64_t mapped_size = 0;
+#ifdef _WIN32
+    segment.Handle =
+        OpenFileMapping( FILE_MAP_ALL_ACCESS, FALSE, name.c_str() );
+    // zero size maps the whole segment, its size is stored in the header
+    if ( segment.Handle != nullptr )
+        memory =
+            MapViewOfFile( segment.Handle, FILE_MAP_ALL_ACCESS, 0, 0, 0 );
+    if ( memory == nullptr )
+    {
+        debug::DebugLogger::ErrorFmt(
+            "Failed to open overflow segment %s, error code:%u", name.c_str(),
+            static_cast<uint32_t>( GetLastError() ) );
+        if ( segment.Handle != nullptr )
+            CloseHandle( segment.Handle );
+        segment.Handle = nullptr;
+        return false;
+    }
+    mapped_size = sizeof( OverflowSegmentHeader ) +
+                  static_cast<OverflowSegmentHeader *>( memory )->Capacity;
+#else
+    int         fd = shm_open( name.c_str(), O_RDWR, 0600 );
+    struct stat info
+    {
+    };
+    if ( fd >= 0 && fstat( fd, &info ) == 0 )
+    {
+        mapped_size = static_cast<uint64_t>( info.st_size );
+        memory      = mmap( nullptr, mapped_size, PROT_READ | PROT_WRITE,
+                            MAP_SHARED, fd, 0 );
+    }
+    if ( fd >= 0 )
+        close( fd );
+    if ( memory == nullptr || memory == MAP_FAILED )
+    {
+        debug::DebugLogger::ErrorFmt(
+            "Failed to open overflow segment %s, error:%s", name.c_str(),
+            std::strerror( errno ) );
+        return false;
+    }
+#endif
+    segment.Header     = static_cast<OverflowSegmentHeader *>( memory );
+    segment.MappedSize = mapped_size;
+    return true;
+}
+
+void SharedMemorySegmentPool::Unmap( Segment &segment )
+{
+    if ( segment.Header == nullptr )
+        return;
+#ifdef _WIN32
+    UnmapViewOfFile( segment.Header );
+    CloseHandle( segment.Handle );
+    segment.Handle = nullptr;
+#else
+    munmap( segment.Header, segment.MappedSize );
+#endif
+    segment.Header = nullptr;
+}
+
+} // namespace rh::rw::engine
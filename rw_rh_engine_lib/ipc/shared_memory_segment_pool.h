@@ -0,0 +1,98 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include "shared_memory_ring.h"
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace rh::rw::engine
+{
+constexpr uint64_t gMinOverflowSegmentSize = 4 * 1024 * 1024;
+constexpr uint32_t gMaxOverflowSegments    = 64;
+/// Idle segments are unmapped after this many trims
+constexpr uint64_t gOverflowSegmentIdleTrims = 600;
+
+/**
+ * On-demand shared memory segments for task payloads that don't fit into the
+ * task ring. Segments are created by client and opened by render driver on
+ * first use. Segments are unmapped by client once they stay idle, ids
+ * are never reused, so render driver never sees a stale mapping under a
+ * known id and drops retired segments before opening new ones.
+ */
+class SharedMemorySegmentPool
+{
+  public:
+    explicit SharedMemorySegmentPool( std::string name );
+    ~SharedMemorySegmentPool();
+    SharedMemorySegmentPool( const SharedMemorySegmentPool & ) = delete;
+    SharedMemorySegmentPool &
+    operator=( const SharedMemorySegmentPool & ) = delete;
+
+    /**
+     * Client side, returns segment with at least size bytes of capacity that
+     * is not used by unfinished tasks.
+     * @param busy_until - completed task cursor value after which segment
+     * may be reused
+     * @param completed_tasks - current completed task cursor value
+     * @return nullptr if segment can't be created
+     */
+    OverflowSegmentHeader *Acquire( uint64_t size, uint64_t busy_until,
+                                    uint64_t completed_tasks );
+    /**
+     * Client side, changes the moment segment may be reused
+     */
+    void Release( uint32_t id, uint64_t busy_until );
+    /**
+     * Client side, meant to be called once per frame. Unmaps segments of
+     * every size that were not acquired during the last
+     * gOverflowSegmentIdleTrims calls.
+     * @param completed_tasks - current completed task cursor value
+     * @return unmapped size in bytes
+     */
+    uint64_t Trim( uint64_t completed_tasks );
+    /**
+     * Render driver side, returns segment created by client
+     */
+    OverflowSegmentHeader *Resolve( uint32_t id );
+
+    /// Size of currently mapped segments
+    [[nodiscard]] uint64_t TotalSize() const;
+    [[nodiscard]] uint32_t SegmentCount() const;
+
+    static uint8_t *Data( OverflowSegmentHeader *segment )
+    {
+        return reinterpret_cast<uint8_t *>( segment + 1 );
+    }
+
+  private:
+    struct Segment
+    {
+        OverflowSegmentHeader *Header     = nullptr;
+        uint64_t               MappedSize = 0;
+        uint64_t               BusyUntil  = 0;
+        /// Trim counter value of the last Acquire
+        uint64_t               LastUse    = 0;
+#ifdef _WIN32
+        HANDLE Handle = nullptr;
+#endif
+    };
+    bool        Create( uint32_t id, uint64_t capacity, Segment &segment );
+    bool        Open( uint32_t id, Segment &segment );
+    void        Unmap( Segment &segment );
+    /// Render driver side, unmaps segments retired by client
+    void        DropRetired();
+    std::string SegmentName( uint32_t id ) const;
+
+    std::string                           mName;
+    std::unordered_map<uint32_t, Segment> mSegments;
+    uint32_t                              mNextId    = 0;
+    uint64_t                              mTrimCount = 0;
+    bool                                  mOwner     = false;
+};
+
+} // namespace rh::rw::engine
@@ -0,0 +1,164 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "task_capture.h"
+#include <DebugUtils/DebugLogger.h>
+
+namespace rh::rw::engine
+{
+namespace
+{
+/// Larger records are treated as corrupted capture
+constexpr uint64_t gMaxRecordSize = 1ull << 32;
+} // namespace
+
+TaskCaptureWriter::~TaskCaptureWriter() { Close(); }
+
+bool TaskCaptureWriter::Open( const std::string &path,
+                              uint64_t           reply_capacity )
+{
+    Close();
+    mFile.open( path, std::ios::out | std::ios::binary | std::ios::trunc );
+    if ( !mFile.is_open() )
+    {
+        debug::DebugLogger::ErrorFmt( "Failed to create task capture %s",
+                                      path.c_str() );
+        return false;
+    }
+    TaskCaptureFileHeader header{ .ReplyCapacity = reply_capacity };
+    mFile.write( reinterpret_cast<const char *>( &header ), sizeof( header ) );
+
+    mPath        = path;
+    mStart       = std::chrono::steady_clock::now();
+    mRecordCount = 0;
+    mRawSize     = 0;
+    mStoredSize  = 0;
+    debug::DebugLogger::LogFormat( debug::LogLevel::Info,
+                                   "Task capture started: %s", path.c_str() );
+    return true;
+}
+
+void TaskCaptureWriter::Close()
+{
+    if ( !mFile.is_open() )
+        return;
+    mFile.close();
+    debug::DebugLogger::LogFormat(
+        debug::LogLevel::Info,
+        "Task capture %s finished: %llu records, %llu KB of payload stored in "
+        "%llu KB",
+        mPath.c_str(),
+        static_cast<unsigned long long>( mRecordCount ),
+        static_cast<unsigned long long>( mRawSize / 1024 ),
+        static_cast<unsigned long long>( mStoredSize / 1024 ) );
+}
+
+uint64_t TaskCaptureWriter::Now() const
+{
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - mStart )
+            .count() );
+}
+
+void TaskCaptureWriter::Write( TaskCaptureRecordType type, uint32_t flags,
+                               int64_t id, uint64_t time, const void *data,
+                               uint64_t size )
+{
+    if ( !mFile.is_open() )
+        return;
+    const auto *bytes = static_cast<const uint8_t *>( data );
+
+    mStored.clear();
+    mEncoder.Compress( bytes, size, mStored );
+    // incompressible data is stored as is
+    const bool compressed = mStored.size() < size;
+    if ( compressed )
+        flags |= TaskCaptureRecordFlags::LzCompressed;
+    else
+        flags &= ~TaskCaptureRecordFlags::LzCompressed;
+
+    TaskCaptureRecordHeader header{
+        .Type       = type,
+        .Flags      = flags,
+        .Id         = id,
+        .Time       = time,
+        .Size       = size,
+        .StoredSize = compressed ? mStored.size() : size };
+    mFile.write( reinterpret_cast<const char *>( &header ), sizeof( header ) );
+    mFile.write( compressed ? reinterpret_cast<const char *>( mStored.data() )
+                            : reinterpret_cast<const char *>( bytes ),
+                 static_cast<std::streamsize>( header.StoredSize ) );
+    if ( !mFile )
+    {
+        debug::DebugLogger::ErrorFmt(
+            "Failed to write task capture %s, capture stopped",
+            mPath.c_str() );
+        Close();
+        return;
+    }
+    mRecordCount++;
+    mRawSize += size;
+    mStoredSize += header.StoredSize;
+}
+
+bool TaskCaptureReader::Open( const std::string &path )
+{
+    mFile.open( path, std::ios::in | std::ios::binary );
+    if ( !mFile.is_open() )
+    {
+        debug::DebugLogger::ErrorFmt( "Failed to open task capture %s",
+                                      path.c_str() );
+        return false;
+    }
+    mFile.read( reinterpret_cast<char *>( &mHeader ), sizeof( mHeader ) );
+    if ( !mFile || mHeader.Magic != gTaskCaptureMagic ||
+         mHeader.Version != gTaskCaptureVersion )
+    {
+        debug::DebugLogger::ErrorFmt(
+            "%s is not a task capture or has unsupported version",
+            path.c_str() );
+        mFile.close();
+        return false;
+    }
+    return true;
+}
+
+bool TaskCaptureReader::Next( TaskCaptureRecord &record )
+{
+    if ( !mFile.is_open() )
+        return false;
+    auto &header = record.Header;
+    mFile.read( reinterpret_cast<char *>( &header ), sizeof( header ) );
+    if ( !mFile )
+        return false;
+    const bool compressed =
+        ( header.Flags & TaskCaptureRecordFlags::LzCompressed ) != 0;
+    if ( header.Size > gMaxRecordSize || header.StoredSize > gMaxRecordSize ||
+         ( !compressed && header.StoredSize != header.Size ) )
+    {
+        debug::DebugLogger::Error( "Task capture record is corrupted" );
+        return false;
+    }
+
+    record.Data.resize( header.Size );
+    auto &stored = compressed ? mStored : record.Data;
+    stored.resize( header.StoredSize );
+    mFile.read( reinterpret_cast<char *>( stored.data() ),
+                static_cast<std::streamsize>( header.StoredSize ) );
+    if ( !mFile )
+    {
+        debug::DebugLogger::Error( "Task capture is truncated" );
+        return false;
+    }
+    if ( compressed && !LzDecompress( mStored.data(), mStored.size(),
+                                      record.Data.data(), header.Size ) )
+    {
+        debug::DebugLogger::Error( "Task capture record is corrupted" );
+        return false;
+    }
+    return true;
+}
+
+} // namespace rh::rw::engine
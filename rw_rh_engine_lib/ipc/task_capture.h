@@ -0,0 +1,127 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include "lz_block_codec.h"
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace rh::rw::engine
+{
+constexpr uint32_t gTaskCaptureMagic   = 0x43544852; // RHTC
+constexpr uint32_t gTaskCaptureVersion = 2;
+
+struct TaskCaptureFileHeader
+{
+    uint32_t Magic   = gTaskCaptureMagic;
+    uint32_t Version = gTaskCaptureVersion;
+    /// Reply capacity of tasks with reply at capture time
+    uint64_t ReplyCapacity = 0;
+};
+
+enum class TaskCaptureRecordType : uint32_t
+{
+    /// Task payload as render driver received it
+    Task,
+    /// Shared memory segment used by the next task
+    Segment,
+    /// Render driver state needed to replay the next task
+    Marker
+};
+
+enum TaskCaptureRecordFlags : uint32_t
+{
+    /// Record data is compressed with LzBlockEncoder
+    LzCompressed = 1,
+    /// Task reply is written in place of the payload
+    HasReply = 2
+};
+
+enum TaskCaptureMarkerType : int64_t
+{
+    /// Resources destroyed by render driver GC while executing the next task
+    GC_PROGRESS = 1,
+    /// Resource ids reserved by asset streamer for streamed uploads
+    ASSET_RESERVE,
+    /// Streamed asset payload uploaded into reserved resource id
+    ASSET_UPLOAD,
+    /// Reserved resource ids freed by asset streamer without upload
+    ASSET_FREE
+};
+
+struct TaskCaptureRecordHeader
+{
+    TaskCaptureRecordType Type  = TaskCaptureRecordType::Task;
+    uint32_t              Flags = 0;
+    /// Task, segment or marker id
+    int64_t               Id = 0;
+    /// Microseconds since capture start
+    uint64_t              Time = 0;
+    uint64_t              Size = 0;
+    /// Size of data stored in file
+    uint64_t              StoredSize = 0;
+};
+
+struct TaskCaptureRecord
+{
+    TaskCaptureRecordHeader Header{};
+    std::vector<uint8_t>    Data{};
+};
+
+/**
+ * Writes tasks executed by render driver into a capture file. Records that
+ * belong to a task, like segments it reads, are written before the task
+ * record itself.
+ */
+class TaskCaptureWriter
+{
+  public:
+    ~TaskCaptureWriter();
+
+    /// @return false if file can't be created
+    bool Open( const std::string &path, uint64_t reply_capacity );
+    /// Logs capture statistics and closes the file
+    void Close();
+    [[nodiscard]] bool IsOpen() const { return mFile.is_open(); }
+
+    /// Microseconds since capture start
+    [[nodiscard]] uint64_t Now() const;
+
+    void Write( TaskCaptureRecordType type, uint32_t flags, int64_t id,
+                uint64_t time, const void *data, uint64_t size );
+
+  private:
+    std::ofstream                         mFile;
+    std::string                           mPath;
+    LzBlockEncoder                        mEncoder;
+    std::vector<uint8_t>                  mStored;
+    std::chrono::steady_clock::time_point mStart;
+    uint64_t                              mRecordCount = 0;
+    uint64_t                              mRawSize     = 0;
+    uint64_t                              mStoredSize  = 0;
+};
+
+class TaskCaptureReader
+{
+  public:
+    /// @return false if file can't be opened or has unsupported version
+    bool Open( const std::string &path );
+
+    [[nodiscard]] const TaskCaptureFileHeader &Header() const
+    {
+        return mHeader;
+    }
+
+    /// @return false at the end of capture or if capture is corrupted
+    bool Next( TaskCaptureRecord &record );
+
+  private:
+    std::ifstream         mFile;
+    TaskCaptureFileHeader mHeader{};
+    std::vector<uint8_t>  mStored;
+};
+
+} // namespace rh::rw::engine
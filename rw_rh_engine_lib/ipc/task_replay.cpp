@@ -0,0 +1,122 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "task_replay.h"
+#include "shared_memory_queue_client.h"
+#include <DebugUtils/DebugLogger.h>
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace rh::rw::engine
+{
+
+TaskReplay::TaskReplay( SharedMemoryTaskQueue &task_queue )
+    : mTaskQueue( task_queue )
+{
+}
+
+TaskReplay::~TaskReplay()
+{
+    for ( const auto &[id, segment] : mSegments )
+        mTaskQueue.ReplaySegment( id, nullptr );
+}
+
+bool TaskReplay::Open( const std::string &path )
+{
+    return mReader.Open( path );
+}
+
+void TaskReplay::SetMarkerHandler( MarkerHandler &&handler )
+{
+    mMarkerHandler = std::move( handler );
+}
+
+void TaskReplay::SetTaskPatcher( TaskPatcher &&patcher )
+{
+    mTaskPatcher = std::move( patcher );
+}
+
+bool TaskReplay::ReplayNextTask( bool realtime )
+{
+    while ( mReader.Next( mRecord ) )
+    {
+        const auto &header = mRecord.Header;
+        switch ( header.Type )
+        {
+        case TaskCaptureRecordType::Segment: StoreSegment( mRecord ); break;
+        case TaskCaptureRecordType::Marker:
+            if ( mMarkerHandler )
+                mMarkerHandler( header.Id, mRecord.Data );
+            break;
+        case TaskCaptureRecordType::Task:
+        {
+            const bool has_reply =
+                ( header.Flags & TaskCaptureRecordFlags::HasReply ) != 0;
+            // tasks with reply may write up to reply capacity in place
+            const uint64_t capacity =
+                has_reply ? ( std::max )( header.Size,
+                                          mReader.Header().ReplyCapacity )
+                          : header.Size;
+            mPayload.resize( ( capacity + sizeof( uint64_t ) - 1 ) /
+                             sizeof( uint64_t ) );
+            auto *payload = reinterpret_cast<uint8_t *>( mPayload.data() );
+            std::memcpy( payload, mRecord.Data.data(), header.Size );
+            if ( mTaskPatcher )
+                mTaskPatcher( header.Id,
+                              std::span<uint8_t>( payload, header.Size ) );
+
+            if ( realtime )
+                WaitForTaskTime( header.Time );
+            mTaskQueue.ReplayTask( header.Id, payload, header.Size,
+                                   capacity );
+            mLastTaskId = header.Id;
+            mTaskCount++;
+            return true;
+        }
+        default:
+            debug::DebugLogger::ErrorFmt(
+                "Unknown task capture record type %u, replay stopped",
+                static_cast<uint32_t>( header.Type ) );
+            return false;
+        }
+    }
+    return false;
+}
+
+void TaskReplay::StoreSegment( const TaskCaptureRecord &record )
+{
+    const auto id = static_cast<uint32_t>( record.Header.Id );
+    const auto size = record.Header.Size;
+    auto &     segment = mSegments[id];
+    // segment is reused by later tasks, same as in shared memory
+    const auto block_count =
+        1 + ( size + sizeof( OverflowSegmentHeader ) - 1 ) /
+                sizeof( OverflowSegmentHeader );
+    if ( segment.size() < block_count )
+        segment.resize( block_count );
+
+    auto &segment_header    = segment.front();
+    segment_header.Id       = id;
+    segment_header.Capacity = ( segment.size() - 1 ) *
+                              sizeof( OverflowSegmentHeader );
+    segment_header.End      = size;
+    std::memcpy( SharedMemorySegmentPool::Data( &segment_header ),
+                 record.Data.data(), size );
+    mTaskQueue.ReplaySegment( id, &segment_header );
+}
+
+void TaskReplay::WaitForTaskTime( uint64_t time )
+{
+    if ( mTaskCount == 0 )
+    {
+        mStart         = std::chrono::steady_clock::now();
+        mFirstTaskTime = time;
+        return;
+    }
+    std::this_thread::sleep_until(
+        mStart + std::chrono::microseconds( time - mFirstTaskTime ) );
+}
+
+} // namespace rh::rw::engine
@@ -0,0 +1,76 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include "shared_memory_ring.h"
+#include "task_capture.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace rh::rw::engine
+{
+class SharedMemoryTaskQueue;
+
+/**
+ * Feeds captured tasks into handlers registered in task queue, in the same
+ * order render driver executed them during capture
+ */
+class TaskReplay
+{
+  public:
+    /// Applies render driver state recorded for the next task
+    using MarkerHandler =
+        std::function<void( int64_t id, std::span<const uint8_t> data )>;
+    /// Allows to replace capture specific payload data, e.g. window handle
+    using TaskPatcher =
+        std::function<void( int64_t id, std::span<uint8_t> payload )>;
+
+    explicit TaskReplay( SharedMemoryTaskQueue &task_queue );
+    ~TaskReplay();
+    TaskReplay( const TaskReplay & ) = delete;
+    TaskReplay &operator=( const TaskReplay & ) = delete;
+
+    bool Open( const std::string &path );
+
+    void SetMarkerHandler( MarkerHandler &&handler );
+    void SetTaskPatcher( TaskPatcher &&patcher );
+
+    /**
+     * Executes the next captured task, segments and markers recorded with it
+     * are applied first
+     * @param realtime - waits until task was executed during capture,
+     * relative to the first replayed task
+     * @return false at the end of capture
+     */
+    bool ReplayNextTask( bool realtime );
+
+    /// Task id of the last replayed task
+    [[nodiscard]] int64_t LastTaskId() const { return mLastTaskId; }
+    [[nodiscard]] uint64_t TaskCount() const { return mTaskCount; }
+
+  private:
+    void StoreSegment( const TaskCaptureRecord &record );
+    void WaitForTaskTime( uint64_t time );
+
+    SharedMemoryTaskQueue &mTaskQueue;
+    TaskCaptureReader      mReader;
+    TaskCaptureRecord      mRecord;
+    MarkerHandler          mMarkerHandler;
+    TaskPatcher            mTaskPatcher;
+    /// Task payload, reply is written in place of it
+    std::vector<uint64_t>  mPayload;
+    /// Segment header followed by segment data
+    std::unordered_map<uint32_t, std::vector<OverflowSegmentHeader>>
+                                          mSegments;
+    std::chrono::steady_clock::time_point mStart;
+    uint64_t                              mFirstTaskTime = 0;
+    uint64_t                              mTaskCount     = 0;
+    int64_t                               mLastTaskId    = 0;
+};
+
+} // namespace rh::rw::engine
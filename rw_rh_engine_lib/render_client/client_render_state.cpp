@@ -2,4 +2,42 @@
 // Created by peter on 10.02.2021.
 //
 
-#include "client_render_state.h"
\ No newline at end of file
+#include "client_render_state.h"
+#include "frame_packet_arena.h"
+
+namespace rh::rw::engine
+{
+
+uint64_t ClientRenderState::FramePacketSize() const
+{
+    // arrays that outgrow their capacity are moved within the packet, so
+    // headroom lets them double once without dropping entries
+    constexpr uint64_t growth_headroom = 2;
+    return ( Im2D.PacketSize() + Im3D.PacketSize() +
+             MeshDrawCalls.PacketSize() + SkinMeshDrawCalls.PacketSize() +
+             Lights.PacketSize() ) *
+           growth_headroom;
+}
+
+void ClientRenderState::BeginFrame( FramePacketArena &arena )
+{
+    // recorders allocate their buffers even if packet is not available, so
+    // they don't keep pointers into the previous frame packet
+    arena.Begin( FramePacketSize() );
+    Lights.BeginFrame( arena );
+    Im2D.BeginFrame( arena );
+    Im3D.BeginFrame( arena );
+    MeshDrawCalls.BeginFrame( arena );
+    SkinMeshDrawCalls.BeginFrame( arena );
+}
+
+void ClientRenderState::LogPeakUsage() const
+{
+    Lights.LogPeakUsage();
+    Im2D.LogPeakUsage();
+    Im3D.LogPeakUsage();
+    MeshDrawCalls.LogPeakUsage();
+    SkinMeshDrawCalls.LogPeakUsage();
+}
+
+} // namespace rh::rw::engine
\ No newline at end of file
@@ -14,10 +14,19 @@
 
 namespace rh::rw::engine
 {
+class FramePacketArena;
 
 class ClientRenderState
 {
   public:
+    /// Size of frame packet that fits every recorder array at its current
+    /// capacity with room to grow
+    [[nodiscard]] uint64_t FramePacketSize() const;
+    /// Starts recording of the next frame into the frame packet
+    void BeginFrame( FramePacketArena &arena );
+    /// Logs peak usage of recorder arrays
+    void LogPeakUsage() const;
+
     ImGuiInputState           ImGuiInputState{};
     MainViewportState         ViewportState;
     SkyState                  SkyState;
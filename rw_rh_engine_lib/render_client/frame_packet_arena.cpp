@@ -0,0 +1,90 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "frame_packet_arena.h"
+#include <DebugUtils/DebugLogger.h>
+#include <ipc/shared_memory_queue_client.h>
+#include <ipc/shared_memory_segment_pool.h>
+
+namespace rh::rw::engine
+{
+
+FramePacketArena::FramePacketArena( SharedMemoryTaskQueue &task_queue )
+    : TaskQueue( task_queue )
+{
+}
+
+bool FramePacketArena::Begin( uint64_t size )
+{
+    Offset              = 0;
+    ReportedOutOfMemory = false;
+    if ( SegmentId != gNoOverflowSegment )
+        return true;
+
+    auto *segment = TaskQueue.AcquireSegment( size );
+    if ( segment == nullptr )
+    {
+        debug::DebugLogger::ErrorFmt(
+            "Failed to acquire %llu bytes frame packet, frame will be empty",
+            static_cast<unsigned long long>( size ) );
+        Base     = nullptr;
+        Capacity = 0;
+        return false;
+    }
+    Base      = SharedMemorySegmentPool::Data( segment );
+    Capacity  = segment->Capacity;
+    SegmentId = segment->Id;
+    return true;
+}
+
+void FramePacketArena::End( uint64_t frame_sequence )
+{
+    if ( SegmentId == gNoOverflowSegment )
+        return;
+    TaskQueue.ReleaseSegment( SegmentId, frame_sequence );
+    SegmentId = gNoOverflowSegment;
+    Base      = nullptr;
+    Capacity  = 0;
+    Offset    = 0;
+}
+
+void *FramePacketArena::AllocateBytes( uint64_t size )
+{
+    if ( size == 0 )
+        return nullptr;
+    uint64_t aligned_size =
+        ( size + gFramePacketAlignment - 1 ) & ~( gFramePacketAlignment - 1 );
+    if ( Base == nullptr || aligned_size > Capacity - Offset )
+    {
+        if ( !ReportedOutOfMemory )
+            debug::DebugLogger::ErrorFmt(
+                "Frame packet is out of memory: failed to allocate %llu "
+                "bytes, %llu of %llu bytes used",
+                static_cast<unsigned long long>( size ),
+                static_cast<unsigned long long>( Offset ),
+                static_cast<unsigned long long>( Capacity ) );
+        ReportedOutOfMemory = true;
+        return nullptr;
+    }
+    void *memory = Base + Offset;
+    Offset += aligned_size;
+    return memory;
+}
+
+FramePacketSection FramePacketArena::Section( const void *data,
+                                              uint64_t    count ) const
+{
+    if ( data == nullptr || count == 0 )
+        return {};
+    return { static_cast<uint64_t>( static_cast<const uint8_t *>( data ) -
+                                    Base ),
+             count };
+}
+
+FramePacketHeader FramePacketArena::Header() const
+{
+    return { .SegmentId = SegmentId, .Size = Offset };
+}
+
+} // namespace rh::rw::engine
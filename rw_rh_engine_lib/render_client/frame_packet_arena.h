@@ -0,0 +1,70 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include <data_desc/frame_packet.h>
+#include <cstdint>
+#include <span>
+
+namespace rh::rw::engine
+{
+class SharedMemoryTaskQueue;
+
+constexpr uint64_t gFramePacketAlignment = 64;
+
+/**
+ * Bump allocator over the frame packet segment, recorders allocate their
+ * per-frame arrays in it so frame data is written into shared memory only
+ * once. Packet segment stays in use by render driver until the frame task is
+ * completed, so the next frame is recorded into another segment.
+ */
+class FramePacketArena
+{
+  public:
+    explicit FramePacketArena( SharedMemoryTaskQueue &task_queue );
+
+    /**
+     * Acquires packet segment for the next frame
+     * @return false if segment can't be acquired, every allocation fails then
+     */
+    bool Begin( uint64_t size );
+    /**
+     * Hands current packet over to render driver
+     * @param frame_sequence - sequence of the last task reading the packet
+     */
+    void End( uint64_t frame_sequence );
+
+    /**
+     * @return empty span if packet is out of memory
+     */
+    template <typename T> std::span<T> Allocate( uint64_t count )
+    {
+        auto *memory = AllocateBytes( sizeof( T ) * count );
+        if ( memory == nullptr )
+            return {};
+        return std::span<T>( static_cast<T *>( memory ), count );
+    }
+
+    [[nodiscard]] FramePacketSection Section( const void *data,
+                                              uint64_t    count ) const;
+    [[nodiscard]] FramePacketHeader  Header() const;
+
+    /// Size of an array allocated in packet including alignment
+    template <typename T> static constexpr uint64_t SizeOf( uint64_t count )
+    {
+        return ( sizeof( T ) * count + gFramePacketAlignment - 1 ) &
+               ~( gFramePacketAlignment - 1 );
+    }
+
+  private:
+    void *AllocateBytes( uint64_t size );
+
+    SharedMemoryTaskQueue &TaskQueue;
+    uint8_t *              Base                = nullptr;
+    uint64_t               Capacity            = 0;
+    uint64_t               Offset              = 0;
+    uint32_t               SegmentId           = gNoOverflowSegment;
+    bool                   ReportedOutOfMemory = false;
+};
+
+} // namespace rh::rw::engine
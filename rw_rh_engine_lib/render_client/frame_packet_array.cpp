@@ -0,0 +1,40 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "frame_packet_array.h"
+#include <DebugUtils/DebugLogger.h>
+
+namespace rh::rw::engine
+{
+
+FramePacketArrayBase::FramePacketArrayBase( const char *name,
+                                            uint64_t    initial_capacity )
+    : Name( name ), NextCapacity( initial_capacity )
+{
+}
+
+uint64_t FramePacketArrayBase::Grow( uint64_t required )
+{
+    // array may be smaller than its capacity if packet was out of memory at
+    // the beginning of the frame
+    if ( required <= NextCapacity )
+        return NextCapacity;
+    NextCapacity = GrowCapacity( NextCapacity, required );
+    debug::DebugLogger::LogFormat(
+        debug::LogLevel::Info,
+        "Frame packet array \"%s\" grown to %llu entries", Name,
+        static_cast<unsigned long long>( NextCapacity ) );
+    return NextCapacity;
+}
+
+void FramePacketArrayBase::LogPeakUsage() const
+{
+    debug::DebugLogger::LogFormat(
+        debug::LogLevel::Info,
+        "Frame packet array \"%s\" peak usage: %llu of %llu entries", Name,
+        static_cast<unsigned long long>( PeakCount ),
+        static_cast<unsigned long long>( NextCapacity ) );
+}
+
+} // namespace rh::rw::engine
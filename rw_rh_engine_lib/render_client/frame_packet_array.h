@@ -0,0 +1,124 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include "frame_packet_arena.h"
+#include <algorithm>
+#include <cstdint>
+#include <data_desc/capacity_policy.h>
+#include <span>
+
+namespace rh::rw::engine
+{
+
+/**
+ * Type independent part of FramePacketArray, keeps capacity and usage
+ * counters
+ */
+class FramePacketArrayBase
+{
+  public:
+    /// Entry count allocated at the beginning of a frame
+    [[nodiscard]] uint64_t Capacity() const { return NextCapacity; }
+    /// Recorded entry count
+    [[nodiscard]] uint64_t Size() const { return Count; }
+    /// Most entries requested within a single frame
+    [[nodiscard]] uint64_t Peak() const { return PeakCount; }
+    /// Logs peak entry count against capacity, used to tune initial capacity
+    void                   LogPeakUsage() const;
+
+  protected:
+    FramePacketArrayBase( const char *name, uint64_t initial_capacity );
+
+    /**
+     * Applies capacity policy to the requested entry count, new capacity is
+     * used by the following frames as well
+     * @return entry count to allocate
+     */
+    uint64_t Grow( uint64_t required );
+
+    const char *Name;
+    uint64_t    NextCapacity;
+    uint64_t    Count     = 0;
+    uint64_t    PeakCount = 0;
+};
+
+/**
+ * Array recorded into the frame packet that grows instead of dropping
+ * entries. Full array is moved into a larger allocation in the same packet,
+ * if packet is out of memory too the entries are dropped for current frame
+ * only, since the next packet is sized by grown capacity.
+ * @tparam T - trivially copyable entry type
+ */
+template <typename T> class FramePacketArray : public FramePacketArrayBase
+{
+  public:
+    FramePacketArray( const char *name, uint64_t initial_capacity )
+        : FramePacketArrayBase( name, initial_capacity )
+    {
+    }
+
+    /// Allocates array in the packet, discards recorded entries
+    void Begin( FramePacketArena &arena )
+    {
+        Arena   = &arena;
+        Entries = arena.Allocate<T>( NextCapacity );
+        Count   = 0;
+    }
+
+    /**
+     * Makes room for count more entries, moves recorded entries if array
+     * has to grow, so pointers into the array are invalidated
+     * @return false if entries don't fit into the packet
+     */
+    bool Reserve( uint64_t count )
+    {
+        const auto required = Count + count;
+        PeakCount           = ( std::max )( PeakCount, required );
+        if ( required <= Entries.size() )
+            return true;
+        if ( Arena == nullptr )
+            return false;
+        auto grown = Arena->template Allocate<T>( Grow( required ) );
+        if ( grown.empty() )
+            return false;
+        std::copy_n( Entries.data(), Count, grown.data() );
+        Entries = grown;
+        return true;
+    }
+
+    /// Room after recorded entries, count entries must be reserved
+    std::span<T> Tail( uint64_t count )
+    {
+        return Entries.subspan( Count, count );
+    }
+    /// Records count entries, count entries must be reserved
+    std::span<T> Append( uint64_t count )
+    {
+        auto entries = Entries.subspan( Count, count );
+        Count += count;
+        return entries;
+    }
+    void Clear() { Count = 0; }
+
+    T       &operator[]( uint64_t idx ) { return Entries[idx]; }
+    const T &operator[]( uint64_t idx ) const { return Entries[idx]; }
+    T       *Data() { return Entries.data(); }
+
+    [[nodiscard]] FramePacketSection
+    Section( const FramePacketArena &arena ) const
+    {
+        return arena.Section( Entries.data(), Count );
+    }
+    /// Packet memory needed for the array at current capacity
+    [[nodiscard]] uint64_t PacketSize() const
+    {
+        return FramePacketArena::SizeOf<T>( NextCapacity );
+    }
+
+  private:
+    FramePacketArena *Arena = nullptr;
+    std::span<T>      Entries{};
+};
+
+} // namespace rh::rw::engine
@@ -4,6 +4,7 @@
 
 #include "im2d_state_recorder.h"
 #include "data_desc/immediate_mode/im_state.h"
+#include <data_desc/frame_packet.h>
 #include <ipc/MemoryReader.h>
 #include <ipc/MemoryWriter.h>
 
@@ -11,32 +12,52 @@ namespace rh::rw::engine
 {
 namespace
 {
-constexpr auto Im2DVertexCountLimit = 100000;
-constexpr auto Im2DIndexCountLimit  = 100000;
+constexpr uint64_t Im2DVertexInitialCapacity   = 100000;
+constexpr uint64_t Im2DIndexInitialCapacity    = 100000;
+constexpr uint64_t Im2DDrawCallInitialCapacity = 4000;
 } // namespace
 Im2DStateRecorder::Im2DStateRecorder( ImmediateState &im_state ) noexcept
-    : ImState{ im_state }
+    : ImState{ im_state },
+      DrawCalls( "im2d draw calls", Im2DDrawCallInitialCapacity ),
+      VertexBuffer( "im2d vertices", Im2DVertexInitialCapacity ),
+      IndexBuffer( "im2d indices", Im2DIndexInitialCapacity )
 {
-    VertexBuffer.resize( Im2DVertexCountLimit );
-    IndexBuffer.resize( Im2DIndexCountLimit );
-    DrawCalls.resize( 4000 );
-    DrawCallCount = 0;
-    VertexCount   = 0;
-    IndexCount    = 0;
 }
 
 Im2DStateRecorder::~Im2DStateRecorder() noexcept = default;
 
+uint64_t Im2DStateRecorder::PacketSize() const
+{
+    return VertexBuffer.PacketSize() + IndexBuffer.PacketSize() +
+           DrawCalls.PacketSize();
+}
+
+void Im2DStateRecorder::LogPeakUsage() const
+{
+    VertexBuffer.LogPeakUsage();
+    IndexBuffer.LogPeakUsage();
+    DrawCalls.LogPeakUsage();
+}
+
+void Im2DStateRecorder::BeginFrame( FramePacketArena &arena )
+{
+    VertexBuffer.Begin( arena );
+    IndexBuffer.Begin( arena );
+    DrawCalls.Begin( arena );
+}
+
 void Im2DStateRecorder::RecordDrawCall( RwIm2DVertex *vertices,
                                         int32_t       num_vertices )
 {
-    auto &result_dc = DrawCalls[DrawCallCount];
+    // draw calls are dropped only if packet is out of memory
+    if ( !DrawCalls.Reserve( 1 ) || !VertexBuffer.Reserve( num_vertices ) )
+        return;
+    auto &result_dc = DrawCalls.Append( 1 )[0];
     auto &im_state  = ImState;
 
-    result_dc.VertexBufferOffset = VertexCount;
-    CopyMemory( ( VertexBuffer.data() + VertexCount ), vertices,
+    result_dc.VertexBufferOffset = static_cast<uint32_t>( VertexBuffer.Size() );
+    CopyMemory( VertexBuffer.Append( num_vertices ).data(), vertices,
                 num_vertices * sizeof( RwIm2DVertex ) );
-    VertexCount += num_vertices;
 
     result_dc.VertexCount       = num_vertices;
     result_dc.RasterId          = im_state.Raster;
@@ -46,26 +67,25 @@ void Im2DStateRecorder::RecordDrawCall( RwIm2DVertex *vertices,
                              im_state.ColorBlendOp,  im_state.BlendEnable,
                              im_state.ZTestEnable,   im_state.ZWriteEnable,
                              im_state.StencilEnable };
-
-    DrawCallCount++;
 }
 
 void Im2DStateRecorder::RecordDrawCall( RwIm2DVertex *vertices,
                                         int32_t num_vertices, int16_t *indices,
                                         int32_t num_indices )
 {
-    auto &result_dc = DrawCalls[DrawCallCount];
+    if ( !DrawCalls.Reserve( 1 ) || !VertexBuffer.Reserve( num_vertices ) ||
+         !IndexBuffer.Reserve( num_indices ) )
+        return;
+    auto &result_dc = DrawCalls.Append( 1 )[0];
     auto &im_state  = ImState;
 
-    result_dc.IndexBufferOffset = IndexCount;
-    CopyMemory( ( IndexBuffer.data() + IndexCount ), indices,
+    result_dc.IndexBufferOffset = static_cast<uint32_t>( IndexBuffer.Size() );
+    CopyMemory( IndexBuffer.Append( num_indices ).data(), indices,
                 num_indices * sizeof( int16_t ) );
-    IndexCount += num_indices;
 
-    result_dc.VertexBufferOffset = VertexCount;
-    CopyMemory( ( VertexBuffer.data() + VertexCount ), vertices,
+    result_dc.VertexBufferOffset = static_cast<uint32_t>( VertexBuffer.Size() );
+    CopyMemory( VertexBuffer.Append( num_vertices ).data(), vertices,
                 num_vertices * sizeof( RwIm2DVertex ) );
-    VertexCount += num_vertices;
 
     result_dc.VertexCount = num_vertices;
     result_dc.RasterId    = im_state.Raster;
@@ -74,62 +94,36 @@ void Im2DStateRecorder::RecordDrawCall( RwIm2DVertex *vertices,
                              im_state.ColorBlendOp,  im_state.BlendEnable,
                              im_state.ZTestEnable,   im_state.ZWriteEnable,
                              im_state.StencilEnable };
-    DrawCallCount++;
 }
 
-uint64_t Im2DStateRecorder::Serialize( MemoryWriter &writer )
+uint64_t Im2DStateRecorder::Serialize( MemoryWriter           &writer,
+                                      const FramePacketArena &arena )
 {
-    // serialize index buffer
-    uint64_t index_count = IndexCount;
-    writer.Write( &index_count );
-    if ( index_count > 0 )
-        writer.Write( IndexBuffer.data(), index_count );
-
-    // serialize vertex buffer
-    uint64_t vertex_count = VertexCount;
-    writer.Write( &vertex_count );
-    if ( vertex_count <= 0 )
-        return writer.Pos();
-    writer.Write( VertexBuffer.data(), vertex_count );
-
-    // serialize drawcalls
-    uint64_t dc_count = DrawCallCount;
-    writer.Write( &dc_count );
-    if ( dc_count <= 0 )
-        return writer.Pos();
-
-    writer.Write( DrawCalls.data(), dc_count );
+    // buffers are already in the frame packet, so only section headers are
+    // written
+    auto index_buffer  = IndexBuffer.Section( arena );
+    auto vertex_buffer = VertexBuffer.Section( arena );
+    auto draw_calls    = DrawCalls.Section( arena );
+    writer.Write( &index_buffer );
+    writer.Write( &vertex_buffer );
+    writer.Write( &draw_calls );
     return writer.Pos();
 }
 
-Im2DRenderState Im2DRenderState::Deserialize( MemoryReader &reader )
+Im2DRenderState Im2DRenderState::Deserialize( MemoryReader          &reader,
+                                              const FramePacketView &packet )
 {
     Im2DRenderState result{};
-    auto            idx_count = *reader.Read<uint64_t>();
-    if ( idx_count > 0 )
-    {
-        result.IndexBuffer = { reader.Read<uint16_t>( idx_count ),
-                               static_cast<size_t>( idx_count ) };
-    }
-
-    auto vtx_count = *reader.Read<uint64_t>();
-    if ( vtx_count <= 0 )
-        return result;
-    result.VertexBuffer = { reader.Read<RwIm2DVertex>( vtx_count ),
-                            static_cast<size_t>( vtx_count ) };
-
-    auto dc_count = *reader.Read<uint64_t>();
-    if ( dc_count <= 0 )
-        return result;
-    result.DrawCalls = { reader.Read<Im2DDrawCall>( dc_count ),
-                         static_cast<size_t>( dc_count ) };
+    result.IndexBuffer  = packet.Read<uint16_t>( reader );
+    result.VertexBuffer = packet.Read<RwIm2DVertex>( reader );
+    result.DrawCalls    = packet.Read<Im2DDrawCall>( reader );
     return result;
 }
 
 void Im2DStateRecorder::Flush()
 {
-    DrawCallCount = 0;
-    VertexCount   = 0;
-    IndexCount    = 0;
+    DrawCalls.Clear();
+    VertexBuffer.Clear();
+    IndexBuffer.Clear();
 }
 } // namespace rh::rw::engine
@@ -1,6 +1,6 @@
 #pragma once
 #include "common_headers.h"
-#include <vector>
+#include "frame_packet_array.h"
 
 #include <Engine/Common/ArrayProxy.h>
 
@@ -36,6 +36,8 @@ struct Im2DDrawCall
 };
 
 struct ImmediateState;
+struct FramePacketView;
+class FramePacketArena;
 class MemoryWriter;
 class MemoryReader;
 
@@ -44,12 +46,15 @@ struct Im2DRenderState
     rh::engine::ArrayProxy<uint16_t>     IndexBuffer;
     rh::engine::ArrayProxy<RwIm2DVertex> VertexBuffer;
     rh::engine::ArrayProxy<Im2DDrawCall> DrawCalls;
-    static Im2DRenderState               Deserialize( MemoryReader &reader );
+
+    static Im2DRenderState Deserialize( MemoryReader          &reader,
+                                        const FramePacketView &packet );
 };
 
 /**
  * State recorder for immediate 2d render mode, records draw calls and dynamic
- * index/vertex data in memory buffers to be sent to im2d renderer
+ * index/vertex data directly into the frame packet to be sent to im2d
+ * renderer
  */
 class Im2DStateRecorder
 {
@@ -60,17 +65,20 @@ class Im2DStateRecorder
     void     RecordDrawCall( RwIm2DVertex *vertices, int32_t num_vertices );
     void     RecordDrawCall( RwIm2DVertex *vertices, int32_t num_vertices,
                              int16_t *indices, int32_t num_indices );
-    uint64_t Serialize( MemoryWriter &writer );
+    /// Allocates frame buffers in the packet, discards recorded data
+    void     BeginFrame( FramePacketArena &arena );
+    uint64_t Serialize( MemoryWriter &writer, const FramePacketArena &arena );
     void     Flush();
 
+    /// Packet memory needed for recorder arrays at current capacity
+    [[nodiscard]] uint64_t PacketSize() const;
+    void                   LogPeakUsage() const;
+
   private:
-    ImmediateState           &ImState;
-    std::vector<Im2DDrawCall> DrawCalls{};
-    std::vector<RwIm2DVertex> VertexBuffer{};
-    std::vector<int16_t>      IndexBuffer{};
-    uint32_t                  IndexCount    = 0;
-    uint32_t                  VertexCount   = 0;
-    uint32_t                  DrawCallCount = 0;
+    ImmediateState                &ImState;
+    FramePacketArray<Im2DDrawCall> DrawCalls;
+    FramePacketArray<RwIm2DVertex> VertexBuffer;
+    FramePacketArray<int16_t>      IndexBuffer;
 };
 
 } // namespace rw::engine
@@ -4,25 +4,47 @@
 
 #include "im3d_state_recorder.h"
 #include "data_desc/immediate_mode/im_state.h"
+#include <data_desc/frame_packet.h>
 #include <ipc/MemoryReader.h>
 #include <ipc/MemoryWriter.h>
 
 namespace rh::rw::engine
 {
 
-constexpr auto Im3DVertexCountLimit = 100000;
-constexpr auto Im3DIndexCountLimit  = 100000;
+constexpr uint64_t Im3DVertexInitialCapacity   = 100000;
+constexpr uint64_t Im3DIndexInitialCapacity    = 100000;
+constexpr uint64_t Im3DDrawCallInitialCapacity = 4000;
 
 Im3DStateRecorder::Im3DStateRecorder( ImmediateState &im_state ) noexcept
-    : ImState( im_state )
+    : ImState( im_state ),
+      IndexBuffer( "im3d indices", Im3DIndexInitialCapacity ),
+      VertexBuffer( "im3d vertices", Im3DVertexInitialCapacity ),
+      DrawCalls( "im3d draw calls", Im3DDrawCallInitialCapacity )
 {
-    VertexBuffer.resize( Im3DVertexCountLimit );
-    IndexBuffer.resize( Im3DIndexCountLimit );
-    DrawCalls.resize( 4000 );
 }
 
 Im3DStateRecorder::~Im3DStateRecorder() noexcept = default;
 
+uint64_t Im3DStateRecorder::PacketSize() const
+{
+    return VertexBuffer.PacketSize() + IndexBuffer.PacketSize() +
+           DrawCalls.PacketSize();
+}
+
+void Im3DStateRecorder::LogPeakUsage() const
+{
+    VertexBuffer.LogPeakUsage();
+    IndexBuffer.LogPeakUsage();
+    DrawCalls.LogPeakUsage();
+}
+
+void Im3DStateRecorder::BeginFrame( FramePacketArena &arena )
+{
+    VertexBuffer.Begin( arena );
+    IndexBuffer.Begin( arena );
+    DrawCalls.Begin( arena );
+}
+
 void Im3DStateRecorder::Transform( RwIm3DVertex *vertices, uint32_t count,
                                    RwMatrix                 *ltm,
                                    [[maybe_unused]] uint32_t flags )
@@ -47,15 +69,19 @@ void Im3DStateRecorder::Transform( RwIm3DVertex *vertices, uint32_t count,
 
 void Im3DStateRecorder::RenderPrimitive( RwPrimitiveType prim_type )
 {
-    auto &result_dc = DrawCalls[DrawCallCount];
-
-    result_dc.IndexBufferOffset  = IndexCount;
-    result_dc.VertexBufferOffset = VertexCount;
+    // draw calls are dropped only if packet is out of memory
+    if ( !DrawCalls.Reserve( 1 ) ||
+         !VertexBuffer.Reserve( StashedVerticesCount ) )
+        return;
+    auto &result_dc = DrawCalls.Append( 1 )[0];
+
+    result_dc.IndexBufferOffset  = static_cast<uint32_t>( IndexBuffer.Size() );
+    result_dc.VertexBufferOffset = static_cast<uint32_t>( VertexBuffer.Size() );
     assert( StashedVertices );
 
-    CopyMemory( ( VertexBuffer.data() + VertexCount ), StashedVertices,
+    CopyMemory( VertexBuffer.Append( StashedVerticesCount ).data(),
+                StashedVertices,
                 StashedVerticesCount * sizeof( RwIm3DVertex ) );
-    VertexCount += StashedVerticesCount;
 
     result_dc.IndexCount  = 0;
     result_dc.VertexCount = StashedVerticesCount;
@@ -67,27 +93,28 @@ void Im3DStateRecorder::RenderPrimitive( RwPrimitiveType prim_type )
         ImState.ColorBlendOp,  ImState.BlendEnable,
         ImState.ZTestEnable,   ImState.ZWriteEnable,
         ImState.StencilEnable, static_cast<uint8_t>( prim_type ) };
-
-    DrawCallCount++;
 }
 
 void Im3DStateRecorder::RenderIndexedPrimitive( RwPrimitiveType prim_type,
                                                 uint16_t       *indices,
                                                 int32_t         num_indices )
 {
-    auto &result_dc = DrawCalls[DrawCallCount];
-
-    result_dc.IndexBufferOffset  = IndexCount;
-    result_dc.VertexBufferOffset = VertexCount;
+    if ( !DrawCalls.Reserve( 1 ) ||
+         !VertexBuffer.Reserve( StashedVerticesCount ) ||
+         !IndexBuffer.Reserve( num_indices ) )
+        return;
+    auto &result_dc = DrawCalls.Append( 1 )[0];
+
+    result_dc.IndexBufferOffset  = static_cast<uint32_t>( IndexBuffer.Size() );
+    result_dc.VertexBufferOffset = static_cast<uint32_t>( VertexBuffer.Size() );
     assert( indices );
     assert( StashedVertices );
 
-    CopyMemory( ( IndexBuffer.data() + IndexCount ), indices,
+    CopyMemory( IndexBuffer.Append( num_indices ).data(), indices,
                 num_indices * sizeof( uint16_t ) );
-    CopyMemory( ( VertexBuffer.data() + VertexCount ), StashedVertices,
+    CopyMemory( VertexBuffer.Append( StashedVerticesCount ).data(),
+                StashedVertices,
                 StashedVerticesCount * sizeof( RwIm3DVertex ) );
-    VertexCount += StashedVerticesCount;
-    IndexCount += num_indices;
 
     result_dc.IndexCount  = num_indices;
     result_dc.VertexCount = StashedVerticesCount;
@@ -99,63 +126,36 @@ void Im3DStateRecorder::RenderIndexedPrimitive( RwPrimitiveType prim_type,
         ImState.ColorBlendOp,  ImState.BlendEnable,
         ImState.ZTestEnable,   ImState.ZWriteEnable,
         ImState.StencilEnable, static_cast<uint8_t>( prim_type ) };
-
-    DrawCallCount++;
 }
 
-uint64_t Im3DStateRecorder::Serialize( MemoryWriter &writer )
+uint64_t Im3DStateRecorder::Serialize( MemoryWriter           &writer,
+                                      const FramePacketArena &arena )
 {
-    // serialize index buffer
-    uint64_t index_count = IndexCount;
-    writer.Write( &index_count );
-    if ( IndexCount > 0 )
-        writer.Write( IndexBuffer.data(), IndexCount );
-
-    // serialize vertex buffer
-    uint64_t vertex_count = VertexCount;
-    writer.Write( &vertex_count );
-    if ( VertexCount <= 0 )
-        return writer.Pos();
-    writer.Write( VertexBuffer.data(), VertexCount );
-
-    // serialize drawcalls
-    uint64_t dc_count = DrawCallCount;
-    writer.Write( &dc_count );
-    if ( DrawCallCount <= 0 )
-        return writer.Pos();
-    writer.Write( DrawCalls.data(), DrawCallCount );
-
+    // buffers are already in the frame packet, so only section headers are
+    // written
+    auto index_buffer  = IndexBuffer.Section( arena );
+    auto vertex_buffer = VertexBuffer.Section( arena );
+    auto draw_calls    = DrawCalls.Section( arena );
+    writer.Write( &index_buffer );
+    writer.Write( &vertex_buffer );
+    writer.Write( &draw_calls );
     return writer.Pos();
 }
 
-Im3DRenderState Im3DRenderState::Deserialize( MemoryReader &reader )
+Im3DRenderState Im3DRenderState::Deserialize( MemoryReader          &reader,
+                                              const FramePacketView &packet )
 {
     Im3DRenderState result{};
-    auto            idx_count = *reader.Read<uint64_t>();
-    if ( idx_count > 0 )
-    {
-        result.IndexBuffer = { reader.Read<uint16_t>( idx_count ),
-                               static_cast<size_t>( idx_count ) };
-    }
-
-    auto vtx_count = *reader.Read<uint64_t>();
-    if ( vtx_count <= 0 )
-        return result;
-    result.VertexBuffer = { reader.Read<RwIm3DVertex>( vtx_count ),
-                            static_cast<size_t>( vtx_count ) };
-
-    auto dc_count = *reader.Read<uint64_t>();
-    if ( dc_count <= 0 )
-        return result;
-    result.DrawCalls = { reader.Read<Im3DDrawCall>( dc_count ),
-                         static_cast<size_t>( dc_count ) };
+    result.IndexBuffer  = packet.Read<uint16_t>( reader );
+    result.VertexBuffer = packet.Read<RwIm3DVertex>( reader );
+    result.DrawCalls    = packet.Read<Im3DDrawCall>( reader );
     return result;
 }
 
 void Im3DStateRecorder::Flush()
 {
-    DrawCallCount = 0;
-    VertexCount   = 0;
-    IndexCount    = 0;
+    DrawCalls.Clear();
+    VertexBuffer.Clear();
+    IndexBuffer.Clear();
 }
 } // namespace rh::rw::engine
\ No newline at end of file
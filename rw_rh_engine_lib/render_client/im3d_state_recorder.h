@@ -1,6 +1,6 @@
 #pragma once
 #include "common_headers.h"
-#include <vector>
+#include "frame_packet_array.h"
 
 #include <Engine/Common/ArrayProxy.h>
 
@@ -35,6 +35,8 @@ struct Im3DDrawCall
 };
 
 struct ImmediateState;
+struct FramePacketView;
+class FramePacketArena;
 class MemoryWriter;
 class MemoryReader;
 
@@ -46,12 +48,15 @@ struct Im3DRenderState
     rh::engine::ArrayProxy<uint16_t>     IndexBuffer;
     rh::engine::ArrayProxy<RwIm3DVertex> VertexBuffer;
     rh::engine::ArrayProxy<Im3DDrawCall> DrawCalls;
-    static Im3DRenderState               Deserialize( MemoryReader &reader );
+
+    static Im3DRenderState Deserialize( MemoryReader          &reader,
+                                        const FramePacketView &packet );
 };
 
 /**
  * State recorder for immediate 3d render mode, records draw calls and dynamic
- * index/vertex data in memory buffers to be sent to im3d renderer
+ * index/vertex data directly into the frame packet to be sent to im3d
+ * renderer
  */
 class Im3DStateRecorder
 {
@@ -64,22 +69,24 @@ class Im3DStateRecorder
     void RenderIndexedPrimitive( RwPrimitiveType prim_type, uint16_t *indices,
                                  int32_t num_indices );
     void RenderPrimitive( RwPrimitiveType prim_type );
-    uint64_t Serialize( MemoryWriter &writer );
+    /// Allocates frame buffers in the packet, discards recorded data
+    void     BeginFrame( FramePacketArena &arena );
+    uint64_t Serialize( MemoryWriter &writer, const FramePacketArena &arena );
     void     Flush();
 
+    /// Packet memory needed for recorder arrays at current capacity
+    [[nodiscard]] uint64_t PacketSize() const;
+    void                   LogPeakUsage() const;
+
   private:
     ImmediateState     &ImState;
     RwIm3DVertex       *StashedVertices      = nullptr;
     uint32_t            StashedVerticesCount = 0;
     DirectX::XMFLOAT4X3 StashedWorldTransform{};
 
-    std::vector<uint16_t>     IndexBuffer{};
-    std::vector<RwIm3DVertex> VertexBuffer{};
-    std::vector<Im3DDrawCall> DrawCalls{};
-
-    uint32_t IndexCount    = 0;
-    uint32_t VertexCount   = 0;
-    uint32_t DrawCallCount = 0;
+    FramePacketArray<uint16_t>     IndexBuffer;
+    FramePacketArray<RwIm3DVertex> VertexBuffer;
+    FramePacketArray<Im3DDrawCall> DrawCalls;
 };
 
 } // namespace rw::engine
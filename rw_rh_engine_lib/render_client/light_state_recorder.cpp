@@ -7,33 +7,45 @@
 #include <ipc/MemoryWriter.h>
 namespace rh::rw::engine
 {
-constexpr size_t gLightBufferSize = 1024;
+constexpr uint64_t gPointLightInitialCapacity = 1024;
 
 LightStateRecorder::LightStateRecorder() noexcept
+    : PointLights( "point lights", gPointLightInitialCapacity )
 {
-    PointLights.resize( gLightBufferSize );
-    PointLightCount = 0;
 }
 
 LightStateRecorder::~LightStateRecorder() noexcept = default;
 
-uint64_t LightStateRecorder::Serialize( MemoryWriter &writer )
+uint64_t LightStateRecorder::PacketSize() const
 {
-    uint64_t point_light_count = PointLightCount;
-    writer.Write( &point_light_count );
-    if ( point_light_count > 0 )
-        writer.Write( PointLights.data(), point_light_count );
+    return PointLights.PacketSize();
+}
+
+void LightStateRecorder::LogPeakUsage() const
+{
+    PointLights.LogPeakUsage();
+}
+
+void LightStateRecorder::BeginFrame( FramePacketArena &arena )
+{
+    PointLights.Begin( arena );
+}
+
+uint64_t LightStateRecorder::Serialize( MemoryWriter           &writer,
+                                        const FramePacketArena &arena )
+{
+    auto point_lights = PointLights.Section( arena );
+    writer.Write( &point_lights );
     return 0;
 }
 
-void LightStateRecorder::Flush() { PointLightCount = 0; }
+void LightStateRecorder::Flush() { PointLights.Clear(); }
 
 void LightStateRecorder::RecordPointLight( PointLight &&light )
 {
-    if ( PointLightCount >= gLightBufferSize )
+    if ( !PointLights.Reserve( 1 ) )
         return;
-    PointLights[PointLightCount] = light;
-    PointLightCount++;
+    PointLights.Append( 1 )[0] = light;
 }
 
 } // namespace rh::rw::engine
\ No newline at end of file
@@ -3,8 +3,8 @@
 //
 
 #pragma once
+#include "frame_packet_array.h"
 #include <data_desc/light_system/point_light.h>
-#include <vector>
 
 struct RwIm2DVertex;
 
@@ -12,6 +12,7 @@ namespace rh::rw::engine
 {
 
 class MemoryWriter;
+class FramePacketArena;
 
 class LightStateRecorder
 {
@@ -20,12 +21,17 @@ class LightStateRecorder
     ~LightStateRecorder() noexcept;
 
     void     RecordPointLight( PointLight &&light );
-    uint64_t Serialize( MemoryWriter &writer );
+    /// Allocates frame buffers in the packet, discards recorded data
+    void     BeginFrame( FramePacketArena &arena );
+    uint64_t Serialize( MemoryWriter &writer, const FramePacketArena &arena );
     void     Flush();
 
+    /// Packet memory needed for recorder arrays at current capacity
+    [[nodiscard]] uint64_t PacketSize() const;
+    void                   LogPeakUsage() const;
+
   private:
-    std::vector<PointLight> PointLights{};
-    uint32_t                PointLightCount = 0;
+    FramePacketArray<PointLight> PointLights;
 };
 
 } // namespace rh::rw::engine
\ No newline at end of file
@@ -4,66 +4,300 @@
 
 #include "mesh_instance_state_recorder.h"
 
+#include <Engine/EngineConfigBlock.h>
+#include <bit>
+#include <cstring>
 #include <ipc/MemoryWriter.h>
 
 namespace rh::rw::engine
 {
 
-constexpr size_t gDrawCallLimit = 10000;
-constexpr size_t gMaterialLimit = 20000;
+constexpr uint64_t gMeshInstanceBitsPerWord = 64;
+// steady state delta is small, the first frames grow arrays to fit the
+// whole visible scene
+constexpr uint64_t gMeshUpdateInitialCapacity   = 4096;
+constexpr uint64_t gMeshRemovalInitialCapacity  = 1024;
+constexpr uint64_t gMeshMaterialInitialCapacity = 8192;
 
 MeshInstanceStateRecorder::MeshInstanceStateRecorder()
+    : MeshData( "mesh instance updates", gMeshUpdateInitialCapacity ),
+      UpdateSlots( "mesh instance update slots", gMeshUpdateInitialCapacity ),
+      RemovedSlots( "mesh instance removals", gMeshRemovalInitialCapacity ),
+      MaterialsData( "mesh instance materials", gMeshMaterialInitialCapacity )
 {
-    MeshData.resize( gDrawCallLimit );
-    DrawCallCount = 0;
-    MaterialsData.resize( gMaterialLimit );
-    MaterialCount = 0;
+    PendingMaterialCount    = 0;
+    PendingMaterialsDropped = false;
+}
+
+uint64_t MeshInstanceStateRecorder::PacketSize() const
+{
+    return MeshData.PacketSize() + UpdateSlots.PacketSize() +
+           RemovedSlots.PacketSize() + MaterialsData.PacketSize();
+}
+
+void MeshInstanceStateRecorder::LogPeakUsage() const
+{
+    MeshData.LogPeakUsage();
+    UpdateSlots.LogPeakUsage();
+    RemovedSlots.LogPeakUsage();
+    MaterialsData.LogPeakUsage();
+}
+
+void MeshInstanceStateRecorder::BeginFrame( FramePacketArena &arena )
+{
+    MeshData.Begin( arena );
+    UpdateSlots.Begin( arena );
+    RemovedSlots.Begin( arena );
+    MaterialsData.Begin( arena );
+    Flush();
+
+    // instances sent for previous frame only are removed before updates of
+    // this frame, so their slots may be reused right away
+    for ( auto slot : TransientSlots )
+        RemoveSlot( slot );
+    TransientSlots.clear();
+    SendRemovals();
+    std::fill( DrawnBits.begin(), DrawnBits.end(), 0 );
 }
 
 std::span<MaterialData>
 MeshInstanceStateRecorder::AllocateDrawCallMaterials( uint64_t count )
 {
-    if ( MaterialsData.size() < MaterialCount + count )
-        MaterialsData.resize( MaterialCount + count );
-
-    MeshData[DrawCallCount].MaterialListStart = MaterialCount;
-    MeshData[DrawCallCount].MaterialListCount = count;
-    return std::span<MaterialData>( &MaterialsData[MaterialCount], count );
+    PendingMaterialCount    = count;
+    PendingMaterialsDropped = !MaterialsData.Reserve( count );
+    if ( PendingMaterialsDropped )
+    {
+        // draw call will be dropped, but caller still needs somewhere to
+        // write materials to
+        if ( DroppedMaterials.size() < count )
+            DroppedMaterials.resize( count );
+        return std::span<MaterialData>( DroppedMaterials.data(), count );
+    }
+    return MaterialsData.Tail( count );
 }
 
 void MeshInstanceStateRecorder::RecordDrawCall( const DrawCallInfo &info )
 {
-    auto count              = MeshData[DrawCallCount].MaterialListCount;
-    MeshData[DrawCallCount] = info;
-    MeshData[DrawCallCount].MaterialListStart = MaterialCount;
-    MeshData[DrawCallCount].MaterialListCount = count;
-    MaterialCount += MeshData[DrawCallCount].MaterialListCount;
-    DrawCallCount++;
+    auto count              = PendingMaterialCount;
+    auto materials_dropped  = PendingMaterialsDropped;
+    PendingMaterialCount    = 0;
+    PendingMaterialsDropped = false;
+    // unchanged instance needs no room in the packet, so materials of a
+    // draw call that doesn't fit are still compared
+    std::span<const MaterialData> materials =
+        materials_dropped
+            ? std::span<const MaterialData>( DroppedMaterials.data(), count )
+            : MaterialsData.Tail( count );
+
+    const auto key_iter   = SlotByDrawCallId.find( info.DrawCallId );
+    const bool persistent = info.DrawCallId != 0 &&
+                            rh::engine::EngineConfigBlock::It
+                                .PersistentMeshInstances;
+    if ( persistent && key_iter != SlotByDrawCallId.end() &&
+         !TestBit( DrawnBits, key_iter->second ) )
+    {
+        const auto slot = key_iter->second;
+        SetBit( DrawnBits, slot );
+        // stale instance stays resident if the update doesn't fit
+        if ( IsSameInstance( Resident[slot], info, materials ) ||
+             materials_dropped || !CanWrite() )
+            return;
+        WriteUpdate( slot, info, count );
+        StoreInstance( slot, info, materials );
+        return;
+    }
+
+    // new instance, or one drawn more than once in this frame
+    if ( materials_dropped || !CanWrite() )
+        return;
+    const bool keyed = persistent && key_iter == SlotByDrawCallId.end();
+    if ( FreeSlots.empty() )
+    {
+        // instances that aren't drawn anymore release their slots in
+        // Serialize, so the update gets its slot there to keep table dense
+        DeferredUpdates.push_back( { MeshData.Size(), keyed } );
+        WriteUpdate( gNoMeshInstanceSlot, info, count );
+        return;
+    }
+    const auto slot = AddInstance( info, materials, keyed );
+    WriteUpdate( slot, info, count );
+}
+
+uint32_t
+MeshInstanceStateRecorder::AddInstance( const DrawCallInfo           &info,
+                                        std::span<const MaterialData> materials,
+                                        bool                          keyed )
+{
+    const auto slot = AcquireSlot();
+    StoreInstance( slot, info, materials );
+    SetBit( ResidentBits, slot );
+    SetBit( DrawnBits, slot );
+    if ( keyed && !SlotByDrawCallId.contains( info.DrawCallId ) )
+        SlotByDrawCallId[info.DrawCallId] = slot;
+    else
+        TransientSlots.push_back( slot );
+    return slot;
+}
+
+bool MeshInstanceStateRecorder::TestBit( const std::vector<uint64_t> &bits,
+                                         uint32_t                     slot )
+{
+    return ( bits[slot / gMeshInstanceBitsPerWord] >>
+             ( slot % gMeshInstanceBitsPerWord ) ) &
+           1;
+}
+
+void MeshInstanceStateRecorder::SetBit( std::vector<uint64_t> &bits,
+                                        uint32_t               slot )
+{
+    bits[slot / gMeshInstanceBitsPerWord] |=
+        uint64_t{ 1 } << ( slot % gMeshInstanceBitsPerWord );
+}
+
+void MeshInstanceStateRecorder::ClearBit( std::vector<uint64_t> &bits,
+                                          uint32_t               slot )
+{
+    bits[slot / gMeshInstanceBitsPerWord] &=
+        ~( uint64_t{ 1 } << ( slot % gMeshInstanceBitsPerWord ) );
+}
+
+bool MeshInstanceStateRecorder::CanWrite()
+{
+    return MeshData.Reserve( 1 ) && UpdateSlots.Reserve( 1 );
+}
+
+uint32_t MeshInstanceStateRecorder::AcquireSlot()
+{
+    if ( !FreeSlots.empty() )
+    {
+        const auto slot = FreeSlots.back();
+        FreeSlots.pop_back();
+        return slot;
+    }
+    const auto slot = static_cast<uint32_t>( Resident.size() );
+    Resident.emplace_back();
+    if ( slot / gMeshInstanceBitsPerWord >= ResidentBits.size() )
+    {
+        ResidentBits.push_back( 0 );
+        DrawnBits.push_back( 0 );
+    }
+    return slot;
+}
+
+bool MeshInstanceStateRecorder::IsSameInstance(
+    const ResidentInstance &instance, const DrawCallInfo &info,
+    std::span<const MaterialData> materials ) const
+{
+    const auto &resident = instance.Info;
+    // both structures have no padding, so bytewise comparison is exact
+    return resident.MeshId == info.MeshId &&
+           resident.PipelineId == info.PipelineId &&
+           resident.LodId == info.LodId &&
+           std::memcmp( &resident.WorldTransform, &info.WorldTransform,
+                        sizeof( info.WorldTransform ) ) == 0 &&
+           instance.Materials.size() == materials.size() &&
+           std::memcmp( instance.Materials.data(), materials.data(),
+                        materials.size_bytes() ) == 0;
+}
+
+void MeshInstanceStateRecorder::WriteUpdate( uint32_t            slot,
+                                             const DrawCallInfo &info,
+                                             uint64_t material_count )
+{
+    auto &draw_call             = MeshData.Append( 1 )[0];
+    draw_call                   = info;
+    draw_call.MaterialListStart = MaterialsData.Size();
+    draw_call.MaterialListCount = material_count;
+    UpdateSlots.Append( 1 )[0]  = slot;
+    MaterialsData.Append( material_count );
+}
+
+void MeshInstanceStateRecorder::StoreInstance(
+    uint32_t slot, const DrawCallInfo &info,
+    std::span<const MaterialData> materials )
+{
+    auto &instance = Resident[slot];
+    instance.Info  = info;
+    instance.Materials.assign( materials.begin(), materials.end() );
+}
+
+void MeshInstanceStateRecorder::RemoveSlot( uint32_t slot )
+{
+    Resident[slot].Materials.clear();
+    ClearBit( ResidentBits, slot );
+    PendingRemovals.push_back( slot );
+}
+
+void MeshInstanceStateRecorder::SendRemovals()
+{
+    // slot is free once its removal is in the packet, driver applies
+    // removals before updates
+    while ( !PendingRemovals.empty() && RemovedSlots.Reserve( 1 ) )
+    {
+        const auto slot             = PendingRemovals.back();
+        RemovedSlots.Append( 1 )[0] = slot;
+        FreeSlots.push_back( slot );
+        PendingRemovals.pop_back();
+    }
 }
 
 void MeshInstanceStateRecorder::Flush()
 {
-    DrawCallCount = 0;
-    MaterialCount = 0;
+    MeshData.Clear();
+    UpdateSlots.Clear();
+    RemovedSlots.Clear();
+    MaterialsData.Clear();
+    PendingMaterialCount    = 0;
+    PendingMaterialsDropped = false;
+    DeferredUpdates.clear();
 }
 
-uint64_t MeshInstanceStateRecorder::Serialize( MemoryWriter &memory_writer )
+uint64_t
+MeshInstanceStateRecorder::Serialize( MemoryWriter           &memory_writer,
+                                      const FramePacketArena &arena )
 {
-    /// Serialize schema:
-    /// uint64 scene_materials_count
-    /// GeometryMaterial scene_materials
-    /// uint64 frame_draw_call_count
-    /// Im2DDrawCall frame_drawcalls[frame_draw_call_count]
+    // persistent instances that weren't drawn in this frame are removed, may
+    // be called several times for the same frame
+    for ( size_t word = 0; word < ResidentBits.size(); word++ )
+    {
+        auto removed = ResidentBits[word] & ~DrawnBits[word];
+        while ( removed != 0 )
+        {
+            auto bit = static_cast<uint32_t>( std::countr_zero( removed ) );
+            removed &= removed - 1;
+            auto slot = static_cast<uint32_t>(
+                word * gMeshInstanceBitsPerWord + bit );
+            SlotByDrawCallId.erase( Resident[slot].Info.DrawCallId );
+            RemoveSlot( slot );
+        }
+    }
+    SendRemovals();
 
-    // serialize drawcalls
+    for ( const auto &deferred : DeferredUpdates )
+    {
+        const auto &update = MeshData[deferred.Index];
+        std::span<const MaterialData> materials(
+            MaterialsData.Data() + update.MaterialListStart,
+            update.MaterialListCount );
+        UpdateSlots[deferred.Index] =
+            AddInstance( update, materials, deferred.Keyed );
+    }
+    DeferredUpdates.clear();
 
-    memory_writer.Write( &DrawCallCount );
-    if ( DrawCallCount <= 0 )
-        return memory_writer.Pos();
+    /// Serialize schema:
+    /// FramePacketSection removed_slots
+    /// FramePacketSection update_slots
+    /// FramePacketSection updates
+    /// FramePacketSection materials
 
-    memory_writer.Write( &MaterialCount );
-    memory_writer.Write( MaterialsData.data(), MaterialCount );
-    memory_writer.Write( MeshData.data(), DrawCallCount );
+    auto removed_slots = RemovedSlots.Section( arena );
+    auto update_slots  = UpdateSlots.Section( arena );
+    auto updates       = MeshData.Section( arena );
+    auto materials     = MaterialsData.Section( arena );
+    memory_writer.Write( &removed_slots );
+    memory_writer.Write( &update_slots );
+    memory_writer.Write( &updates );
+    memory_writer.Write( &materials );
 
     return memory_writer.Pos();
 }
@@ -2,16 +2,26 @@
 // Created by peter on 17.02.2021.
 //
 #pragma once
+#include "frame_packet_array.h"
 #include <data_desc/instances/mesh_instance.h>
 #include <rw_engine/rh_backend/material_backend.h>
 #include <span>
+#include <unordered_map>
 #include <vector>
 
 namespace rh::rw::engine
 {
 class MemoryWriter;
 class MemoryReader;
+class FramePacketArena;
 
+/**
+ * Records mesh instances as a delta against the instance table of render
+ * driver. Instances are keyed by DrawCallId, unchanged instances are not sent
+ * at all, instances that weren't drawn in current frame are removed.
+ * Instances without DrawCallId or drawn several times per frame are sent
+ * every frame.
+ */
 class MeshInstanceStateRecorder
 {
   public:
@@ -20,13 +30,73 @@ class MeshInstanceStateRecorder
     std::span<MaterialData> AllocateDrawCallMaterials( uint64_t count );
 
     void     RecordDrawCall( const DrawCallInfo &info );
-    uint64_t Serialize( MemoryWriter &memory_writer );
+    /// Allocates frame buffers in the packet, discards recorded data
+    void     BeginFrame( FramePacketArena &arena );
+    uint64_t Serialize( MemoryWriter           &memory_writer,
+                        const FramePacketArena &arena );
     void     Flush();
 
+    /// Packet memory needed for recorder arrays at current capacity
+    [[nodiscard]] uint64_t PacketSize() const;
+    void                   LogPeakUsage() const;
+
   private:
-    std::vector<DrawCallInfo> MeshData;
-    std::vector<MaterialData> MaterialsData;
-    uint64_t                  DrawCallCount;
-    uint64_t                  MaterialCount;
+    struct ResidentInstance
+    {
+        DrawCallInfo              Info;
+        std::vector<MaterialData> Materials;
+    };
+    struct DeferredUpdate
+    {
+        uint64_t Index;
+        bool     Keyed;
+    };
+    bool     IsSameInstance( const ResidentInstance       &instance,
+                             const DrawCallInfo           &info,
+                             std::span<const MaterialData> materials ) const;
+    /// Makes room for an update in the packet, its materials are already
+    /// allocated
+    bool     CanWrite();
+    /// Takes the lowest free slot, instance table grows if there is none
+    uint32_t AcquireSlot();
+    /// @param keyed - instance is found by DrawCallId in next frames
+    uint32_t AddInstance( const DrawCallInfo           &info,
+                          std::span<const MaterialData> materials,
+                          bool                          keyed );
+    void     WriteUpdate( uint32_t slot, const DrawCallInfo &info,
+                          uint64_t material_count );
+    void     StoreInstance( uint32_t slot, const DrawCallInfo &info,
+                            std::span<const MaterialData> materials );
+    void     RemoveSlot( uint32_t slot );
+    /// Moves pending removals into the packet and frees their slots
+    void     SendRemovals();
+
+    static bool TestBit( const std::vector<uint64_t> &bits, uint32_t slot );
+    static void SetBit( std::vector<uint64_t> &bits, uint32_t slot );
+    static void ClearBit( std::vector<uint64_t> &bits, uint32_t slot );
+
+    // frame packet sections
+    FramePacketArray<DrawCallInfo> MeshData;
+    FramePacketArray<uint32_t>     UpdateSlots;
+    FramePacketArray<uint32_t>     RemovedSlots;
+    FramePacketArray<MaterialData> MaterialsData;
+    /// Receives materials of draw calls that don't fit into the packet
+    std::vector<MaterialData>      DroppedMaterials;
+    uint64_t                       PendingMaterialCount;
+    bool                           PendingMaterialsDropped;
+    /// New instances that are given a slot once removals are known
+    std::vector<DeferredUpdate> DeferredUpdates;
+
+    // mirror of render driver instance table
+    std::vector<ResidentInstance>          Resident;
+    std::unordered_map<uint64_t, uint32_t> SlotByDrawCallId;
+    std::vector<uint32_t>                  FreeSlots;
+    /// Slots of instances sent only for current frame
+    std::vector<uint32_t>                  TransientSlots;
+    /// Removed slots that didn't fit into the packet yet
+    std::vector<uint32_t>                  PendingRemovals;
+    std::vector<uint64_t>                  ResidentBits;
+    /// Slots drawn in current frame
+    std::vector<uint64_t>                  DrawnBits;
 };
 } // namespace rh::rw::engine
\ No newline at end of file
@@ -0,0 +1,74 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "mesh_load_batch.h"
+#include <ipc/shared_memory_queue_client.h>
+#include <rw_engine/rh_backend/mesh_rendering_backend.h>
+#include <rw_engine/system_funcs/mesh_load_cmd.h>
+
+namespace rh::rw::engine
+{
+namespace
+{
+/// Ids reserved by a single MESH_RESERVE task
+constexpr uint32_t gMeshIdReserveCount = 64;
+/// Batch is sent early once it grows past this size
+constexpr uint64_t gMaxMeshBatchSize = 8 * 1024 * 1024;
+constexpr uint64_t gNoMeshId         = 0xBADF00D;
+} // namespace
+
+MeshLoadBatch::MeshLoadBatch( SharedMemoryTaskQueue &asset_queue )
+    : mAssetQueue( asset_queue )
+{
+}
+
+uint64_t MeshLoadBatch::Add( const BackendMeshInitData &mesh_data )
+{
+    if ( mReservedIds.empty() && !ReserveIds() )
+        return gNoMeshId;
+    const auto id = mReservedIds.back();
+    mReservedIds.pop_back();
+
+    const uint64_t offset = mPayload.size();
+    mPayload.resize( offset + sizeof( id ) +
+                     LoadMeshCmdImpl::PayloadSize( mesh_data ) );
+    MemoryWriter writer( mPayload.data() + offset, mPayload.size() - offset );
+    writer.Write( &id );
+    LoadMeshCmdImpl::Serialize( writer, mesh_data, gUnboundedMemorySize );
+    mMeshCount++;
+
+    if ( mPayload.size() >= gMaxMeshBatchSize )
+        Flush();
+    return id;
+}
+
+void MeshLoadBatch::Flush()
+{
+    if ( mMeshCount == 0 )
+        return;
+    const uint64_t chunk_size = mAssetQueue.TaskChunkSize();
+    mAssetQueue.ExecuteChunkedTask(
+        SharedMemoryTaskType::MESH_LOAD_BATCH,
+        [this, chunk_size]( MemoryWriter &&writer ) {
+            writer.Write( &mMeshCount );
+            writer.WriteSplit( mPayload.data(), mPayload.size(), chunk_size );
+        } );
+    mPayload.clear();
+    mMeshCount = 0;
+}
+
+bool MeshLoadBatch::ReserveIds()
+{
+    mAssetQueue.ExecuteTask(
+        SharedMemoryTaskType::MESH_RESERVE,
+        []( MemoryWriter &&writer ) { writer.Write( &gMeshIdReserveCount ); },
+        [this]( MemoryReader &&reader ) {
+            const auto count = *reader.Read<uint32_t>();
+            const auto *ids  = reader.Read<uint64_t>( count );
+            mReservedIds.assign( ids, ids + count );
+        } );
+    return !mReservedIds.empty();
+}
+
+} // namespace rh::rw::engine
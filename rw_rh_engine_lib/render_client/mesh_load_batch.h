@@ -0,0 +1,39 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace rh::rw::engine
+{
+class SharedMemoryTaskQueue;
+struct BackendMeshInitData;
+
+/**
+ * Client side batch of mesh loads sent through asset queue. Mesh ids are
+ * reserved by render driver in advance and handed out by the client, so
+ * meshes of a streamed model are sent in a single task instead of waiting
+ * for every id. Batch is sent before the next frame, mesh is drawn once
+ * render driver uploads it.
+ */
+class MeshLoadBatch
+{
+  public:
+    explicit MeshLoadBatch( SharedMemoryTaskQueue &asset_queue );
+
+    /// @return mesh id, 0xBADF00D if render driver has no ids to give
+    uint64_t Add( const BackendMeshInitData &mesh_data );
+    /// Sends batched meshes to render driver
+    void Flush();
+
+  private:
+    bool ReserveIds();
+
+    SharedMemoryTaskQueue &mAssetQueue;
+    std::vector<uint64_t>  mReservedIds{};
+    std::vector<uint8_t>   mPayload{};
+    uint32_t               mMeshCount = 0;
+};
+
+} // namespace rh::rw::engine
@@ -6,6 +6,8 @@
 #include <Engine/EngineConfigBlock.h>
 #include <rw_engine/rh_backend/material_backend.h>
 #include <rw_engine/rh_backend/raster_backend.h>
+#include <rw_engine/rw_asset_pack/asset_pack.h>
+#include <rw_engine/rw_geometry_cache/geometry_cache.h>
 
 namespace rh::rw::engine
 {
@@ -29,13 +31,37 @@ class ClientPlugins
 
 RenderClient::RenderClient()
 {
+    const auto &config = rh::engine::EngineConfigBlock::It;
     /// initialize SM task queue
     TaskQueue =
         std::make_unique<SharedMemoryTaskQueue>( SharedMemoryTaskQueueInfo{
-            .mName = "RenderHookTaskQueue",
-            .mSize = 1024 * 1024 *
-                     rh::engine::EngineConfigBlock::It.SharedMemorySizeMB,
+            .mName  = "RenderHookTaskQueue",
+            .mSize  = 1024 * 1024 * config.SharedMemorySizeMB,
             .mOwner = true } );
+    // render driver answers asset loads right away, GPU upload is done
+    // between frames
+    if ( config.AsyncAssetUploads )
+    {
+        AssetQueue = std::make_unique<SharedMemoryTaskQueue>(
+            SharedMemoryTaskQueueInfo{
+                .mName  = "RenderHookAssetQueue",
+                .mSize  = 1024 * 1024 * config.AssetSharedMemorySizeMB,
+                .mOwner = true } );
+        MeshBatch = std::make_unique<MeshLoadBatch>( *AssetQueue );
+    }
+    FrameArena = std::make_unique<FramePacketArena>( *TaskQueue );
+    RenderState.BeginFrame( *FrameArena );
+
+    if ( !config.AssetPackPath.empty() )
+    {
+        Pack = std::make_unique<AssetPack>();
+        if ( !Pack->Open( config.AssetPackPath ) )
+            Pack.reset();
+    }
+    if ( !config.GeometryCachePath.empty() )
+        MeshCache = std::make_unique<GeometryCache>(
+            config.GeometryCachePath,
+            1024ull * 1024 * config.GeometryCacheSizeMB );
 
     /// Create render driver sub-process
     STARTUPINFOA start_info{ .cb = sizeof( start_info ) };
@@ -47,6 +73,10 @@ RenderClient::RenderClient()
 RenderClient::~RenderClient()
 {
     TaskQueue->SendExitEvent();
+    RenderState.LogPeakUsage();
+    FrameArena.reset();
+    MeshBatch.reset();
+    AssetQueue.reset();
     TaskQueue.reset();
     if ( RenderDriverProcess.hProcess )
         TerminateProcess( RenderDriverProcess.hProcess, 0 );
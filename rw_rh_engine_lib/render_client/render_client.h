@@ -4,11 +4,16 @@
 
 #pragma once
 #include "client_render_state.h"
+#include "frame_packet_arena.h"
+#include "mesh_load_batch.h"
 #include <common_headers.h>
+#include <deque>
 #include <ipc/shared_memory_queue_client.h>
 namespace rh::rw::engine
 {
 class ClientPlugins;
+class AssetPack;
+class GeometryCache;
 struct PluginPtrTable;
 class RenderClient
 {
@@ -23,14 +28,47 @@ class RenderClient
         return *TaskQueue;
     }
 
+    /// Texture and mesh loads, main task queue if asset uploads are not
+    /// streamed
+    SharedMemoryTaskQueue &GetAssetQueue()
+    {
+        assert( TaskQueue );
+        return AssetQueue ? *AssetQueue : *TaskQueue;
+    }
+
+    /// Batched mesh loads, nullptr if asset uploads are not streamed
+    MeshLoadBatch *GetMeshLoadBatch() { return MeshBatch.get(); }
+
+    /// Cooked meshes and textures, nullptr if no asset pack is used
+    [[nodiscard]] const AssetPack *GetAssetPack() const { return Pack.get(); }
+
+    /// Geometry converted by earlier launches, nullptr if cache is disabled
+    GeometryCache *GetGeometryCache() { return MeshCache.get(); }
+
+    FramePacketArena &GetFrameArena()
+    {
+        assert( FrameArena );
+        return *FrameArena;
+    }
+
     bool RegisterPlugins( const PluginPtrTable &plugin_cb );
 
     ClientRenderState RenderState{};
+    /// Task sequences of frames published to render driver but not rendered
+    /// yet, oldest first
+    std::deque<uint64_t> InFlightFrames{};
+    /// Largest serialized frame size, used to size the shared memory region
+    uint64_t FrameSizeHighWaterMark = 0;
 
   private:
     std::unique_ptr<SharedMemoryTaskQueue> TaskQueue{};
+    std::unique_ptr<SharedMemoryTaskQueue> AssetQueue{};
+    std::unique_ptr<MeshLoadBatch>         MeshBatch{};
+    std::unique_ptr<FramePacketArena>      FrameArena{};
     PROCESS_INFORMATION                    RenderDriverProcess{};
     std::unique_ptr<ClientPlugins>         Plugins{};
+    std::unique_ptr<AssetPack>             Pack{};
+    std::unique_ptr<GeometryCache>         MeshCache{};
 };
 
 extern std::unique_ptr<RenderClient> gRenderClient;
@@ -4,87 +4,141 @@
 
 #include "skin_instance_state_recorder.h"
 
+#include <algorithm>
+#include <data_desc/frame_packet.h>
 #include <ipc/MemoryReader.h>
 #include <ipc/MemoryWriter.h>
 
 namespace rh::rw::engine
 {
 
-constexpr size_t gSkinDrawCallLimit = 100;
-constexpr size_t gSkinMaterialLimit = 2000;
+constexpr uint64_t gSkinDrawCallInitialCapacity = 128;
+constexpr uint64_t gSkinMaterialInitialCapacity = 2048;
+constexpr uint64_t gSkinBoneInitialCapacity     = 8192;
 
 SkinInstanceStateRecorder::SkinInstanceStateRecorder()
+    : MaterialsData( "skin materials", gSkinMaterialInitialCapacity ),
+      BonePalette( "skin bone palette", gSkinBoneInitialCapacity ),
+      MeshData( "skin draw calls", gSkinDrawCallInitialCapacity )
 {
-    MeshData.resize( gSkinDrawCallLimit );
-    MaterialsData.resize( gSkinMaterialLimit );
-    DrawCallCount = 0;
-    MaterialCount = 0;
+    PendingMaterialCount    = 0;
+    PendingBoneCount        = 0;
+    PendingMaterialsDropped = false;
+    PendingBonesDropped     = false;
+}
+
+uint64_t SkinInstanceStateRecorder::PacketSize() const
+{
+    return MeshData.PacketSize() + MaterialsData.PacketSize() +
+           BonePalette.PacketSize();
+}
+
+void SkinInstanceStateRecorder::LogPeakUsage() const
+{
+    MeshData.LogPeakUsage();
+    MaterialsData.LogPeakUsage();
+    BonePalette.LogPeakUsage();
+}
+
+void SkinInstanceStateRecorder::BeginFrame( FramePacketArena &arena )
+{
+    MeshData.Begin( arena );
+    MaterialsData.Begin( arena );
+    BonePalette.Begin( arena );
+    Flush();
 }
 
 std::span<MaterialData>
 SkinInstanceStateRecorder::AllocateDrawCallMaterials( uint64_t count )
 {
-    if ( MaterialsData.size() < MaterialCount + count )
-        MaterialsData.resize( MaterialCount + count );
-
-    MeshData[DrawCallCount].MaterialListStart = MaterialCount;
-    MeshData[DrawCallCount].MaterialListCount = count;
+    PendingMaterialCount    = count;
+    PendingMaterialsDropped = !MaterialsData.Reserve( count );
+    if ( PendingMaterialsDropped )
+    {
+        // draw call will be dropped, but caller still needs somewhere to
+        // write materials to
+        if ( DroppedMaterials.size() < count )
+            DroppedMaterials.resize( count );
+        return std::span<MaterialData>( DroppedMaterials.data(), count );
+    }
+    return MaterialsData.Tail( count );
+}
 
-    return std::span<MaterialData>( &MaterialsData[MaterialCount], count );
+std::span<DirectX::XMFLOAT4X3>
+SkinInstanceStateRecorder::AllocateBoneTransforms( uint64_t count )
+{
+    count               = ( std::min )( count, uint64_t{ gSkinBoneLimit } );
+    PendingBoneCount    = count;
+    PendingBonesDropped = !BonePalette.Reserve( count );
+    if ( PendingBonesDropped )
+    {
+        if ( DroppedBones.size() < count )
+            DroppedBones.resize( count );
+        return std::span<DirectX::XMFLOAT4X3>( DroppedBones.data(), count );
+    }
+    return BonePalette.Tail( count );
 }
 
 void SkinInstanceStateRecorder::RecordDrawCall( const SkinDrawCallInfo &info )
 {
-    assert( DrawCallCount < 100 );
-    auto mat_count          = MeshData[DrawCallCount].MaterialListCount;
-    MeshData[DrawCallCount] = info;
-    MeshData[DrawCallCount].MaterialListStart = MaterialCount;
-    MeshData[DrawCallCount].MaterialListCount = mat_count;
-    MaterialCount += mat_count;
-    DrawCallCount++;
+    auto mat_count          = PendingMaterialCount;
+    auto bone_count         = PendingBoneCount;
+    auto dropped            = PendingMaterialsDropped || PendingBonesDropped;
+    PendingMaterialCount    = 0;
+    PendingBoneCount        = 0;
+    PendingMaterialsDropped = false;
+    PendingBonesDropped     = false;
+    if ( dropped || !MeshData.Reserve( 1 ) )
+        return;
+
+    auto &draw_call             = MeshData.Append( 1 )[0];
+    draw_call                   = info;
+    draw_call.MaterialListStart = MaterialsData.Size();
+    draw_call.MaterialListCount = mat_count;
+    draw_call.BoneListStart     = BonePalette.Size();
+    draw_call.BoneListCount     = bone_count;
+    MaterialsData.Append( mat_count );
+    BonePalette.Append( bone_count );
 }
 
-uint64_t SkinInstanceStateRecorder::Serialize( MemoryWriter &writer ) const
+uint64_t
+SkinInstanceStateRecorder::Serialize( MemoryWriter           &writer,
+                                      const FramePacketArena &arena ) const
 {
     /// Serialize schema:
-    /// uint64 skip_offset
-    /// uint64 frame_draw_call_count
-    /// uint64 material_count
-    /// uint64 materials
-    /// Im2DDrawCall frame_drawcalls[frame_draw_call_count]
-
-    // serialize drawcalls
-    writer.Write( &DrawCallCount );
+    /// FramePacketSection materials
+    /// FramePacketSection bone_palette
+    /// FramePacketSection draw_calls
 
-    if ( DrawCallCount <= 0 )
-    {
-        return writer.Pos();
-    }
-    writer.Write( &MaterialCount );
-    writer.Write( MaterialsData.data(), MaterialCount );
-    writer.Write( MeshData.data(), DrawCallCount );
+    auto materials    = MaterialsData.Section( arena );
+    auto bone_palette = BonePalette.Section( arena );
+    auto draw_calls   = MeshData.Section( arena );
+    writer.Write( &materials );
+    writer.Write( &bone_palette );
+    writer.Write( &draw_calls );
 
     return writer.Pos();
 }
 
-SkinInstanceState SkinInstanceState::Deserialize( MemoryReader &reader )
+SkinInstanceState
+SkinInstanceState::Deserialize( MemoryReader          &reader,
+                                const FramePacketView &packet )
 {
     SkinInstanceState result{};
-    auto              dc_count = *reader.Read<uint64_t>();
-    if ( dc_count <= 0 )
-        return result;
-
-    auto material_count = *reader.Read<uint64_t>();
-    result.Materials    = rh::engine::ArrayProxy(
-           reader.Read<MaterialData>( material_count ), material_count );
-    result.DrawCalls = rh::engine::ArrayProxy(
-        reader.Read<SkinDrawCallInfo>( dc_count ), dc_count );
+    result.Materials      = packet.Read<MaterialData>( reader );
+    result.BoneTransforms = packet.Read<DirectX::XMFLOAT4X3>( reader );
+    result.DrawCalls      = packet.Read<SkinDrawCallInfo>( reader );
     return result;
 }
 
 void SkinInstanceStateRecorder::Flush()
 {
-    DrawCallCount = 0;
-    MaterialCount = 0;
+    MeshData.Clear();
+    MaterialsData.Clear();
+    BonePalette.Clear();
+    PendingMaterialCount    = 0;
+    PendingBoneCount        = 0;
+    PendingMaterialsDropped = false;
+    PendingBonesDropped     = false;
 }
 } // namespace rh::rw::engine
\ No newline at end of file
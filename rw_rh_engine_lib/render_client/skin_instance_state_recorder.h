@@ -2,6 +2,7 @@
 // Created by peter on 17.02.2021.
 //
 #pragma once
+#include "frame_packet_array.h"
 #include <Engine/Common/ArrayProxy.h>
 #include <rw_engine/rh_backend/material_backend.h>
 #include <span>
@@ -16,21 +17,31 @@ struct SkinDrawCallInfo
     uint64_t            DrawCallId;
     uint64_t            MaterialListStart;
     uint64_t            MaterialListCount;
+    /// Bone matrices are stored in per-frame bone palette
+    uint64_t            BoneListStart;
+    uint64_t            BoneListCount;
     DirectX::XMFLOAT4X3 WorldTransform;
-    DirectX::XMFLOAT4X3 BoneTransform[256];
 };
 
 class MemoryWriter;
 class MemoryReader;
+class FramePacketArena;
+struct FramePacketView;
+
+/// Max bone count of a single skinned mesh
+constexpr uint32_t gSkinBoneLimit = 256;
 
 /**
  * Memory view into current frame's mesh instance list state
  */
 struct SkinInstanceState
 {
-    rh::engine::ArrayProxy<MaterialData>     Materials;
-    rh::engine::ArrayProxy<SkinDrawCallInfo> DrawCalls;
-    static SkinInstanceState Deserialize( MemoryReader &reader );
+    rh::engine::ArrayProxy<MaterialData>        Materials;
+    rh::engine::ArrayProxy<DirectX::XMFLOAT4X3> BoneTransforms;
+    rh::engine::ArrayProxy<SkinDrawCallInfo>    DrawCalls;
+
+    static SkinInstanceState Deserialize( MemoryReader          &reader,
+                                          const FramePacketView &packet );
 };
 
 class SkinInstanceStateRecorder
@@ -38,18 +49,35 @@ class SkinInstanceStateRecorder
   public:
     SkinInstanceStateRecorder();
 
-    std::span<MaterialData> AllocateDrawCallMaterials( uint64_t count );
+    std::span<MaterialData>        AllocateDrawCallMaterials( uint64_t count );
+    /// Allocates bone matrices of the next draw call in bone palette
+    std::span<DirectX::XMFLOAT4X3> AllocateBoneTransforms( uint64_t count );
 
+    /// Copies draw call into the frame packet, bone list is taken from the
+    /// last AllocateBoneTransforms call
     void RecordDrawCall( const SkinDrawCallInfo &info );
 
-    uint64_t Serialize( MemoryWriter &writer ) const;
+    /// Allocates frame buffers in the packet, discards recorded data
+    void     BeginFrame( FramePacketArena &arena );
+    uint64_t Serialize( MemoryWriter           &writer,
+                        const FramePacketArena &arena ) const;
     void     Flush();
 
+    /// Packet memory needed for recorder arrays at current capacity
+    [[nodiscard]] uint64_t PacketSize() const;
+    void                   LogPeakUsage() const;
+
   private:
-    std::vector<MaterialData>     MaterialsData;
-    std::vector<SkinDrawCallInfo> MeshData;
-    uint64_t                      DrawCallCount;
-    uint64_t                      MaterialCount;
+    FramePacketArray<MaterialData>        MaterialsData;
+    FramePacketArray<DirectX::XMFLOAT4X3> BonePalette;
+    FramePacketArray<SkinDrawCallInfo>    MeshData;
+    /// Receives materials of draw calls that don't fit into the packet
+    std::vector<MaterialData>             DroppedMaterials;
+    std::vector<DirectX::XMFLOAT4X3>      DroppedBones;
+    uint64_t                              PendingMaterialCount;
+    uint64_t                              PendingBoneCount;
+    bool                                  PendingMaterialsDropped;
+    bool                                  PendingBonesDropped;
 };
 
 } // namespace rh::rw::engine
\ No newline at end of file
@@ -30,6 +30,7 @@ void FramebufferLoop::Run( const FrameState &frame_state )
     auto  frame     = swap_chain->GetAvaliableFrame( frame_res.mImageAquire );
 
     // Record scene to command buffer
+    RecordedFrameIdx++;
     auto dispatch = Renderer.Render( frame_state, frame_res.mCmdBuffer, frame );
     auto to_signal = !dispatch.empty() ? dispatch.back().mToSignalDep : nullptr;
     dispatch.push_back( { frame_res.mCmdBuffer,
@@ -49,6 +50,7 @@ void FramebufferLoop::Run( const FrameState &frame_state )
     // TODO: Allow non-blocking execution
     // Wait for cmd buffer
     Device.Wait( { frame_res.mCmdBuffer->ExecutionFinishedPrimitive() } );
+    CompletedFrameIdx = RecordedFrameIdx;
 
     FramebufferState.NextFrame();
 }
@@ -25,11 +25,21 @@ class FramebufferLoop
     FramebufferLoop( const FramebufferLoopCreateInfo &info );
     void Run( const FrameState &frame_state );
 
+    /// Index of the last frame recorded, frames are counted from 1
+    [[nodiscard]] uint64_t RecordedFrame() const { return RecordedFrameIdx; }
+    /// Index of the last frame GPU has finished executing
+    [[nodiscard]] uint64_t CompletedFrame() const
+    {
+        return CompletedFrameIdx;
+    }
+
   private:
     rh::engine::IDeviceState &Device;
     rh::engine::IWindow &     Window;
     IFrameRenderer &          Renderer;
     FramebufferState          FramebufferState;
+    uint64_t                  RecordedFrameIdx  = 0;
+    uint64_t                  CompletedFrameIdx = 0;
 };
 
 } // namespace rh::rw::engine
\ No newline at end of file
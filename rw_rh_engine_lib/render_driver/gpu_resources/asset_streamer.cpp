@@ -0,0 +1,501 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "asset_streamer.h"
+#include "resource_mgr.h"
+#include <DebugUtils/DebugLogger.h>
+#include <Engine/Common/IDeviceState.h>
+#include <Engine/Common/IImageBuffer.h>
+#include <Engine/Common/IImageView.h>
+#include <Engine/EngineConfigBlock.h>
+#include <ipc/shared_memory_queue_client.h>
+#include <rw_engine/rh_backend/raster_backend.h>
+#include <rw_engine/system_funcs/mesh_load_cmd.h>
+#include <rw_engine/system_funcs/raster_load_cmd.h>
+#include <rw_engine/system_funcs/skinned_mesh_load_cmd.h>
+
+#include <array>
+#include <chrono>
+
+namespace rh::rw::engine
+{
+namespace
+{
+/// Resource ids reserved ahead for each asset type, asset queue thread waits
+/// for render driver thread once they run out
+constexpr uint32_t gReservedIdCount = 128;
+constexpr auto     gReservedIdWait  = std::chrono::milliseconds( 1 );
+/// Answered to the client if asset can't be streamed
+constexpr uint64_t gNoAssetId = BackendRasterPlugin::NullRasterId;
+
+uint32_t TypeIndex( AssetType type ) { return static_cast<uint32_t>( type ); }
+} // namespace
+
+AssetStreamer::AssetStreamer( SharedMemoryTaskQueue &task_queue )
+    : mTaskQueue( task_queue )
+{
+}
+
+AssetStreamer::~AssetStreamer() = default;
+
+void AssetStreamer::RegisterTasks( SharedMemoryTaskQueue &asset_queue )
+{
+    auto register_load = [this, &asset_queue]( int64_t task_id,
+                                               AssetType type )
+    {
+        asset_queue.RegisterTask(
+            task_id, std::make_unique<SharedMemoryTask>(
+                         [this, type]( MemoryReader &&reader,
+                                       MemoryWriter &&writer ) {
+                             Enqueue( type, std::move( reader ),
+                                      std::move( writer ) );
+                         } ) );
+    };
+    register_load( SharedMemoryTaskType::RASTER_LOAD, AssetType::Raster );
+    register_load( SharedMemoryTaskType::MESH_LOAD, AssetType::Mesh );
+    register_load( SharedMemoryTaskType::SKINNED_MESH_LOAD,
+                   AssetType::SkinMesh );
+    asset_queue.RegisterTask(
+        SharedMemoryTaskType::MESH_RESERVE,
+        std::make_unique<SharedMemoryTask>(
+            [this]( MemoryReader &&reader, MemoryWriter &&writer ) {
+                ReserveMeshIds( std::move( reader ), std::move( writer ) );
+            } ) );
+    asset_queue.RegisterTask(
+        SharedMemoryTaskType::MESH_LOAD_BATCH,
+        std::make_unique<SharedMemoryTask>(
+            [this]( MemoryReader &&reader, MemoryWriter && ) {
+                EnqueueMeshBatch( std::move( reader ) );
+            } ) );
+}
+
+void AssetStreamer::Open( rh::engine::IDeviceState &device,
+                          EngineResourceHolder &    resources )
+{
+    using namespace rh::engine;
+    mDevice    = &device;
+    mResources = &resources;
+
+    // white texel, textured geometry looks untextured until it's uploaded
+    uint32_t                           texel = 0xFFFFFFFF;
+    std::array<ImageBufferInitData, 1> texel_data{
+        ImageBufferInitData{ .mData   = &texel,
+                             .mSize   = sizeof( texel ),
+                             .mStride = sizeof( texel ) } };
+    mFallbackBuffer = device.CreateImageBuffer(
+        { .mDimension   = ImageDimensions::d2D,
+          .mFormat      = ImageBufferFormat::RGBA8,
+          .mHeight      = 1,
+          .mWidth       = 1,
+          .mPreinitData = texel_data } );
+    mFallbackView = device.CreateImageView(
+        { .mBuffer = mFallbackBuffer,
+          .mFormat = ImageBufferFormat::RGBA8,
+          .mUsage  = ImageViewUsage::ShaderResource } );
+
+    std::lock_guard lock( mMutex );
+    mOpened = true;
+}
+
+void AssetStreamer::Close()
+{
+    if ( mResources == nullptr )
+        return;
+    std::deque<AssetUpload> dropped_uploads;
+    std::vector<uint64_t>   reserved_ids[TypeIndex( AssetType::Count )];
+    {
+        std::lock_guard lock( mMutex );
+        mOpened = false;
+        std::swap( dropped_uploads, mUploads );
+        for ( uint32_t type = 0; type < TypeIndex( AssetType::Count ); type++ )
+            std::swap( reserved_ids[type], mReservedIds[type] );
+        reserved_ids[TypeIndex( AssetType::Mesh )].insert(
+            reserved_ids[TypeIndex( AssetType::Mesh )].end(),
+            mDroppedMeshIds.begin(), mDroppedMeshIds.end() );
+        mDroppedMeshIds.clear();
+    }
+    mReservedIdsCond.notify_all();
+
+    // pending resources are freed without destruct callbacks, so fallback
+    // texture stays owned by streamer
+    for ( auto id : reserved_ids[TypeIndex( AssetType::Raster )] )
+        mResources->GetRasterPool().FreeResource( id );
+    for ( auto id : reserved_ids[TypeIndex( AssetType::Mesh )] )
+        mResources->GetMeshPool().FreeResource( id );
+    for ( auto id : reserved_ids[TypeIndex( AssetType::SkinMesh )] )
+        mResources->GetSkinMeshPool().FreeResource( id );
+    if ( !dropped_uploads.empty() )
+        debug::DebugLogger::LogFmt( "Dropped %zu streamed asset uploads",
+                                    debug::LogLevel::Info,
+                                    dropped_uploads.size() );
+
+    delete mFallbackView;
+    delete mFallbackBuffer;
+    mFallbackView   = nullptr;
+    mFallbackBuffer = nullptr;
+    mResources      = nullptr;
+    mDevice         = nullptr;
+}
+
+void AssetStreamer::Stop()
+{
+    {
+        std::lock_guard lock( mMutex );
+        mStopped = true;
+    }
+    mReservedIdsCond.notify_all();
+}
+
+bool AssetStreamer::Update()
+{
+    using namespace std::chrono;
+    if ( mReplayMode || mResources == nullptr )
+        return false;
+
+    // ids are reserved and freed between tasks, so replay can do it at the
+    // same point of the session
+    std::vector<uint64_t> dropped_mesh_ids;
+    {
+        std::lock_guard lock( mMutex );
+        std::swap( dropped_mesh_ids, mDroppedMeshIds );
+    }
+    if ( !dropped_mesh_ids.empty() )
+        Free( AssetType::Mesh, dropped_mesh_ids );
+    for ( uint32_t type = 0; type < TypeIndex( AssetType::Count ); type++ )
+    {
+        uint64_t reserved_count;
+        {
+            std::lock_guard lock( mMutex );
+            reserved_count = mReservedIds[type].size();
+        }
+        if ( reserved_count < gReservedIdCount / 2 )
+            Reserve( static_cast<AssetType>( type ),
+                     static_cast<uint32_t>( gReservedIdCount -
+                                            reserved_count ) );
+    }
+
+    const auto deadline =
+        steady_clock::now() +
+        microseconds(
+            rh::engine::EngineConfigBlock::It.AssetUploadTimeBudgetUs );
+    bool has_uploads;
+    do
+    {
+        has_uploads = UploadNext();
+    } while ( has_uploads && steady_clock::now() < deadline );
+    return has_uploads;
+}
+
+void AssetStreamer::Flush()
+{
+    if ( mResources == nullptr )
+        return;
+    while ( UploadNext() )
+        ;
+}
+
+void AssetStreamer::SetReplayMode() { mReplayMode = true; }
+
+void AssetStreamer::ReplayMarker( int64_t id, std::span<const uint8_t> data )
+{
+    if ( mResources == nullptr )
+        return;
+    if ( id == TaskCaptureMarkerType::ASSET_RESERVE &&
+         data.size() == sizeof( AssetReserveMarker ) )
+    {
+        AssetReserveMarker marker{};
+        std::memcpy( &marker, data.data(), sizeof( marker ) );
+        if ( marker.Type < AssetType::Count )
+            Reserve( marker.Type, marker.Count );
+    }
+    else if ( id == TaskCaptureMarkerType::ASSET_FREE &&
+              data.size() >= sizeof( AssetFreeMarker ) )
+    {
+        AssetFreeMarker marker{};
+        std::memcpy( &marker, data.data(), sizeof( marker ) );
+        if ( marker.Type >= AssetType::Count ||
+             data.size() != sizeof( marker ) +
+                                uint64_t{ marker.Count } * sizeof( uint64_t ) )
+            return;
+        std::vector<uint64_t> ids( marker.Count );
+        std::memcpy( ids.data(), data.data() + sizeof( marker ),
+                     ids.size() * sizeof( uint64_t ) );
+        Free( marker.Type, ids );
+    }
+    else if ( id == TaskCaptureMarkerType::ASSET_UPLOAD &&
+              data.size() >= sizeof( AssetUploadMarker ) )
+    {
+        AssetUploadMarker marker{};
+        std::memcpy( &marker, data.data(), sizeof( marker ) );
+        if ( marker.Type >= AssetType::Count )
+            return;
+        AssetUpload upload{ .Type = marker.Type, .Id = marker.Id };
+        upload.Payload.Assign( data.subspan( sizeof( marker ) ) );
+        Upload( upload );
+    }
+}
+
+void AssetStreamer::Enqueue( AssetType type, MemoryReader &&reader,
+                             MemoryWriter &&writer )
+{
+    auto upload           = ReadUpload( type, reader );
+    upload.Id             = TakeReservedId( type );
+    const uint64_t result = upload.Id;
+    if ( result != gNoAssetId )
+    {
+        {
+            std::lock_guard lock( mMutex );
+            mUploads.push_back( std::move( upload ) );
+        }
+        mTaskQueue.WakeTaskLoop();
+    }
+    writer.Write( &result );
+}
+
+void AssetStreamer::EnqueueMeshBatch( MemoryReader &&reader )
+{
+    const auto               mesh_count = *reader.Read<uint32_t>();
+    std::vector<AssetUpload> uploads;
+    uploads.reserve( mesh_count );
+    for ( uint32_t i = 0; i < mesh_count && !reader.Overflowed(); i++ )
+    {
+        // ids were handed out to the client by ReserveMeshIds
+        const auto id = *reader.Read<uint64_t>();
+        if ( reader.Overflowed() )
+            break;
+        uploads.push_back( ReadUpload( AssetType::Mesh, reader ) );
+        uploads.back().Id = id;
+    }
+    if ( reader.Overflowed() )
+    {
+        // batch is dropped, ids that were read are freed so they don't stay
+        // pending forever
+        {
+            std::lock_guard lock( mMutex );
+            for ( const auto &upload : uploads )
+                mDroppedMeshIds.push_back( upload.Id );
+        }
+        mTaskQueue.WakeTaskLoop();
+        return;
+    }
+
+    {
+        std::lock_guard lock( mMutex );
+        // reserved ids are freed once streamer is closed
+        if ( !mOpened )
+            return;
+        for ( auto &upload : uploads )
+            mUploads.push_back( std::move( upload ) );
+    }
+    mTaskQueue.WakeTaskLoop();
+}
+
+void AssetStreamer::ReserveMeshIds( MemoryReader &&reader,
+                                    MemoryWriter &&writer )
+{
+    const auto requested_count = *reader.Read<uint32_t>();
+    // reply is written in place of the request
+    std::vector<uint64_t> ids;
+    ids.reserve( requested_count );
+    for ( uint32_t i = 0; i < requested_count; i++ )
+    {
+        const auto id = TakeReservedId( AssetType::Mesh );
+        if ( id == gNoAssetId )
+            break;
+        ids.push_back( id );
+    }
+    const auto count = static_cast<uint32_t>( ids.size() );
+    writer.Write( &count );
+    writer.Write( ids.data(), ids.size() );
+}
+
+AssetStreamer::AssetUpload AssetStreamer::ReadUpload( AssetType     type,
+                                                      MemoryReader &reader )
+{
+    AssetUpload upload{ .Type = type };
+    switch ( type )
+    {
+    case AssetType::Raster:
+        RasterLoadCmdImpl::ReadPayload( reader, upload.Payload );
+        break;
+    case AssetType::Mesh:
+        LoadMeshCmdImpl::ReadPayload( reader, upload.Payload );
+        // CPU side of mesh creation is done on asset queue thread, while
+        // render driver thread is busy with frames
+        upload.EmissiveTriangles = LoadMeshCmdImpl::FindEmissiveTriangles(
+            upload.Payload.Reader() );
+        break;
+    case AssetType::SkinMesh:
+        SkinnedMeshLoadCmdImpl::ReadPayload( reader, upload.Payload );
+        break;
+    default: break;
+    }
+    return upload;
+}
+
+uint64_t AssetStreamer::TakeReservedId( AssetType type )
+{
+    std::unique_lock lock( mMutex );
+    auto &           reserved_ids = mReservedIds[TypeIndex( type )];
+    while ( mOpened && !mStopped && reserved_ids.empty() )
+    {
+        // render driver thread reserves ids between tasks
+        mTaskQueue.WakeTaskLoop();
+        mReservedIdsCond.wait_for( lock, gReservedIdWait );
+    }
+    if ( !mOpened || mStopped )
+    {
+        debug::DebugLogger::Error(
+            "Asset was sent before render driver window was opened" );
+        return gNoAssetId;
+    }
+    const auto id = reserved_ids.back();
+    reserved_ids.pop_back();
+    return id;
+}
+
+void AssetStreamer::Reserve( AssetType type, uint32_t count )
+{
+    std::vector<uint64_t> ids;
+    ids.reserve( count );
+    for ( uint32_t i = 0; i < count; i++ )
+    {
+        switch ( type )
+        {
+        case AssetType::Raster:
+            ids.push_back( mResources->GetRasterPool().ReserveResource(
+                RasterData{ nullptr, mFallbackView } ) );
+            break;
+        case AssetType::Mesh:
+            ids.push_back(
+                mResources->GetMeshPool().ReserveResource( {} ) );
+            break;
+        case AssetType::SkinMesh:
+            ids.push_back(
+                mResources->GetSkinMeshPool().ReserveResource( {} ) );
+            break;
+        default: break;
+        }
+    }
+    if ( mTaskQueue.IsCapturing() )
+    {
+        AssetReserveMarker marker{ .Type = type, .Count = count };
+        mTaskQueue.CaptureMarker( TaskCaptureMarkerType::ASSET_RESERVE,
+                                  &marker, sizeof( marker ) );
+    }
+
+    {
+        std::lock_guard lock( mMutex );
+        auto &          reserved_ids = mReservedIds[TypeIndex( type )];
+        reserved_ids.insert( reserved_ids.end(), ids.begin(), ids.end() );
+    }
+    mReservedIdsCond.notify_all();
+}
+
+void AssetStreamer::Free( AssetType type, std::span<const uint64_t> ids )
+{
+    // pending resources are freed without destruct callbacks
+    for ( auto id : ids )
+    {
+        switch ( type )
+        {
+        case AssetType::Raster:
+            mResources->GetRasterPool().FreeResource( id );
+            break;
+        case AssetType::Mesh:
+            mResources->GetMeshPool().FreeResource( id );
+            break;
+        case AssetType::SkinMesh:
+            mResources->GetSkinMeshPool().FreeResource( id );
+            break;
+        default: break;
+        }
+    }
+    if ( mTaskQueue.IsCapturing() )
+    {
+        AssetFreeMarker marker{ .Type  = type,
+                                .Count = static_cast<uint32_t>( ids.size() ) };
+        std::vector<uint8_t> data( sizeof( marker ) + ids.size_bytes() );
+        std::memcpy( data.data(), &marker, sizeof( marker ) );
+        std::memcpy( data.data() + sizeof( marker ), ids.data(),
+                     ids.size_bytes() );
+        mTaskQueue.CaptureMarker( TaskCaptureMarkerType::ASSET_FREE,
+                                  data.data(), data.size() );
+    }
+}
+
+void AssetStreamer::Upload( AssetUpload &upload )
+{
+    auto &resources = *mResources;
+    switch ( upload.Type )
+    {
+    case AssetType::Raster:
+    {
+        auto &pool = resources.GetRasterPool();
+        // client may free the asset before it's uploaded
+        if ( pool.IsPending( upload.Id ) )
+            pool.ResolveResource( upload.Id,
+                                  RasterLoadCmdImpl::CreateResource(
+                                      upload.Payload.Reader() ) );
+        break;
+    }
+    case AssetType::Mesh:
+    {
+        auto &pool = resources.GetMeshPool();
+        if ( !pool.IsPending( upload.Id ) )
+            break;
+        // replayed uploads have no emissive triangles found in advance
+        auto mesh = upload.EmissiveTriangles
+                        ? LoadMeshCmdImpl::CreateResource(
+                              upload.Payload.Reader(),
+                              std::move( *upload.EmissiveTriangles ) )
+                        : LoadMeshCmdImpl::CreateResource(
+                              upload.Payload.Reader() );
+        pool.ResolveResource( upload.Id, std::move( mesh ) );
+        break;
+    }
+    case AssetType::SkinMesh:
+    {
+        auto &pool = resources.GetSkinMeshPool();
+        if ( pool.IsPending( upload.Id ) )
+            pool.ResolveResource( upload.Id,
+                                  SkinnedMeshLoadCmdImpl::CreateResource(
+                                      upload.Payload.Reader() ) );
+        break;
+    }
+    default: break;
+    }
+
+    // uploads run on time budget, replay has to upload the same assets
+    // between the same tasks to get the same resources
+    if ( mTaskQueue.IsCapturing() )
+    {
+        AssetUploadMarker    marker{ .Type = upload.Type, .Id = upload.Id };
+        const auto           payload = upload.Payload.Data();
+        std::vector<uint8_t> data( sizeof( marker ) + payload.size() );
+        std::memcpy( data.data(), &marker, sizeof( marker ) );
+        std::memcpy( data.data() + sizeof( marker ), payload.data(),
+                     payload.size() );
+        mTaskQueue.CaptureMarker( TaskCaptureMarkerType::ASSET_UPLOAD,
+                                  data.data(), data.size() );
+    }
+}
+
+bool AssetStreamer::UploadNext()
+{
+    AssetUpload upload;
+    {
+        std::lock_guard lock( mMutex );
+        if ( mUploads.empty() )
+            return false;
+        upload = std::move( mUploads.front() );
+        mUploads.pop_front();
+    }
+    Upload( upload );
+
+    std::lock_guard lock( mMutex );
+    return !mUploads.empty();
+}
+
+} // namespace rh::rw::engine
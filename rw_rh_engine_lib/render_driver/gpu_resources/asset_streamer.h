@@ -0,0 +1,189 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include <data_desc/light_system/packed_light.h>
+#include <ipc/MemoryReader.h>
+#include <ipc/MemoryWriter.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace rh::engine
+{
+class IDeviceState;
+class IImageBuffer;
+class IImageView;
+} // namespace rh::engine
+
+namespace rh::rw::engine
+{
+class EngineResourceHolder;
+class SharedMemoryTaskQueue;
+
+enum class AssetType : uint32_t
+{
+    Raster,
+    Mesh,
+    SkinMesh,
+    Count
+};
+
+/// ASSET_RESERVE capture marker data
+struct AssetReserveMarker
+{
+    AssetType Type;
+    uint32_t  Count;
+};
+
+/// ASSET_FREE capture marker data, followed by Count freed ids
+struct AssetFreeMarker
+{
+    AssetType Type;
+    uint32_t  Count;
+};
+
+/// ASSET_UPLOAD capture marker data, followed by asset payload
+struct AssetUploadMarker
+{
+    AssetType Type;
+    uint32_t  Padding = 0;
+    uint64_t  Id;
+};
+
+/**
+ * Asset task payload copied out of shared memory, so the task can be
+ * answered before the asset is uploaded
+ */
+class AssetPayload
+{
+  public:
+    template <typename T> T Copy( MemoryReader &reader )
+    {
+        CopyArray<T>( reader, 1 );
+        T value;
+        std::memcpy( &value, mData.data() + mData.size() - sizeof( T ),
+                     sizeof( T ) );
+        return value;
+    }
+
+    template <typename T> void CopyArray( MemoryReader &reader, uint64_t count )
+    {
+        const auto size = sizeof( T ) * count;
+        const auto *src = reader.Read<uint8_t>( size );
+        mData.insert( mData.end(), src, src + size );
+    }
+
+    void Assign( std::span<const uint8_t> data )
+    {
+        mData.assign( data.begin(), data.end() );
+    }
+
+    [[nodiscard]] std::span<const uint8_t> Data() const { return mData; }
+    [[nodiscard]] MemoryReader             Reader()
+    {
+        return MemoryReader( mData.data(), mData.size() );
+    }
+
+  private:
+    std::vector<uint8_t> mData{};
+};
+
+/**
+ * Streams textures and meshes sent through asset task queue.
+ * Asset queue thread only copies the payload and answers with a resource id
+ * reserved in advance, so the client never waits for GPU uploads. Device and
+ * resource pools stay owned by render driver thread, it uploads pending
+ * assets between frame tasks until upload time budget runs out. Until then
+ * rasters are backed by a fallback texture and meshes are empty.
+ */
+class AssetStreamer
+{
+  public:
+    explicit AssetStreamer( SharedMemoryTaskQueue &task_queue );
+    ~AssetStreamer();
+    AssetStreamer( const AssetStreamer & ) = delete;
+    AssetStreamer &operator=( const AssetStreamer & ) = delete;
+
+    /**
+     * Registers load tasks served by asset queue thread, including mesh id
+     * reservation and batched mesh loads
+     */
+    void RegisterTasks( SharedMemoryTaskQueue &asset_queue );
+
+    /// Render driver thread, called once main window is created
+    void Open( rh::engine::IDeviceState &device,
+               EngineResourceHolder &    resources );
+    /// Render driver thread, drops uploads that were not done yet
+    void Close();
+    /// Wakes asset queue thread waiting for reserved ids before shutdown
+    void Stop();
+
+    /**
+     * Render driver thread, called between frame tasks. Reserves resource
+     * ids for asset queue and uploads pending assets until upload time
+     * budget runs out.
+     * @return true if some uploads are still pending
+     */
+    bool Update();
+    /**
+     * Render driver thread, uploads every pending asset, e.g. before raster
+     * is read back
+     */
+    void Flush();
+
+    /**
+     * Replay only, resource ids are reserved and assets are uploaded only
+     * from captured markers, so pool ids match the captured session
+     */
+    void SetReplayMode();
+    void ReplayMarker( int64_t id, std::span<const uint8_t> data );
+
+  private:
+    struct AssetUpload
+    {
+        AssetType    Type;
+        uint64_t     Id;
+        AssetPayload Payload;
+        /// Found by asset queue thread, so render driver thread only
+        /// creates GPU buffers
+        std::optional<std::vector<PackedLight>> EmissiveTriangles{};
+    };
+
+    void        Enqueue( AssetType type, MemoryReader &&reader,
+                         MemoryWriter &&writer );
+    void        EnqueueMeshBatch( MemoryReader &&reader );
+    void        ReserveMeshIds( MemoryReader &&reader, MemoryWriter &&writer );
+    AssetUpload ReadUpload( AssetType type, MemoryReader &reader );
+    uint64_t    TakeReservedId( AssetType type );
+    void        Reserve( AssetType type, uint32_t count );
+    void        Free( AssetType type, std::span<const uint64_t> ids );
+    void        Upload( AssetUpload &upload );
+    bool        UploadNext();
+
+    SharedMemoryTaskQueue &   mTaskQueue;
+    rh::engine::IDeviceState *mDevice    = nullptr;
+    EngineResourceHolder *    mResources = nullptr;
+    rh::engine::IImageBuffer *mFallbackBuffer = nullptr;
+    rh::engine::IImageView *  mFallbackView   = nullptr;
+    std::atomic<bool>         mReplayMode{ false };
+
+    /// guards everything below, shared with asset queue thread
+    std::mutex              mMutex;
+    std::condition_variable mReservedIdsCond;
+    bool                    mOpened  = false;
+    bool                    mStopped = false;
+    std::vector<uint64_t>
+        mReservedIds[static_cast<uint32_t>( AssetType::Count )];
+    std::deque<AssetUpload> mUploads;
+    /// Ids of mesh batch that couldn't be read, freed by render driver thread
+    std::vector<uint64_t> mDroppedMeshIds;
+};
+
+} // namespace rh::rw::engine
@@ -0,0 +1,42 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "content_hash.h"
+#include <cstring>
+
+namespace rh::rw::engine
+{
+uint64_t HashContent( const void *data, uint64_t size, uint64_t seed )
+{
+    // MurmurHash64A, word at a time, so hashing a mesh costs less than
+    // uploading it
+    constexpr uint64_t multiplier = 0xc6a4a7935bd1e995ull;
+    constexpr uint32_t shift      = 47;
+
+    const auto *bytes = static_cast<const uint8_t *>( data );
+    uint64_t    hash  = seed ^ ( size * multiplier );
+    uint64_t    pos   = 0;
+    for ( ; pos + sizeof( uint64_t ) <= size; pos += sizeof( uint64_t ) )
+    {
+        uint64_t word;
+        std::memcpy( &word, bytes + pos, sizeof( word ) );
+        word *= multiplier;
+        word ^= word >> shift;
+        word *= multiplier;
+        hash ^= word;
+        hash *= multiplier;
+    }
+    if ( pos < size )
+    {
+        uint64_t tail = 0;
+        std::memcpy( &tail, bytes + pos, size - pos );
+        hash ^= tail;
+        hash *= multiplier;
+    }
+    hash ^= hash >> shift;
+    hash *= multiplier;
+    hash ^= hash >> shift;
+    return hash;
+}
+} // namespace rh::rw::engine
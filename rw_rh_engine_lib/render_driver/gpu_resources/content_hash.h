@@ -0,0 +1,14 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include <cstdint>
+
+namespace rh::rw::engine
+{
+/**
+ * 64 bit hash of memory contents, used to find identical resources sent by
+ * the client. Not cryptographic, callers also compare resource sizes.
+ */
+uint64_t HashContent( const void *data, uint64_t size, uint64_t seed = 0 );
+} // namespace rh::rw::engine
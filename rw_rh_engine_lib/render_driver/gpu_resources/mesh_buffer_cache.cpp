@@ -0,0 +1,58 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "mesh_buffer_cache.h"
+#include <rw_engine/rh_backend/mesh_rendering_backend.h>
+
+namespace rh::rw::engine
+{
+bool MeshBufferCache::Acquire( const MeshBufferKey &key,
+                               BackendMeshData &    mesh )
+{
+    auto entry = mEntries.find( key );
+    if ( entry == mEntries.end() )
+        return false;
+    entry->second.IndexBuffer->AddRef();
+    entry->second.VertexBuffer->AddRef();
+    entry->second.MeshCount++;
+    mesh.mIndexBuffer  = entry->second.IndexBuffer;
+    mesh.mVertexBuffer = entry->second.VertexBuffer;
+
+    mStats.SharedMeshCount++;
+    mStats.SavedBytes += entry->second.Size;
+    return true;
+}
+
+void MeshBufferCache::Insert( const MeshBufferKey &  key,
+                              const BackendMeshData &mesh )
+{
+    if ( mesh.mIndexBuffer == nullptr || mesh.mVertexBuffer == nullptr )
+        return;
+    const uint64_t size =
+        key.IndexCount * sizeof( uint16_t ) +
+        key.VertexCount * sizeof( VertexDescPosColorUVNormals );
+    mEntries[key] = Entry{ .IndexBuffer  = mesh.mIndexBuffer,
+                           .VertexBuffer = mesh.mVertexBuffer,
+                           .MeshCount    = 1,
+                           .Size         = size };
+    mKeys[mesh.mVertexBuffer] = key;
+}
+
+void MeshBufferCache::Release( const BackendMeshData &mesh )
+{
+    auto key = mKeys.find( mesh.mVertexBuffer );
+    if ( key == mKeys.end() )
+        return;
+    auto entry = mEntries.find( key->second );
+    if ( --entry->second.MeshCount > 0 )
+    {
+        mStats.SharedMeshCount--;
+        mStats.SavedBytes -= entry->second.Size;
+        return;
+    }
+    // buffers are destroyed right after this
+    mEntries.erase( entry );
+    mKeys.erase( key );
+}
+} // namespace rh::rw::engine
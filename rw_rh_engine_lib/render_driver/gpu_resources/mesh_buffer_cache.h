@@ -0,0 +1,78 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+
+namespace rh::rw::engine
+{
+struct BackendMeshData;
+class RefCountedBuffer;
+
+/// Identifies mesh vertex and index streams by contents
+struct MeshBufferKey
+{
+    uint64_t VertexHash  = 0;
+    uint64_t IndexHash   = 0;
+    uint64_t VertexCount = 0;
+    uint64_t IndexCount  = 0;
+
+    bool operator==( const MeshBufferKey & ) const = default;
+};
+
+struct MeshBufferCacheStats
+{
+    /// Meshes that reuse buffers of an identical mesh
+    uint64_t SharedMeshCount = 0;
+    /// GPU memory that would be used by buffers of shared meshes
+    uint64_t SavedBytes = 0;
+};
+
+/**
+ * Render driver side cache of mesh buffers by their contents. Game ships
+ * many byte identical geometries under different models, e.g. LODs and
+ * clone props, meshes with identical streams share a single buffer pair.
+ * Cache doesn't own buffers, entries are removed once the last mesh using
+ * them is destroyed.
+ */
+class MeshBufferCache
+{
+  public:
+    /**
+     * Makes mesh reference buffers of an identical mesh, if there is one
+     * @return false if mesh needs its own buffers
+     */
+    bool Acquire( const MeshBufferKey &key, BackendMeshData &mesh );
+    /// Adds buffers created for a mesh that wasn't found in cache
+    void Insert( const MeshBufferKey &key, const BackendMeshData &mesh );
+    /// Called before destroyed mesh releases its buffers
+    void Release( const BackendMeshData &mesh );
+
+    [[nodiscard]] const MeshBufferCacheStats &GetStats() const
+    {
+        return mStats;
+    }
+
+  private:
+    struct KeyHash
+    {
+        uint64_t operator()( const MeshBufferKey &key ) const
+        {
+            return key.VertexHash ^ ( key.IndexHash * 31 );
+        }
+    };
+    struct Entry
+    {
+        RefCountedBuffer *IndexBuffer  = nullptr;
+        RefCountedBuffer *VertexBuffer = nullptr;
+        uint64_t          MeshCount    = 0;
+        uint64_t          Size         = 0;
+    };
+
+    std::unordered_map<MeshBufferKey, Entry, KeyHash> mEntries;
+    /// cached meshes by their vertex buffer
+    std::unordered_map<const RefCountedBuffer *, MeshBufferKey> mKeys;
+    MeshBufferCacheStats                                       mStats{};
+};
+} // namespace rh::rw::engine
@@ -0,0 +1,52 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "raster_image_cache.h"
+#include "raster_pool.h"
+
+namespace rh::rw::engine
+{
+bool RasterImageCache::Acquire( const RasterImageKey &key,
+                                RasterData           &raster )
+{
+    auto entry = mEntries.find( key );
+    if ( entry == mEntries.end() )
+        return false;
+    entry->second.RasterCount++;
+    raster.mImageBuffer = entry->second.ImageBuffer;
+    raster.mImageView   = entry->second.ImageView;
+
+    mStats.SharedRasterCount++;
+    mStats.SavedBytes += key.Size;
+    return true;
+}
+
+void RasterImageCache::Insert( const RasterImageKey &key,
+                               const RasterData     &raster )
+{
+    if ( raster.mImageView == nullptr )
+        return;
+    mEntries[key] = Entry{ .ImageBuffer = raster.mImageBuffer,
+                           .ImageView   = raster.mImageView,
+                           .RasterCount = 1 };
+    mKeys[raster.mImageView] = key;
+}
+
+bool RasterImageCache::Release( const RasterData &raster )
+{
+    auto key = mKeys.find( raster.mImageView );
+    if ( key == mKeys.end() )
+        return true;
+    auto entry = mEntries.find( key->second );
+    if ( --entry->second.RasterCount > 0 )
+    {
+        mStats.SharedRasterCount--;
+        mStats.SavedBytes -= key->second.Size;
+        return false;
+    }
+    mEntries.erase( entry );
+    mKeys.erase( key );
+    return true;
+}
+} // namespace rh::rw::engine
@@ -0,0 +1,85 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+
+namespace rh::engine
+{
+class IImageBuffer;
+class IImageView;
+} // namespace rh::engine
+
+namespace rh::rw::engine
+{
+struct RasterData;
+
+/// Identifies raster by its header and mip chain contents
+struct RasterImageKey
+{
+    uint64_t ContentHash = 0;
+    /// Size of mip chain data
+    uint64_t Size = 0;
+
+    bool operator==( const RasterImageKey & ) const = default;
+};
+
+struct RasterImageCacheStats
+{
+    /// Rasters that reuse image of an identical raster
+    uint64_t SharedRasterCount = 0;
+    /// Texture data that would be uploaded for shared rasters
+    uint64_t SavedBytes = 0;
+};
+
+/**
+ * Render driver side cache of raster images by their contents. The same
+ * textures are embedded into many TXDs, e.g. road tiles and vehicle parts,
+ * rasters with identical contents share a single image and view, so they
+ * are uploaded once and take a single bindless texture slot.
+ * Images are reference counted by the cache and destroyed with the last
+ * raster using them.
+ */
+class RasterImageCache
+{
+  public:
+    /**
+     * Makes raster reference image of an identical raster, if there is one
+     * @return false if raster needs its own image
+     */
+    bool Acquire( const RasterImageKey &key, RasterData &raster );
+    /// Adds image created for a raster that wasn't found in cache
+    void Insert( const RasterImageKey &key, const RasterData &raster );
+    /**
+     * Called when raster is destroyed
+     * @return true if raster was the last one using its image, so it has to
+     * be destroyed
+     */
+    bool Release( const RasterData &raster );
+
+    [[nodiscard]] const RasterImageCacheStats &GetStats() const
+    {
+        return mStats;
+    }
+
+  private:
+    struct KeyHash
+    {
+        uint64_t operator()( const RasterImageKey &key ) const
+        {
+            return key.ContentHash;
+        }
+    };
+    struct Entry
+    {
+        rh::engine::IImageBuffer *ImageBuffer = nullptr;
+        rh::engine::IImageView   *ImageView   = nullptr;
+        uint64_t                  RasterCount = 0;
+    };
+
+    std::unordered_map<RasterImageKey, Entry, KeyHash>               mEntries;
+    std::unordered_map<const rh::engine::IImageView *, RasterImageKey> mKeys;
+    RasterImageCacheStats                                            mStats{};
+};
+} // namespace rh::rw::engine
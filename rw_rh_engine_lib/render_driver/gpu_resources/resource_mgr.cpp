@@ -3,11 +3,18 @@
 //
 
 #include "resource_mgr.h"
+#include <Engine/EngineConfigBlock.h>
+#include <chrono>
+
 namespace rh::rw::engine
 {
 
 EngineResourceHolder::EngineResourceHolder()
-    : RasterPool( 11000, []( RasterData &data, uint64_t ) { data.Release(); } ),
+    : RasterPool( 11000,
+                  [this]( RasterData &data, uint64_t ) {
+                      if ( RasterImages.Release( data ) )
+                          data.Release();
+                  } ),
       SkinMeshPool( 1000,
                     []( SkinMeshData &data, uint64_t id ) {
                         if ( data.mIndexBuffer &&
@@ -17,7 +24,8 @@ EngineResourceHolder::EngineResourceHolder()
                              RefCountedBuffer::Release( data.mVertexBuffer ) )
                             delete data.mVertexBuffer;
                     } ),
-      MeshPool( 10000, []( BackendMeshData &obj, uint64_t id ) {
+      MeshPool( 10000, [this]( BackendMeshData &obj, uint64_t id ) {
+          MeshBuffers.Release( obj );
           if ( obj.mIndexBuffer &&
                RefCountedBuffer::Release( obj.mIndexBuffer ) )
               delete obj.mIndexBuffer;
@@ -28,10 +36,54 @@ EngineResourceHolder::EngineResourceHolder()
 {
 }
 
-void EngineResourceHolder::GC()
+void EngineResourceHolder::SetFrameFences( uint64_t recorded_frame,
+                                           uint64_t completed_frame )
+{
+    RasterPool.SetFrameFences( recorded_frame, completed_frame );
+    SkinMeshPool.SetFrameFences( recorded_frame, completed_frame );
+    MeshPool.SetFrameFences( recorded_frame, completed_frame );
+}
+
+GCProgress EngineResourceHolder::GC()
+{
+    using namespace std::chrono;
+    GCProgress progress{};
+    if ( HasReplayGC )
+    {
+        HasReplayGC = false;
+        progress.SkinMeshCount =
+            SkinMeshPool.CollectGarbage( ReplayGC.SkinMeshCount );
+        progress.MeshCount = MeshPool.CollectGarbage( ReplayGC.MeshCount );
+        progress.RasterCount =
+            RasterPool.CollectGarbage( ReplayGC.RasterCount );
+        return progress;
+    }
+
+    // pools are collected in small batches, so a sector unload spreads over
+    // several frames instead of stalling one
+    constexpr uint64_t gc_batch_size = 16;
+
+    const auto deadline =
+        steady_clock::now() +
+        microseconds( rh::engine::EngineConfigBlock::It.GCTimeBudgetUs );
+    uint64_t freed;
+    do
+    {
+        const auto skin_mesh_count =
+            SkinMeshPool.CollectGarbage( gc_batch_size );
+        const auto mesh_count   = MeshPool.CollectGarbage( gc_batch_size );
+        const auto raster_count = RasterPool.CollectGarbage( gc_batch_size );
+        progress.SkinMeshCount += skin_mesh_count;
+        progress.MeshCount += mesh_count;
+        progress.RasterCount += raster_count;
+        freed = skin_mesh_count + mesh_count + raster_count;
+    } while ( freed > 0 && steady_clock::now() < deadline );
+    return progress;
+}
+
+void EngineResourceHolder::ReplayNextGC( const GCProgress &progress )
 {
-    SkinMeshPool.CollectGarbage( 1000 );
-    MeshPool.CollectGarbage( 120 );
-    RasterPool.CollectGarbage( 100 );
+    ReplayGC    = progress;
+    HasReplayGC = true;
 }
 } // namespace rh::rw::engine
\ No newline at end of file
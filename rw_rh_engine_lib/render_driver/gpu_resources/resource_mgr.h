@@ -4,6 +4,8 @@
 
 #pragma once
 #include <Engine/ResourcePool.h>
+#include <render_driver/gpu_resources/mesh_buffer_cache.h>
+#include <render_driver/gpu_resources/raster_image_cache.h>
 #include <render_driver/gpu_resources/raster_pool.h>
 #include <rw_engine/rh_backend/mesh_rendering_backend.h>
 #include <rw_engine/rh_backend/skinned_mesh_backend.h>
@@ -18,12 +20,36 @@ class IImageView;
 
 namespace rh::rw::engine
 {
+/// Resource counts destroyed by a single GC run
+struct GCProgress
+{
+    uint64_t SkinMeshCount = 0;
+    uint64_t MeshCount     = 0;
+    uint64_t RasterCount   = 0;
+};
+
 class EngineResourceHolder
 {
   public:
     EngineResourceHolder();
 
-    void GC();
+    /**
+     * Updates frame fences of all pools, freed resources are destroyed only
+     * after the last frame that may use them is completed
+     * @param recorded_frame - last frame that may use resources freed from
+     * now on
+     * @param completed_frame - last frame GPU has finished executing
+     */
+    void SetFrameFences( uint64_t recorded_frame, uint64_t completed_frame );
+
+    /// Destroys retired resources until GC time budget runs out
+    GCProgress GC();
+    /**
+     * Replay only, next GC destroys exactly the captured resource counts
+     * instead of running on time budget, so pool ids match the captured
+     * session
+     */
+    void ReplayNextGC( const GCProgress &progress );
 
     rh::engine::ResourcePool<RasterData> &GetRasterPool() { return RasterPool; }
     rh::engine::ResourcePool<SkinMeshData> &GetSkinMeshPool()
@@ -34,11 +60,19 @@ class EngineResourceHolder
     {
         return MeshPool;
     }
+    MeshBufferCache  &GetMeshBufferCache() { return MeshBuffers; }
+    RasterImageCache &GetRasterImageCache() { return RasterImages; }
 
   private:
+    // pools release cached buffers and images on destruction, so caches
+    // must outlive them
+    MeshBufferCache  MeshBuffers{};
+    RasterImageCache RasterImages{};
     // Resources
     rh::engine::ResourcePool<RasterData>      RasterPool;
     rh::engine::ResourcePool<SkinMeshData>    SkinMeshPool;
     rh::engine::ResourcePool<BackendMeshData> MeshPool;
+    GCProgress                                ReplayGC{};
+    bool                                      HasReplayGC = false;
 };
 } // namespace rh::rw::engine
\ No newline at end of file
@@ -4,6 +4,7 @@
 
 #include "render_driver.h"
 #include "framebuffer_loop.h"
+#include "gpu_resources/asset_streamer.h"
 #include "gpu_resources/resource_mgr.h"
 
 #include <rw_engine/system_funcs/get_adapter_cmd.h>
@@ -29,18 +30,39 @@
 #include <Engine/Common/IDeviceState.h>
 #include <Engine/Common/IImageBuffer.h>
 #include <Engine/Common/IImageView.h>
+#include <Engine/Definitions.h>
 #include <Engine/EngineConfigBlock.h>
+#include <Engine/NullImpl/NullDeviceState.h>
 #include <Engine/VulkanImpl/VulkanDeviceState.h>
+#include <data_desc/instances/mesh_instance.h>
 
+#include <rendering_loop/headless/HeadlessRenderer.h>
 #include <rendering_loop/ray_tracing/RayTracingRenderer.h>
 
 namespace rh::rw::engine
 {
 std::unique_ptr<RenderDriver> gRenderDriver = nullptr;
 
+namespace
+{
+bool UseNullDevice()
+{
+    return rh::engine::EngineConfigBlock::It.RenderingAPI_id ==
+           static_cast<uint32_t>( rh::engine::RenderingAPI::Null );
+}
+} // namespace
+
 RenderDriver::RenderDriver()
 {
-    DeviceState = std::make_unique<rh::engine::VulkanDeviceState>();
+    const auto &config = rh::engine::EngineConfigBlock::It;
+    if ( UseNullDevice() )
+        DeviceState = std::make_unique<rh::engine::NullDeviceState>(
+            rh::engine::NullDeviceCreateInfo{
+                .mWidth  = config.RendererWidth,
+                .mHeight = config.RendererHeight } );
+    else
+        DeviceState = std::make_unique<rh::engine::VulkanDeviceState>();
+    MeshInstances = std::make_unique<MeshInstanceTable>();
 
     /// initialize SM task queue
     TaskQueue =
@@ -51,17 +73,50 @@ RenderDriver::RenderDriver()
             .mOwner =
                 IPCSettings::mMode == IPCRenderMode::MultiThreadedRenderer } );
 
+    if ( !config.TaskCapturePath.empty() )
+        TaskQueue->StartCapture( config.TaskCapturePath );
+
+    Streamer = std::make_unique<AssetStreamer>( *TaskQueue );
+    if ( config.AsyncAssetUploads )
+    {
+        AssetQueue = std::make_unique<SharedMemoryTaskQueue>(
+            SharedMemoryTaskQueueInfo{
+                .mName  = "RenderHookAssetQueue",
+                .mSize  = 1024 * 1024 * config.AssetSharedMemorySizeMB,
+                .mOwner = IPCSettings::mMode ==
+                          IPCRenderMode::MultiThreadedRenderer } );
+        Streamer->RegisterTasks( *AssetQueue );
+        AssetQueueThread = std::make_unique<std::thread>(
+            [this]()
+            {
+                while ( IsRunning )
+                    AssetQueue->TaskLoop();
+            } );
+    }
+
     TaskQueueThread = std::make_unique<std::thread>(
         [this]()
         {
+            bool has_uploads = false;
             while ( IsRunning )
-                TaskQueue->TaskLoop();
+            {
+                // streamed uploads are done once published tasks are
+                // drained, frame tasks always go first
+                if ( has_uploads )
+                    TaskQueue->TaskLoop( 0 );
+                else
+                    TaskQueue->TaskLoop();
+                has_uploads = Streamer->Update();
+            }
         } );
 }
 
 RenderDriver::~RenderDriver()
 {
     IsRunning = false;
+    Streamer->Stop();
+    if ( AssetQueueThread && AssetQueueThread->joinable() )
+        AssetQueueThread->join();
     if ( TaskQueueThread && TaskQueueThread->joinable() )
         TaskQueueThread->join();
 }
@@ -93,11 +148,16 @@ bool RenderDriver::OpenMainWindow( HWND window )
         return false;
 
     RendererBase renderer_info{ *DeviceState, *MainWindow, *Resources };
-    Renderer = std::make_unique<RayTracingRenderer>( renderer_info );
+    // ray tracing passes depend on vulkan device
+    if ( UseNullDevice() )
+        Renderer = std::make_unique<HeadlessRenderer>( renderer_info );
+    else
+        Renderer = std::make_unique<RayTracingRenderer>( renderer_info );
 
     FramebufferLoopCreateInfo fb_info{ *DeviceState, *MainWindow, *Renderer };
     FrameLoop = std::make_unique<FramebufferLoop>( fb_info );
 
+    Streamer->Open( *DeviceState, *Resources );
     return true;
 }
 
@@ -109,6 +169,7 @@ bool RenderDriver::CloseMainWindow()
 
     Renderer.reset();
 
+    Streamer->Close();
     Resources.reset();
 
     MainWindow.reset();
@@ -118,8 +179,18 @@ bool RenderDriver::CloseMainWindow()
 
 void RenderDriver::DrawFrame( const FrameState &frame_state )
 {
+    // resources freed while the frame is recorded may still be used by it
+    Resources->SetFrameFences( FrameLoop->RecordedFrame() + 1,
+                               FrameLoop->CompletedFrame() );
     FrameLoop->Run( frame_state );
-    Resources->GC();
+    Resources->SetFrameFences( FrameLoop->RecordedFrame(),
+                               FrameLoop->CompletedFrame() );
+    const auto gc_progress = Resources->GC();
+    // GC runs on time budget, replay has to destroy the same resources to
+    // get the same resource ids
+    if ( TaskQueue->IsCapturing() )
+        TaskQueue->CaptureMarker( TaskCaptureMarkerType::GC_PROGRESS,
+                                  &gc_progress, sizeof( gc_progress ) );
 }
 
 EngineResourceHolder &RenderDriver::GetResources()
@@ -16,9 +16,11 @@ class IWindow;
 
 namespace rh::rw::engine
 {
+class AssetStreamer;
 class EngineResourceHolder;
 class FramebufferLoop;
 class IFrameRenderer;
+class MeshInstanceTable;
 
 struct FrameState;
 class RenderDriver
@@ -43,6 +45,12 @@ class RenderDriver
         return *TaskQueue;
     }
 
+    AssetStreamer &GetAssetStreamer()
+    {
+        assert( Streamer );
+        return *Streamer;
+    }
+
     rh::engine::IDeviceState &GetDeviceState()
     {
         assert( DeviceState );
@@ -55,15 +63,27 @@ class RenderDriver
         return *MainWindow;
     }
 
+    MeshInstanceTable &GetMeshInstanceTable()
+    {
+        assert( MeshInstances );
+        return *MeshInstances;
+    }
+
   private:
     std::atomic<bool>                         IsRunning{ true };
     std::unique_ptr<SharedMemoryTaskQueue>    TaskQueue;
     std::unique_ptr<std::thread>              TaskQueueThread;
+    /// Texture and mesh loads, answered without waiting for frame tasks
+    std::unique_ptr<SharedMemoryTaskQueue>    AssetQueue;
+    std::unique_ptr<std::thread>              AssetQueueThread;
+    std::unique_ptr<AssetStreamer>            Streamer;
     std::unique_ptr<rh::engine::IDeviceState> DeviceState;
     std::unique_ptr<rh::engine::IWindow>      MainWindow;
     std::unique_ptr<EngineResourceHolder>     Resources;
     std::unique_ptr<IFrameRenderer>           Renderer;
     std::unique_ptr<FramebufferLoop>          FrameLoop;
+    /// Outlives main window, client keeps sending deltas against it
+    std::unique_ptr<MeshInstanceTable>        MeshInstances;
 };
 
 /**
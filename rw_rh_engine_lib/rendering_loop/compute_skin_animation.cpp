@@ -3,9 +3,11 @@
 //
 
 #include "compute_skin_animation.h"
+#include <DebugUtils/DebugLogger.h>
 #include <Engine/VulkanImpl/VulkanCommandBuffer.h>
 #include <Engine/VulkanImpl/VulkanDebugUtils.h>
 #include <Engine/VulkanImpl/VulkanDeviceState.h>
+#include <data_desc/capacity_policy.h>
 #include <data_desc/frame_info.h>
 #include <render_client/skin_instance_state_recorder.h>
 #include <render_driver/frame_renderer.h>
@@ -15,14 +17,12 @@
 namespace rh::rw::engine
 {
 
-static const int bone_matrix_count         = 256;
-constexpr int    bone_matrix_bind_idx      = 2;
-constexpr int    prev_bone_matrix_bind_idx = 3;
+constexpr int bone_matrix_bind_idx      = 2;
+constexpr int prev_bone_matrix_bind_idx = 3;
 
 SkinAnimationPipeline::SkinAnimationPipeline(
     const SkinAnimationPipelineCreateInfo &info )
-    : Device( info.Device ), Resources( info.Resources ),
-      mMaxAnims( info.AnimBufferLimit )
+    : Device( info.Device ), Resources( info.Resources )
 {
     using namespace rh::engine;
     auto &device   = (VulkanDeviceState &)Device;
@@ -33,13 +33,6 @@ SkinAnimationPipeline::SkinAnimationPipeline(
                                     std::string( "skin_animation_finish_sp" ) );
 #endif
 
-    DescriptorSetAllocatorCreateParams dsc_all_cp{};
-    std::array                         dsc_pool_sizes = {
-        DescriptorPoolSize{ DescriptorType::RWBuffer, 4 * mMaxAnims } };
-
-    dsc_all_cp.mMaxSets         = mMaxAnims;
-    dsc_all_cp.mDescriptorPools = dsc_pool_sizes;
-    mDescAllocator = device.CreateDescriptorSetAllocator( dsc_all_cp );
     //
     // [ {type: rw_buff, count: 1, reg: 0} ]
     //
@@ -57,13 +50,6 @@ SkinAnimationPipeline::SkinAnimationPipeline(
 
     mDescSetLayout = device.CreateDescriptorSetLayout( { desc_set_bindings } );
 
-    std::vector<IDescriptorSetLayout *> layout_array( mMaxAnims,
-                                                      mDescSetLayout );
-
-    DescriptorSetsAllocateParams all_params{};
-    all_params.mLayouts = layout_array;
-    mDescSetPool        = mDescAllocator->AllocateDescriptorSets( all_params );
-
     mPipelineLayout = device.CreatePipelineLayout(
         { .mSetLayouts = {
               static_cast<IDescriptorSetLayout *>( mDescSetLayout ) } } );
@@ -82,65 +68,84 @@ SkinAnimationPipeline::SkinAnimationPipeline(
     create_info.mLayout                  = mPipelineLayout;
     mPipeline = device.CreateComputePipeline( create_info );
 
-    mBoneMatrixPool.resize( mMaxAnims * 2 );
+    GrowAnimSlots( info.AnimBufferLimit );
+
+    mCmdBuffer = (VulkanCommandBuffer *)device.CreateCommandBuffer();
+#ifdef _DEBUG
+    VulkanDebugUtils::SetDebugName(
+        mCmdBuffer, std::string( "skin_animation_cmd_buffer" ) );
+#endif
+}
+
+void SkinAnimationPipeline::GrowAnimSlots( uint32_t count )
+{
+    using namespace rh::engine;
+    auto &device = (VulkanDeviceState &)Device;
+
+    // new slots get their own allocator, so descriptor sets recorded into
+    // previous frames stay untouched
+    DescriptorSetAllocatorCreateParams dsc_all_cp{};
+    std::array                         dsc_pool_sizes = {
+        DescriptorPoolSize{ DescriptorType::RWBuffer, 4 * count } };
+
+    dsc_all_cp.mMaxSets         = count;
+    dsc_all_cp.mDescriptorPools = dsc_pool_sizes;
+    auto *allocator = device.CreateDescriptorSetAllocator( dsc_all_cp );
+    mDescAllocators.push_back( allocator );
+
+    std::vector<IDescriptorSetLayout *> layout_array( count, mDescSetLayout );
+
+    DescriptorSetsAllocateParams all_params{};
+    all_params.mLayouts = layout_array;
+    auto desc_sets      = allocator->AllocateDescriptorSets( all_params );
 
     BufferCreateInfo bone_buff_ci{};
-    bone_buff_ci.mSize  = sizeof( DirectX::XMFLOAT4X3 ) * bone_matrix_count;
+    bone_buff_ci.mSize  = sizeof( DirectX::XMFLOAT4X3 ) * gSkinBoneLimit;
     bone_buff_ci.mUsage = BufferUsage::StorageBuffer;
     bone_buff_ci.mFlags = BufferFlags::Dynamic;
-    for ( int idx = 0; idx < mMaxAnims; idx++ )
+    for ( auto *desc_set : desc_sets )
     {
-        mBoneMatrixPool[idx] = device.CreateBuffer( bone_buff_ci );
+        auto idx = mDescSetPool.size();
+        mDescSetPool.push_back( desc_set );
+        mBoneMatrixPool.push_back( device.CreateBuffer( bone_buff_ci ) );
+        mPrevBoneMatrixPool.push_back( device.CreateBuffer( bone_buff_ci ) );
 #ifdef _DEBUG
         VulkanDebugUtils::SetDebugName( mBoneMatrixPool[idx],
                                         std::string( "bone_matrix_buffer_" ) +
                                             std::to_string( idx ) );
+        VulkanDebugUtils::SetDebugName(
+            mPrevBoneMatrixPool[idx],
+            std::string( "prev_bone_matrix_buffer_" ) +
+                std::to_string( idx ) );
 #endif
         std::array mtx_buffer_update = {
             BufferUpdateInfo{ 0, VK_WHOLE_SIZE, mBoneMatrixPool[idx] } };
+        std::array prev_mtx_buffer_update = {
+            BufferUpdateInfo{ 0, VK_WHOLE_SIZE, mPrevBoneMatrixPool[idx] } };
         DescriptorSetUpdateInfo mtx_updateInfo{};
-        mtx_updateInfo.mSet              = mDescSetPool[idx];
+        mtx_updateInfo.mSet              = desc_set;
         mtx_updateInfo.mBinding          = bone_matrix_bind_idx;
         mtx_updateInfo.mDescriptorType   = DescriptorType::RWBuffer;
         mtx_updateInfo.mBufferUpdateInfo = mtx_buffer_update;
-
         device.UpdateDescriptorSets( mtx_updateInfo );
-    }
 
-    for ( uint32_t idx = mMaxAnims; idx < mMaxAnims * 2; idx++ )
-    {
-        mBoneMatrixPool[idx] = device.CreateBuffer( bone_buff_ci );
-#ifdef _DEBUG
-        VulkanDebugUtils::SetDebugName( mBoneMatrixPool[idx],
-                                        std::string( "bone_matrix_buffer_" ) +
-                                            std::to_string( idx ) );
-#endif
-        std::array mtx_buffer_update = {
-            BufferUpdateInfo{ 0, VK_WHOLE_SIZE, mBoneMatrixPool[idx] } };
-        DescriptorSetUpdateInfo mtx_updateInfo{};
-        mtx_updateInfo.mSet              = mDescSetPool[idx - mMaxAnims];
         mtx_updateInfo.mBinding          = prev_bone_matrix_bind_idx;
-        mtx_updateInfo.mDescriptorType   = DescriptorType::RWBuffer;
-        mtx_updateInfo.mBufferUpdateInfo = mtx_buffer_update;
-
+        mtx_updateInfo.mBufferUpdateInfo = prev_mtx_buffer_update;
         device.UpdateDescriptorSets( mtx_updateInfo );
     }
-
-    mCmdBuffer = (VulkanCommandBuffer *)device.CreateCommandBuffer();
-#ifdef _DEBUG
-    VulkanDebugUtils::SetDebugName(
-        mCmdBuffer, std::string( "skin_animation_cmd_buffer" ) );
-#endif
+    mMaxAnims = static_cast<uint32_t>( mDescSetPool.size() );
 }
 
 std::vector<AnimatedMeshDrawCall> SkinAnimationPipeline::AnimateSkinnedMeshes(
-    const rh::engine::ArrayProxy<SkinDrawCallInfo> &draw_calls )
+    const SkinInstanceState &skin_state )
 {
     using namespace rh::engine;
     //
 
     auto &dev_state      = dynamic_cast<VulkanDeviceState &>( Device );
     auto &skin_mesh_pool = Resources.GetSkinMeshPool();
+    auto &draw_calls     = skin_state.DrawCalls;
+    auto &bone_palette   = skin_state.BoneTransforms;
 
     std::vector<AnimatedMeshDrawCall> result_drawcalls{};
     result_drawcalls.reserve( draw_calls.Size() );
@@ -154,9 +159,26 @@ std::vector<AnimatedMeshDrawCall> SkinAnimationPipeline::AnimateSkinnedMeshes(
 
     std::vector<AnimDispatch> dispatch_list;
     dispatch_list.reserve( draw_calls.Size() );
+
+    if ( draw_calls.Size() > mMaxAnims )
+    {
+        GrowAnimSlots( static_cast<uint32_t>(
+            GrowCapacity( mMaxAnims, draw_calls.Size() ) - mMaxAnims ) );
+        debug::DebugLogger::LogFmt( "Skin animation slots grown to %u",
+                                    debug::LogLevel::Info, mMaxAnims );
+    }
     uint64_t idx = 0;
     for ( auto &dc : draw_calls )
     {
+        // bone list comes from the client, drop draw calls pointing outside
+        // of the palette
+        if ( dc.BoneListCount > gSkinBoneLimit ||
+             dc.BoneListStart > bone_palette.Size() ||
+             dc.BoneListCount > bone_palette.Size() - dc.BoneListStart )
+            continue;
+        // streamed mesh is not uploaded yet
+        if ( !skin_mesh_pool.IsReady( dc.MeshId ) )
+            continue;
         const auto &mesh_info = skin_mesh_pool.GetResource( dc.MeshId );
 
         // Create temporary buffers
@@ -180,22 +202,18 @@ std::vector<AnimatedMeshDrawCall> SkinAnimationPipeline::AnimateSkinnedMeshes(
 
         // update buffers
 
-        mBoneMatrixPool[idx]->Update( &dc.BoneTransform->f[0],
-                                      sizeof( DirectX::XMFLOAT4X3 ) * 256 );
+        // only bones used by the mesh are uploaded
+        const auto *bones      = bone_palette.Data() + dc.BoneListStart;
+        const auto  bones_size = static_cast<uint32_t>(
+            sizeof( DirectX::XMFLOAT4X3 ) * dc.BoneListCount );
+        mBoneMatrixPool[idx]->Update( bones, bones_size );
 
-        if ( auto it = mAnimationCache.find( anim_dc.mInstanceId );
-             it != mAnimationCache.end() )
-        {
-            mBoneMatrixPool[idx + mMaxAnims]->Update(
-                it->second.data(), sizeof( DirectX::XMFLOAT4X3 ) * 256 );
-        }
+        auto &prev_bones = mAnimationCache[anim_dc.mInstanceId];
+        if ( prev_bones.size() == dc.BoneListCount )
+            mPrevBoneMatrixPool[idx]->Update( prev_bones.data(), bones_size );
         else
-        {
-            mBoneMatrixPool[idx + mMaxAnims]->Update(
-                &dc.BoneTransform->f[0], sizeof( DirectX::XMFLOAT4X3 ) * 256 );
-        }
-        std::copy( std::begin( dc.BoneTransform ), std::end( dc.BoneTransform ),
-                   std::begin( mAnimationCache[anim_dc.mInstanceId] ) );
+            mPrevBoneMatrixPool[idx]->Update( bones, bones_size );
+        prev_bones.assign( bones, bones + dc.BoneListCount );
 
         auto desc_set = mDescSetPool[idx];
         {
@@ -268,8 +286,12 @@ SkinAnimationPipeline::~SkinAnimationPipeline()
 {
     for ( auto buffer : mBoneMatrixPool )
         delete buffer;
+    for ( auto buffer : mPrevBoneMatrixPool )
+        delete buffer;
     for ( auto dset : mDescSetPool )
         delete dset;
+    for ( auto allocator : mDescAllocators )
+        delete allocator;
 }
 
 void SkinAnimationPipeline::Update( const FrameState &state )
@@ -285,8 +307,7 @@ void SkinAnimationPipeline::Update( const FrameState &state )
         return;
 
     // Generate Skin Meshes
-    auto animated_meshes =
-        AnimateSkinnedMeshes( state.SkinInstances.DrawCalls );
+    auto animated_meshes = AnimateSkinnedMeshes( state.SkinInstances );
     if ( animated_meshes.empty() )
         return;
 
@@ -39,9 +39,10 @@ struct SkinAnimationPipelineCreateInfo
     rh::engine::IDeviceState &Device;
     EngineResourceHolder &    Resources;
     // params
+    /// Initial animation slot count, grows with skinned draw call count
     uint32_t AnimBufferLimit;
 };
-struct SkinDrawCallInfo;
+struct SkinInstanceState;
 using rh::engine::ScopedPointer;
 struct FrameState;
 class SkinAnimationPipeline
@@ -50,8 +51,8 @@ class SkinAnimationPipeline
     SkinAnimationPipeline( const SkinAnimationPipelineCreateInfo &info );
     ~SkinAnimationPipeline();
 
-    std::vector<AnimatedMeshDrawCall> AnimateSkinnedMeshes(
-        const rh::engine::ArrayProxy<SkinDrawCallInfo> &draw_calls );
+    std::vector<AnimatedMeshDrawCall>
+         AnimateSkinnedMeshes( const SkinInstanceState &skin_state );
     void Update( const FrameState &state );
 
     rh::engine::CommandBufferSubmitInfo
@@ -60,19 +61,25 @@ class SkinAnimationPipeline
     std::vector<DrawCallInfo> DrawCallList{};
 
   private:
+    /// Allocates descriptor sets and bone buffers for count animation slots
+    void GrowAnimSlots( uint32_t count );
+
     rh::engine::IDeviceState &                         Device;
     EngineResourceHolder &                             Resources;
     ScopedPointer<rh::engine::IShader>                 mAnimShader;
     ScopedPointer<rh::engine::VulkanComputePipeline>   mPipeline;
     ScopedPointer<rh::engine::IPipelineLayout>         mPipelineLayout;
     ScopedPointer<rh::engine::IDescriptorSetLayout>    mDescSetLayout;
-    ScopedPointer<rh::engine::IDescriptorSetAllocator> mDescAllocator;
     ScopedPointer<rh::engine::VulkanCommandBuffer>     mCmdBuffer;
     ScopedPointer<rh::engine::ISyncPrimitive>          mAnimateFinish;
 
-    std::vector<rh::engine::IDescriptorSet *> mDescSetPool;
-    std::vector<rh::engine::IBuffer *>        mBoneMatrixPool;
-    std::unordered_map<uint64_t, std::array<DirectX::XMFLOAT4X3, 256>>
+    /// Each allocator holds descriptor sets of a single growth step
+    std::vector<rh::engine::IDescriptorSetAllocator *> mDescAllocators;
+    std::vector<rh::engine::IDescriptorSet *>          mDescSetPool;
+    std::vector<rh::engine::IBuffer *>                 mBoneMatrixPool;
+    std::vector<rh::engine::IBuffer *>                 mPrevBoneMatrixPool;
+    /// Bone matrices of the previous frame by instance id
+    std::unordered_map<uint64_t, std::vector<DirectX::XMFLOAT4X3>>
              mAnimationCache;
     uint32_t mMaxAnims{};
 };
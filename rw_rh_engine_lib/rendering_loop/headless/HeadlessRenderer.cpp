@@ -0,0 +1,146 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "HeadlessRenderer.h"
+#include <Engine/Common/IDeviceState.h>
+#include <Engine/Common/ISwapchain.h>
+#include <data_desc/frame_info.h>
+#include <render_driver/gpu_resources/resource_mgr.h>
+#include <rendering_loop/ray_tracing/CameraDescription.h>
+#include <rendering_loop/ray_tracing/RTSceneDescription.h>
+#include <rw_engine/rh_backend/im2d_renderer.h>
+#include <rw_engine/rh_backend/im3d_renderer.h>
+
+namespace rh::rw::engine
+{
+using namespace rh::engine;
+
+HeadlessRenderer::HeadlessRenderer( const RendererBase &info )
+    : Device( info.Device ), Resources( info.Resources )
+{
+    rgResourcePool.Create<CameraDescription>( info );
+
+    // same pass layout as forward pass of ray tracing renderer
+    mForwardPass = Device.CreateRenderPass( RenderPassCreateParams{
+        .mAttachments =
+            {
+                { .mFormat     = ImageBufferFormat::BGRA8,
+                  .mDestLayout = ImageLayout::PresentSrc },
+                { .mFormat     = ImageBufferFormat::D24S8,
+                  .mDestLayout = ImageLayout::DepthStencilReadOnly },
+            },
+        .mSubpasses = {
+            { .mBindPoint              = PipelineBindPoint::Graphics,
+              .mColorAttachments       = { { .mReqLayout =
+                                           ImageLayout::ColorAttachment,
+                                       .mAttachmentId = 0 } },
+              .mDepthStencilAttachment = AttachmentRef{
+                  .mReqLayout    = ImageLayout::DepthStencilAttachment,
+                  .mAttachmentId = 1 } } } } );
+
+    mSceneDescription = new RTSceneDescription( { Device, Resources } );
+    mIm2DRenderer =
+        new Im2DRenderer( Device, Resources.GetRasterPool(),
+                          rgResourcePool.Get<CameraDescription>(),
+                          mForwardPass );
+    mIm3DRenderer =
+        new Im3DRenderer( Device, Resources.GetRasterPool(),
+                          rgResourcePool.Get<CameraDescription>(),
+                          mForwardPass );
+}
+
+HeadlessRenderer::~HeadlessRenderer()
+{
+    for ( auto *fb : mFramebufferCache )
+        delete fb;
+}
+
+void HeadlessRenderer::OnResize( const WindowParams &window )
+{
+    for ( auto *&fb : mFramebufferCache )
+    {
+        delete fb;
+        fb = nullptr;
+    }
+}
+
+std::vector<CommandBufferSubmitInfo>
+HeadlessRenderer::Render( const FrameState &state, ICommandBuffer *dest,
+                          const SwapchainFrame &frame )
+{
+    auto framebuffer = GetFrameBuffer( frame );
+
+    rgResourcePool.Update( state );
+
+    const auto &mesh_data = state.MeshInstances;
+    mSceneDescription->RecordMeshInstances( mesh_data );
+    if ( mesh_data.VisibleSlots.Size() > 0 )
+        mSceneDescription->Update();
+
+    dest->BeginRecord();
+    dest->SetViewports(
+        0, { ViewPort{ .width    = static_cast<float>( frame.mWidth ),
+                       .height   = static_cast<float>( frame.mHeight ),
+                       .maxDepth = 1.0 } } );
+    dest->SetScissors( 0, { Scissor{ 0, 0, frame.mWidth, frame.mHeight } } );
+
+    std::array clear_values = {
+        ClearValue{ ClearColor{ state.Viewport->ClearColor.red,
+                                state.Viewport->ClearColor.green,
+                                state.Viewport->ClearColor.blue,
+                                state.Viewport->ClearColor.alpha } },
+        ClearValue{ ClearDepthStencil{ 1.0f, 0 } } };
+
+    dest->BeginRenderPass( { .m_pRenderPass  = mForwardPass,
+                             .m_pFrameBuffer = framebuffer,
+                             .m_aClearValues = clear_values } );
+    mIm2DRenderer->Reset();
+    mIm3DRenderer->Reset();
+    mIm3DRenderer->Render( state.Im3D, dest );
+    mIm2DRenderer->Render( state.Im2D, dest );
+    dest->EndRenderPass();
+    dest->EndRecord();
+    return {};
+}
+
+IFrameBuffer *HeadlessRenderer::GetFrameBuffer( const SwapchainFrame &frame )
+{
+    if ( mFramebufferCache.size() <= frame.mImageId )
+        mFramebufferCache.resize( frame.mImageId + 1, nullptr );
+    auto &framebuffer = mFramebufferCache[frame.mImageId];
+    if ( framebuffer != nullptr )
+        return framebuffer;
+
+    if ( mFrameWidth != frame.mWidth || mFrameHeight != frame.mHeight )
+    {
+        delete mDepthBufferView;
+        delete mDepthBuffer;
+
+        ImageBufferCreateParams ds_buffer{};
+        ds_buffer.mHeight    = frame.mHeight;
+        ds_buffer.mWidth     = frame.mWidth;
+        ds_buffer.mFormat    = ImageBufferFormat::D24S8;
+        ds_buffer.mUsage     = ImageBufferUsage::DepthStencilAttachment;
+        ds_buffer.mDimension = ImageDimensions::d2D;
+        mDepthBuffer         = Device.CreateImageBuffer( ds_buffer );
+
+        ImageViewCreateInfo ds_view{};
+        ds_view.mBuffer  = mDepthBuffer;
+        ds_view.mFormat  = ImageBufferFormat::D24S8;
+        ds_view.mUsage   = ImageViewUsage::DepthStencilTarget;
+        mDepthBufferView = Device.CreateImageView( ds_view );
+
+        mFrameWidth  = frame.mWidth;
+        mFrameHeight = frame.mHeight;
+    }
+
+    framebuffer = Device.CreateFrameBuffer(
+        { .width      = frame.mWidth,
+          .height     = frame.mHeight,
+          .imageViews = { frame.mImageView, mDepthBufferView },
+          .renderPass = mForwardPass } );
+    return framebuffer;
+}
+
+} // namespace rh::rw::engine
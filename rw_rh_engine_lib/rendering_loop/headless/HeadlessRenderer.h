@@ -0,0 +1,59 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include <Engine/Common/ScopedPtr.h>
+#include <render_driver/frame_renderer.h>
+#include <render_driver/render_graph/RenderGraphResourcePool.h>
+
+namespace rh::engine
+{
+class IFrameBuffer;
+class IImageBuffer;
+class IImageView;
+class IRenderPass;
+} // namespace rh::engine
+
+namespace rh::rw::engine
+{
+class Im2DRenderer;
+class Im3DRenderer;
+class RTSceneDescription;
+using rh::engine::ScopedPointer;
+
+/**
+ * Renderer used with null device, runs the API independent part of the ray
+ * tracing renderer: scene description, camera and immediate mode drawing.
+ * Ray tracing passes and skin animation need vulkan device and are skipped,
+ * so skinned instances are not recorded.
+ */
+class HeadlessRenderer : public IFrameRenderer
+{
+  public:
+    HeadlessRenderer( const RendererBase &info );
+    ~HeadlessRenderer() override;
+
+    void OnResize( const rh::engine::WindowParams &window ) override;
+    std::vector<rh::engine::CommandBufferSubmitInfo>
+    Render( const FrameState &scene, rh::engine::ICommandBuffer *dest,
+            const rh::engine::SwapchainFrame &frame ) override;
+
+  private:
+    rh::engine::IFrameBuffer *
+    GetFrameBuffer( const rh::engine::SwapchainFrame &frame );
+
+    rh::engine::IDeviceState &              Device;
+    EngineResourceHolder &                  Resources;
+    RenderGraphResourcePool                 rgResourcePool;
+    ScopedPointer<rh::engine::IRenderPass>  mForwardPass;
+    ScopedPointer<rh::engine::IImageBuffer> mDepthBuffer;
+    ScopedPointer<rh::engine::IImageView>   mDepthBufferView;
+    ScopedPointer<RTSceneDescription>       mSceneDescription;
+    ScopedPointer<Im2DRenderer>             mIm2DRenderer;
+    ScopedPointer<Im3DRenderer>             mIm3DRenderer;
+    std::vector<rh::engine::IFrameBuffer *> mFramebufferCache;
+    uint32_t                                mFrameWidth  = 0;
+    uint32_t                                mFrameHeight = 0;
+};
+
+} // namespace rh::rw::engine
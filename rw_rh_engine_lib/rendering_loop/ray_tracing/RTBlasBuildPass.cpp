@@ -54,7 +54,27 @@ RTBlasBuildPass::RTBlasBuildPass( const BlasBuildPassCreateInfo &info )
         {
             auto &device =
                 dynamic_cast<rh::engine::VulkanDeviceState &>( Device );
-            BLASPool[id].mHasEntry = true;
+            // mesh pool grows when it runs out of slots
+            const auto slot = rh::engine::ResourceSlot( id );
+            if ( slot >= BLASPool.size() )
+                BLASPool.resize( slot + 1 );
+            auto &entry           = BLASPool[slot];
+            entry.mHasEntry       = true;
+            entry.mData.mGeometry = data.mVertexBuffer;
+
+            // meshes with identical contents share buffers, so BLAS is
+            // created and built once per vertex buffer
+            auto &shared = SharedBLASMap[data.mVertexBuffer];
+            if ( shared.RefCount++ > 0 )
+            {
+                entry.mData.mBLAS      = shared.BLAS;
+                entry.mData.mBlasBuilt = shared.Built;
+                Stats.SharedBlasCount++;
+                Stats.SavedBuilds++;
+                if ( !shared.Built )
+                    RequestBlasBuild( id );
+                return;
+            }
             rh::engine::AccelerationStructureCreateInfo ac_ci{};
             ac_ci.mVertexBuffer      = data.mVertexBuffer->Get();
             ac_ci.mIndexBuffer       = data.mIndexBuffer->Get();
@@ -63,7 +83,8 @@ RTBlasBuildPass::RTBlasBuildPass( const BlasBuildPassCreateInfo &info )
             ac_ci.mSplits            = { { 0, 0,
                                 static_cast<uint32_t>( data.mVertexCount ),
                                 static_cast<uint32_t>( data.mIndexCount ) } };
-            BLASPool[id].mData.mBLAS = device.CreateBLAS( ac_ci );
+            entry.mData.mBLAS = device.CreateBLAS( ac_ci );
+            shared.BLAS       = entry.mData.mBLAS;
             // Add BLAS to build list
             RequestBlasBuild( id );
         },
@@ -71,12 +92,23 @@ RTBlasBuildPass::RTBlasBuildPass( const BlasBuildPassCreateInfo &info )
     mesh_pool.AddOnDestructCallback(
         [this]( BackendMeshData &data, uint64_t id )
         {
-            delete static_cast<
-                rh::engine::VulkanBottomLevelAccelerationStructure *>(
-                BLASPool[id].mData.mBLAS );
-            BLASPool[id].mData.mBLAS      = nullptr;
-            BLASPool[id].mData.mBlasBuilt = false;
-            BLASPool[id].mHasEntry        = false;
+            auto &entry  = BLASPool[rh::engine::ResourceSlot( id )];
+            auto  shared = SharedBLASMap.find( entry.mData.mGeometry );
+            if ( shared != SharedBLASMap.end() &&
+                 --shared->second.RefCount > 0 )
+                Stats.SharedBlasCount--;
+            else
+            {
+                delete static_cast<
+                    rh::engine::VulkanBottomLevelAccelerationStructure *>(
+                    entry.mData.mBLAS );
+                if ( shared != SharedBLASMap.end() )
+                    SharedBLASMap.erase( shared );
+            }
+            entry.mData.mBLAS      = nullptr;
+            entry.mData.mGeometry  = nullptr;
+            entry.mData.mBlasBuilt = false;
+            entry.mHasEntry        = false;
         },
         MeshPoolCallbackId );
 }
@@ -107,10 +139,18 @@ void RTBlasBuildPass::Execute()
     {
         auto id = BLASQueue.front();
         BLASQueue.pop();
-        auto &mesh_info = BLASPool[id].mData;
+        auto &mesh_info = BLASPool[rh::engine::ResourceSlot( id )].mData;
         auto  blas = (VulkanBottomLevelAccelerationStructure *)mesh_info.mBLAS;
         if ( !blas )
             continue;
+        // BLAS shared with another mesh could be built in the meantime
+        auto &shared = SharedBLASMap[mesh_info.mGeometry];
+        if ( shared.Built )
+        {
+            mesh_info.mBlasBuilt = true;
+            continue;
+        }
+        shared.Built = true;
 
         scratch_buff_size[current_scratch] = ( std::max )(
             blas->GetScratchSize(), scratch_buff_size[current_scratch] );
@@ -179,16 +219,13 @@ RTBlasBuildPass::~RTBlasBuildPass()
     auto &mesh_pool = Resources.GetMeshPool();
     mesh_pool.RemoveOnRequestCallback( MeshPoolCallbackId );
     mesh_pool.RemoveOnDestructCallback( MeshPoolCallbackId );
-    // Cleanup blas pool
-    for ( auto blas : BLASPool )
-    {
+    // Cleanup blas pool, every BLAS is owned by shared map
+    for ( auto &[geometry, shared] : SharedBLASMap )
         delete static_cast<
             rh::engine::VulkanBottomLevelAccelerationStructure *>(
-            blas.mData.mBLAS );
-        blas.mData.mBLAS      = nullptr;
-        blas.mData.mBlasBuilt = false;
-        blas.mHasEntry        = false;
-    }
+            shared.BLAS );
+    SharedBLASMap.clear();
+    BLASPool.clear();
     delete BlasCmdBuffer;
     delete BlasBuilt;
 }
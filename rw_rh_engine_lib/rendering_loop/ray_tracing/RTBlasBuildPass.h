@@ -7,6 +7,7 @@
 #include <Engine/ResourcePool.h>
 #include <cstdint>
 #include <queue>
+#include <unordered_map>
 #include <vector>
 
 namespace rh::engine
@@ -23,6 +24,8 @@ struct BLASMeshData
 {
     void *mBLAS;
     bool  mBlasBuilt = false;
+    /// Vertex buffer BLAS is built from, meshes sharing it share the BLAS
+    const void *mGeometry = nullptr;
 };
 
 template <typename T> struct PoolEntry
@@ -39,6 +42,14 @@ struct BlasBuildPassCreateInfo
     uint32_t                  ScratchBufferBaseSize = 2 * 1024 * 1024;
 };
 
+struct BlasBuildStats
+{
+    /// Meshes that reuse BLAS of a mesh with shared buffers
+    uint64_t SharedBlasCount = 0;
+    /// BLAS builds skipped over the session
+    uint64_t SavedBuilds = 0;
+};
+
 struct ScratchBuffer
 {
     uint64_t                                       Size = 0;
@@ -58,21 +69,31 @@ class RTBlasBuildPass
 
     const BLASMeshData &GetBlas( uint64_t mesh_id ) const
     {
-        return BLASPool[mesh_id].mData;
+        return BLASPool[rh::engine::ResourceSlot( mesh_id )].mData;
     }
+    const BlasBuildStats &GetStats() const { return Stats; }
 
   private:
+    struct SharedBlas
+    {
+        void    *BLAS     = nullptr;
+        uint32_t RefCount = 0;
+        bool     Built    = false;
+    };
+
     rh::engine::IDeviceState &Device;
     EngineResourceHolder     &Resources;
 
     std::vector<uint64_t>                NewBLASList;
     std::queue<uint64_t>                 BLASQueue;
     std::vector<PoolEntry<BLASMeshData>> BLASPool;
+    std::unordered_map<const void *, SharedBlas> SharedBLASMap;
     rh::engine::VulkanCommandBuffer     *BlasCmdBuffer;
     std::vector<ScratchBuffer>           ScratchBuffers{};
     rh::engine::ISyncPrimitive          *BlasBuilt = nullptr;
     uint8_t                              ScratchBufferCount;
     bool                                 IsCompleted = false;
+    BlasBuildStats                       Stats{};
 };
 
 } // namespace rh::rw::engine
\ No newline at end of file
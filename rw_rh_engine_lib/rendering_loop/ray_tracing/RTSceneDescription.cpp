@@ -7,8 +7,12 @@
 #include "scene_description/gpu_mesh_buffer_pool.h"
 #include "scene_description/gpu_scene_materials_pool.h"
 #include "scene_description/gpu_texture_pool.h"
+#include <DebugUtils/DebugLogger.h>
 #include <Engine/Common/IDeviceState.h>
+#include <algorithm>
+#include <data_desc/capacity_policy.h>
 #include <render_client/mesh_instance_state_recorder.h>
+#include <render_client/skin_instance_state_recorder.h>
 #include <render_driver/gpu_resources/resource_mgr.h>
 #include <render_driver/render_driver.h>
 #include <rw_engine/rh_backend/raster_backend.h>
@@ -21,34 +25,37 @@ using namespace rh::engine;
 
 constexpr auto SceneDescCallbacksId = 0x52;
 
+constexpr uint32_t gSceneDescBindId     = 0;
+constexpr uint32_t gSceneMaterialBindId = 4;
+
 RTSceneDescription::RTSceneDescription(
     const RTSceneDescriptionCreateInfo &info )
     : Device( info.Device ), Resources( info.Resources )
 {
 
-    constexpr auto draw_count_limit     = 10000;
-    constexpr auto model_count_limit    = 20000;
-    constexpr auto texture_count_limit  = 20000;
-    constexpr auto material_count_limit = 20001;
+    // resident mesh instances are followed by skinned draw calls, both
+    // buffers grow with the scene
+    constexpr uint64_t draw_count_initial_capacity     = 4096;
+    constexpr uint64_t material_count_initial_capacity = 8192;
+    constexpr auto     model_count_limit               = 20000;
+    constexpr auto     texture_count_limit             = 20000;
 
-    constexpr auto scene_desc_bind_id       = 0;
     constexpr auto vertex_buff_desc_bind_id = 1;
     constexpr auto index_buff_bind_id       = 2;
     constexpr auto texture_desc_bind_id     = 3;
-    constexpr auto material_buff_bind_id    = 4;
 
-    mSceneDesc.resize( draw_count_limit );
-    mSceneMaterials.resize( material_count_limit );
+    mSceneDesc.resize( draw_count_initial_capacity );
+    mSceneMaterials.resize( material_count_initial_capacity );
 
     DescriptorGenerator descriptorGenerator{ Device };
     // Scene desc
     descriptorGenerator.AddDescriptor(
-        0, scene_desc_bind_id, 0, DescriptorType::RWBuffer, 1,
+        0, gSceneDescBindId, 0, DescriptorType::RWBuffer, 1,
         ShaderStage::Compute | ShaderStage::RayHit | ShaderStage::RayGen |
             ShaderStage::RayAnyHit );
     // Materials
     descriptorGenerator.AddDescriptor(
-        0, material_buff_bind_id, 0, DescriptorType::RWBuffer, 1,
+        0, gSceneMaterialBindId, 0, DescriptorType::RWBuffer, 1,
         ShaderStage::Compute | ShaderStage::RayHit | ShaderStage::RayGen |
             ShaderStage::RayAnyHit );
     // Verts
@@ -92,31 +99,14 @@ RTSceneDescription::RTSceneDescription(
         { Device, mSceneSet, model_count_limit, index_buff_bind_id,
           vertex_buff_desc_bind_id } );
 
-    mSceneDescBuffer = Device.CreateBuffer(
-        { .mSize        = sizeof( SceneObjDesc ) * draw_count_limit,
-          .mUsage       = BufferUsage::StorageBuffer,
-          .mFlags       = BufferFlags::Dynamic,
-          .mInitDataPtr = nullptr } );
-
-    mMaterialDescBuffer = Device.CreateBuffer(
-        { .mSize        = sizeof( MaterialData ) * material_count_limit,
-          .mUsage       = BufferUsage::StorageBuffer,
-          .mFlags       = BufferFlags::Dynamic,
-          .mInitDataPtr = nullptr } );
-
-    std::array sdesc_buff_ui = {
-        BufferUpdateInfo{ 0, VK_WHOLE_SIZE, mSceneDescBuffer } };
-    std::array mdesc_buff_ui = {
-        BufferUpdateInfo{ 0, VK_WHOLE_SIZE, mMaterialDescBuffer } };
-
-    Device.UpdateDescriptorSets( { .mSet            = mSceneSet,
-                                   .mBinding        = scene_desc_bind_id,
-                                   .mDescriptorType = DescriptorType::RWBuffer,
-                                   .mBufferUpdateInfo = sdesc_buff_ui } );
-    Device.UpdateDescriptorSets( { .mSet            = mSceneSet,
-                                   .mBinding        = material_buff_bind_id,
-                                   .mDescriptorType = DescriptorType::RWBuffer,
-                                   .mBufferUpdateInfo = mdesc_buff_ui } );
+    mSceneDescCapacity = draw_count_initial_capacity;
+    mMaterialCapacity  = material_count_initial_capacity;
+    CreateSceneBuffer( mSceneDescBuffer,
+                       sizeof( SceneObjDesc ) * mSceneDescCapacity,
+                       gSceneDescBindId );
+    CreateSceneBuffer( mMaterialDescBuffer,
+                       sizeof( MaterialData ) * mMaterialCapacity,
+                       gSceneMaterialBindId );
 
     /// Setup callbacks
     auto &raster_pool = Resources.GetRasterPool();
@@ -128,16 +118,30 @@ RTSceneDescription::RTSceneDescription(
             // Update global vb/ib descriptor set
 
             mModelBuffersPool->StoreModel( data, id );
+            // streamed mesh may be drawn before it's uploaded, without model
+            mResidentStale = true;
         },
         SceneDescCallbacksId );
 
+    // resident instance descriptions store model and texture pool ids
     mesh_pool.AddOnDestructCallback(
         [this]( BackendMeshData &data, uint64_t id )
-        { mModelBuffersPool->RemoveModel( id ); },
+        {
+            mModelBuffersPool->RemoveModel( id );
+            mResidentStale = true;
+        },
+        SceneDescCallbacksId );
+    raster_pool.AddOnDestructCallback(
+        [this]( RasterData &data, uint64_t id )
+        {
+            mTexturePool->RemoveTexture( id );
+            mResidentStale = true;
+        },
+        SceneDescCallbacksId );
+    // streamed raster may be drawn before it's uploaded, without texture
+    raster_pool.AddOnRequestCallback(
+        [this]( RasterData &data, uint64_t id ) { mResidentStale = true; },
         SceneDescCallbacksId );
-    raster_pool.AddOnDestructCallback( [this]( RasterData &data, uint64_t id )
-                                       { mTexturePool->RemoveTexture( id ); },
-                                       SceneDescCallbacksId );
 }
 
 RTSceneDescription::~RTSceneDescription()
@@ -147,6 +151,7 @@ RTSceneDescription::~RTSceneDescription()
     mesh_pool.RemoveOnDestructCallback( SceneDescCallbacksId );
     mesh_pool.RemoveOnRequestCallback( SceneDescCallbacksId );
     raster_pool.RemoveOnDestructCallback( SceneDescCallbacksId );
+    raster_pool.RemoveOnRequestCallback( SceneDescCallbacksId );
 }
 
 rh::engine::IDescriptorSetLayout *RTSceneDescription::DescLayout()
@@ -154,33 +159,183 @@ rh::engine::IDescriptorSetLayout *RTSceneDescription::DescLayout()
     return mSceneSetLayout;
 }
 rh::engine::IDescriptorSet *RTSceneDescription::DescSet() { return mSceneSet; }
-void                        RTSceneDescription::Update()
+
+void RTSceneDescription::CreateSceneBuffer(
+    ScopedPointer<rh::engine::IBuffer> &buffer, uint64_t size,
+    uint32_t binding )
+{
+    // render loop waits for the previous frame before recording the next
+    // one, so old buffer is not in use anymore
+    IBuffer *old_buffer = buffer;
+    buffer = Device.CreateBuffer( { .mSize  = static_cast<uint32_t>( size ),
+                                    .mUsage = BufferUsage::StorageBuffer,
+                                    .mFlags = BufferFlags::Dynamic,
+                                    .mInitDataPtr = nullptr } );
+    delete old_buffer;
+
+    std::array buff_ui = { BufferUpdateInfo{ 0, VK_WHOLE_SIZE, buffer } };
+    Device.UpdateDescriptorSets( { .mSet            = mSceneSet,
+                                   .mBinding        = binding,
+                                   .mDescriptorType = DescriptorType::RWBuffer,
+                                   .mBufferUpdateInfo = buff_ui } );
+}
+
+void RTSceneDescription::Update()
 {
+    // only the tail starting at the first changed description is uploaded
+    auto draw_calls_from = ( std::min )( mUploadDrawCallsFrom, mDrawCalls );
+    auto materials_from  = ( std::min )( mUploadMaterialsFrom, mMaterials );
 
-    mSceneDescBuffer->Update( mSceneDesc.data(),
-                              mDrawCalls * sizeof( SceneObjDesc ) );
-    mMaterialDescBuffer->Update( mSceneMaterials.data(),
-                                 mMaterials * sizeof( MaterialData ) );
+    // grown buffer is empty, so it's uploaded whole
+    if ( mDrawCalls > mSceneDescCapacity )
+    {
+        mSceneDescCapacity = GrowCapacity( mSceneDescCapacity, mDrawCalls );
+        CreateSceneBuffer( mSceneDescBuffer,
+                           sizeof( SceneObjDesc ) * mSceneDescCapacity,
+                           gSceneDescBindId );
+        draw_calls_from = 0;
+        debug::DebugLogger::LogFmt(
+            "Scene description buffer grown to %llu draw calls",
+            debug::LogLevel::Info,
+            static_cast<unsigned long long>( mSceneDescCapacity ) );
+    }
+    if ( mMaterials > mMaterialCapacity )
+    {
+        mMaterialCapacity = GrowCapacity( mMaterialCapacity, mMaterials );
+        CreateSceneBuffer( mMaterialDescBuffer,
+                           sizeof( MaterialData ) * mMaterialCapacity,
+                           gSceneMaterialBindId );
+        materials_from = 0;
+        debug::DebugLogger::LogFmt(
+            "Scene material buffer grown to %llu materials",
+            debug::LogLevel::Info,
+            static_cast<unsigned long long>( mMaterialCapacity ) );
+    }
+    mPeakDrawCalls = ( std::max )( mPeakDrawCalls, mDrawCalls );
+    mPeakMaterials = ( std::max )( mPeakMaterials, mMaterials );
+    mSceneDescBuffer->Update(
+        mSceneDesc.data() + draw_calls_from,
+        static_cast<uint32_t>( ( mDrawCalls - draw_calls_from ) *
+                               sizeof( SceneObjDesc ) ),
+        static_cast<uint32_t>( draw_calls_from * sizeof( SceneObjDesc ) ) );
+    mMaterialDescBuffer->Update(
+        mSceneMaterials.data() + materials_from,
+        static_cast<uint32_t>( ( mMaterials - materials_from ) *
+                               sizeof( MaterialData ) ),
+        static_cast<uint32_t>( materials_from * sizeof( MaterialData ) ) );
     // mSceneMaterialsPool->ResetFrame();
-    mDrawCalls = 0;
-    mMaterials = 0;
+    mDrawCalls           = 0;
+    mMaterials           = 0;
+    mUploadDrawCallsFrom = UINT64_MAX;
+    mUploadMaterialsFrom = UINT64_MAX;
+}
+
+void RTSceneDescription::RecordMeshInstances( const MeshInstanceState &state )
+{
+    auto store_instance = [this, &state]( uint32_t slot )
+    {
+        const auto &dc       = state.DrawCalls[slot];
+        auto       &obj_desc = StoreDrawCall(
+            slot, dc, state.Materials.Data() + dc.MaterialListStart,
+            dc.MaterialListCount, dc.MaterialListStart );
+        // instance may have been in another slot or not resident last frame
+        auto iter = mPrevTransformMap.find( dc.DrawCallId );
+        if ( iter != mPrevTransformMap.end() )
+            obj_desc.prevTransfom = iter->second;
+        else
+            obj_desc.prevTransfom = obj_desc.transfomIT;
+        mPrevTransformMap[dc.DrawCallId] = obj_desc.transform;
+        mUploadDrawCallsFrom = ( std::min )( mUploadDrawCallsFrom,
+                                             static_cast<uint64_t>( slot ) );
+        mUploadMaterialsFrom =
+            ( std::min )( mUploadMaterialsFrom, dc.MaterialListStart );
+    };
+
+    // instances that have stopped moving get their prev transform back in
+    // sync, the ones that are still moving are recomputed below anyway
+    for ( auto slot : mMovedSlots )
+    {
+        if ( slot >= state.DrawCalls.Size() || slot >= mSceneDesc.size() )
+            continue;
+        auto &obj_desc        = mSceneDesc[slot];
+        obj_desc.prevTransfom = obj_desc.transform;
+        mUploadDrawCallsFrom  = ( std::min )( mUploadDrawCallsFrom,
+                                             static_cast<uint64_t>( slot ) );
+    }
+
+    if ( mResidentStale )
+    {
+        for ( auto slot : state.VisibleSlots )
+            store_instance( slot );
+        mResidentStale = false;
+    }
+    else
+    {
+        for ( auto slot : state.DirtySlots )
+            store_instance( slot );
+    }
+    mMovedSlots.assign( state.DirtySlots.begin(), state.DirtySlots.end() );
+
+    // other draw calls are stored after resident instances
+    mDrawCalls = state.DrawCalls.Size();
+    mMaterials = state.Materials.Size();
 }
 
 void RTSceneDescription::RecordDrawCall( const DrawCallInfo &dc,
                                          const MaterialData *materials,
                                          uint64_t            material_count )
 {
-    SceneObjDesc &obj_desc    = mSceneDesc[mDrawCalls];
+    auto &obj_desc =
+        StoreDrawCall( mDrawCalls, dc, materials, material_count, mMaterials );
+
+    if ( dc.DrawCallId != 0 )
+    {
+        // update prev transform
+        // TODO:
+        auto iter = mPrevTransformMap.find( dc.DrawCallId );
+        if ( iter != mPrevTransformMap.end() )
+            obj_desc.prevTransfom = iter->second;
+        else
+            obj_desc.prevTransfom = obj_desc.transfomIT;
+
+        mPrevTransformMap[dc.DrawCallId] = obj_desc.transform;
+    }
+    else
+        assert( "draw call id is not set!" );
+
+    mUploadDrawCallsFrom = ( std::min )( mUploadDrawCallsFrom, mDrawCalls );
+    mUploadMaterialsFrom = ( std::min )( mUploadMaterialsFrom, mMaterials );
+    mDrawCalls++;
+    mMaterials += material_count;
+}
+
+SceneObjDesc &RTSceneDescription::StoreDrawCall( uint64_t            index,
+                                                 const DrawCallInfo &dc,
+                                                 const MaterialData *materials,
+                                                 uint64_t material_count,
+                                                 uint64_t material_offset )
+{
+    // CPU arrays grow right away, GPU buffers follow them in Update
+    if ( index >= mSceneDesc.size() )
+        mSceneDesc.resize( GrowCapacity( mSceneDesc.size(), index + 1 ) );
+    if ( material_offset + material_count > mSceneMaterials.size() )
+        mSceneMaterials.resize( GrowCapacity(
+            mSceneMaterials.size(), material_offset + material_count ) );
+
+    SceneObjDesc &obj_desc    = mSceneDesc[index];
     auto &        raster_pool = Resources.GetRasterPool();
     auto &        mesh_pool   = Resources.GetMeshPool();
 
     const auto &mesh = mesh_pool.GetResource( dc.MeshId );
     for ( auto i = 0; i < material_count; i++ )
     {
-        mSceneMaterials[i + mMaterials] = materials[i];
+        mSceneMaterials[i + material_offset] = materials[i];
         auto get_pool_id = [this, &raster_pool]( auto orig_tex_id )
         {
-            if ( orig_tex_id == BackendRasterPlugin::NullRasterId )
+            // pending streamed rasters are not cached in texture pool, so
+            // they are untextured until uploaded
+            if ( orig_tex_id == BackendRasterPlugin::NullRasterId ||
+                 !raster_pool.IsReady( orig_tex_id ) )
                 return -1;
             auto tex_pool_id = mTexturePool->GetTexId( orig_tex_id );
             if ( tex_pool_id < 0 )
@@ -193,17 +348,16 @@ void RTSceneDescription::RecordDrawCall( const DrawCallInfo &dc,
             return tex_pool_id;
         };
 
-        auto tex_pool_id =
-            get_pool_id( mSceneMaterials[i + mMaterials].mTexture );
-        auto spec_tex_pool_id =
-            get_pool_id( mSceneMaterials[i + mMaterials].mSpecTexture );
+        auto &material         = mSceneMaterials[i + material_offset];
+        auto  tex_pool_id      = get_pool_id( material.mTexture );
+        auto  spec_tex_pool_id = get_pool_id( material.mSpecTexture );
 
-        mSceneMaterials[i + mMaterials].mTexture     = tex_pool_id;
-        mSceneMaterials[i + mMaterials].mSpecTexture = spec_tex_pool_id;
+        material.mTexture     = tex_pool_id;
+        material.mSpecTexture = spec_tex_pool_id;
     }
 
     obj_desc.objId         = mModelBuffersPool->GetModelId( dc.MeshId );
-    obj_desc.txtOffset     = mMaterials;
+    obj_desc.txtOffset     = material_offset;
     obj_desc.triangleCount = mesh.mIndexCount / 3;
 
     std::copy( &dc.WorldTransform.m[0][0], &dc.WorldTransform.m[0][0] + 3 * 4,
@@ -214,23 +368,6 @@ void RTSceneDescription::RecordDrawCall( const DrawCallInfo &dc,
         nullptr, DirectX::XMMatrixTranspose(
                      DirectX::XMLoadFloat4x4( &obj_desc.transform ) ) ) );
     DirectX::XMStoreFloat4x4( &obj_desc.transfomIT, it_mtx );
-
-    if ( dc.DrawCallId != 0 )
-    {
-        // update prev transform
-        // TODO:
-        auto iter = mPrevTransformMap.find( dc.DrawCallId );
-        if ( iter != mPrevTransformMap.end() )
-            obj_desc.prevTransfom = iter->second;
-        else
-            DirectX::XMStoreFloat4x4( &obj_desc.prevTransfom, it_mtx );
-
-        mPrevTransformMap[dc.DrawCallId] = obj_desc.transform;
-    }
-    else
-        assert( "draw call id is not set!" );
-
-    mDrawCalls++;
-    mMaterials += material_count;
+    return obj_desc;
 }
 } // namespace rh::rw::engine
\ No newline at end of file
@@ -34,6 +34,7 @@ class GPUTexturePool;
 class GPUModelBuffersPool;
 class GPUSceneMaterialsPool;
 struct DrawCallInfo;
+struct MeshInstanceState;
 class EngineResourceHolder;
 struct RTSceneDescriptionCreateInfo
 {
@@ -50,11 +51,30 @@ class RTSceneDescription
     rh::engine::IDescriptorSetLayout *DescLayout();
     rh::engine::IDescriptorSet *      DescSet();
 
+    /**
+     * Updates descriptions of resident mesh instances, must be called every
+     * frame before RecordDrawCall. Descriptions are stored by instance slot,
+     * only instances changed in current frame are recomputed.
+     */
+    void RecordMeshInstances( const MeshInstanceState &state );
     void RecordDrawCall( const DrawCallInfo &dc, const MaterialData *materials,
                          uint64_t material_count );
     void Update();
 
+    /// Most draw calls and materials uploaded in a single frame
+    [[nodiscard]] uint64_t PeakDrawCalls() const { return mPeakDrawCalls; }
+    [[nodiscard]] uint64_t PeakMaterials() const { return mPeakMaterials; }
+
   private:
+    /// Creates storage buffer and binds it to the scene set instead of the
+    /// previous one
+    void          CreateSceneBuffer( ScopedPointer<rh::engine::IBuffer> &buffer,
+                                     uint64_t size, uint32_t binding );
+    SceneObjDesc &StoreDrawCall( uint64_t index, const DrawCallInfo &dc,
+                                 const MaterialData *materials,
+                                 uint64_t            material_count,
+                                 uint64_t            material_offset );
+
     rh::engine::IDeviceState &                         Device;
     EngineResourceHolder &                             Resources;
     std::vector<SceneObjDesc>                          mSceneDesc;
@@ -70,6 +90,18 @@ class RTSceneDescription
     ScopedPointer<GPUModelBuffersPool>                 mModelBuffersPool;
     ScopedPointer<GPUSceneMaterialsPool>               mSceneMaterialsPool;
     std::unordered_map<uint64_t, DirectX::XMFLOAT4X4>  mPrevTransformMap;
+    /// Instance slots changed in previous frame, their prev transform is
+    /// reset once they stop moving
+    std::vector<uint32_t>                              mMovedSlots;
+    /// Cached descriptions reference pool ids of destroyed resources
+    bool                                               mResidentStale = true;
+    uint64_t                                           mUploadDrawCallsFrom = 0;
+    uint64_t                                           mUploadMaterialsFrom = 0;
+    /// Entry capacity of GPU buffers
+    uint64_t                                           mSceneDescCapacity = 0;
+    uint64_t                                           mMaterialCapacity  = 0;
+    uint64_t                                           mPeakDrawCalls     = 0;
+    uint64_t                                           mPeakMaterials     = 0;
 };
 
 } // namespace rh::rw::engine
\ No newline at end of file
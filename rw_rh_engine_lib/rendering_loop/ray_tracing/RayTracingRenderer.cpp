@@ -24,6 +24,7 @@
 #include <Engine/VulkanImpl/VulkanCommandBuffer.h>
 #include <Engine/VulkanImpl/VulkanDeviceState.h>
 #include <Engine/VulkanImpl/VulkanWin32Window.h>
+#include <algorithm>
 #include <data_desc/frame_info.h>
 #include <imgui.h>
 #include <ipc/MemoryReader.h>
@@ -190,6 +191,9 @@ RayTracingRenderer::Render( const FrameState &                state,
 
     auto raytraced =
         RenderPrimaryRays( state.MeshInstances, state.SkinInstances );
+    if ( mTiledLightCulling->ReserveLights( state.Lights.PointLights.Size() ) )
+        mRestirShadowsPass->SetLightBuffer(
+            mTiledLightCulling->GetLightBuffer() );
 
     dest->BeginRecord();
 
@@ -255,22 +259,21 @@ bool RayTracingRenderer::RenderPrimaryRays( const MeshInstanceState &mesh_data,
 {
     using namespace rh::engine;
 
+    // resident instances have to be kept in sync even if nothing is drawn
+    mSceneDescription->RecordMeshInstances( mesh_data );
+
     uint64_t draw_call_count =
-        mesh_data.DrawCalls.Size() + skin_data.DrawCalls.Size();
+        mesh_data.VisibleSlots.Size() + skin_data.DrawCalls.Size();
     if ( draw_call_count <= 0 )
         return false;
 
-    uint64_t i = 0;
-    // Fill scene description
-    for ( const auto &dc : mesh_data.DrawCalls )
+    // Fill scene description, instance index of resident mesh is its slot
+    for ( auto slot : mesh_data.VisibleSlots )
     {
-        mSceneDescription->RecordDrawCall(
-            dc, &mesh_data.Materials[dc.MaterialListStart],
-            dc.MaterialListCount );
+        const auto &dc = mesh_data.DrawCalls[slot];
         mRestirShadowsPass->RecordTriLights(
             Resources.GetMeshPool().GetResource( dc.MeshId ).EmissiveTriangles,
-            dc.WorldTransform, i );
-        i++;
+            dc.WorldTransform, slot );
     }
     for ( const auto &dc : mSkinAnimationPipe->DrawCallList )
     {
@@ -284,10 +287,10 @@ bool RayTracingRenderer::RenderPrimaryRays( const MeshInstanceState &mesh_data,
     // Build TLAS instance buffer
     std::vector<VkAccelerationStructureInstanceNV> instance_buffer{};
     instance_buffer.reserve( draw_call_count );
-    i = 0;
 
-    for ( const auto &dc : mesh_data.DrawCalls )
+    for ( auto slot : mesh_data.VisibleSlots )
     {
+        const auto &dc   = mesh_data.DrawCalls[slot];
         const auto &mesh = blas_resource.GetBlas( dc.MeshId );
         if ( mesh.mBlasBuilt )
         {
@@ -299,13 +302,13 @@ bool RayTracingRenderer::RenderPrimaryRays( const MeshInstanceState &mesh_data,
                        &instance.transform.matrix[0][0] );
             instance.mask                           = 0xFF;
             instance.accelerationStructureReference = blas->GetAddress();
-            instance.instanceCustomIndex            = i;
+            instance.instanceCustomIndex            = slot;
             instance_buffer.push_back( instance );
         }
-
-        i++;
     }
 
+    // skinned draw calls are stored after resident instances
+    uint64_t i = mesh_data.DrawCalls.Size();
     for ( const auto &dc : mSkinAnimationPipe->DrawCallList )
     {
         const auto &mesh = blas_resource.GetBlas( dc.MeshId );
@@ -353,6 +356,19 @@ void RayTracingRenderer::DrawGUI( const FrameState &scene )
     ImGui::BeginGroup();
 
     ImGui::Text( "BLAS Built in last frame:%llu.", mBlasBuilt );
+    auto       &resources     = gRenderDriver->GetResources();
+    const auto &mesh_buffers  = resources.GetMeshBufferCache().GetStats();
+    const auto &raster_images = resources.GetRasterImageCache().GetStats();
+    const auto &blas_stats    = mBlasBuildPass->GetStats();
+    ImGui::Text( "Shared meshes:%llu, %.2f MB saved, BLAS builds saved:%llu.",
+                 mesh_buffers.SharedMeshCount,
+                 static_cast<double>( mesh_buffers.SavedBytes ) /
+                     ( 1024.0 * 1024.0 ),
+                 blas_stats.SavedBuilds );
+    ImGui::Text( "Shared textures:%llu, %.2f MB saved.",
+                 raster_images.SharedRasterCount,
+                 static_cast<double>( raster_images.SavedBytes ) /
+                     ( 1024.0 * 1024.0 ) );
 
     std::rotate( mFrameTimeGraph.begin(), mFrameTimeGraph.begin() + 1,
                  mFrameTimeGraph.end() );
@@ -417,8 +433,15 @@ void RayTracingRenderer::DrawGUI( const FrameState &scene )
 
                 if ( ImGui::CollapsingHeader( "Matrices" ) )
                 {
-                    for ( const auto &bone_mtx : instance.BoneTransform )
+                    const auto &palette = scene.SkinInstances.BoneTransforms;
+                    const auto  bone_end =
+                        ( std::min )( instance.BoneListStart +
+                                          instance.BoneListCount,
+                                      static_cast<uint64_t>( palette.Size() ) );
+                    for ( auto bone = instance.BoneListStart; bone < bone_end;
+                          bone++ )
                     {
+                        const auto &bone_mtx = palette[bone];
                         ImGui::PushID( mtx_id );
                         ImGui::Text( "Matrix %u\n "
                                      "row_0 - x:%f; y:%f; z:%f;\n"
@@ -159,6 +159,17 @@ rh::engine::IBuffer *LightSamplingPass::GetPrevResult()
     return PrevReservoirBuffer;
 }
 
+void LightSamplingPass::SetLightBuffer( rh::engine::IBuffer *lights )
+{
+    Lights = lights;
+    DescSetUpdateBatch{ Device }
+        .Begin( DescSet )
+        .UpdateBuffer( LightPopulationPassBind::Lights,
+                       DescriptorType::RWBuffer,
+                       { BufferUpdateInfo{ 0, VK_WHOLE_SIZE, Lights } } )
+        .End();
+}
+
 void LightSamplingPass::UpdateUI()
 {
     if ( !ImGui::CollapsingHeader( "Light sampling pass" ) )
@@ -66,6 +66,8 @@ class LightSamplingPass : public LightPopulationPassBase
 
     rh::engine::IBuffer *GetResult();
     rh::engine::IBuffer *GetPrevResult();
+    /// Rebinds point light buffer after it was recreated
+    void                 SetLightBuffer( rh::engine::IBuffer *lights );
 
     void UpdateUI();
 
@@ -329,6 +329,17 @@ void ShadowsPass::Execute( void *tlas, uint32_t light_count,
 
 void ShadowsPass::Reset() { TriLightsCpuBufferCount = 0; }
 
+void ShadowsPass::SetLightBuffer( rh::engine::IBuffer *lights )
+{
+    mLightPopulationPass->SetLightBuffer( lights );
+    mSpatialReusePass->SetLightBuffer( lights );
+    DescSetUpdateBatch{ Device }
+        .Begin( mRayTraceSet )
+        .UpdateBuffer( ShadowsPassBind::Lights, DescriptorType::RWBuffer,
+                       { { 0, VK_WHOLE_SIZE, lights } } )
+        .End();
+}
+
 void ShadowsPass::RecordTriLights( const std::vector<PackedLight> &lights,
                                    const DirectX::XMFLOAT4X3      &transform,
                                    int                             inst_id )
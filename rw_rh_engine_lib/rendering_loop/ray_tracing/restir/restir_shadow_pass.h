@@ -85,6 +85,8 @@ class ShadowsPass
     void RecordTriLights( const std::vector<PackedLight> &lights,
                           const DirectX::XMFLOAT4X3 &transform, int inst_id );
     void Reset();
+    /// Rebinds point light buffer in every pass after it was recreated
+    void SetLightBuffer( rh::engine::IBuffer *lights );
 
   private:
     rh::engine::IDeviceState          &Device;
@@ -132,6 +132,16 @@ rh::engine::IBuffer *SpatialReusePass::GetResult()
     return TempReservoirBuffer;
 }
 
+void SpatialReusePass::SetLightBuffer( rh::engine::IBuffer *lights )
+{
+    mLightBuffer = lights;
+    DescSetUpdateBatch{ Device }
+        .Begin( mDescSet )
+        .UpdateBuffer( SpatialReusePassBind::Lights, DescriptorType::RWBuffer,
+                       { BufferUpdateInfo{ 0, VK_WHOLE_SIZE, mLightBuffer } } )
+        .End();
+}
+
 void SpatialReusePass::UpdateUI()
 {
     if ( !ImGui::CollapsingHeader( "Spatial reuse pass" ) )
@@ -69,6 +69,8 @@ class SpatialReusePass : public SpatialReusePassBase
                   rh::engine::ICommandBuffer *cmd_buffer );
 
     rh::engine::IBuffer *GetResult();
+    /// Rebinds point light buffer after it was recreated
+    void                 SetLightBuffer( rh::engine::IBuffer *lights );
 
     void UpdateUI();
 
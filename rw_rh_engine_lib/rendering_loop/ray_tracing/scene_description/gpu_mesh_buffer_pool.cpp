@@ -4,6 +4,7 @@
 
 #include "gpu_mesh_buffer_pool.h"
 #include <Engine/Common/IDeviceState.h>
+#include <Engine/ResourcePool.h>
 #include <rw_engine/rh_backend/mesh_rendering_backend.h>
 
 namespace rh::rw::engine
@@ -21,7 +22,10 @@ GPUModelBuffersPool::GPUModelBuffersPool(
 
 int32_t GPUModelBuffersPool::GetModelId( uint64_t model_id )
 {
-    return mBuffersRemap[model_id];
+    const auto mesh_slot = rh::engine::ResourceSlot( model_id );
+    if ( mesh_slot >= mBuffersRemap.size() )
+        return -1;
+    return mBuffersRemap[mesh_slot];
 }
 
 void GPUModelBuffersPool::StoreModel( const BackendMeshData &model,
@@ -58,15 +62,19 @@ void GPUModelBuffersPool::StoreModel( const BackendMeshData &model,
         ibUpdateInfo.mBufferUpdateInfo = ib_list;
         Device.UpdateDescriptorSets( ibUpdateInfo );
     }
-    mBuffersRemap[model_id] = id;
-    mSlotAvailability[id]   = 0;
+    // remap is indexed by mesh pool slot, mesh pool may outgrow it
+    const auto mesh_slot = rh::engine::ResourceSlot( model_id );
+    if ( mesh_slot >= mBuffersRemap.size() )
+        mBuffersRemap.resize( mesh_slot + 1, -1 );
+    mBuffersRemap[mesh_slot] = id;
+    mSlotAvailability[id]    = 0;
 }
 void GPUModelBuffersPool::RemoveModel( uint64_t id )
 {
     auto slot_id = GetModelId( id );
     if ( slot_id < 0 )
         return;
-    mSlotAvailability[slot_id] = 1;
-    mBuffersRemap[id]          = -1;
+    mSlotAvailability[slot_id]                    = 1;
+    mBuffersRemap[rh::engine::ResourceSlot( id )] = -1;
 }
 } // namespace rh::rw::engine
\ No newline at end of file
@@ -4,6 +4,7 @@
 
 #include "gpu_texture_pool.h"
 #include <Engine/Common/IDeviceState.h>
+#include <Engine/ResourcePool.h>
 
 namespace rh::rw::engine
 {
@@ -12,7 +13,8 @@ GPUTexturePool::GPUTexturePool( const GPUTexturePoolCreateInfo &info )
     : Device( info.Device ), mGPUPool( info.DescSet ),
       mBindingId( info.TexturePoolBinding )
 {
-    mSlotAvailability.resize( info.TextureCount, 1 );
+    mSlotRefCount.resize( info.TextureCount, 0 );
+    mSlotImages.resize( info.TextureCount, nullptr );
     mBuffersRemap.resize( info.TextureCount, -1 );
 }
 
@@ -20,11 +22,24 @@ uint64_t GPUTexturePool::StoreTexture( rh::engine::IImageView *image,
                                        uint64_t                tex_id )
 {
     using namespace rh::engine;
+    // remap is indexed by raster pool slot, raster pool may outgrow it
+    const auto raster_slot = rh::engine::ResourceSlot( tex_id );
+    if ( raster_slot >= mBuffersRemap.size() )
+        mBuffersRemap.resize( raster_slot + 1, -1 );
+
+    // deduplicated rasters share image view, descriptor is written once
+    if ( auto shared = mImageSlots.find( image ); shared != mImageSlots.end() )
+    {
+        mBuffersRemap[raster_slot] = shared->second;
+        mSlotRefCount[shared->second]++;
+        return shared->second;
+    }
+
     uint64_t id = 0;
 
     // TODO: Can be improved and optimized, can be iterated from last free
     // resource
-    while ( id < mSlotAvailability.size() && mSlotAvailability[id] == 0 )
+    while ( id < mSlotRefCount.size() && mSlotRefCount[id] > 0 )
         id++;
 
     std::array<ImageUpdateInfo, 1> img_upd_list = {
@@ -38,8 +53,10 @@ uint64_t GPUTexturePool::StoreTexture( rh::engine::IImageView *image,
     imgUpdateInfo.mImageUpdateInfo = img_upd_list;
     Device.UpdateDescriptorSets( imgUpdateInfo );
 
-    mBuffersRemap[tex_id] = id;
-    mSlotAvailability[id] = 0;
+    mBuffersRemap[raster_slot] = id;
+    mSlotRefCount[id]          = 1;
+    mSlotImages[id]            = image;
+    mImageSlots[image]         = id;
     return id;
 }
 
@@ -48,13 +65,19 @@ void GPUTexturePool::RemoveTexture( uint64_t id )
     auto slot_id = GetTexId( id );
     if ( slot_id < 0 )
         return;
-    mSlotAvailability[slot_id] = 1;
-    mBuffersRemap[id]          = -1;
+    mBuffersRemap[rh::engine::ResourceSlot( id )] = -1;
+    if ( --mSlotRefCount[slot_id] > 0 )
+        return;
+    mImageSlots.erase( mSlotImages[slot_id] );
+    mSlotImages[slot_id] = nullptr;
 }
 
 int32_t GPUTexturePool::GetTexId( uint64_t tex_id )
 {
-    return mBuffersRemap[tex_id];
+    const auto raster_slot = rh::engine::ResourceSlot( tex_id );
+    if ( raster_slot >= mBuffersRemap.size() )
+        return -1;
+    return mBuffersRemap[raster_slot];
 }
 
 } // namespace rh::rw::engine
\ No newline at end of file
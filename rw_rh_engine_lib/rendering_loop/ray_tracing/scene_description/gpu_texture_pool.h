@@ -2,6 +2,8 @@
 // Created by peter on 15.05.2020.
 //
 #pragma once
+#include <cstdint>
+#include <unordered_map>
 #include <vector>
 
 namespace rh
@@ -32,16 +34,20 @@ class GPUTexturePool
   public:
     explicit GPUTexturePool( const GPUTexturePoolCreateInfo &info );
 
+    /// Rasters sharing an image view share a single texture slot
     uint64_t StoreTexture( rh::engine::IImageView *image, uint64_t texture_id );
     void     RemoveTexture( uint64_t id );
     int32_t  GetTexId( uint64_t tex_id );
 
   private:
-    rh::engine::IDeviceState &  Device;
-    std::vector<uint8_t>        mSlotAvailability;
-    std::vector<int32_t>        mBuffersRemap;
-    rh::engine::IDescriptorSet *mGPUPool;
-    uint32_t                    mBindingId;
+    rh::engine::IDeviceState                             &Device;
+    /// rasters referencing each slot, slot is free if there are none
+    std::vector<uint32_t>                                 mSlotRefCount;
+    std::vector<int32_t>                                  mBuffersRemap;
+    std::vector<rh::engine::IImageView *>                 mSlotImages;
+    std::unordered_map<rh::engine::IImageView *, int32_t> mImageSlots;
+    rh::engine::IDescriptorSet                           *mGPUPool;
+    uint32_t                                              mBindingId;
 };
 } // namespace rw::engine
 
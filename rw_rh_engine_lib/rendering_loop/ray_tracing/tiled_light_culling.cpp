@@ -9,7 +9,9 @@
 #include <Engine/Common/IDeviceState.h>
 #include <Engine/Common/types/shader_stage.h>
 #include <Engine/VulkanImpl/VulkanCommandBuffer.h>
+#include <DebugUtils/DebugLogger.h>
 #include <Engine/VulkanImpl/VulkanDeviceState.h>
+#include <data_desc/capacity_policy.h>
 #include <data_desc/light_system/lighting_state.h>
 #include <rendering_loop/DescriptorGenerator.h>
 namespace rh::rw::engine
@@ -30,8 +32,8 @@ enum tile_build_slot_ids
 };
 
 TiledLightCulling::TiledLightCulling( const TiledLightCullingParams &params )
-    : mCameraDesc( params.mCameraDesc ), mWidth( params.mWidth ),
-      mHeight( params.mHeight )
+    : mDevice( params.mDevice ), mCameraDesc( params.mCameraDesc ),
+      mWidth( params.mWidth ), mHeight( params.mHeight )
 {
     auto &device = dynamic_cast<VulkanDeviceState &>( params.mDevice );
 
@@ -71,8 +73,8 @@ TiledLightCulling::TiledLightCulling( const TiledLightCullingParams &params )
     // Buffers
     uint32_t tile_size           = 8;
     uint32_t max_lights_per_tile = 32;
-    //
-    uint32_t max_lights = 1024;
+    // initial light buffer capacity, grows with light count
+    mLightCapacity = 1024;
     uint32_t tile_count =
         ( params.mWidth * params.mHeight ) / ( tile_size * tile_size );
 
@@ -97,7 +99,8 @@ TiledLightCulling::TiledLightCulling( const TiledLightCullingParams &params )
                                                       tile_count *
                                                       max_lights_per_tile );
     mLightBuffer = device.CreateBuffer( BufferCreateInfo{
-        .mSize  = static_cast<uint32_t>( sizeof( PointLight ) * max_lights ),
+        .mSize =
+            static_cast<uint32_t>( sizeof( PointLight ) * mLightCapacity ),
         .mUsage = BufferUsage::StorageBuffer,
         .mFlags = BufferFlags::Dynamic,
         .mInitDataPtr = nullptr } );
@@ -125,11 +128,13 @@ void TiledLightCulling::Execute( rh::engine::ICommandBuffer *dest,
                                  const AnalyticLightsState & info )
 {
     auto *vk_cmd_buff = dynamic_cast<VulkanCommandBuffer *>( dest );
-    if ( info.PointLights.Size() > 0 )
+    // lights that didn't fit into the buffer are skipped for this frame
+    const auto light_count = static_cast<uint32_t>( ( std::min )(
+        mLightCapacity, static_cast<uint64_t>( info.PointLights.Size() ) ) );
+    if ( light_count > 0 )
         mLightBuffer->Update( info.PointLights.Data(),
-                              min( 1024u, info.PointLights.Size() ) *
-                                  sizeof( PointLight ) );
-    Config.max_light_count   = info.PointLights.Size();
+                              light_count * sizeof( PointLight ) );
+    Config.max_light_count   = light_count;
     Config.max_light_in_tile = 32;
     mTileConfigBuffer->Update( &Config, sizeof( TileConfig ) );
 
@@ -144,4 +149,33 @@ void TiledLightCulling::Execute( rh::engine::ICommandBuffer *dest,
     vk_cmd_buff->DispatchCompute(
         { .mX = mWidth / 8, .mY = mHeight / 8, .mZ = 1 } );
 }
+
+bool TiledLightCulling::ReserveLights( uint64_t count )
+{
+    if ( count <= mLightCapacity )
+        return false;
+    mLightCapacity = GrowCapacity( mLightCapacity, count );
+
+    // previous frame is completed before the next one is recorded, so old
+    // buffer is not in use anymore
+    IBuffer *old_buffer = mLightBuffer;
+    mLightBuffer        = mDevice.CreateBuffer( BufferCreateInfo{
+        .mSize =
+            static_cast<uint32_t>( sizeof( PointLight ) * mLightCapacity ),
+        .mUsage       = BufferUsage::StorageBuffer,
+        .mFlags       = BufferFlags::Dynamic,
+        .mInitDataPtr = nullptr } );
+    delete old_buffer;
+
+    DescSetUpdateBatch{ mDevice }
+        .Begin( mBuildTilesDescSet )
+        .UpdateBuffer( tb_Lights, DescriptorType::RWBuffer,
+                       { BufferUpdateInfo{ 0, VK_WHOLE_SIZE, mLightBuffer } } )
+        .End();
+    debug::DebugLogger::LogFmt( "Point light buffer grown to %llu lights",
+                                debug::LogLevel::Info,
+                                static_cast<unsigned long long>(
+                                    mLightCapacity ) );
+    return true;
+}
 } // namespace rh::rw::engine
\ No newline at end of file
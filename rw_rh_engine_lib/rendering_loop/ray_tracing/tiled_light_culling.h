@@ -61,15 +61,24 @@ class TiledLightCulling
 
     void                 Execute( rh::engine::ICommandBuffer *dest,
                                   const AnalyticLightsState & info );
+    /**
+     * Grows light buffer to fit light count, should be called before the
+     * frame is recorded
+     * @return true if light buffer was recreated and has to be rebound by
+     * passes that use it
+     */
+    bool                 ReserveLights( uint64_t count );
     rh::engine::IBuffer *GetTileListBuffer() { return mTileBuffer; }
     rh::engine::IBuffer *GetLightIdxListBuffer() { return mLightIdxListBuffer; }
     rh::engine::IBuffer *GetLightBuffer() { return mLightBuffer; }
 
   private:
-    CameraDescription *mCameraDesc;
+    rh::engine::IDeviceState &mDevice;
+    CameraDescription *       mCameraDesc;
     uint32_t           mWidth{};
     uint32_t           mHeight{};
     TileConfig         Config{};
+    uint64_t           mLightCapacity = 0;
 
     SPtr<rh::engine::IDescriptorSetAllocator> mDescSetAlloc;
 
@@ -3,6 +3,8 @@
 //
 
 #include "im2d_renderer.h"
+#include <DebugUtils/DebugLogger.h>
+#include <data_desc/capacity_policy.h>
 #include <ipc/MemoryReader.h>
 #include <render_client/im2d_state_recorder.h>
 #include <render_driver/gpu_resources/raster_pool.h>
@@ -25,9 +27,9 @@ namespace rh::rw::engine
 {
 using namespace rh::engine;
 
-constexpr auto VERTEX_COUNT_LIMIT     = 100000;
-constexpr auto INDEX_COUNT_LIMIT      = 100000;
-constexpr auto TEXTURE_DESC_POOL_SIZE = 1000;
+constexpr auto VERTEX_COUNT_INITIAL_CAPACITY = 100000;
+constexpr auto INDEX_COUNT_INITIAL_CAPACITY  = 100000;
+constexpr auto TEXTURE_DESC_POOL_SIZE        = 1000;
 
 constexpr auto Im2DCallbackId = 421;
 
@@ -83,12 +85,14 @@ Im2DRenderer::Im2DRenderer( rh::engine::IDeviceState &device,
     mDepthMaskPixel.shader = Device.CreateShader( mDepthMaskPixel.desc );
 
     // create buffers
-    mVertexBuffer = Device.CreateBuffer(
-        { .mSize  = sizeof( RwIm2DVertex ) * VERTEX_COUNT_LIMIT,
+    mVertexCapacity = VERTEX_COUNT_INITIAL_CAPACITY;
+    mIndexCapacity  = INDEX_COUNT_INITIAL_CAPACITY;
+    mVertexBuffer   = Device.CreateBuffer(
+        { .mSize  = sizeof( RwIm2DVertex ) * VERTEX_COUNT_INITIAL_CAPACITY,
           .mUsage = BufferUsage::VertexBuffer } );
-    mIndexBuffer =
-        Device.CreateBuffer( { .mSize  = sizeof( int16_t ) * INDEX_COUNT_LIMIT,
-                               .mUsage = BufferUsage::IndexBuffer } );
+    mIndexBuffer = Device.CreateBuffer(
+        { .mSize  = sizeof( int16_t ) * INDEX_COUNT_INITIAL_CAPACITY,
+          .mUsage = BufferUsage::IndexBuffer } );
 
     std::vector tex_layout_array =
         std::vector( TEXTURE_DESC_POOL_SIZE, mTextureDescSetLayout );
@@ -237,6 +241,8 @@ Im2DRenderer::~Im2DRenderer()
     delete mGlobalsBuffer;
     delete mVertexBuffer;
     delete mIndexBuffer;
+    for ( auto buffer : mRetiredBuffers )
+        delete buffer;
     delete mTextureDescSetLayout;
     delete mGlobalSetLayout;
     delete mBaseVertex.shader;
@@ -270,11 +276,15 @@ uint64_t Im2DRenderer::Render( const Im2DRenderState &     state,
 {
     // Update buffers
     if ( state.IndexBuffer.Size() > 0 )
+    {
+        ReserveIndices( state.IndexBuffer.Size() );
         mIndexBuffer->Update( state.IndexBuffer.Data(),
                               state.IndexBuffer.Size() * sizeof( int16_t ), 0 );
+    }
 
     if ( state.VertexBuffer.Size() <= 0 )
         return 0;
+    ReserveVertices( state.VertexBuffer.Size() );
 
     auto current_display_mode = [this]() {
         uint32_t display_mode;
@@ -367,6 +377,7 @@ void Im2DRenderer::DrawQuad( rh::engine::IImageView *    texture,
         RwIm2DVertex{ w, -1, 0, 0, 0xFFFFFFFF, 1.0f, 0.0f },
         RwIm2DVertex{ w, h, 0, 0, 0xFFFFFFFF, 1.0f, 1.0f } };
 
+    ReserveVertices( quad.size() );
     mVertexBuffer->Update( quad.data(), 6 * sizeof( RwIm2DVertex ),
                            mVertexBufferOffset );
     mVertexBufferOffset += 6 * sizeof( RwIm2DVertex );
@@ -458,7 +469,51 @@ void Im2DRenderer::DrawQuad( uint64_t                    texture_id,
 
     cmd_buffer->Draw( 6, 1, 0, 0 );
 }
-void Im2DRenderer::Reset() { mVertexBufferOffset = 0; }
+void Im2DRenderer::Reset()
+{
+    // previous frame is completed at this point
+    for ( auto buffer : mRetiredBuffers )
+        delete buffer;
+    mRetiredBuffers.clear();
+    mVertexBufferOffset = 0;
+}
+
+void Im2DRenderer::RetireBuffer( rh::engine::IBuffer *buffer )
+{
+    mRetiredBuffers.push_back( buffer );
+}
+
+void Im2DRenderer::ReserveVertices( uint64_t vertex_count )
+{
+    const auto required =
+        mVertexBufferOffset / sizeof( RwIm2DVertex ) + vertex_count;
+    if ( required <= mVertexCapacity )
+        return;
+    mVertexCapacity = GrowCapacity( mVertexCapacity, required );
+    RetireBuffer( mVertexBuffer );
+    mVertexBuffer = Device.CreateBuffer(
+        { .mSize  = static_cast<uint32_t>( sizeof( RwIm2DVertex ) *
+                                          mVertexCapacity ),
+          .mUsage = BufferUsage::VertexBuffer } );
+    debug::DebugLogger::LogFmt(
+        "Im2D vertex buffer grown to %llu vertices", debug::LogLevel::Info,
+        static_cast<unsigned long long>( mVertexCapacity ) );
+}
+
+void Im2DRenderer::ReserveIndices( uint64_t index_count )
+{
+    if ( index_count <= mIndexCapacity )
+        return;
+    mIndexCapacity = GrowCapacity( mIndexCapacity, index_count );
+    RetireBuffer( mIndexBuffer );
+    mIndexBuffer = Device.CreateBuffer(
+        { .mSize =
+              static_cast<uint32_t>( sizeof( int16_t ) * mIndexCapacity ),
+          .mUsage = BufferUsage::IndexBuffer } );
+    debug::DebugLogger::LogFmt(
+        "Im2D index buffer grown to %llu indices", debug::LogLevel::Info,
+        static_cast<unsigned long long>( mIndexCapacity ) );
+}
 
 AttachmentBlendState UnpackBlendState( const PackedIm2DState &s )
 {
@@ -545,6 +600,7 @@ void Im2DRenderer::DrawDepthMask( rh::engine::IImageView *    texture,
         RwIm2DVertex{ w, -1, 0, 0, 0xFFFFFFFF, 1.0f, 0.0f },
         RwIm2DVertex{ w, h, 0, 0, 0xFFFFFFFF, 1.0f, 1.0f } };
 
+    ReserveVertices( quad.size() );
     mVertexBuffer->Update( quad.data(), 6 * sizeof( RwIm2DVertex ),
                            mVertexBufferOffset );
     mVertexBufferOffset += 6 * sizeof( RwIm2DVertex );
@@ -57,6 +57,15 @@ class Im2DRenderer
     void     Reset();
 
   private:
+    /**
+     * Grows vertex buffer to fit vertex_count more vertices after current
+     * offset, replaced buffer may be bound by this frame so it's kept until
+     * Reset
+     */
+    void ReserveVertices( uint64_t vertex_count );
+    void ReserveIndices( uint64_t index_count );
+    void RetireBuffer( rh::engine::IBuffer *buffer );
+
     rh::engine::IDescriptorSet *      GetRasterDescSet( uint64_t id );
     rh::engine::IDeviceState &        Device;
     RasterPoolType &                  RasterPool;
@@ -84,6 +93,9 @@ class Im2DRenderer
     rh::engine::IDescriptorSet *              mBaseDescSet;
     rh::engine::IBuffer *                     mVertexBuffer;
     rh::engine::IBuffer *                     mIndexBuffer;
+    uint64_t                                  mVertexCapacity = 0;
+    uint64_t                                  mIndexCapacity  = 0;
+    std::vector<rh::engine::IBuffer *>        mRetiredBuffers;
     rh::engine::IRenderPass *                 mRenderPass;
     std::vector<rh::engine::IDescriptorSet *> mDescriptorSetPool;
     uint64_t                                  mDescriptorSetPoolId = 0;
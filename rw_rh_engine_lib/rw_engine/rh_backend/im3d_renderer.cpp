@@ -6,11 +6,13 @@
 #include "im2d_backend.h"
 #include "im3d_backend.h"
 #include "raster_backend.h"
+#include <DebugUtils/DebugLogger.h>
 #include <Engine/Common/IDeviceState.h>
 #include <Engine/Common/types/blend_op.h>
 #include <Engine/Common/types/comparison_func.h>
 #include <Engine/Common/types/sampler_filter.h>
 
+#include <data_desc/capacity_policy.h>
 #include <render_client/im3d_state_recorder.h>
 #include <render_driver/gpu_resources/raster_pool.h>
 
@@ -23,10 +25,10 @@ namespace rh::rw::engine
 {
 using namespace rh::engine;
 
-constexpr auto VERTEX_COUNT_LIMIT     = 100000;
-constexpr auto INDEX_COUNT_LIMIT      = 100000;
-constexpr auto DRAW_CALL_POOL_SIZE    = 1000;
-constexpr auto TEXTURE_DESC_POOL_SIZE = 1000;
+constexpr auto VERTEX_COUNT_INITIAL_CAPACITY = 100000;
+constexpr auto INDEX_COUNT_INITIAL_CAPACITY  = 100000;
+constexpr auto DRAW_CALL_POOL_SIZE           = 1000;
+constexpr auto TEXTURE_DESC_POOL_SIZE        = 1000;
 
 Im3DRenderer::Im3DRenderer( rh::engine::IDeviceState &device,
                             RasterPoolType &          raster_pool,
@@ -73,12 +75,14 @@ Im3DRenderer::Im3DRenderer( rh::engine::IDeviceState &device,
     mNoTexPixel.shader = Device.CreateShader( mNoTexPixel.desc );
 
     // create buffers
-    mVertexBuffer = Device.CreateBuffer(
-        { .mSize  = sizeof( RwIm3DVertex ) * VERTEX_COUNT_LIMIT,
+    mVertexCapacity = VERTEX_COUNT_INITIAL_CAPACITY;
+    mIndexCapacity  = INDEX_COUNT_INITIAL_CAPACITY;
+    mVertexBuffer   = Device.CreateBuffer(
+        { .mSize  = sizeof( RwIm3DVertex ) * VERTEX_COUNT_INITIAL_CAPACITY,
           .mUsage = BufferUsage::VertexBuffer } );
-    mIndexBuffer =
-        Device.CreateBuffer( { .mSize  = sizeof( uint16_t ) * INDEX_COUNT_LIMIT,
-                               .mUsage = BufferUsage::IndexBuffer } );
+    mIndexBuffer = Device.CreateBuffer(
+        { .mSize  = sizeof( uint16_t ) * INDEX_COUNT_INITIAL_CAPACITY,
+          .mUsage = BufferUsage::IndexBuffer } );
 
     std::vector tex_layout_array = std::vector(
         TEXTURE_DESC_POOL_SIZE, (IDescriptorSetLayout *)mTextureDescSetLayout );
@@ -136,6 +140,10 @@ Im3DRenderer::~Im3DRenderer()
         delete ptr;
     for ( auto &ptr : mMatrixDescriptorSetPool )
         delete ptr;
+    for ( auto allocator : mMatrixSetAllocators )
+        delete allocator;
+    for ( auto buffer : mRetiredBuffers )
+        delete buffer;
 }
 
 struct PackedIm3DState
@@ -227,11 +235,99 @@ rh::engine::IPipeline *Im3DRenderer::GetCachedPipeline( uint64_t hash )
 
     return mIm3DPipelines[hash];
 }
-void Im3DRenderer::Reset() { mVertexBufferOffset = 0; }
+void Im3DRenderer::Reset()
+{
+    // previous frame is completed at this point
+    for ( auto buffer : mRetiredBuffers )
+        delete buffer;
+    mRetiredBuffers.clear();
+    mVertexBufferOffset = 0;
+}
+
+void Im3DRenderer::ReserveBuffers( const Im3DRenderState &state )
+{
+    const auto vertex_count = mVertexBufferOffset / sizeof( RwIm3DVertex ) +
+                              state.VertexBuffer.Size();
+    if ( vertex_count > mVertexCapacity )
+    {
+        mVertexCapacity = GrowCapacity( mVertexCapacity, vertex_count );
+        mRetiredBuffers.push_back( mVertexBuffer );
+        mVertexBuffer = Device.CreateBuffer(
+            { .mSize  = static_cast<uint32_t>( sizeof( RwIm3DVertex ) *
+                                              mVertexCapacity ),
+              .mUsage = BufferUsage::VertexBuffer } );
+        debug::DebugLogger::LogFmt(
+            "Im3D vertex buffer grown to %llu vertices", debug::LogLevel::Info,
+            static_cast<unsigned long long>( mVertexCapacity ) );
+    }
+    if ( state.IndexBuffer.Size() > mIndexCapacity )
+    {
+        mIndexCapacity =
+            GrowCapacity( mIndexCapacity, state.IndexBuffer.Size() );
+        mRetiredBuffers.push_back( mIndexBuffer );
+        mIndexBuffer = Device.CreateBuffer(
+            { .mSize = static_cast<uint32_t>( sizeof( uint16_t ) *
+                                              mIndexCapacity ),
+              .mUsage = BufferUsage::IndexBuffer } );
+        debug::DebugLogger::LogFmt(
+            "Im3D index buffer grown to %llu indices", debug::LogLevel::Info,
+            static_cast<unsigned long long>( mIndexCapacity ) );
+    }
+    ReserveMatrixSets( state.DrawCalls.Size() );
+}
+
+void Im3DRenderer::ReserveMatrixSets( uint64_t draw_call_count )
+{
+    const auto set_count = mMatrixDescriptorSetPool.size();
+    if ( draw_call_count <= set_count )
+        return;
+    const auto new_count = GrowCapacity( set_count, draw_call_count );
+    const auto add_count = static_cast<uint32_t>( new_count - set_count );
+
+    // Im3D is rendered once per frame, so matrix sets are not bound by
+    // current frame yet and can be pointed to a new buffer
+    std::array pool_sizes = {
+        DescriptorPoolSize{ DescriptorType::ROBuffer, add_count } };
+    auto *allocator = Device.CreateDescriptorSetAllocator(
+        { .mDescriptorPools = pool_sizes, .mMaxSets = add_count } );
+    mMatrixSetAllocators.push_back( allocator );
+
+    std::vector obj_layout_array =
+        std::vector( add_count, (IDescriptorSetLayout *)mObjectSetLayout );
+    auto new_sets =
+        allocator->AllocateDescriptorSets( { .mLayouts = obj_layout_array } );
+    mMatrixDescriptorSetPool.insert( mMatrixDescriptorSetPool.end(),
+                                     new_sets.begin(), new_sets.end() );
+
+    auto matrix_size = Device.GetLimits().GetMinAlignedBufferEntrySize(
+        sizeof( DirectX::XMFLOAT4X4 ) );
+    mRetiredBuffers.push_back( mMatrixBuffer );
+    mMatrixBuffer = Device.CreateBuffer( BufferCreateInfo{
+        static_cast<uint32_t>( matrix_size * new_count ),
+        BufferUsage::ConstantBuffer, Dynamic, nullptr } );
+    uint32_t buff_offset = 0;
+    for ( auto &i : mMatrixDescriptorSetPool )
+    {
+        std::array              buffer_upd_info = { BufferUpdateInfo{
+            buff_offset, sizeof( DirectX::XMFLOAT4X4 ), mMatrixBuffer } };
+        DescriptorSetUpdateInfo info{};
+        info.mDescriptorType   = DescriptorType::ROBuffer;
+        info.mBinding          = 0;
+        info.mSet              = i;
+        info.mBufferUpdateInfo = buffer_upd_info;
+        Device.UpdateDescriptorSets( info );
+        buff_offset += matrix_size;
+    }
+    debug::DebugLogger::LogFmt(
+        "Im3D matrix pool grown to %llu draw calls", debug::LogLevel::Info,
+        static_cast<unsigned long long>( new_count ) );
+}
 
 uint64_t Im3DRenderer::Render( const Im3DRenderState &     state,
                                rh::engine::ICommandBuffer *cmd_buffer )
 {
+    ReserveBuffers( state );
+
     // Update buffers
     if ( state.IndexBuffer.Size() > 0 )
         mIndexBuffer->Update( state.IndexBuffer.Data(),
@@ -54,6 +54,13 @@ class Im3DRenderer
     void     Reset();
 
   private:
+    /**
+     * Grows buffers and matrix descriptor sets to fit the frame, replaced
+     * buffers are kept until Reset
+     */
+    void ReserveBuffers( const Im3DRenderState &state );
+    void ReserveMatrixSets( uint64_t draw_call_count );
+
     rh::engine::IDescriptorSet *           GetRasterDescSet( uint64_t id );
     rh::engine::IDeviceState &             Device;
     RasterPoolType &                       RasterPool;
@@ -79,6 +86,11 @@ class Im3DRenderer
     SPtr<rh::engine::IBuffer>                 mMatrixBuffer;
     std::vector<rh::engine::IDescriptorSet *> mDescriptorSetPool;
     std::vector<rh::engine::IDescriptorSet *> mMatrixDescriptorSetPool;
+    /// Allocators of matrix descriptor sets added by growth
+    std::vector<rh::engine::IDescriptorSetAllocator *> mMatrixSetAllocators;
+    std::vector<rh::engine::IBuffer *>                 mRetiredBuffers;
+    uint64_t                                           mVertexCapacity = 0;
+    uint64_t                                           mIndexCapacity  = 0;
     uint64_t                                  mDescriptorSetPoolId = 0;
     uint64_t                                  mVertexBufferOffset  = 0;
     SPtr<rh::engine::ISampler>                mTextureSampler;
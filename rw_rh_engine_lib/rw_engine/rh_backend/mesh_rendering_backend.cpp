@@ -15,7 +15,10 @@ using namespace rh::rw::engine;
 uint64_t
 rh::rw::engine::CreateBackendMesh( const BackendMeshInitData &initData )
 {
-    return LoadMeshCmdImpl( gRenderClient->GetTaskQueue() ).Invoke( initData );
+    // streamed meshes are sent in batches with the next frame
+    if ( auto *batch = gRenderClient->GetMeshLoadBatch() )
+        return batch->Add( initData );
+    return LoadMeshCmdImpl( gRenderClient->GetAssetQueue() ).Invoke( initData );
 }
 
 void rh::rw::engine::DestroyBackendMesh( uint64_t id )
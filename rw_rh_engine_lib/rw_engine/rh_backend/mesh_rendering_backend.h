@@ -98,12 +98,16 @@ struct VertexDescPosColorUVNormals
 
 struct BackendMeshInitData
 {
-    uint64_t                      mIndexCount;
-    uint64_t                      mVertexCount;
-    uint16_t *                    mIndexData;
-    VertexDescPosColorUVNormals * mVertexData;
-    std::vector<GeometrySplit>    mSplits;
-    std::vector<GeometryMaterial> mMaterials;
+    uint64_t                            mIndexCount;
+    uint64_t                            mVertexCount;
+    const uint16_t *                    mIndexData;
+    const VertexDescPosColorUVNormals * mVertexData;
+    std::vector<GeometrySplit>          mSplits;
+    std::vector<GeometryMaterial>       mMaterials;
+    /// Emissive triangles found ahead of time, e.g. by asset cooker, if
+    /// nullptr render driver finds them itself
+    const PackedLight *mEmissiveTriangles     = nullptr;
+    uint64_t           mEmissiveTriangleCount = 0;
 };
 
 uint64_t CreateBackendMesh( const BackendMeshInitData &initData );
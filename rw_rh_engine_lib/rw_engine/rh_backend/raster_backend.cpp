@@ -45,9 +45,8 @@ BackendRasterExt::~BackendRasterExt()
     if ( mImageId == BackendRasterPlugin::NullRasterId )
         return;
 
-    // Destroy raster
-    // TODO: Better way could be to free rasters in batches, per-frame, need
-    // to test this
+    // Destroy raster, destroy commands are batched and sent with the next
+    // task so it doesn't block
     assert( gRenderClient );
     if ( gRenderClient )
     {
@@ -16,7 +16,7 @@ namespace rh::rw::engine
 
 uint64_t CreateSkinMesh( const SkinnedMeshInitData &initData )
 {
-    SkinnedMeshLoadCmdImpl cmd( gRenderClient->GetTaskQueue() );
+    SkinnedMeshLoadCmdImpl cmd( gRenderClient->GetAssetQueue() );
 
     return cmd.Invoke( initData );
 }
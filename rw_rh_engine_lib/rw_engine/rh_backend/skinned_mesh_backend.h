@@ -9,11 +9,11 @@ namespace rh::rw::engine
 
 struct SkinnedMeshInitData
 {
-    uint64_t                     mIndexCount;
-    uint64_t                     mVertexCount;
-    uint16_t *                   mIndexData;
-    VertexDescPosColorUVNormals *mVertexData;
-    std::vector<GeometrySplit>   mSplits;
+    uint64_t                           mIndexCount;
+    uint64_t                           mVertexCount;
+    const uint16_t *                   mIndexData;
+    const VertexDescPosColorUVNormals *mVertexData;
+    std::vector<GeometrySplit>         mSplits;
 };
 
 struct SkinMeshData
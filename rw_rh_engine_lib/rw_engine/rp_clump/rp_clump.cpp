@@ -3,18 +3,27 @@
 #include <rw_engine/rp_geometry/rp_geometry.h>
 #include <rw_engine/rw_frame/rw_frame.h>
 #include <rw_engine/rw_macro_constexpr.h>
+#include <rw_engine/rw_stream/rw_chunk_index.h>
 #include <rw_engine/rw_stream/rw_stream.h>
 
 #include <common_headers.h>
 
 #include <DebugUtils/DebugLogger.h>
+#include <Engine/EngineConfigBlock.h>
 
-#include <fstream>
 #include <rw_engine/test_heap_allocator.h>
 
 bool rh::rw::engine::LoadClump( RpClump *&clump, const std::string &dff_path )
 {
-    std::ifstream stream( dff_path, std::ios_base::in | std::ios_base::binary );
+    RwMappedFile file;
+    if ( !file.Open( dff_path ) )
+        return false;
+    // clump is parsed straight from file mapping
+    RwMemoryStream stream( file.Data() );
+    RwChunkIndex   chunk_index;
+    chunk_index.Open( dff_path, file.Data(),
+                      rh::engine::EngineConfigBlock::It.CacheChunkIndices );
+    stream.SetChunkIndex( &chunk_index );
 
     if ( RwStreamFindChunk( &stream, rwID_CLUMP, nullptr, nullptr ) )
         clump = RpClumpStreamRead( &stream );
@@ -47,15 +56,16 @@ RpClump *rh::rw::engine::RpClumpStreamRead( void *stream )
     rpGeometryList   gl{};
     RpAtomic *       atom;
 
-    logger::Log( "RpClumpStreamRead: reading _rpClump info:\n" );
+    logger::LogFormat( rh::debug::LogLevel::Info,
+                       "RpClumpStreamRead: reading _rpClump info:\n" );
 
     if ( version > 0x33000 )
     {
         status = ( sizeof( cl ) == RwStreamRead( stream, &cl, sizeof( cl ) ) );
 
-        logger::Log( "numAtomics:" + std::to_string( cl.numAtomics ) +
-                     "\tnumCameras:" + std::to_string( cl.numCameras ) +
-                     "\tnumLights:" + std::to_string( cl.numLights ) );
+        logger::LogFormat( rh::debug::LogLevel::Info,
+                           "numAtomics:%d\tnumCameras:%d\tnumLights:%d",
+                           cl.numAtomics, cl.numCameras, cl.numLights );
     }
     else
     {
@@ -63,7 +73,8 @@ RpClump *rh::rw::engine::RpClumpStreamRead( void *stream )
             ( sizeof( cl.numAtomics ) ==
               RwStreamRead( stream, &cl.numAtomics, sizeof( cl.numAtomics ) ) );
 
-        logger::Log( "numAtomics:" + std::to_string( cl.numAtomics ) );
+        logger::LogFormat( rh::debug::LogLevel::Info, "numAtomics:%d",
+                           cl.numAtomics );
     }
 
     RpClump *clump = RpClumpCreate();
@@ -164,17 +164,14 @@ RpGeometry *RpGeometryStreamRead( void *stream )
             /* Read in the triangles */
             if ( geometry->numTriangles )
             {
-                RpTriangle *destTri;
-                int32_t     numTris;
-                uint32_t    size;
-
-                /* Load the triangle information */
-                numTris = geometry->numTriangles;
-                destTri = geometry->triangles;
-
-                size = static_cast<uint32_t>( numTris ) * sizeof( _rpTriangle );
-                if ( RwStreamRead( stream, reinterpret_cast<void *>( destTri ),
-                                   size ) != size ||
+                RpTriangle *destTri = geometry->triangles;
+
+                /* Load the triangle information, packed triangles are read
+                 * in place from the stream */
+                const auto srceTris = RwStreamReadSpan<_rpTriangle>(
+                    stream, static_cast<uint64_t>( geometry->numTriangles ) );
+                if ( srceTris.size() !=
+                         static_cast<uint64_t>( geometry->numTriangles ) ||
                      destTri == nullptr )
                 {
                     rh::rw::engine::RpGeometryDestroy( geometry );
@@ -182,27 +179,23 @@ RpGeometry *RpGeometryStreamRead( void *stream )
                     return nullptr;
                 }
 
-                /* These are unpacked "in-place" into RwUInt16 fields */
-                // these guys smart tricksters tbh, why tho?
-                while ( numTris-- )
+                /* Unpack into RwUInt16 fields */
+                for ( const auto &srceTri : srceTris )
                 {
-                    uint16_t     hi, lo;
-                    _rpTriangle *srceTri;
-
-                    srceTri = reinterpret_cast<_rpTriangle *>( destTri );
+                    uint16_t hi, lo;
 
-                    hi = static_cast<uint16_t>( ( srceTri->vertex01 >> 16 ) &
+                    hi = static_cast<uint16_t>( ( srceTri.vertex01 >> 16 ) &
                                                 0xFFFF );
                     lo = static_cast<uint16_t>(
-                        static_cast<uint16_t>( srceTri->vertex01 ) & 0xFFFF );
+                        static_cast<uint16_t>( srceTri.vertex01 ) & 0xFFFF );
                     destTri->vertIndex[0] = hi;
                     destTri->vertIndex[1] = lo;
 
                     hi = static_cast<uint16_t>(
-                        static_cast<uint16_t>( srceTri->vertex2Mat >> 16 ) &
+                        static_cast<uint16_t>( srceTri.vertex2Mat >> 16 ) &
                         0xFFFF );
                     lo = static_cast<uint16_t>(
-                        static_cast<uint16_t>( srceTri->vertex2Mat ) & 0xFFFF );
+                        static_cast<uint16_t>( srceTri.vertex2Mat ) & 0xFFFF );
                     destTri->vertIndex[2] = hi;
                     destTri->matIndex     = lo;
 
@@ -398,12 +391,12 @@ RpGeometry *RpGeometryCreate( int32_t numVerts, int32_t numTriangles,
 
     if ( !( rpGEOMETRYNATIVE & format ) )
     {
-        logger::Log( "Geometry offset " +
-                     std::to_string( reinterpret_cast<intptr_t>( geometry ) ) );
+        logger::LogFormat( rh::debug::LogLevel::Info, "Geometry offset %p",
+                           static_cast<void *>( geometry ) );
         /* step past structure to allocate arrays */
         goffset = reinterpret_cast<char *>( geometry ) + sizeof( RpGeometry );
-        logger::Log( "Prelit offset " +
-                     std::to_string( reinterpret_cast<intptr_t>( goffset ) ) );
+        logger::LogFormat( rh::debug::LogLevel::Info, "Prelit offset %p",
+                           static_cast<void *>( goffset ) );
 
         /* Create prelight values if necessary */
         if ( ( flags & rpGEOMETRYPRELIT ) && numVerts )
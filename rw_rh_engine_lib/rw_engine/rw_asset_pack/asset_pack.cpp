@@ -0,0 +1,346 @@
+//
+// Created by peter on 16.10.2026.
+//
+#include "asset_pack.h"
+#include <DebugUtils/DebugLogger.h>
+#include <render_driver/gpu_resources/content_hash.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+
+namespace rh::rw::engine
+{
+namespace
+{
+template <typename Entry>
+const Entry *FindEntry( std::span<const Entry> entries, uint64_t key )
+{
+    const auto it = std::ranges::lower_bound( entries, key, {}, &Entry::Key );
+    return it != entries.end() && it->Key == key ? &*it : nullptr;
+}
+
+uint64_t AlignUp( uint64_t value )
+{
+    return ( value + gAssetPackAlignment - 1 ) & ~( gAssetPackAlignment - 1 );
+}
+} // namespace
+
+uint64_t TextureSourceKey( std::span<const uint8_t> data )
+{
+    return HashContent( data.data(), data.size(), gAssetPackVersion );
+}
+
+bool AssetPack::Open( const std::filesystem::path &path )
+{
+    using logger = debug::DebugLogger;
+    if ( !mFile.Open( path ) )
+        return false;
+    const auto file = mFile.Data();
+
+    AssetPackHeader header{};
+    if ( file.size() < sizeof( header ) )
+    {
+        logger::ErrorFmt( "Asset pack %s is truncated",
+                          path.generic_string().c_str() );
+        return false;
+    }
+    std::memcpy( &header, file.data(), sizeof( header ) );
+    if ( header.Magic != gAssetPackMagic ||
+         header.Version != gAssetPackVersion ||
+         header.VertexSize != sizeof( VertexDescPosColorUVNormals ) ||
+         header.EmissiveTriangleSize != sizeof( PackedLight ) )
+    {
+        logger::ErrorFmt( "Asset pack %s was made by other cooker version",
+                          path.generic_string().c_str() );
+        return false;
+    }
+
+    auto in_file = [&file]( uint64_t offset, uint64_t size )
+    { return offset <= file.size() && size <= file.size() - offset; };
+    const uint64_t mesh_table_size =
+        uint64_t{ header.MeshCount } * sizeof( AssetPackMeshEntry );
+    const uint64_t texture_table_size =
+        uint64_t{ header.TextureCount } * sizeof( AssetPackTextureEntry );
+    if ( !in_file( header.MeshTableOffset, mesh_table_size ) ||
+         !in_file( header.TextureTableOffset, texture_table_size ) ||
+         !in_file( header.DataOffset, header.DataSize ) ||
+         header.MeshTableOffset % gAssetPackAlignment != 0 ||
+         header.TextureTableOffset % gAssetPackAlignment != 0 ||
+         header.DataOffset % gAssetPackAlignment != 0 )
+    {
+        logger::ErrorFmt( "Asset pack %s is truncated",
+                          path.generic_string().c_str() );
+        return false;
+    }
+    mData     = file.subspan( header.DataOffset, header.DataSize );
+    mMeshes   = { reinterpret_cast<const AssetPackMeshEntry *>(
+                      file.data() + header.MeshTableOffset ),
+                  header.MeshCount };
+    mTextures = { reinterpret_cast<const AssetPackTextureEntry *>(
+                      file.data() + header.TextureTableOffset ),
+                  header.TextureCount };
+
+    // lookups are binary searches, so keys must be sorted and unique
+    auto keys_sorted = []( const auto &entries )
+    {
+        return std::ranges::adjacent_find(
+                   entries, []( const auto &a, const auto &b )
+                   { return a.Key >= b.Key; } ) == entries.end();
+    };
+    // only tables and splits are checked, so asset data is paged in when it
+    // is used
+    const bool meshes_valid = std::ranges::all_of(
+        mMeshes,
+        [this]( const AssetPackMeshEntry &mesh )
+        {
+            auto in_data = [this]( uint64_t offset, uint64_t count,
+                                   uint64_t element_size )
+            { return InData( offset, count * element_size ); };
+            if ( !in_data( mesh.VertexOffset, mesh.VertexCount,
+                           sizeof( VertexDescPosColorUVNormals ) ) ||
+                 !in_data( mesh.IndexOffset, mesh.IndexCount,
+                           sizeof( uint16_t ) ) ||
+                 !in_data( mesh.SplitOffset, mesh.SplitCount,
+                           sizeof( GeometrySplit ) ) ||
+                 !in_data( mesh.MaterialOffset, mesh.MaterialCount,
+                           sizeof( GeometryMaterial ) ) ||
+                 !in_data( mesh.EmissiveOffset, mesh.EmissiveCount,
+                           sizeof( PackedLight ) ) )
+                return false;
+            return std::ranges::all_of(
+                std::span( At<GeometrySplit>( mesh.SplitOffset ),
+                           mesh.SplitCount ),
+                [&mesh]( const GeometrySplit &split )
+                {
+                    return uint64_t{ split.mIndexOffset } + split.mIndexCount <=
+                               mesh.IndexCount &&
+                           uint64_t{ split.mVertexOffset } +
+                                   split.mVertexCount <=
+                               mesh.VertexCount;
+                } );
+        } );
+    const bool textures_valid = std::ranges::all_of(
+        mTextures,
+        [this]( const AssetPackTextureEntry &texture )
+        {
+            const uint64_t mip_count = texture.Header.mMipLevelCount;
+            if ( !InData( texture.MipOffset,
+                          mip_count * sizeof( AssetPackMipEntry ) ) )
+                return false;
+            return std::ranges::all_of(
+                std::span( At<AssetPackMipEntry>( texture.MipOffset ),
+                           mip_count ),
+                [this]( const AssetPackMipEntry &mip )
+                { return InData( mip.DataOffset, mip.Header.mSize ); } );
+        } );
+    if ( !keys_sorted( mMeshes ) || !keys_sorted( mTextures ) ||
+         !meshes_valid || !textures_valid )
+    {
+        logger::ErrorFmt( "Asset pack %s has broken tables",
+                          path.generic_string().c_str() );
+        mMeshes   = {};
+        mTextures = {};
+        return false;
+    }
+
+    logger::LogFormat( debug::LogLevel::Info,
+                       "Asset pack %s: %u meshes, %u textures",
+                       path.generic_string().c_str(), header.MeshCount,
+                       header.TextureCount );
+    return true;
+}
+
+bool AssetPack::InData( uint64_t offset, uint64_t size ) const
+{
+    return offset % gAssetPackAlignment == 0 && offset <= mData.size() &&
+           size <= mData.size() - offset;
+}
+
+bool AssetPack::FindMesh( uint64_t key, BackendMeshInitData &init_data ) const
+{
+    const auto *mesh = FindEntry( mMeshes, key );
+    if ( mesh == nullptr )
+        return false;
+
+    init_data.mVertexCount = mesh->VertexCount;
+    init_data.mIndexCount  = mesh->IndexCount;
+    init_data.mVertexData =
+        At<VertexDescPosColorUVNormals>( mesh->VertexOffset );
+    init_data.mIndexData = At<uint16_t>( mesh->IndexOffset );
+
+    const auto *splits = At<GeometrySplit>( mesh->SplitOffset );
+    init_data.mSplits.assign( splits, splits + mesh->SplitCount );
+    const auto *materials = At<GeometryMaterial>( mesh->MaterialOffset );
+    init_data.mMaterials.assign( materials, materials + mesh->MaterialCount );
+
+    init_data.mEmissiveTriangles     = At<PackedLight>( mesh->EmissiveOffset );
+    init_data.mEmissiveTriangleCount = mesh->EmissiveCount;
+    return true;
+}
+
+bool AssetPack::FindTexture( uint64_t key, DecodedNativeTexture &texture ) const
+{
+    const auto *entry = FindEntry( mTextures, key );
+    if ( entry == nullptr )
+        return false;
+
+    texture.Name.assign( entry->Name,
+                         strnlen( entry->Name, sizeof( entry->Name ) ) );
+    texture.Mask.assign( entry->Mask,
+                         strnlen( entry->Mask, sizeof( entry->Mask ) ) );
+    texture.FilterAndAddress = entry->FilterAndAddress;
+    texture.Width            = entry->Width;
+    texture.Height           = entry->Height;
+    texture.Depth            = entry->Depth;
+    texture.RasterType       = entry->RasterType;
+    texture.RasterFormat     = entry->RasterFormat;
+    texture.OriginalFormat   = entry->OriginalFormat;
+    texture.BytesPerBlock    = entry->BytesPerBlock;
+    texture.BlockSize        = entry->BlockSize;
+    texture.Compressed       = ( entry->Flags & TextureCompressed ) != 0;
+    texture.IsCubemap        = ( entry->Flags & TextureIsCubemap ) != 0;
+    texture.HasAlpha         = ( entry->Flags & TextureHasAlpha ) != 0;
+    texture.ConvertFromPal   = ( entry->Flags & TextureConvertFromPal ) != 0;
+    texture.Header           = entry->Header;
+
+    const auto mips = std::span( At<AssetPackMipEntry>( entry->MipOffset ),
+                                 entry->Header.mMipLevelCount );
+    texture.MipLevels.clear();
+    texture.MipLevels.reserve( mips.size() );
+    for ( const auto &mip : mips )
+        texture.MipLevels.push_back(
+            { .Header = mip.Header, .Data = At<uint8_t>( mip.DataOffset ) } );
+    return true;
+}
+
+uint64_t AssetPackWriter::AppendData( const void *data, uint64_t size )
+{
+    const uint64_t offset = AlignUp( mData.size() );
+    mData.resize( offset + size );
+    if ( size > 0 )
+        std::memcpy( mData.data() + offset, data, size );
+    return offset;
+}
+
+void AssetPackWriter::AddMesh( uint64_t key, const BackendMeshInitData &mesh,
+                               std::span<const PackedLight> emissive_triangles )
+{
+    if ( !mMeshKeys.insert( key ).second )
+        return;
+
+    AssetPackMeshEntry entry{};
+    entry.Key           = key;
+    entry.VertexCount   = static_cast<uint32_t>( mesh.mVertexCount );
+    entry.IndexCount    = static_cast<uint32_t>( mesh.mIndexCount );
+    entry.SplitCount    = static_cast<uint32_t>( mesh.mSplits.size() );
+    entry.MaterialCount = static_cast<uint32_t>( mesh.mMaterials.size() );
+    entry.EmissiveCount = static_cast<uint32_t>( emissive_triangles.size() );
+    entry.VertexOffset  = AppendData(
+        mesh.mVertexData,
+        mesh.mVertexCount * sizeof( VertexDescPosColorUVNormals ) );
+    entry.IndexOffset =
+        AppendData( mesh.mIndexData, mesh.mIndexCount * sizeof( uint16_t ) );
+    entry.SplitOffset =
+        AppendData( mesh.mSplits.data(),
+                    mesh.mSplits.size() * sizeof( GeometrySplit ) );
+    entry.MaterialOffset =
+        AppendData( mesh.mMaterials.data(),
+                    mesh.mMaterials.size() * sizeof( GeometryMaterial ) );
+    entry.EmissiveOffset = AppendData( emissive_triangles.data(),
+                                       emissive_triangles.size_bytes() );
+    mMeshes.push_back( entry );
+}
+
+void AssetPackWriter::AddTexture( uint64_t                    key,
+                                  const DecodedNativeTexture &texture )
+{
+    if ( !mTextureKeys.insert( key ).second )
+        return;
+
+    AssetPackTextureEntry entry{};
+    entry.Key = key;
+    std::memcpy( entry.Name, texture.Name.data(),
+                 ( std::min )( texture.Name.size(), sizeof( entry.Name ) ) );
+    std::memcpy( entry.Mask, texture.Mask.data(),
+                 ( std::min )( texture.Mask.size(), sizeof( entry.Mask ) ) );
+    entry.FilterAndAddress = texture.FilterAndAddress;
+    entry.Width            = texture.Width;
+    entry.Height           = texture.Height;
+    entry.Depth            = texture.Depth;
+    entry.RasterType       = texture.RasterType;
+    entry.RasterFormat     = texture.RasterFormat;
+    entry.OriginalFormat   = texture.OriginalFormat;
+    entry.BytesPerBlock    = texture.BytesPerBlock;
+    entry.BlockSize        = texture.BlockSize;
+    entry.Flags = ( texture.Compressed ? TextureCompressed : 0u ) |
+                  ( texture.IsCubemap ? TextureIsCubemap : 0u ) |
+                  ( texture.HasAlpha ? TextureHasAlpha : 0u ) |
+                  ( texture.ConvertFromPal ? TextureConvertFromPal : 0u );
+    entry.Header                = texture.Header;
+    entry.Header.mMipLevelCount =
+        static_cast<uint32_t>( texture.MipLevels.size() );
+
+    std::vector<AssetPackMipEntry> mips;
+    mips.reserve( texture.MipLevels.size() );
+    for ( const auto &mip : texture.MipLevels )
+        mips.push_back( { .Header     = mip.Header,
+                          .DataOffset = AppendData( mip.Data,
+                                                    mip.Header.mSize ) } );
+    entry.MipOffset =
+        AppendData( mips.data(), mips.size() * sizeof( AssetPackMipEntry ) );
+    mTextures.push_back( entry );
+}
+
+bool AssetPackWriter::Write( const std::filesystem::path &path )
+{
+    std::ranges::sort( mMeshes, {}, &AssetPackMeshEntry::Key );
+    std::ranges::sort( mTextures, {}, &AssetPackTextureEntry::Key );
+
+    AssetPackHeader header{};
+    header.MeshCount          = static_cast<uint32_t>( mMeshes.size() );
+    header.TextureCount       = static_cast<uint32_t>( mTextures.size() );
+    header.MeshTableOffset    = AlignUp( sizeof( AssetPackHeader ) );
+    header.TextureTableOffset =
+        AlignUp( header.MeshTableOffset +
+                 mMeshes.size() * sizeof( AssetPackMeshEntry ) );
+    header.DataOffset =
+        AlignUp( header.TextureTableOffset +
+                 mTextures.size() * sizeof( AssetPackTextureEntry ) );
+    header.DataSize = mData.size();
+
+    auto temp_path = path;
+    temp_path += ".tmp";
+    {
+        std::ofstream file( temp_path, std::ios::binary | std::ios::trunc );
+        if ( !file.is_open() )
+            return false;
+        auto write_at = [&file]( uint64_t offset, const void *data,
+                                 uint64_t size )
+        {
+            // zero padding up to offset
+            static const std::array<char, gAssetPackAlignment> padding{};
+            const auto position = static_cast<uint64_t>( file.tellp() );
+            file.write( padding.data(),
+                        static_cast<std::streamsize>( offset - position ) );
+            file.write( static_cast<const char *>( data ),
+                        static_cast<std::streamsize>( size ) );
+        };
+        write_at( 0, &header, sizeof( header ) );
+        write_at( header.MeshTableOffset, mMeshes.data(),
+                  mMeshes.size() * sizeof( AssetPackMeshEntry ) );
+        write_at( header.TextureTableOffset, mTextures.data(),
+                  mTextures.size() * sizeof( AssetPackTextureEntry ) );
+        write_at( header.DataOffset, mData.data(), mData.size() );
+        file.flush();
+        if ( !file.good() )
+            return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename( temp_path, path, ec );
+    return !ec;
+}
+
+} // namespace rh::rw::engine
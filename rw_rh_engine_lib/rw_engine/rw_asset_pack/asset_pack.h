@@ -0,0 +1,177 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include <rw_engine/rh_backend/mesh_rendering_backend.h>
+#include <rw_engine/rh_backend/raster_backend.h>
+#include <rw_engine/rw_standard_render_commands/nativetexturereadcmd.h>
+#include <rw_engine/rw_stream/rw_memory_stream.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <unordered_set>
+#include <vector>
+
+namespace rh::rw::engine
+{
+/**
+ * Asset pack is a file of render ready meshes and textures made offline by
+ * asset cooker. Assets are looked up by a hash of their source data, so
+ * game files changed after cooking are simply not found and converted as
+ * usual.
+ *
+ * Layout: header, mesh table and texture table sorted by key, then data
+ * section. Offsets in tables are relative to data section, every array is
+ * 16 byte aligned so it can be used straight from file mapping.
+ */
+constexpr uint32_t gAssetPackMagic     = 0x4B504852; // RHPK
+constexpr uint32_t gAssetPackVersion   = 1;
+constexpr uint64_t gAssetPackAlignment = 16;
+
+struct AssetPackHeader
+{
+    uint32_t Magic   = gAssetPackMagic;
+    uint32_t Version = gAssetPackVersion;
+    /// Sizes of structures shared with runtime, pack made with different
+    /// ones is rejected
+    uint32_t VertexSize           = sizeof( VertexDescPosColorUVNormals );
+    uint32_t EmissiveTriangleSize = sizeof( PackedLight );
+    uint32_t MeshCount            = 0;
+    uint32_t TextureCount         = 0;
+    uint64_t MeshTableOffset      = 0;
+    uint64_t TextureTableOffset   = 0;
+    uint64_t DataOffset           = 0;
+    uint64_t DataSize             = 0;
+};
+
+struct AssetPackMeshEntry
+{
+    /// GeometrySourceKey of cooked geometry
+    uint64_t Key;
+    uint64_t VertexOffset;
+    uint64_t IndexOffset;
+    uint64_t SplitOffset;
+    uint64_t MaterialOffset;
+    uint64_t EmissiveOffset;
+    uint32_t VertexCount;
+    uint32_t IndexCount;
+    uint32_t SplitCount;
+    uint32_t MaterialCount;
+    uint32_t EmissiveCount;
+    uint32_t Padding;
+};
+
+enum AssetPackTextureFlags : uint32_t
+{
+    TextureCompressed     = 1,
+    TextureIsCubemap      = 2,
+    TextureHasAlpha       = 4,
+    TextureConvertFromPal = 8
+};
+
+struct AssetPackTextureEntry
+{
+    /// Hash of texture native STRUCT chunk, see TextureSourceKey
+    uint64_t     Key;
+    /// Offset of Header.mMipLevelCount AssetPackMipEntry records
+    uint64_t     MipOffset;
+    char         Name[32];
+    char         Mask[32];
+    uint32_t     FilterAndAddress;
+    uint32_t     Width;
+    uint32_t     Height;
+    uint32_t     Depth;
+    uint32_t     RasterType;
+    uint32_t     RasterFormat;
+    uint32_t     OriginalFormat;
+    uint32_t     BytesPerBlock;
+    uint32_t     BlockSize;
+    uint32_t     Flags;
+    RasterHeader Header;
+};
+
+struct AssetPackMipEntry
+{
+    MipLevelHeader Header;
+    uint64_t       DataOffset;
+};
+
+/// Key of texture native STRUCT chunk data in asset packs
+uint64_t TextureSourceKey( std::span<const uint8_t> data );
+
+/**
+ * Memory mapped asset pack, lookups are read only and may be done from any
+ * thread
+ */
+class AssetPack
+{
+  public:
+    /**
+     * Maps pack and checks that tables are sorted by key, every table entry
+     * points inside of it and every mesh split stays inside its mesh
+     * @return false if file is missing, truncated, broken or made by other
+     * version
+     */
+    bool Open( const std::filesystem::path &path );
+
+    /**
+     * Fills init data of cooked mesh, vertex, index and emissive triangle
+     * arrays point into the pack
+     * @return false if mesh isn't cooked
+     */
+    bool FindMesh( uint64_t key, BackendMeshInitData &init_data ) const;
+
+    /**
+     * Fills decoded texture, mip levels point into the pack
+     * @return false if texture isn't cooked
+     */
+    bool FindTexture( uint64_t key, DecodedNativeTexture &texture ) const;
+
+    [[nodiscard]] uint64_t MeshCount() const { return mMeshes.size(); }
+    [[nodiscard]] uint64_t TextureCount() const { return mTextures.size(); }
+
+  private:
+    [[nodiscard]] bool InData( uint64_t offset, uint64_t size ) const;
+    template <typename T> const T *At( uint64_t offset ) const
+    {
+        return reinterpret_cast<const T *>( mData.data() + offset );
+    }
+
+    RwMappedFile                           mFile;
+    std::span<const uint8_t>               mData;
+    std::span<const AssetPackMeshEntry>    mMeshes;
+    std::span<const AssetPackTextureEntry> mTextures;
+};
+
+/// Builds asset pack in memory, used by asset cooker
+class AssetPackWriter
+{
+  public:
+    /// Meshes and textures with already added keys are skipped
+    void AddMesh( uint64_t key, const BackendMeshInitData &mesh,
+                  std::span<const PackedLight> emissive_triangles );
+    void AddTexture( uint64_t key, const DecodedNativeTexture &texture );
+
+    /**
+     * Writes pack into a temporary file next to path and renames it, so
+     * an interrupted write never leaves a broken pack behind
+     */
+    bool Write( const std::filesystem::path &path );
+
+    [[nodiscard]] uint64_t MeshCount() const { return mMeshes.size(); }
+    [[nodiscard]] uint64_t TextureCount() const { return mTextures.size(); }
+    [[nodiscard]] uint64_t DataSize() const { return mData.size(); }
+
+  private:
+    /// @return offset of aligned copy of data in data section
+    uint64_t AppendData( const void *data, uint64_t size );
+
+    std::vector<AssetPackMeshEntry>    mMeshes;
+    std::vector<AssetPackTextureEntry> mTextures;
+    std::unordered_set<uint64_t>       mMeshKeys;
+    std::unordered_set<uint64_t>       mTextureKeys;
+    std::vector<uint8_t>               mData;
+};
+
+} // namespace rh::rw::engine
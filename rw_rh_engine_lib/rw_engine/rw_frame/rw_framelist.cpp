@@ -15,7 +15,8 @@ rwFrameList *rh::rw::engine::_rwFrameListStreamRead( void *       stream,
 {
     using logger = rh::debug::DebugLogger;
 
-    logger::Log( "rwFrameListStreamRead start" );
+    logger::LogFormat( rh::debug::LogLevel::Info,
+                       "rwFrameListStreamRead start" );
 
     struct rwStreamFrameList
     {
@@ -31,7 +32,16 @@ rwFrameList *rh::rw::engine::_rwFrameListStreamRead( void *       stream,
     if ( RwStreamRead( stream, &fl, sizeof( fl ) ) != sizeof( fl ) )
         return nullptr;
 
-    logger::Log( "numFrames:" + std::to_string( fl.numFrames ) );
+    logger::LogFormat( rh::debug::LogLevel::Info, "numFrames:%d",
+                       fl.numFrames );
+
+    if ( fl.numFrames < 0 )
+        return nullptr;
+    // frames are read in place from the stream
+    const auto stream_frames = RwStreamReadSpan<rwStreamFrame>(
+        stream, static_cast<uint64_t>( fl.numFrames ) );
+    if ( stream_frames.size() != static_cast<uint64_t>( fl.numFrames ) )
+        return nullptr;
 
     frameList->numFrames = fl.numFrames;
 
@@ -40,15 +50,9 @@ rwFrameList *rh::rw::engine::_rwFrameListStreamRead( void *       stream,
 
     for ( i = 0; i < fl.numFrames; i++ )
     {
-        rwStreamFrame f;
-        RwFrame *     frame;
-        RwMatrix *    mat;
-
-        if ( RwStreamRead( stream, &f, sizeof( f ) ) != sizeof( f ) )
-        {
-            hFree( frameList->frames );
-            return nullptr;
-        }
+        const rwStreamFrame &f = stream_frames[i];
+        RwFrame *            frame;
+        RwMatrix *           mat;
 
         /* Create the frame */
         frame = RwFrameCreate();
@@ -0,0 +1,380 @@
+//
+// Created by peter on 16.10.2026.
+//
+#include "geometry_cache.h"
+#include <DebugUtils/DebugLogger.h>
+#include <render_driver/gpu_resources/content_hash.h>
+#include <rw_engine/rw_rh_pipeline.h>
+#include <rw_engine/system_funcs/mesh_load_cmd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace rh::rw::engine
+{
+namespace
+{
+namespace fs = std::filesystem;
+
+/// Offsets of arrays in cache file
+struct CacheFileLayout
+{
+    uint64_t VertexOffset;
+    uint64_t IndexOffset;
+    uint64_t SplitOffset;
+    uint64_t MaterialOffset;
+    uint64_t EmissiveOffset;
+    uint64_t BodySize;
+};
+
+CacheFileLayout GetLayout( const GeometryCacheFileHeader &header )
+{
+    uint64_t offset = sizeof( GeometryCacheFileHeader );
+    auto     place  = [&offset]( uint64_t size )
+    {
+        const uint64_t start = ( offset + gGeometryCacheAlignment - 1 ) &
+                               ~( gGeometryCacheAlignment - 1 );
+        offset = start + size;
+        return start;
+    };
+    CacheFileLayout layout{};
+    layout.VertexOffset = place( uint64_t{ header.VertexCount } *
+                                 sizeof( VertexDescPosColorUVNormals ) );
+    layout.IndexOffset =
+        place( uint64_t{ header.IndexCount } * sizeof( uint16_t ) );
+    layout.SplitOffset =
+        place( uint64_t{ header.SplitCount } * sizeof( GeometrySplit ) );
+    layout.MaterialOffset =
+        place( uint64_t{ header.MaterialCount } * sizeof( GeometryMaterial ) );
+    layout.EmissiveOffset =
+        place( uint64_t{ header.EmissiveCount } * sizeof( PackedLight ) );
+    layout.BodySize = offset - sizeof( GeometryCacheFileHeader );
+    return layout;
+}
+
+template <typename T>
+std::span<const T> ArrayAt( std::span<const uint8_t> file, uint64_t offset,
+                            uint32_t count )
+{
+    return { reinterpret_cast<const T *>( file.data() + offset ), count };
+}
+
+bool ReadCacheFile( std::span<const uint8_t> file, uint64_t key,
+                    CachedGeometryKind kind, CachedGeometry &result )
+{
+    GeometryCacheFileHeader header{};
+    if ( file.size() < sizeof( header ) )
+        return false;
+    std::memcpy( &header, file.data(), sizeof( header ) );
+    if ( header.Magic != gGeometryCacheMagic ||
+         header.Version != gGeometryCacheVersion ||
+         header.VertexSize != sizeof( VertexDescPosColorUVNormals ) ||
+         header.EmissiveTriangleSize != sizeof( PackedLight ) ||
+         header.Key != key || header.Kind != static_cast<uint32_t>( kind ) )
+        return false;
+
+    const auto layout = GetLayout( header );
+    if ( header.BodySize != layout.BodySize ||
+         file.size() - sizeof( header ) < layout.BodySize ||
+         HashContent( file.data() + sizeof( header ), layout.BodySize ) !=
+             header.Checksum )
+        return false;
+
+    result.Vertices = ArrayAt<VertexDescPosColorUVNormals>(
+        file, layout.VertexOffset, header.VertexCount );
+    result.Indices =
+        ArrayAt<uint16_t>( file, layout.IndexOffset, header.IndexCount );
+    result.Splits =
+        ArrayAt<GeometrySplit>( file, layout.SplitOffset, header.SplitCount );
+    result.Materials = ArrayAt<GeometryMaterial>( file, layout.MaterialOffset,
+                                                  header.MaterialCount );
+    result.EmissiveTriangles = ArrayAt<PackedLight>(
+        file, layout.EmissiveOffset, header.EmissiveCount );
+    return true;
+}
+
+/// @return false if file name is not a key written by PathOf
+bool ParseKey( const fs::path &path, uint64_t &key )
+{
+    const auto name = path.stem().string();
+    if ( path.extension() != ".geo" || name.size() != 16 )
+        return false;
+    char *end = nullptr;
+    key       = std::strtoull( name.c_str(), &end, 16 );
+    return end == name.c_str() + name.size();
+}
+
+int64_t Now()
+{
+    return fs::file_time_type::clock::now().time_since_epoch().count();
+}
+
+uint64_t GetGeometrySize( const InstancedGeometry &geometry )
+{
+    return geometry.Vertices.size() * sizeof( geometry.Vertices[0] ) +
+           geometry.Indices.size() * sizeof( geometry.Indices[0] ) +
+           geometry.Splits.size() * sizeof( geometry.Splits[0] ) +
+           geometry.Materials.size() * sizeof( geometry.Materials[0] );
+}
+} // namespace
+
+struct GeometryCache::PendingWrite
+{
+    uint64_t           Key;
+    CachedGeometryKind Kind;
+    InstancedGeometry  Geometry;
+    uint64_t           Size;
+};
+
+BackendMeshInitData CachedGeometry::GetInitData() const
+{
+    return { .mIndexCount            = Indices.size(),
+             .mVertexCount           = Vertices.size(),
+             .mIndexData             = Indices.data(),
+             .mVertexData            = Vertices.data(),
+             .mSplits                = { Splits.begin(), Splits.end() },
+             .mMaterials             = { Materials.begin(), Materials.end() },
+             .mEmissiveTriangles     = EmissiveTriangles.data(),
+             .mEmissiveTriangleCount = EmissiveTriangles.size() };
+}
+
+GeometryCache::GeometryCache( std::filesystem::path directory,
+                              uint64_t              max_size )
+    : mDirectory( std::move( directory ) ), mMaxSize( max_size )
+{
+    std::error_code ec;
+    fs::create_directories( mDirectory, ec );
+    for ( const auto &file : fs::directory_iterator( mDirectory, ec ) )
+    {
+        // left by a write that was interrupted
+        if ( file.path().extension() == ".tmp" )
+        {
+            fs::remove( file.path(), ec );
+            continue;
+        }
+        uint64_t key;
+        if ( !ParseKey( file.path(), key ) )
+            continue;
+        const auto size = file.file_size( ec );
+        if ( ec )
+            continue;
+        const auto time = file.last_write_time( ec );
+        if ( ec )
+            continue;
+        mEntries[key] = { size, time.time_since_epoch().count() };
+        mSize += size;
+    }
+    Evict();
+    debug::DebugLogger::LogFormat(
+        debug::LogLevel::Info, "Geometry cache %s: %llu files, %llu KB",
+        mDirectory.generic_string().c_str(),
+        static_cast<unsigned long long>( mEntries.size() ),
+        static_cast<unsigned long long>( mSize / 1024 ) );
+    mWriter = std::thread( [this]() { WriterLoop(); } );
+}
+
+GeometryCache::~GeometryCache()
+{
+    {
+        std::lock_guard lock( mWriteMutex );
+        mStopped = true;
+    }
+    mWriteCond.notify_one();
+    mWriter.join();
+}
+
+bool GeometryCache::Find( uint64_t key, CachedGeometryKind kind,
+                          CachedGeometry &result )
+{
+    const auto path = PathOf( key );
+    {
+        std::lock_guard lock( mMutex );
+        const auto      entry = mEntries.find( key );
+        if ( entry == mEntries.end() )
+            return false;
+        // file is touched before it's mapped, mapped file times can't be
+        // changed on Windows
+        std::error_code ec;
+        const auto      now = fs::file_time_type::clock::now();
+        fs::last_write_time( path, now, ec );
+        entry->second.LastUse = now.time_since_epoch().count();
+    }
+
+    if ( result.File.Open( path ) &&
+         ReadCacheFile( result.File.Data(), key, kind, result ) )
+        return true;
+
+    result.File.Close();
+    debug::DebugLogger::LogFormat( debug::LogLevel::Warning,
+                                   "Geometry cache file %s is broken",
+                                   path.generic_string().c_str() );
+    std::lock_guard lock( mMutex );
+    Remove( key );
+    return false;
+}
+
+void GeometryCache::Store( uint64_t key, CachedGeometryKind kind,
+                           InstancedGeometry &&geometry )
+{
+    const uint64_t size = GetGeometrySize( geometry );
+    {
+        std::lock_guard lock( mWriteMutex );
+        // geometry is cached again on next launch if it's dropped here
+        if ( mPendingSize + size > gGeometryCacheMaxPendingSize )
+            return;
+        mPendingWrites.push_back( { key, kind, std::move( geometry ), size } );
+        mPendingSize += size;
+    }
+    mWriteCond.notify_one();
+}
+
+void GeometryCache::WriterLoop()
+{
+    std::vector<PendingWrite> writes;
+    std::unique_lock          lock( mWriteMutex );
+    for ( ;; )
+    {
+        mWriteCond.wait(
+            lock, [this]() { return mStopped || !mPendingWrites.empty(); } );
+        if ( mStopped )
+            return;
+        writes.swap( mPendingWrites );
+        lock.unlock();
+        uint64_t written_size = 0;
+        for ( const auto &write : writes )
+        {
+            if ( mStopped )
+                break;
+            Write( write );
+            written_size += write.Size;
+        }
+        writes.clear();
+        lock.lock();
+        mPendingSize -= written_size;
+    }
+}
+
+void GeometryCache::Write( const PendingWrite &write )
+{
+    const auto &geometry = write.Geometry;
+    const auto  key      = write.Key;
+
+    // emissive triangles are found once and cached with the mesh
+    std::vector<PackedLight> emissive_triangles;
+    if ( write.Kind == CachedGeometryKind::Static )
+        emissive_triangles =
+            LoadMeshCmdImpl::FindEmissiveTriangles( geometry.GetInitData() );
+
+    GeometryCacheFileHeader header{};
+    header.Key           = key;
+    header.Kind          = static_cast<uint32_t>( write.Kind );
+    header.VertexCount   = static_cast<uint32_t>( geometry.Vertices.size() );
+    header.IndexCount    = static_cast<uint32_t>( geometry.Indices.size() );
+    header.SplitCount    = static_cast<uint32_t>( geometry.Splits.size() );
+    header.MaterialCount = static_cast<uint32_t>( geometry.Materials.size() );
+    header.EmissiveCount = static_cast<uint32_t>( emissive_triangles.size() );
+
+    const auto layout = GetLayout( header );
+    header.BodySize   = layout.BodySize;
+
+    // padding between arrays stays zeroed
+    std::vector<uint8_t> file_data( sizeof( header ) + layout.BodySize );
+    auto copy = [&file_data]( uint64_t offset, const auto &array )
+    {
+        if ( !array.empty() )
+            std::memcpy( file_data.data() + offset, array.data(),
+                         array.size() * sizeof( array[0] ) );
+    };
+    copy( layout.VertexOffset, geometry.Vertices );
+    copy( layout.IndexOffset, geometry.Indices );
+    copy( layout.SplitOffset, geometry.Splits );
+    copy( layout.MaterialOffset, geometry.Materials );
+    copy( layout.EmissiveOffset, emissive_triangles );
+    header.Checksum =
+        HashContent( file_data.data() + sizeof( header ), layout.BodySize );
+    std::memcpy( file_data.data(), &header, sizeof( header ) );
+
+    const auto path      = PathOf( key );
+    auto       temp_path = path;
+    temp_path += ".tmp";
+
+    // only writer thread touches temporary files, file IO is done unlocked
+    // so Find doesn't wait for the disk
+    std::error_code ec;
+    {
+        std::ofstream file( temp_path, std::ios::binary | std::ios::trunc );
+        if ( !file.is_open() )
+            return;
+        file.write( reinterpret_cast<const char *>( file_data.data() ),
+                    static_cast<std::streamsize>( file_data.size() ) );
+        file.flush();
+        if ( !file.good() )
+        {
+            file.close();
+            fs::remove( temp_path, ec );
+            return;
+        }
+    }
+    fs::rename( temp_path, path, ec );
+    if ( ec )
+    {
+        fs::remove( temp_path, ec );
+        return;
+    }
+
+    std::lock_guard lock( mMutex );
+    auto           &entry = mEntries[key];
+    mSize -= entry.Size;
+    entry = { file_data.size(), Now() };
+    mSize += entry.Size;
+    Evict();
+}
+
+std::filesystem::path GeometryCache::PathOf( uint64_t key ) const
+{
+    char name[32];
+    std::snprintf( name, sizeof( name ), "%016llx.geo",
+                   static_cast<unsigned long long>( key ) );
+    return mDirectory / name;
+}
+
+void GeometryCache::Remove( uint64_t key )
+{
+    const auto entry = mEntries.find( key );
+    if ( entry == mEntries.end() )
+        return;
+    // file may still be mapped by another thread on Windows, it's left
+    // behind then and found again on next launch
+    std::error_code ec;
+    fs::remove( PathOf( key ), ec );
+    mSize -= entry->second.Size;
+    mEntries.erase( entry );
+}
+
+void GeometryCache::Evict()
+{
+    if ( mSize <= mMaxSize )
+        return;
+
+    std::vector<std::pair<int64_t, uint64_t>> by_use;
+    by_use.reserve( mEntries.size() );
+    for ( const auto &[key, entry] : mEntries )
+        by_use.emplace_back( entry.LastUse, key );
+    std::ranges::sort( by_use );
+
+    // cache is shrunk below its size, so stores right after eviction don't
+    // evict again
+    const uint64_t target_size = mMaxSize / 4 * 3;
+    for ( const auto &[last_use, key] : by_use )
+    {
+        if ( mSize <= target_size )
+            break;
+        Remove( key );
+    }
+}
+
+} // namespace rh::rw::engine
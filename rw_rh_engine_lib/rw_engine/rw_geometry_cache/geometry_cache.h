@@ -0,0 +1,144 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include <rw_engine/rh_backend/mesh_rendering_backend.h>
+#include <rw_engine/rw_stream/rw_memory_stream.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace rh::rw::engine
+{
+struct InstancedGeometry;
+
+/**
+ * Geometry cache is a directory of geometry converted at runtime, one file
+ * per geometry named after a hash of its source data. Later game launches
+ * map cached files and send them to render driver instead of converting
+ * geometry again, which helps when there is no cooked asset pack, e.g. with
+ * mods.
+ *
+ * File layout: header, then vertex, index, split, material and emissive
+ * triangle arrays, each 16 byte aligned. Header holds a checksum of
+ * everything after it, files that fail to validate are deleted.
+ */
+constexpr uint32_t gGeometryCacheMagic     = 0x43475852; // RXGC
+constexpr uint32_t gGeometryCacheVersion   = 1;
+constexpr uint64_t gGeometryCacheAlignment = 16;
+
+enum class CachedGeometryKind : uint32_t
+{
+    Static,
+    Skinned
+};
+
+struct GeometryCacheFileHeader
+{
+    uint32_t Magic   = gGeometryCacheMagic;
+    uint32_t Version = gGeometryCacheVersion;
+    /// Sizes of structures shared with runtime, files made with different
+    /// ones are rejected
+    uint32_t VertexSize           = sizeof( VertexDescPosColorUVNormals );
+    uint32_t EmissiveTriangleSize = sizeof( PackedLight );
+    uint64_t Key                  = 0;
+    uint32_t Kind                 = 0;
+    uint32_t VertexCount          = 0;
+    uint32_t IndexCount           = 0;
+    uint32_t SplitCount           = 0;
+    uint32_t MaterialCount        = 0;
+    uint32_t EmissiveCount        = 0;
+    uint64_t BodySize             = 0;
+    /// HashContent of BodySize bytes following the header
+    uint64_t Checksum             = 0;
+};
+
+/// Geometry read from cache, arrays point into mapped cache file
+struct CachedGeometry
+{
+    RwMappedFile                                 File;
+    std::span<const VertexDescPosColorUVNormals> Vertices;
+    std::span<const uint16_t>                    Indices;
+    std::span<const GeometrySplit>               Splits;
+    std::span<const GeometryMaterial>            Materials;
+    std::span<const PackedLight>                 EmissiveTriangles;
+
+    /// Init data of static mesh, emissive triangles are always set
+    [[nodiscard]] BackendMeshInitData GetInitData() const;
+};
+
+/// Size of geometry waiting to be written, stores past it are dropped
+constexpr uint64_t gGeometryCacheMaxPendingSize = 64ull * 1024 * 1024;
+
+/**
+ * Size bounded geometry cache, least recently used files are deleted once
+ * the cache grows past its size. Find and Store may be called from any
+ * thread, files are written by a writer thread owned by the cache.
+ */
+class GeometryCache
+{
+  public:
+    /// Indexes files in directory and removes unfinished writes
+    GeometryCache( std::filesystem::path directory, uint64_t max_size );
+    /// Finishes file being written, geometry still queued is dropped
+    ~GeometryCache();
+    GeometryCache( const GeometryCache & )            = delete;
+    GeometryCache &operator=( const GeometryCache & ) = delete;
+
+    /**
+     * Maps cached geometry and marks it as recently used
+     * @return false if geometry isn't cached or its file is broken
+     */
+    bool Find( uint64_t key, CachedGeometryKind kind, CachedGeometry &result );
+
+    /**
+     * Queues geometry for writer thread, which finds emissive triangles of
+     * static geometry, checksums it and writes it into a temporary file that
+     * is then renamed, so an interrupted write never leaves a broken file
+     * behind
+     */
+    void Store( uint64_t key, CachedGeometryKind kind,
+                InstancedGeometry &&geometry );
+
+    [[nodiscard]] uint64_t Size() const { return mSize; }
+
+  private:
+    struct Entry
+    {
+        uint64_t Size;
+        /// Last write time of file, it's updated on use
+        int64_t  LastUse;
+    };
+    struct PendingWrite;
+
+    void                                Write( const PendingWrite &write );
+    void                                WriterLoop();
+    [[nodiscard]] std::filesystem::path PathOf( uint64_t key ) const;
+    void                                Remove( uint64_t key );
+    /// Deletes least recently used files until cache fits max size
+    void                                Evict();
+
+    std::filesystem::path               mDirectory;
+    uint64_t                            mMaxSize;
+    /// Changed under mMutex, read without it by Size
+    std::atomic<uint64_t>               mSize = 0;
+    std::unordered_map<uint64_t, Entry> mEntries;
+    std::mutex                          mMutex;
+
+    std::mutex                mWriteMutex;
+    std::condition_variable   mWriteCond;
+    /// pending writes and their size are guarded by write mutex
+    std::vector<PendingWrite> mPendingWrites;
+    uint64_t                  mPendingSize = 0;
+    std::atomic<bool>         mStopped     = false;
+    std::thread               mWriter;
+};
+
+} // namespace rh::rw::engine
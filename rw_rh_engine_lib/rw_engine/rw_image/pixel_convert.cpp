@@ -0,0 +1,415 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "pixel_convert.h"
+#include <algorithm>
+
+#if defined( _M_IX86 ) || defined( _M_X64 ) || defined( __i386__ ) ||         \
+    defined( __x86_64__ )
+#define RH_PIXEL_SIMD
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC compiles any intrinsic without extra flags, gcc and clang only inside
+// functions targeting the instruction set
+#if defined( _MSC_VER ) && !defined( __clang__ )
+#define RH_TARGET_AVX2
+#else
+#define RH_TARGET_AVX2 __attribute__( ( target( "avx2" ) ) )
+#endif
+
+namespace rh::rw::engine
+{
+namespace
+{
+constexpr uint32_t gPaletteTableSize = 256;
+
+constexpr uint32_t PackBGRA( uint32_t r, uint32_t g, uint32_t b, uint32_t a )
+{
+    return ( a << 24 ) | ( r << 16 ) | ( g << 8 ) | b;
+}
+
+constexpr uint32_t Expand4( uint32_t x ) { return ( x << 4 ) | x; }
+constexpr uint32_t Expand5( uint32_t x ) { return ( x << 3 ) | ( x >> 2 ); }
+constexpr uint32_t Expand6( uint32_t x ) { return ( x << 2 ) | ( x >> 4 ); }
+
+PixelKernelLevel DetectPixelKernelLevel()
+{
+#ifdef RH_PIXEL_SIMD
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid( info, 0 );
+    const int max_leaf = info[0];
+    __cpuid( info, 1 );
+    const bool sse2    = ( info[3] & ( 1 << 26 ) ) != 0;
+    const bool osxsave = ( info[2] & ( 1 << 27 ) ) != 0;
+    const bool avx     = ( info[2] & ( 1 << 28 ) ) != 0;
+    // OS must save ymm registers as well
+    if ( max_leaf >= 7 && osxsave && avx && ( _xgetbv( 0 ) & 6 ) == 6 )
+    {
+        __cpuidex( info, 7, 0 );
+        if ( info[1] & ( 1 << 5 ) )
+            return PixelKernelLevel::AVX2;
+    }
+    return sse2 ? PixelKernelLevel::SSE2 : PixelKernelLevel::Scalar;
+#else
+    __builtin_cpu_init();
+    if ( __builtin_cpu_supports( "avx2" ) )
+        return PixelKernelLevel::AVX2;
+    if ( __builtin_cpu_supports( "sse2" ) )
+        return PixelKernelLevel::SSE2;
+    return PixelKernelLevel::Scalar;
+#endif
+#else
+    return PixelKernelLevel::Scalar;
+#endif
+}
+
+PixelKernelLevel &CurrentPixelKernelLevel()
+{
+    static PixelKernelLevel level = GetSupportedPixelKernelLevel();
+    return level;
+}
+
+/// Scalar kernels, also a reference for vector ones
+
+void LookupScalar( const uint8_t *indices, uint64_t count,
+                   const uint32_t *table, uint32_t *dst )
+{
+    for ( uint64_t i = 0; i < count; i++ )
+        dst[i] = table[indices[i]];
+}
+
+template <PackedPixelFormat Format> uint32_t ExpandPixel( uint32_t p )
+{
+    if constexpr ( Format == PackedPixelFormat::R5G6B5 )
+        return PackBGRA( Expand5( p >> 11 ), Expand6( ( p >> 5 ) & 0x3F ),
+                         Expand5( p & 0x1F ), 0xFF );
+    else if constexpr ( Format == PackedPixelFormat::A4R4G4B4 )
+        return PackBGRA( Expand4( ( p >> 8 ) & 0xF ),
+                         Expand4( ( p >> 4 ) & 0xF ), Expand4( p & 0xF ),
+                         Expand4( p >> 12 ) );
+    else
+    {
+        const uint32_t a = Format == PackedPixelFormat::X1R5G5B5 || ( p >> 15 )
+                               ? 0xFF
+                               : 0;
+        return PackBGRA( Expand5( ( p >> 10 ) & 0x1F ),
+                         Expand5( ( p >> 5 ) & 0x1F ), Expand5( p & 0x1F ),
+                         a );
+    }
+}
+
+template <PackedPixelFormat Format>
+void ExpandScalar( const uint16_t *src, uint64_t count, uint32_t *dst )
+{
+    for ( uint64_t i = 0; i < count; i++ )
+        dst[i] = ExpandPixel<Format>( src[i] );
+}
+
+bool HasTransparentScalar( const uint32_t *pixels, uint64_t count )
+{
+    for ( uint64_t i = 0; i < count; i++ )
+        if ( ( pixels[i] >> 24 ) != 0xFF )
+            return true;
+    return false;
+}
+
+#ifdef RH_PIXEL_SIMD
+/// SSE2 kernels, 16 bit pixels are expanded in 16 bit lanes and then
+/// interleaved into B8G8R8A8
+
+__m128i Expand4SSE2( __m128i x )
+{
+    return _mm_or_si128( _mm_slli_epi16( x, 4 ), x );
+}
+__m128i Expand5SSE2( __m128i x )
+{
+    return _mm_or_si128( _mm_slli_epi16( x, 3 ), _mm_srli_epi16( x, 2 ) );
+}
+__m128i Expand6SSE2( __m128i x )
+{
+    return _mm_or_si128( _mm_slli_epi16( x, 2 ), _mm_srli_epi16( x, 4 ) );
+}
+
+template <PackedPixelFormat Format>
+void ExpandSSE2( const uint16_t *src, uint64_t count, uint32_t *dst )
+{
+    const __m128i mask4 = _mm_set1_epi16( 0xF );
+    const __m128i mask5 = _mm_set1_epi16( 0x1F );
+    const __m128i mask6 = _mm_set1_epi16( 0x3F );
+    const __m128i mask8 = _mm_set1_epi16( 0xFF );
+
+    uint64_t i = 0;
+    for ( ; i + 8 <= count; i += 8 )
+    {
+        const __m128i p =
+            _mm_loadu_si128( reinterpret_cast<const __m128i *>( src + i ) );
+        __m128i r, g, b, a;
+        if constexpr ( Format == PackedPixelFormat::R5G6B5 )
+        {
+            r = Expand5SSE2( _mm_srli_epi16( p, 11 ) );
+            g = Expand6SSE2( _mm_and_si128( _mm_srli_epi16( p, 5 ), mask6 ) );
+            b = Expand5SSE2( _mm_and_si128( p, mask5 ) );
+            a = mask8;
+        }
+        else if constexpr ( Format == PackedPixelFormat::A4R4G4B4 )
+        {
+            r = Expand4SSE2( _mm_and_si128( _mm_srli_epi16( p, 8 ), mask4 ) );
+            g = Expand4SSE2( _mm_and_si128( _mm_srli_epi16( p, 4 ), mask4 ) );
+            b = Expand4SSE2( _mm_and_si128( p, mask4 ) );
+            a = Expand4SSE2( _mm_srli_epi16( p, 12 ) );
+        }
+        else
+        {
+            r = Expand5SSE2( _mm_and_si128( _mm_srli_epi16( p, 10 ), mask5 ) );
+            g = Expand5SSE2( _mm_and_si128( _mm_srli_epi16( p, 5 ), mask5 ) );
+            b = Expand5SSE2( _mm_and_si128( p, mask5 ) );
+            if constexpr ( Format == PackedPixelFormat::X1R5G5B5 )
+                a = mask8;
+            else
+                a = _mm_and_si128( _mm_srai_epi16( p, 15 ), mask8 );
+        }
+        const __m128i bg = _mm_or_si128( b, _mm_slli_epi16( g, 8 ) );
+        const __m128i ra = _mm_or_si128( r, _mm_slli_epi16( a, 8 ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i *>( dst + i ),
+                          _mm_unpacklo_epi16( bg, ra ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i *>( dst + i + 4 ),
+                          _mm_unpackhi_epi16( bg, ra ) );
+    }
+    ExpandScalar<Format>( src + i, count - i, dst + i );
+}
+
+bool HasTransparentSSE2( const uint32_t *pixels, uint64_t count )
+{
+    const __m128i alpha = _mm_set1_epi32( static_cast<int>( 0xFF000000 ) );
+    uint64_t      i     = 0;
+    for ( ; i + 16 <= count; i += 16 )
+    {
+        const auto *src = reinterpret_cast<const __m128i *>( pixels + i );
+        const __m128i acc = _mm_and_si128(
+            _mm_and_si128( _mm_loadu_si128( src ), _mm_loadu_si128( src + 1 ) ),
+            _mm_and_si128( _mm_loadu_si128( src + 2 ),
+                           _mm_loadu_si128( src + 3 ) ) );
+        const __m128i opaque =
+            _mm_cmpeq_epi32( _mm_and_si128( acc, alpha ), alpha );
+        if ( _mm_movemask_epi8( opaque ) != 0xFFFF )
+            return true;
+    }
+    return HasTransparentScalar( pixels + i, count - i );
+}
+
+/// AVX2 kernels, palette lookup is a gather of 8 pixels
+
+RH_TARGET_AVX2 void LookupAVX2( const uint8_t *indices, uint64_t count,
+                                const uint32_t *table, uint32_t *dst )
+{
+    const auto *base = reinterpret_cast<const int *>( table );
+    uint64_t    i    = 0;
+    for ( ; i + 16 <= count; i += 16 )
+    {
+        const __m128i idx = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>( indices + i ) );
+        const __m256i lo = _mm256_i32gather_epi32(
+            base, _mm256_cvtepu8_epi32( idx ), 4 );
+        const __m256i hi = _mm256_i32gather_epi32(
+            base, _mm256_cvtepu8_epi32( _mm_srli_si128( idx, 8 ) ), 4 );
+        _mm256_storeu_si256( reinterpret_cast<__m256i *>( dst + i ), lo );
+        _mm256_storeu_si256( reinterpret_cast<__m256i *>( dst + i + 8 ), hi );
+    }
+    LookupScalar( indices + i, count - i, table, dst + i );
+}
+
+RH_TARGET_AVX2 __m256i Expand4AVX2( __m256i x )
+{
+    return _mm256_or_si256( _mm256_slli_epi16( x, 4 ), x );
+}
+RH_TARGET_AVX2 __m256i Expand5AVX2( __m256i x )
+{
+    return _mm256_or_si256( _mm256_slli_epi16( x, 3 ),
+                            _mm256_srli_epi16( x, 2 ) );
+}
+RH_TARGET_AVX2 __m256i Expand6AVX2( __m256i x )
+{
+    return _mm256_or_si256( _mm256_slli_epi16( x, 2 ),
+                            _mm256_srli_epi16( x, 4 ) );
+}
+
+template <PackedPixelFormat Format>
+RH_TARGET_AVX2 void ExpandAVX2( const uint16_t *src, uint64_t count,
+                                uint32_t *dst )
+{
+    const __m256i mask4 = _mm256_set1_epi16( 0xF );
+    const __m256i mask5 = _mm256_set1_epi16( 0x1F );
+    const __m256i mask6 = _mm256_set1_epi16( 0x3F );
+    const __m256i mask8 = _mm256_set1_epi16( 0xFF );
+
+    uint64_t i = 0;
+    for ( ; i + 16 <= count; i += 16 )
+    {
+        const __m256i p = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>( src + i ) );
+        __m256i r, g, b, a;
+        if constexpr ( Format == PackedPixelFormat::R5G6B5 )
+        {
+            r = Expand5AVX2( _mm256_srli_epi16( p, 11 ) );
+            g = Expand6AVX2(
+                _mm256_and_si256( _mm256_srli_epi16( p, 5 ), mask6 ) );
+            b = Expand5AVX2( _mm256_and_si256( p, mask5 ) );
+            a = mask8;
+        }
+        else if constexpr ( Format == PackedPixelFormat::A4R4G4B4 )
+        {
+            r = Expand4AVX2(
+                _mm256_and_si256( _mm256_srli_epi16( p, 8 ), mask4 ) );
+            g = Expand4AVX2(
+                _mm256_and_si256( _mm256_srli_epi16( p, 4 ), mask4 ) );
+            b = Expand4AVX2( _mm256_and_si256( p, mask4 ) );
+            a = Expand4AVX2( _mm256_srli_epi16( p, 12 ) );
+        }
+        else
+        {
+            r = Expand5AVX2(
+                _mm256_and_si256( _mm256_srli_epi16( p, 10 ), mask5 ) );
+            g = Expand5AVX2(
+                _mm256_and_si256( _mm256_srli_epi16( p, 5 ), mask5 ) );
+            b = Expand5AVX2( _mm256_and_si256( p, mask5 ) );
+            if constexpr ( Format == PackedPixelFormat::X1R5G5B5 )
+                a = mask8;
+            else
+                a = _mm256_and_si256( _mm256_srai_epi16( p, 15 ), mask8 );
+        }
+        const __m256i bg = _mm256_or_si256( b, _mm256_slli_epi16( g, 8 ) );
+        const __m256i ra = _mm256_or_si256( r, _mm256_slli_epi16( a, 8 ) );
+        // unpack works inside 128 bit lanes, lanes are put back in order
+        const __m256i lo = _mm256_unpacklo_epi16( bg, ra );
+        const __m256i hi = _mm256_unpackhi_epi16( bg, ra );
+        _mm256_storeu_si256( reinterpret_cast<__m256i *>( dst + i ),
+                             _mm256_permute2x128_si256( lo, hi, 0x20 ) );
+        _mm256_storeu_si256( reinterpret_cast<__m256i *>( dst + i + 8 ),
+                             _mm256_permute2x128_si256( lo, hi, 0x31 ) );
+    }
+    ExpandScalar<Format>( src + i, count - i, dst + i );
+}
+
+RH_TARGET_AVX2 bool HasTransparentAVX2( const uint32_t *pixels,
+                                        uint64_t        count )
+{
+    const __m256i alpha =
+        _mm256_set1_epi32( static_cast<int>( 0xFF000000 ) );
+    uint64_t i = 0;
+    for ( ; i + 32 <= count; i += 32 )
+    {
+        const auto *src = reinterpret_cast<const __m256i *>( pixels + i );
+        const __m256i acc = _mm256_and_si256(
+            _mm256_and_si256( _mm256_loadu_si256( src ),
+                              _mm256_loadu_si256( src + 1 ) ),
+            _mm256_and_si256( _mm256_loadu_si256( src + 2 ),
+                              _mm256_loadu_si256( src + 3 ) ) );
+        const __m256i opaque =
+            _mm256_cmpeq_epi32( _mm256_and_si256( acc, alpha ), alpha );
+        if ( static_cast<uint32_t>( _mm256_movemask_epi8( opaque ) ) !=
+             0xFFFFFFFFu )
+            return true;
+    }
+    return HasTransparentScalar( pixels + i, count - i );
+}
+#endif
+
+template <PackedPixelFormat Format>
+void ExpandPacked( const uint16_t *src, uint64_t count, uint32_t *dst )
+{
+#ifdef RH_PIXEL_SIMD
+    switch ( CurrentPixelKernelLevel() )
+    {
+    case PixelKernelLevel::AVX2:
+        ExpandAVX2<Format>( src, count, dst );
+        return;
+    case PixelKernelLevel::SSE2:
+        ExpandSSE2<Format>( src, count, dst );
+        return;
+    default: break;
+    }
+#endif
+    ExpandScalar<Format>( src, count, dst );
+}
+} // namespace
+
+PixelKernelLevel GetSupportedPixelKernelLevel()
+{
+    static const PixelKernelLevel level = DetectPixelKernelLevel();
+    return level;
+}
+
+PixelKernelLevel GetPixelKernelLevel() { return CurrentPixelKernelLevel(); }
+
+PixelKernelLevel SetPixelKernelLevel( PixelKernelLevel level )
+{
+    CurrentPixelKernelLevel() =
+        ( std::min )( level, GetSupportedPixelKernelLevel() );
+    return CurrentPixelKernelLevel();
+}
+
+void ExpandPalette( const uint8_t *indices, uint64_t count,
+                    const uint8_t *palette, uint32_t palette_size, bool opaque,
+                    uint32_t *dst )
+{
+    // palette is swizzled once, so every kernel is a plain table lookup
+    uint32_t   table[gPaletteTableSize]{};
+    const auto entry_count = ( std::min )( palette_size, gPaletteTableSize );
+    for ( uint32_t i = 0; i < entry_count; i++ )
+    {
+        const uint8_t *entry = palette + i * 4;
+        table[i] = PackBGRA( entry[0], entry[1], entry[2],
+                             opaque ? 0xFF : entry[3] );
+    }
+
+#ifdef RH_PIXEL_SIMD
+    // SSE2 has no gather, a scalar lookup is as fast as shuffling there
+    if ( CurrentPixelKernelLevel() == PixelKernelLevel::AVX2 )
+    {
+        LookupAVX2( indices, count, table, dst );
+        return;
+    }
+#endif
+    LookupScalar( indices, count, table, dst );
+}
+
+void ExpandPackedPixels( PackedPixelFormat format, const uint16_t *src,
+                         uint64_t count, uint32_t *dst )
+{
+    switch ( format )
+    {
+    case PackedPixelFormat::A1R5G5B5:
+        ExpandPacked<PackedPixelFormat::A1R5G5B5>( src, count, dst );
+        break;
+    case PackedPixelFormat::X1R5G5B5:
+        ExpandPacked<PackedPixelFormat::X1R5G5B5>( src, count, dst );
+        break;
+    case PackedPixelFormat::R5G6B5:
+        ExpandPacked<PackedPixelFormat::R5G6B5>( src, count, dst );
+        break;
+    case PackedPixelFormat::A4R4G4B4:
+        ExpandPacked<PackedPixelFormat::A4R4G4B4>( src, count, dst );
+        break;
+    }
+}
+
+bool HasTransparentPixels( const uint32_t *pixels, uint64_t count )
+{
+#ifdef RH_PIXEL_SIMD
+    switch ( CurrentPixelKernelLevel() )
+    {
+    case PixelKernelLevel::AVX2: return HasTransparentAVX2( pixels, count );
+    case PixelKernelLevel::SSE2: return HasTransparentSSE2( pixels, count );
+    default: break;
+    }
+#endif
+    return HasTransparentScalar( pixels, count );
+}
+
+} // namespace rh::rw::engine
@@ -0,0 +1,54 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include <cstdint>
+
+namespace rh::rw::engine
+{
+/// Instruction set used by pixel conversion kernels
+enum class PixelKernelLevel : uint32_t
+{
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+/// 16 bit packed formats that can be expanded into B8G8R8A8
+enum class PackedPixelFormat : uint32_t
+{
+    A1R5G5B5,
+    X1R5G5B5,
+    R5G6B5,
+    A4R4G4B4
+};
+
+/// Best kernel level supported by CPU, detected once
+PixelKernelLevel GetSupportedPixelKernelLevel();
+PixelKernelLevel GetPixelKernelLevel();
+/**
+ * Selects kernels used by conversions below, tests and benchmarks use it to
+ * compare kernels against scalar ones. Not thread safe.
+ * @return level actually used, clamped to the supported one
+ */
+PixelKernelLevel SetPixelKernelLevel( PixelKernelLevel level );
+
+/**
+ * Expands 8 bit palette indices into B8G8R8A8 pixels.
+ * @param palette - palette_size R8G8B8A8 entries as stored in RW palettes,
+ * indices past the palette are expanded into transparent black
+ * @param opaque - alpha of expanded pixels is set to 0xFF
+ */
+void ExpandPalette( const uint8_t *indices, uint64_t count,
+                    const uint8_t *palette, uint32_t palette_size, bool opaque,
+                    uint32_t *dst );
+
+/// Expands 16 bit packed pixels into B8G8R8A8 pixels
+void ExpandPackedPixels( PackedPixelFormat format, const uint16_t *src,
+                         uint64_t count, uint32_t *dst );
+
+/// @return true if any of 32 bit pixels has alpha below 0xFF, alpha is the
+/// highest byte in both R8G8B8A8 and B8G8R8A8 layouts
+bool HasTransparentPixels( const uint32_t *pixels, uint64_t count );
+
+} // namespace rh::rw::engine
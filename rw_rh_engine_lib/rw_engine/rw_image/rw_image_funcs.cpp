@@ -1,4 +1,5 @@
 #include "rw_image_funcs.h"
+#include "pixel_convert.h"
 #include <common_headers.h>
 
 uint32_t rh::rw::engine::InternalImageFindFormat( RwImage *image )
@@ -22,29 +23,9 @@ uint32_t rh::rw::engine::InternalImageFindFormat( RwImage *image )
          */
 
         /* First: check palette for transparent colors */
-        paletteHasAlpha = FALSE;
-        if ( 4 == depth )
-        {
-            for ( y = 0; y < 16; y++ )
-            {
-                if ( 0xFF != rpPal[y].alpha )
-                {
-                    paletteHasAlpha = TRUE;
-                    break;
-                }
-            }
-        }
-        else
-        {
-            for ( y = 0; y < 256; y++ )
-            {
-                if ( 0xFF != rpPal[y].alpha )
-                {
-                    paletteHasAlpha = TRUE;
-                    break;
-                }
-            }
-        }
+        paletteHasAlpha =
+            HasTransparentPixels( reinterpret_cast<const uint32_t *>( rpPal ),
+                                  4 == depth ? 16 : 256 );
 
         if ( paletteHasAlpha )
         {
@@ -85,45 +66,19 @@ uint32_t rh::rw::engine::InternalImageFindFormat( RwImage *image )
         const int32_t  height = image->height;
         const uint8_t *cpIn   = image->cpPixels;
         int32_t        y;
-        uint32_t       alphaBits = 0;
+        bool           hasAlpha = false;
 
-        for ( y = 0; y < height; y++ )
+        /* lower 4 bits of the alpha channel are discarded in 4444, but any
+         * alpha below 0xFF ends up in 8888 anyway */
+        for ( y = 0; y < height && !hasAlpha; y++ )
         {
-            const auto *rpInCur = reinterpret_cast<const RwRGBA *>( cpIn );
-            int32_t     x;
-
-            for ( x = 0; x < width; x++ )
-            {
-                if ( rpInCur->alpha < 0xff )
-                {
-                    /* lower 4 bits of the alpha channel are discarded in 4444
-                     */
-                    if ( rpInCur->alpha > 0xf )
-                    {
-                        alphaBits = 8;
-                        break;
-                    }
-                    alphaBits = 1;
-                }
-
-                /* Next pixel */
-                rpInCur++;
-            }
-
-            if ( alphaBits >= 8 )
-            {
-                break;
-            }
-
+            hasAlpha = HasTransparentPixels(
+                reinterpret_cast<const uint32_t *>( cpIn ),
+                static_cast<uint64_t>( width ) );
             cpIn += image->stride;
         }
 
-        if ( alphaBits >= 8 )
-            format = rwRASTERFORMAT8888;
-        else if ( alphaBits )
-            format = rwRASTERFORMAT8888;
-        else
-            format = rwRASTERFORMAT888;
+        format = hasAlpha ? rwRASTERFORMAT8888 : rwRASTERFORMAT888;
     }
 
     return format;
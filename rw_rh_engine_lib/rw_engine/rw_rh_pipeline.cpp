@@ -5,8 +5,12 @@
 #include <Engine/Common/types/primitive_type.h>
 #include <algorithm>
 #include <common_headers.h>
+#include <render_client/render_client.h>
+#include <render_driver/gpu_resources/content_hash.h>
 #include <rw_engine/rh_backend/mesh_rendering_backend.h>
 #include <rw_engine/rh_backend/raster_backend.h>
+#include <rw_engine/rw_asset_pack/asset_pack.h>
+#include <rw_engine/rw_geometry_cache/geometry_cache.h>
 
 namespace rh::rw::engine
 {
@@ -129,27 +133,11 @@ void GenerateNormals( VertexDescPosColorUVNormals *verticles,
     }
 }
 
-RwResEntry *InstanceAtomicGeometry( RpGeometryInterface *geom_io, void *owner,
-                                    RwResEntry **       resEntryPointer,
-                                    const RpMeshHeader *meshHeader )
+void InstanceGeometry( RpGeometryInterface *geom_io,
+                       const RpMeshHeader *meshHeader,
+                       InstancedGeometry &  result )
 {
     using namespace rh::engine;
-    ResEnty *resEntry;
-
-    resEntry = reinterpret_cast<ResEnty *>(
-        gRwDeviceGlobals.ResourceFuncs.AllocateResourceEntry(
-            owner, resEntryPointer, sizeof( ResEnty ) - sizeof( RwResEntry ),
-            []( RwResEntry *resEntry ) noexcept
-            {
-                auto *entry = reinterpret_cast<ResEnty *>( resEntry );
-                if ( entry != nullptr )
-                    DestroyBackendMesh( entry->meshData );
-            } ) );
-
-    *resEntryPointer = resEntry;
-    if ( resEntry == nullptr )
-        return nullptr;
-
     PrimitiveType primType = PrimitiveType::TriangleStrip;
 
     bool convert_to_list = false;
@@ -162,13 +150,14 @@ RwResEntry *InstanceAtomicGeometry( RpGeometryInterface *geom_io, void *owner,
         primType = PrimitiveType::TriangleList;
 
     const auto *mesh_start = reinterpret_cast<const RpMesh *>( meshHeader + 1 );
-    auto *      indexBuffer = new uint16_t[meshHeader->totalIndicesInMesh * 3];
-    uint32_t    startIndex  = 0;
-    uint32_t    indexCount;
+    auto &      indexBuffer = result.Indices;
+    indexBuffer.resize( meshHeader->totalIndicesInMesh * 3 );
+    uint32_t startIndex = 0;
+    uint32_t indexCount;
 
     // Index data
-    std::vector<GeometrySplit>    geometry_splits;
-    std::vector<GeometryMaterial> geometry_mats;
+    auto &geometry_splits = result.Splits;
+    auto &geometry_mats   = result.Materials;
     geometry_splits.reserve( meshHeader->numMeshes );
     geometry_mats.reserve( meshHeader->numMeshes );
     auto meshes = std::span( mesh_start, meshHeader->numMeshes );
@@ -220,21 +209,22 @@ RwResEntry *InstanceAtomicGeometry( RpGeometryInterface *geom_io, void *owner,
 
         if ( primType == PrimitiveType::TriangleList )
         {
-            std::sort(
-                reinterpret_cast<RxTriangle *>( indexBuffer + startIndex ),
-                reinterpret_cast<RxTriangle *>( indexBuffer + startIndex +
-                                                indexCount ),
-                SortTriangles );
+            std::sort( reinterpret_cast<RxTriangle *>( indexBuffer.data() +
+                                                       startIndex ),
+                       reinterpret_cast<RxTriangle *>(
+                           indexBuffer.data() + startIndex + indexCount ),
+                       SortTriangles );
         }
         meshData.mIndexCount = indexCount;
         startIndex += indexCount;
 
         geometry_splits.push_back( meshData );
     }
+    indexBuffer.resize( startIndex );
 
     // Vertex data
-    auto *vertexData = new VertexDescPosColorUVNormals[static_cast<size_t>(
-        geom_io->GetVertexCount() )];
+    auto &vertexData = result.Vertices;
+    vertexData.resize( static_cast<size_t>( geom_io->GetVertexCount() ) );
 
     auto   morph_target = geom_io->GetMorphTarget( 0 );
     RwV3d *vertexPos    = morph_target->verts;
@@ -293,7 +283,7 @@ RwResEntry *InstanceAtomicGeometry( RpGeometryInterface *geom_io, void *owner,
         v_id++;
     }
     if ( morph_target->normals == nullptr )
-        GenerateNormals( vertexData,
+        GenerateNormals( vertexData.data(),
                          static_cast<uint32_t>( geom_io->GetVertexCount() ),
                          geom_io->GetTrianglePtr(),
                          static_cast<uint32_t>( geom_io->GetTriangleCount() ),
@@ -311,18 +301,97 @@ RwResEntry *InstanceAtomicGeometry( RpGeometryInterface *geom_io, void *owner,
         }
         j++;
     }
+}
+
+uint64_t GeometrySourceKey( RpGeometryInterface *geom_io,
+                            const RpMeshHeader * meshHeader )
+{
+    const auto vertex_count =
+        static_cast<uint64_t>( geom_io->GetVertexCount() );
+    auto *morph_target = geom_io->GetMorphTarget( 0 );
+
+    const uint64_t header[] = { gGeometryInstancingVersion, meshHeader->flags,
+                                meshHeader->numMeshes, vertex_count,
+                                morph_target->normals != nullptr };
+    uint64_t       key      = HashContent( header, sizeof( header ) );
+    auto hash = [&key]( const void *data, uint64_t size )
+    { key = HashContent( data, size, key ); };
+
+    hash( morph_target->verts, vertex_count * sizeof( RwV3d ) );
+    // triangles are only used to generate missing normals
+    if ( morph_target->normals != nullptr )
+        hash( morph_target->normals, vertex_count * sizeof( RwV3d ) );
+    else
+        hash( geom_io->GetTrianglePtr(),
+              static_cast<uint64_t>( geom_io->GetTriangleCount() ) *
+                  sizeof( RpTriangle ) );
+    const auto *uv = geom_io->GetTexCoordSetPtr( 0 );
+    hash( uv, uv != nullptr ? vertex_count * sizeof( RwTexCoords ) : 0 );
+    const auto *colors = geom_io->GetVertexColorPtr();
+    hash( colors, colors != nullptr ? vertex_count * sizeof( RwRGBA ) : 0 );
+
+    const auto *mesh_start = reinterpret_cast<const RpMesh *>( meshHeader + 1 );
+    for ( const auto &mesh : std::span( mesh_start, meshHeader->numMeshes ) )
+    {
+        hash( mesh.indices, mesh.numIndices * sizeof( uint16_t ) );
+        struct
+        {
+            RwRGBA Color;
+            float  Specular;
+            float  Emission;
+        } material{ mesh.material->color,
+                    mesh.material->surfaceProps.specular,
+                    BackendMaterialPlugin::GetData( mesh.material ).Emission };
+        hash( &material, sizeof( material ) );
+    }
+    return key;
+}
+
+RwResEntry *InstanceAtomicGeometry( RpGeometryInterface *geom_io, void *owner,
+                                    RwResEntry **       resEntryPointer,
+                                    const RpMeshHeader *meshHeader )
+{
+    ResEnty *resEntry;
 
+    resEntry = reinterpret_cast<ResEnty *>(
+        gRwDeviceGlobals.ResourceFuncs.AllocateResourceEntry(
+            owner, resEntryPointer, sizeof( ResEnty ) - sizeof( RwResEntry ),
+            []( RwResEntry *resEntry ) noexcept
+            {
+                auto *entry = reinterpret_cast<ResEnty *>( resEntry );
+                if ( entry != nullptr )
+                    DestroyBackendMesh( entry->meshData );
+            } ) );
+
+    *resEntryPointer = resEntry;
+    if ( resEntry == nullptr )
+        return nullptr;
+
+    // cooked and cached meshes are sent straight from file mappings
     BackendMeshInitData backendMeshInitData{};
-    backendMeshInitData.mIndexCount = startIndex;
-    backendMeshInitData.mVertexCount =
-        static_cast<size_t>( geom_io->GetVertexCount() );
-    backendMeshInitData.mIndexData  = indexBuffer;
-    backendMeshInitData.mVertexData = vertexData;
-    backendMeshInitData.mSplits     = geometry_splits;
-    backendMeshInitData.mMaterials  = geometry_mats;
-    resEntry->meshData              = CreateBackendMesh( backendMeshInitData );
-    delete[] vertexData;
-    delete[] indexBuffer;
+    const auto *pack  = gRenderClient ? gRenderClient->GetAssetPack() : nullptr;
+    auto       *cache = gRenderClient ? gRenderClient->GetGeometryCache()
+                                      : nullptr;
+    const auto  key   = ( pack || cache )
+                            ? GeometrySourceKey( geom_io, meshHeader )
+                            : 0;
+
+    InstancedGeometry geometry{};
+    CachedGeometry    cached{};
+    if ( pack == nullptr || !pack->FindMesh( key, backendMeshInitData ) )
+    {
+        if ( cache && cache->Find( key, CachedGeometryKind::Static, cached ) )
+            backendMeshInitData = cached.GetInitData();
+        else
+        {
+            InstanceGeometry( geom_io, meshHeader, geometry );
+            backendMeshInitData = geometry.GetInitData();
+        }
+    }
+    resEntry->meshData = CreateBackendMesh( backendMeshInitData );
+    // mesh creation copies geometry, so it's handed over to cache writer
+    if ( cache && !geometry.Vertices.empty() )
+        cache->Store( key, CachedGeometryKind::Static, std::move( geometry ) );
 
     resEntry->batchId = meshHeader->serialNum;
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "i_rp_geometry.h"
+#include <rw_engine/rh_backend/mesh_rendering_backend.h>
 #include <cstdint>
 #include <functional>
 #include <span>
@@ -34,6 +35,46 @@ enum RenderStatus
     Instanced
 };
 
+/// Bump when InstanceGeometry output changes, so cooked meshes made by
+/// older versions are not used
+constexpr uint64_t gGeometryInstancingVersion = 1;
+
+/// Render ready geometry, vertices and indices are sent to render driver as
+/// is
+struct InstancedGeometry
+{
+    std::vector<VertexDescPosColorUVNormals> Vertices;
+    std::vector<uint16_t>                    Indices;
+    std::vector<GeometrySplit>               Splits;
+    std::vector<GeometryMaterial>            Materials;
+
+    [[nodiscard]] BackendMeshInitData GetInitData() const
+    {
+        return { .mIndexCount  = Indices.size(),
+                 .mVertexCount = Vertices.size(),
+                 .mIndexData   = Indices.data(),
+                 .mVertexData  = Vertices.data(),
+                 .mSplits      = Splits,
+                 .mMaterials   = Materials };
+    }
+};
+
+/**
+ * Converts RW geometry into render ready geometry: tri-strips become
+ * sorted triangle lists, missing normals are generated and material ids and
+ * emission are stored in vertices
+ */
+void InstanceGeometry( RpGeometryInterface *geom_io,
+                       const RpMeshHeader *meshHeader,
+                       InstancedGeometry &  result );
+
+/**
+ * Hash of everything InstanceGeometry output depends on, cooked meshes are
+ * looked up by it
+ */
+uint64_t GeometrySourceKey( RpGeometryInterface *geom_io,
+                            const RpMeshHeader * meshHeader );
+
 RenderStatus InstanceAtomic( RpAtomic *atomic, RpGeometryInterface *geom_io );
 
 void MeshGetNumVerticesMinIndex( const uint16_t *indices, uint32_t size,
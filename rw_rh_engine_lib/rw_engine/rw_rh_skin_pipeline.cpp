@@ -7,10 +7,14 @@
 #include <DirectXMathConvert.inl>
 #include <DirectXMathMatrix.inl>
 #include <Engine/Common/types/primitive_type.h>
+#include <algorithm>
+#include <render_client/render_client.h>
+#include <render_driver/gpu_resources/content_hash.h>
 #include <rw_engine/rh_backend/mesh_rendering_backend.h>
 #include <rw_engine/rh_backend/raster_backend.h>
 #include <rw_engine/rh_backend/skinned_mesh_backend.h>
 #include <rw_engine/rw_frame/rw_frame.h>
+#include <rw_engine/rw_geometry_cache/geometry_cache.h>
 #include <rw_engine/rw_macro_constexpr.h>
 #include <rw_engine/system_funcs/rw_device_system_globals.h>
 
@@ -72,28 +76,10 @@ void GenerateSkinNormals( VertexDescPosColorUVNormals *verticles,
     }
 }
 
-RwResEntry *RHInstanceSkinAtomicGeometry( RpGeometryInterface *geom_io,
-                                          void *               owner,
-                                          RwResEntry **        resEntryPointer,
-                                          const RpMeshHeader * meshHeader,
-                                          RpHAnimHierarchy *   pHierarchy,
-                                          RwFrame *            pFrame )
+void InstanceSkinGeometry( RpGeometryInterface *geom_io,
+                           const RpMeshHeader * meshHeader,
+                           InstancedGeometry &  result )
 {
-    ResEnty *resEntry;
-
-    resEntry = reinterpret_cast<ResEnty *>(
-        gRwDeviceGlobals.ResourceFuncs.AllocateResourceEntry(
-            owner, resEntryPointer, sizeof( ResEnty ) - sizeof( RwResEntry ),
-            []( RwResEntry *resEntry ) noexcept {
-                auto *entry = reinterpret_cast<ResEnty *>( resEntry );
-                if ( entry != nullptr )
-                    DestroySkinMesh( entry->meshData );
-            } ) );
-
-    *resEntryPointer = resEntry;
-    if ( resEntry == nullptr )
-        return nullptr;
-
     rh::engine::PrimitiveType primType =
         rh::engine::PrimitiveType::TriangleStrip;
 
@@ -107,13 +93,14 @@ RwResEntry *RHInstanceSkinAtomicGeometry( RpGeometryInterface *geom_io,
         primType = rh::engine::PrimitiveType::TriangleList;
 
     const auto *mesh_start = reinterpret_cast<const RpMesh *>( meshHeader + 1 );
-    auto *      indexBuffer = new uint16_t[meshHeader->totalIndicesInMesh * 3];
-    uint32_t    startIndex  = 0;
-    uint32_t    indexCount  = 0;
+    auto &      indexBuffer = result.Indices;
+    indexBuffer.resize( meshHeader->totalIndicesInMesh * 3 );
+    uint32_t startIndex = 0;
+    uint32_t indexCount = 0;
 
     // Index data
-    std::vector<GeometrySplit>    geometry_splits;
-    std::vector<GeometryMaterial> geometry_mats;
+    auto &geometry_splits = result.Splits;
+    geometry_splits.reserve( meshHeader->numMeshes );
     for ( const RpMesh *mesh = mesh_start;
           mesh != mesh_start + meshHeader->numMeshes; mesh++ )
     {
@@ -156,8 +143,10 @@ RwResEntry *RHInstanceSkinAtomicGeometry( RpGeometryInterface *geom_io,
         if ( primType == rh::engine::PrimitiveType::TriangleList )
         {
             /*std::sort(
-                reinterpret_cast<RxTriangle *>( indexBuffer + startIndex ),
-                reinterpret_cast<RxTriangle *>( indexBuffer + startIndex +
+                reinterpret_cast<RxTriangle *>( indexBuffer.data() +
+                                                startIndex ),
+                reinterpret_cast<RxTriangle *>( indexBuffer.data() +
+                                                startIndex +
                                                 indexCount ),
                 SortTriangles );*/
         }
@@ -171,8 +160,8 @@ RwResEntry *RHInstanceSkinAtomicGeometry( RpGeometryInterface *geom_io,
         static_cast<const RpGeometry *>( geom_io->GetThis() ) );
 
     // Vertex data
-    auto *vertexData = new VertexDescPosColorUVNormals[static_cast<size_t>(
-        geom_io->GetVertexCount() )];
+    auto &vertexData = result.Vertices;
+    vertexData.resize( static_cast<size_t>( geom_io->GetVertexCount() ) );
 
     auto                   morph_target   = geom_io->GetMorphTarget( 0 );
     RwV3d *                vertexPos      = morph_target->verts;
@@ -258,7 +247,7 @@ RwResEntry *RHInstanceSkinAtomicGeometry( RpGeometryInterface *geom_io,
         vertexData[v_id] = desc;
         v_id++;
     }
-    GenerateSkinNormals( vertexData,
+    GenerateSkinNormals( vertexData.data(),
                          static_cast<uint32_t>( geom_io->GetVertexCount() ),
                          geom_io->GetTrianglePtr(),
                          static_cast<uint32_t>( geom_io->GetTriangleCount() ),
@@ -274,18 +263,88 @@ RwResEntry *RHInstanceSkinAtomicGeometry( RpGeometryInterface *geom_io,
         }
         j++;
     }
+    indexBuffer.resize( startIndex );
+}
+
+uint64_t SkinGeometrySourceKey( RpGeometryInterface *geom_io,
+                                const RpMeshHeader * meshHeader )
+{
+    const uint64_t header[] = { gSkinGeometryInstancingVersion,
+                                GeometrySourceKey( geom_io, meshHeader ) };
+    uint64_t       key      = HashContent( header, sizeof( header ) );
+    // skinned normals are always generated from triangles
+    key = HashContent( geom_io->GetTrianglePtr(),
+                       static_cast<uint64_t>( geom_io->GetTriangleCount() ) *
+                           sizeof( RpTriangle ),
+                       key );
+
+    auto &skin_funcs = gRwDeviceGlobals.SkinFuncs;
+    auto *skin       = skin_funcs.GeometryGetSkin(
+        static_cast<const RpGeometry *>( geom_io->GetThis() ) );
+    const auto vertex_count =
+        static_cast<uint64_t>( geom_io->GetVertexCount() );
+    const auto *weights  = skin_funcs.GetVertexBoneWeights( skin );
+    const auto *bone_ids = skin_funcs.GetVertexBoneIndices( skin );
+    key = HashContent( weights,
+                       weights ? vertex_count * sizeof( RwMatrixWeights ) : 0,
+                       key );
+    key = HashContent( bone_ids,
+                       bone_ids ? vertex_count * sizeof( uint32_t ) : 0, key );
+    return key;
+}
+
+RwResEntry *RHInstanceSkinAtomicGeometry( RpGeometryInterface *geom_io,
+                                          void *               owner,
+                                          RwResEntry **        resEntryPointer,
+                                          const RpMeshHeader * meshHeader,
+                                          RpHAnimHierarchy *   pHierarchy,
+                                          RwFrame *            pFrame )
+{
+    ResEnty *resEntry;
+
+    resEntry = reinterpret_cast<ResEnty *>(
+        gRwDeviceGlobals.ResourceFuncs.AllocateResourceEntry(
+            owner, resEntryPointer, sizeof( ResEnty ) - sizeof( RwResEntry ),
+            []( RwResEntry *resEntry ) noexcept {
+                auto *entry = reinterpret_cast<ResEnty *>( resEntry );
+                if ( entry != nullptr )
+                    DestroySkinMesh( entry->meshData );
+            } ) );
+
+    *resEntryPointer = resEntry;
+    if ( resEntry == nullptr )
+        return nullptr;
+
+    // cached meshes are sent straight from file mapping
+    auto      *cache =
+        gRenderClient ? gRenderClient->GetGeometryCache() : nullptr;
+    const auto key = cache ? SkinGeometrySourceKey( geom_io, meshHeader ) : 0;
 
     SkinnedMeshInitData backendMeshInitData{};
-    backendMeshInitData.mIndexCount = startIndex;
-    backendMeshInitData.mVertexCount =
-        static_cast<size_t>( geom_io->GetVertexCount() );
-    backendMeshInitData.mIndexData =
-        reinterpret_cast<uint16_t *>( indexBuffer );
-    backendMeshInitData.mVertexData = vertexData;
-    backendMeshInitData.mSplits     = geometry_splits;
-    resEntry->meshData              = CreateSkinMesh( backendMeshInitData );
-    delete[] vertexData;
-    delete[] indexBuffer;
+    InstancedGeometry   geometry{};
+    CachedGeometry      cached{};
+    if ( cache && cache->Find( key, CachedGeometryKind::Skinned, cached ) )
+    {
+        backendMeshInitData.mIndexCount  = cached.Indices.size();
+        backendMeshInitData.mVertexCount = cached.Vertices.size();
+        backendMeshInitData.mIndexData   = cached.Indices.data();
+        backendMeshInitData.mVertexData  = cached.Vertices.data();
+        backendMeshInitData.mSplits.assign( cached.Splits.begin(),
+                                            cached.Splits.end() );
+    }
+    else
+    {
+        InstanceSkinGeometry( geom_io, meshHeader, geometry );
+        backendMeshInitData.mIndexCount  = geometry.Indices.size();
+        backendMeshInitData.mVertexCount = geometry.Vertices.size();
+        backendMeshInitData.mIndexData   = geometry.Indices.data();
+        backendMeshInitData.mVertexData  = geometry.Vertices.data();
+        backendMeshInitData.mSplits      = geometry.Splits;
+    }
+    resEntry->meshData = CreateSkinMesh( backendMeshInitData );
+    // mesh creation copies geometry, so it's handed over to cache writer
+    if ( cache && !geometry.Vertices.empty() )
+        cache->Store( key, CachedGeometryKind::Skinned, std::move( geometry ) );
 
     resEntry->batchId = meshHeader->serialNum;
 
@@ -299,8 +358,21 @@ DirectX::XMFLOAT4X3 RwMatrixToDxMatrix( const RwMatrix *mtx )
              mtx->at.z,    mtx->pos.x,   mtx->pos.y,   mtx->pos.z };
 }
 
-void PrepareBoneMatrices( DirectX::XMFLOAT4X3 *matrix_cache, RpAtomic *atomic,
-                          IAnimHierarcy &anim_hier )
+uint32_t GetBoneMatrixCount( RpAtomic *atomic, IAnimHierarcy &anim_hier )
+{
+    auto &skin_fptr_tbl = gRwDeviceGlobals.SkinFuncs;
+
+    auto _anim_hier = skin_fptr_tbl.AtomicGetHAnimHierarchy( atomic );
+    auto skin       = skin_fptr_tbl.GeometryGetSkin( atomic->geometry );
+
+    if ( !_anim_hier || !skin )
+        return 0;
+    anim_hier.Init( _anim_hier );
+    return anim_hier.GetNumNodes();
+}
+
+void PrepareBoneMatrices( std::span<DirectX::XMFLOAT4X3> matrix_cache,
+                          RpAtomic *atomic, IAnimHierarcy &anim_hier )
 {
     auto &skin_fptr_tbl = gRwDeviceGlobals.SkinFuncs;
 
@@ -310,6 +382,9 @@ void PrepareBoneMatrices( DirectX::XMFLOAT4X3 *matrix_cache, RpAtomic *atomic,
     if ( !_anim_hier || !skin )
         return;
     anim_hier.Init( _anim_hier );
+    // palette may be clamped to max bone count
+    const auto node_count = ( std::min )(
+        static_cast<size_t>( anim_hier.GetNumNodes() ), matrix_cache.size() );
     auto *skinToBoneMatrices = skin_fptr_tbl.GetSkinToBoneMatrices( skin );
 
     auto frame = static_cast<RwFrame *>( rwObject::GetParent( atomic ) );
@@ -322,7 +397,7 @@ void PrepareBoneMatrices( DirectX::XMFLOAT4X3 *matrix_cache, RpAtomic *atomic,
 
     if ( anim_hier.GetFlags() & 2 ) // rpHANIMHIERARCHYNOMATRICES
     {
-        for ( int i = 0; i < anim_hier.GetNumNodes(); i++ )
+        for ( size_t i = 0; i < node_count; i++ )
         {
             DirectX::XMFLOAT4X3 skin_to_bone_mtx_d3d =
                 RwMatrixToDxMatrix( &skinToBoneMatrices[i] );
@@ -344,7 +419,7 @@ void PrepareBoneMatrices( DirectX::XMFLOAT4X3 *matrix_cache, RpAtomic *atomic,
         if ( anim_hier.GetFlags() &
              0x4000 ) // rpHANIMHIERARCHYLOCALSPACEMATRICES
         {
-            for ( int i = 0; i < anim_hier.GetNumNodes(); i++ )
+            for ( size_t i = 0; i < node_count; i++ )
             {
 
                 DirectX::XMFLOAT4X3 skin_to_bone_mtx_d3d =
@@ -364,7 +439,7 @@ void PrepareBoneMatrices( DirectX::XMFLOAT4X3 *matrix_cache, RpAtomic *atomic,
         }
         else
         {
-            for ( int i = 0; i < anim_hier.GetNumNodes(); i++ )
+            for ( size_t i = 0; i < node_count; i++ )
             {
                 DirectX::XMFLOAT4X3 skin_to_bone_mtx_d3d =
                     RwMatrixToDxMatrix( &skinToBoneMatrices[i] );
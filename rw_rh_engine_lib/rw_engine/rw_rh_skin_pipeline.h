@@ -6,13 +6,35 @@
 #include <common_headers.h>
 #include <cstdint>
 #include <functional>
+#include <span>
 #include <vector>
 
 namespace rh::rw::engine
 {
 class IAnimHierarcy;
-void PrepareBoneMatrices( DirectX::XMFLOAT4X3 *matrix_cache, RpAtomic *atomic,
-                          IAnimHierarcy &anim_hier );
+
+/// Bump when InstanceSkinGeometry output changes, so cached meshes made by
+/// older versions are not used
+constexpr uint64_t gSkinGeometryInstancingVersion = 1;
+
+/**
+ * Converts skinned RW geometry into render ready geometry, bone weights and
+ * indices are stored in vertices. Materials are not used.
+ */
+void InstanceSkinGeometry( RpGeometryInterface *geom_io,
+                           const RpMeshHeader * meshHeader,
+                           InstancedGeometry &  result );
+
+/// Hash of everything InstanceSkinGeometry output depends on
+uint64_t SkinGeometrySourceKey( RpGeometryInterface *geom_io,
+                                const RpMeshHeader * meshHeader );
+
+/**
+ * @return bone matrix count of skinned atomic, 0 if it has no hierarchy
+ */
+uint32_t GetBoneMatrixCount( RpAtomic *atomic, IAnimHierarcy &anim_hier );
+void     PrepareBoneMatrices( std::span<DirectX::XMFLOAT4X3> matrix_cache,
+                              RpAtomic *atomic, IAnimHierarcy &anim_hier );
 RenderStatus InstanceSkinAtomic( RpAtomic *           atomic,
                                  RpGeometryInterface *geom_io );
 } // namespace rh::rw::engine
\ No newline at end of file
@@ -2,7 +2,9 @@
 
 #include <common_headers.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstring>
 #include <ostream>
 #include <queue>
 #include <span>
@@ -14,8 +16,11 @@
 
 #include <rw_engine/rh_backend/raster_backend.h>
 #include <rw_engine/rw_api_injectors.h>
+#include <rw_engine/rw_asset_pack/asset_pack.h>
+#include <rw_engine/rw_image/pixel_convert.h>
 #include <rw_engine/rw_macro_constexpr.h>
 #include <rw_engine/rw_rh_convert_funcs.h>
+#include <rw_engine/rw_stream/rw_memory_stream.h>
 #include <rw_engine/system_funcs/raster_load_cmd.h>
 #include <rw_engine/system_funcs/rw_device_system_globals.h>
 
@@ -103,102 +108,111 @@ RwNativeTextureReadCmd::RwNativeTextureReadCmd( RwStream   *stream,
 
 bool RwNativeTextureReadCmd::Execute()
 {
-    RwRaster *raster = nullptr;
-
-    uint32_t          length, version;
-    rwD3DNativeRaster nativeRaster{};
-    rwNativeTexture   nativeTexture{};
+    uint32_t length, version;
 
     auto timestamp = std::chrono::high_resolution_clock::now();
 
-    auto &io         = g_pIO_API;
-    auto &rw_texture = g_pTexture_API;
+    auto &io = g_pIO_API;
 
     if ( !io.fpFindChunk( m_pStream, rwID_STRUCT, &length, &version ) )
         return false;
     if ( version < 0x31000 || version > 0x38002 )
         return false;
 
-    io.fpRead( m_pStream, reinterpret_cast<void *>( &nativeTexture ),
-               sizeof( rwNativeTexture ) );
+    // stream may be a game stream, so the chunk is copied out and decoded
+    // the same way as dictionaries read by RwTexDictionaryStreamRead
+    std::vector<uint8_t> chunk_data( length );
+    if ( io.fpRead( m_pStream, chunk_data.data(), length ) != length )
+        return false;
+
+    DecodedNativeTexture decoded{};
+    if ( !Decode( chunk_data, decoded ) )
+    {
+        debug::DebugLogger::Error( decoded.Error );
+        return false;
+    }
+    RwTexture *texture = Submit( decoded );
+    if ( texture == nullptr )
+        return false;
+    *m_pTexture = texture;
+
+    debug::DebugLogger::LogFormat(
+        debug::LogLevel::Info, "Texture loading : %lld mcs.",
+        static_cast<long long>(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::high_resolution_clock::now() - timestamp )
+                .count() ) );
+
+    return true;
+}
+
+bool RwNativeTextureReadCmd::Decode( std::span<const uint8_t> data,
+                                     DecodedNativeTexture    &result )
+{
+    if ( gRenderClient )
+    {
+        if ( const auto *pack = gRenderClient->GetAssetPack();
+             pack && pack->FindTexture( TextureSourceKey( data ), result ) )
+            return true;
+    }
 
-    std::stringstream debug_output;
-    debug_output << nativeTexture;
+    RwMemoryStream    stream( data );
+    rwD3DNativeRaster nativeRaster{};
+    rwNativeTexture   nativeTexture{};
 
-    io.fpRead( m_pStream, reinterpret_cast<void *>( &nativeRaster ),
-               sizeof( rwD3DNativeRaster ) );
+    if ( stream.Read( &nativeTexture, sizeof( rwNativeTexture ) ) !=
+             sizeof( rwNativeTexture ) ||
+         stream.Read( &nativeRaster, sizeof( rwD3DNativeRaster ) ) !=
+             sizeof( rwD3DNativeRaster ) )
+    {
+        result.Error = "Texture native data block is truncated!";
+        return false;
+    }
 
     bool compressed = false, isCubemap = false;
 
     switch ( nativeTexture.id )
     {
     case rwID_PCD3D8:
-        debug_output << nativeRaster.d3d8_;
         compressed = nativeRaster.d3d8_.dxtFormat != 0;
         break;
     case rwID_PCD3D9:
-        debug_output << nativeRaster.d3d9_;
         compressed =
             static_cast<bool>( nativeRaster.d3d9_.flags & ( 1u << 3u ) );
         isCubemap =
             static_cast<bool>( nativeRaster.d3d9_.flags & ( 1u << 1u ) );
         break;
-    default: return false;
+    default:
+        result.Error = "Unsupported texture platform!";
+        return false;
     }
 
-    std::string debug_output_str = debug_output.str();
-
-    debug::DebugLogger::Log( debug_output_str );
-
-    if ( compressed ) // is compressed
+    // texture description is built only if it is going to be logged
+    if ( debug::DebugLogger::IsEnabled( debug::LogLevel::Info ) )
     {
-        debug::DebugLogger::Log( "compressed raster path" );
-        // Validate format
-        // ...
-        // Create a raster
-        raster = g_pRaster_API.fpCreateRaster(
-            nativeRaster.d3d9_.width, nativeRaster.d3d9_.height,
-            static_cast<int32_t>( nativeRaster.d3d9_.depth ),
-            static_cast<int32_t>( nativeRaster.d3d9_.type |
-                                  nativeRaster.d3d9_.format |
-                                  rwRASTERDONTALLOCATE ) );
-        // Attach API texture
-        if ( isCubemap ) // is cubemap
-        {
-            debug::DebugLogger::Log( "cubemap raster path" );
-            // Create a raster
-            // ...
-            // Attach API texture
-        }
-    }
-    else if ( isCubemap ) // is cubemap
-    {
-        debug::DebugLogger::Log( "cubemap raster path" );
-        // Create a raster
-        // ...
-        // Attach API texture
-    }
-    else if ( nativeRaster.d3d9_.format &
-              static_cast<uint32_t>(
-                  ~( rwRASTERFORMATAUTOMIPMAP | rwRASTERFORMATMIPMAP ) ) )
-    {
-        debug::DebugLogger::Log( "rw raster path" );
-        // Create a raster
-        // ...
-        raster = g_pRaster_API.fpCreateRaster(
-            nativeRaster.d3d9_.width, nativeRaster.d3d9_.height,
-            static_cast<int32_t>( nativeRaster.d3d9_.depth ),
-            static_cast<int32_t>( nativeRaster.d3d9_.type |
-                                  nativeRaster.d3d9_.format |
-                                  rwRASTERDONTALLOCATE ) );
-    }
-    else
-    {
-        debug::DebugLogger::Log( "weird raster path" );
+        std::stringstream debug_output;
+        debug_output << nativeTexture;
+        if ( nativeTexture.id == rwID_PCD3D8 )
+            debug_output << nativeRaster.d3d8_;
+        else
+            debug_output << nativeRaster.d3d9_;
+        result.DebugInfo = debug_output.str();
     }
-
-    if ( raster == nullptr )
-        return false;
+    result.Name.assign( nativeTexture.name,
+                        strnlen( nativeTexture.name,
+                                 rwTEXTUREBASENAMELENGTH ) );
+    result.Mask.assign( nativeTexture.mask,
+                        strnlen( nativeTexture.mask,
+                                 rwTEXTUREBASENAMELENGTH ) );
+    result.FilterAndAddress =
+        static_cast<uint32_t>( nativeTexture.filterAndAddress );
+    result.Width        = nativeRaster.d3d9_.width;
+    result.Height       = nativeRaster.d3d9_.height;
+    result.Depth        = nativeRaster.d3d9_.depth;
+    result.RasterType   = nativeRaster.d3d9_.type;
+    result.RasterFormat = nativeRaster.d3d9_.format;
+    result.Compressed   = compressed;
+    result.IsCubemap    = isCubemap;
 
     rh::engine::ImageBufferFormat rhFormat =
         RwNativeFormatToRHImageBufferFormat(
@@ -209,41 +223,25 @@ bool RwNativeTextureReadCmd::Execute()
 
     uint32_t bytesPerBlock, blockSize = 4;
 
-    std::vector<RwRGBA> palette;
+    std::span<const RwRGBA> palette;
 
     /* Load the palette if palletized */
     if ( nativeRaster.d3d9_.format & rwRASTERFORMATPAL4 )
     {
-        uint32_t size = sizeof( RwRGBA ) * 32;
-
-        palette.resize( size / sizeof( RwRGBA ) );
-
-        if ( io.fpRead( m_pStream, reinterpret_cast<void *>( palette.data() ),
-                        size ) != size )
+        palette = stream.ReadSpan<RwRGBA>( 32 );
+        if ( palette.empty() )
         {
-            rh::debug::DebugLogger::Error(
-                "Failed to read 4bit palette data!" );
-
-            g_pRaster_API.fpDestroyRaster( raster );
-
+            result.Error = "Failed to read 4bit palette data!";
             return false;
         }
         rhFormat = rh::engine::ImageBufferFormat::BGRA8;
     }
     else if ( nativeRaster.d3d9_.format & rwRASTERFORMATPAL8 )
     {
-        constexpr uint32_t size = sizeof( RwRGBA ) * 256;
-
-        palette.resize( size / sizeof( RwRGBA ) );
-
-        if ( io.fpRead( m_pStream, reinterpret_cast<void *>( palette.data() ),
-                        size ) != size )
+        palette = stream.ReadSpan<RwRGBA>( 256 );
+        if ( palette.empty() )
         {
-            rh::debug::DebugLogger::Error(
-                "Failed to read 8bit palette data!" );
-
-            g_pRaster_API.fpDestroyRaster( raster );
-
+            result.Error = "Failed to read 8bit palette data!";
             return false;
         }
         rhFormat = rh::engine::ImageBufferFormat::BGRA8;
@@ -260,180 +258,268 @@ bool RwNativeTextureReadCmd::Execute()
     default: bytesPerBlock = 16; break;
     }
 
-    auto &internalRaster = BackendRasterPlugin::GetData( raster );
-    debug_output.str( "" );
-    debug_output.clear();
-    debug_output << "Texture adress: 0x" << std::hex
-                 << reinterpret_cast<INT_PTR>( &internalRaster ) << '\n';
-    rh::debug::DebugLogger::Log( debug_output.str() );
-
-    auto convert_paletted_mip_level =
-        [&]( MipLevelHeader &mip_header, uint32_t width, uint32_t height,
-             uint32_t size, uint8_t *raw_pixels, uint32_t *result_data,
-             bool has_alpha )
-    {
-        // Convert paletted raster if needed
-        auto result_size = height * width * sizeof( uint32_t );
-
-        if ( !has_alpha )
-            for ( size_t j = 0; j < size; j++ )
-                result_data[j] = rwRGBA::Long_RGB( palette[raw_pixels[j]] );
-        else
-            for ( size_t j = 0; j < size; j++ )
-                result_data[j] = rwRGBA::Long( palette[raw_pixels[j]] );
-
-        mip_header.mSize   = result_size;
-        mip_header.mStride = bytesPerBlock * ( ( width + 3 ) / blockSize );
-    };
-
     // Some txd records can have invalid mip level counter, default it
     // to 1 for now
-    const uint32_t numMipLevels = max( nativeRaster.d3d9_.numMipLevels, 1u );
-    const bool     convert_from_pal =
+    const uint32_t numMipLevels =
+        ( std::max )( uint32_t{ nativeRaster.d3d9_.numMipLevels }, 1u );
+    const bool convert_from_pal =
         nativeRaster.d3d9_.format & rwRASTERFORMATPAL4 ||
         nativeRaster.d3d9_.format & rwRASTERFORMATPAL8;
     const bool has_alpha =
         static_cast<bool>( ( nativeTexture.id == rwID_PCD3D8 )
                                ? nativeRaster.d3d8_.alpha
                                : nativeRaster.d3d9_.flags & ( 1u << 0u ) );
-
-    RasterHeader header{ .mWidth         = nativeRaster.d3d9_.width,
-                         .mHeight        = nativeRaster.d3d9_.height,
-                         .mDepth         = 1,
-                         .mFormat        = static_cast<uint32_t>( rhFormat ),
-                         .mMipLevelCount = numMipLevels };
-
-    RasterLoadCmdImpl load_texture_cmd( gRenderClient->GetTaskQueue() );
-
+    // Fix rgb8 format "alpha" channel
+    const bool fix_alpha =
+        !convert_from_pal && !compressed &&
+        ( nativeRaster.d3d9_.format & rwRASTERFORMAT888 ) ==
+            rwRASTERFORMAT888;
+
+    result.BytesPerBlock  = bytesPerBlock;
+    result.BlockSize      = blockSize;
+    result.HasAlpha       = has_alpha;
+    result.ConvertFromPal = convert_from_pal;
+    result.Header = { .mWidth         = nativeRaster.d3d9_.width,
+                      .mHeight        = nativeRaster.d3d9_.height,
+                      .mDepth         = 1,
+                      .mFormat        = static_cast<uint32_t>( rhFormat ),
+                      .mMipLevelCount = numMipLevels };
+
+    // converted mip levels are appended to storage, it is reserved up front
+    // so pointers to converted levels stay valid
     uint32_t mip_width  = nativeRaster.d3d9_.width;
     uint32_t mip_height = nativeRaster.d3d9_.height;
+    if ( convert_from_pal )
+    {
+        uint64_t storage_size = 0;
+        for ( uint32_t i = 0; i < numMipLevels; i++ )
+        {
+            storage_size += uint64_t{ mip_width } * mip_height * 4;
+            mip_width  = ( std::max )( mip_width >> 1u, 1u );
+            mip_height = ( std::max )( mip_height >> 1u, 1u );
+        }
+        result.Storage.reserve( storage_size );
+    }
+    else if ( fix_alpha )
+        result.Storage.reserve( data.size() );
 
-    assert( internalRaster.mImageId == BackendRasterPlugin::NullRasterId );
-    internalRaster.MipCount      = numMipLevels;
-    internalRaster.BlockSize     = blockSize;
-    internalRaster.BytesPerBlock = bytesPerBlock;
-    internalRaster.Compressed    = compressed;
-    internalRaster.HasAlpha      = has_alpha;
-    internalRaster.mImageId      = load_texture_cmd.Invoke(
-             header,
-             [&]( MemoryWriter &writer, MipLevelHeader &mip_header )
-             {
-            writer.Skip( sizeof( MipLevelHeader ) );
-
-            auto *image_memory = writer.CurrentPtr<uint32_t>();
-            if ( convert_from_pal )
-                writer.Skip( mip_height * mip_width * sizeof( uint32_t ) );
-            auto *pixels = writer.CurrentPtr<uint8_t>();
-            if ( convert_from_pal )
-                writer.SeekFromCurrent(
-                         -static_cast<int64_t>( mip_height * mip_width ) *
-                         sizeof( uint32_t ) );
-
-            uint32_t size;
-            io.fpRead( m_pStream, reinterpret_cast<char *>( &size ),
-                            sizeof( size ) );
-            io.fpRead( m_pStream, reinterpret_cast<char *>( pixels ), size );
+    mip_width  = nativeRaster.d3d9_.width;
+    mip_height = nativeRaster.d3d9_.height;
+    result.MipLevels.reserve( numMipLevels );
+    for ( uint32_t i = 0; i < numMipLevels; i++ )
+    {
+        uint32_t size = 0;
+        if ( stream.Read( &size, sizeof( size ) ) != sizeof( size ) )
+        {
+            result.Error = "Failed to read mip level size!";
+            return false;
+        }
+        auto pixels = stream.ReadSpan<uint8_t>( size );
+        if ( pixels.size() != size )
+        {
+            result.Error = "Failed to read mip level data!";
+            return false;
+        }
 
-            if ( convert_from_pal )
-                convert_paletted_mip_level( mip_header, mip_width, mip_height,
-                                                 size, pixels, image_memory,
-                                                 has_alpha );
-            else
-            {
-                // Fix rgb8 format "alpha" channel
-                if ( !compressed && ( nativeRaster.d3d9_.format &
-                                      rwRASTERFORMAT888 ) == rwRASTERFORMAT888 )
-                {
-                    std::span<RwRGBA> rgba_pixels(
-                             reinterpret_cast<RwRGBA *>( pixels ), size / 4 );
-                    for ( auto &pix : rgba_pixels )
-                        pix.alpha = 0xff;
-                }
+        DecodedMipLevel mip{};
+        mip.Header.mStride = bytesPerBlock * ( ( mip_width + 3 ) / blockSize );
+        if ( convert_from_pal )
+        {
+            // Convert paletted raster
+            const uint64_t pixel_count = uint64_t{ mip_width } * mip_height;
+            const auto     offset      = result.Storage.size();
+            result.Storage.resize( offset + pixel_count * sizeof( uint32_t ) );
+            auto *result_data =
+                reinterpret_cast<uint32_t *>( result.Storage.data() + offset );
+            const auto count = ( std::min )( uint64_t{ size }, pixel_count );
+
+            ExpandPalette( pixels.data(), count,
+                           reinterpret_cast<const uint8_t *>( palette.data() ),
+                           static_cast<uint32_t>( palette.size() ), !has_alpha,
+                           result_data );
+
+            mip.Header.mSize = static_cast<uint32_t>( pixel_count * 4 );
+            mip.Data         = result.Storage.data() + offset;
+        }
+        else if ( fix_alpha )
+        {
+            const auto offset = result.Storage.size();
+            result.Storage.insert( result.Storage.end(), pixels.begin(),
+                                   pixels.end() );
+            std::span<RwRGBA> rgba_pixels(
+                reinterpret_cast<RwRGBA *>( result.Storage.data() + offset ),
+                size / 4 );
+            for ( auto &pix : rgba_pixels )
+                pix.alpha = 0xff;
+
+            mip.Header.mSize = size;
+            mip.Data         = result.Storage.data() + offset;
+        }
+        else
+        {
+            // sent to render driver straight from chunk data
+            mip.Header.mSize = size;
+            mip.Data         = pixels.data();
+        }
+        result.MipLevels.push_back( mip );
 
-                mip_header.mSize = size;
-                mip_header.mStride =
-                    bytesPerBlock * ( ( mip_width + 3 ) / blockSize );
-            }
-            writer.Skip( mip_header.mSize );
+        mip_width  = ( std::max )( mip_width >> 1u, 1u );
+        mip_height = ( std::max )( mip_height >> 1u, 1u );
+    }
 
-            mip_width  = ( std::max )( mip_width >> 1u, 1u );
-            mip_height = ( std::max )( mip_height >> 1u, 1u );
-            return true;
-             } );
     if ( nativeTexture.id == rwID_PCD3D8 )
     {
         if ( compressed )
         {
             switch ( nativeRaster.d3d8_.dxtFormat )
             {
-            case 1: internalRaster.OriginalFormat = D3DFMT_DXT1;
-            case 2: internalRaster.OriginalFormat = D3DFMT_DXT2;
-            case 3: internalRaster.OriginalFormat = D3DFMT_DXT3;
-            case 4: internalRaster.OriginalFormat = D3DFMT_DXT4;
-            case 5: internalRaster.OriginalFormat = D3DFMT_DXT5;
+            case 1: result.OriginalFormat = D3DFMT_DXT1;
+            case 2: result.OriginalFormat = D3DFMT_DXT2;
+            case 3: result.OriginalFormat = D3DFMT_DXT3;
+            case 4: result.OriginalFormat = D3DFMT_DXT4;
+            case 5: result.OriginalFormat = D3DFMT_DXT5;
             }
         }
         else
         {
             if ( convert_from_pal )
             {
-                internalRaster.OriginalFormat = D3DFMT_A8R8G8B8;
+                result.OriginalFormat = D3DFMT_A8R8G8B8;
             }
             else
             {
                 switch ( nativeRaster.d3d8_.format )
                 {
                 case rwRASTERFORMATDEFAULT:
-                    internalRaster.OriginalFormat = D3DFMT_A8R8G8B8;
+                    result.OriginalFormat = D3DFMT_A8R8G8B8;
                 case rwRASTERFORMAT1555:
-                    internalRaster.OriginalFormat = D3DFMT_A1R5G5B5;
+                    result.OriginalFormat = D3DFMT_A1R5G5B5;
                 case rwRASTERFORMAT565:
-                    internalRaster.OriginalFormat = D3DFMT_R5G6B5;
+                    result.OriginalFormat = D3DFMT_R5G6B5;
                 case rwRASTERFORMAT4444:
-                    internalRaster.OriginalFormat = D3DFMT_A4R4G4B4;
-                case rwRASTERFORMATLUM8:
-                    internalRaster.OriginalFormat = D3DFMT_A8;
+                    result.OriginalFormat = D3DFMT_A4R4G4B4;
+                case rwRASTERFORMATLUM8: result.OriginalFormat = D3DFMT_A8;
                 case rwRASTERFORMAT8888:
-                    internalRaster.OriginalFormat = D3DFMT_A8R8G8B8;
+                    result.OriginalFormat = D3DFMT_A8R8G8B8;
                 case rwRASTERFORMAT888:
-                    internalRaster.OriginalFormat = D3DFMT_X8R8G8B8;
+                    result.OriginalFormat = D3DFMT_X8R8G8B8;
                 case rwRASTERFORMAT555:
-                    internalRaster.OriginalFormat = D3DFMT_A1R5G5B5;
+                    result.OriginalFormat = D3DFMT_A1R5G5B5;
                 }
             }
         }
     }
     else
-        internalRaster.OriginalFormat = nativeRaster.d3d9_.d3dFormat;
-    if ( convert_from_pal )
+        result.OriginalFormat = nativeRaster.d3d9_.d3dFormat;
+
+    return true;
+}
+
+RwTexture *RwNativeTextureReadCmd::Submit( const DecodedNativeTexture &decoded )
+{
+    RwRaster *raster = nullptr;
+
+    if ( !decoded.DebugInfo.empty() )
+        debug::DebugLogger::Log( decoded.DebugInfo );
+
+    const auto raster_flags = static_cast<int32_t>(
+        decoded.RasterType | decoded.RasterFormat | rwRASTERDONTALLOCATE );
+
+    if ( decoded.Compressed ) // is compressed
+    {
+        debug::DebugLogger::LogFormat( debug::LogLevel::Info,
+                                       "compressed raster path" );
+        // Validate format
+        // ...
+        // Create a raster
+        raster = g_pRaster_API.fpCreateRaster(
+            decoded.Width, decoded.Height,
+            static_cast<int32_t>( decoded.Depth ), raster_flags );
+        // Attach API texture
+        if ( decoded.IsCubemap ) // is cubemap
+        {
+            debug::DebugLogger::LogFormat( debug::LogLevel::Info,
+                                           "cubemap raster path" );
+            // Create a raster
+            // ...
+            // Attach API texture
+        }
+    }
+    else if ( decoded.IsCubemap ) // is cubemap
+    {
+        debug::DebugLogger::LogFormat( debug::LogLevel::Info,
+                                       "cubemap raster path" );
+        // Create a raster
+        // ...
+        // Attach API texture
+    }
+    else if ( decoded.RasterFormat &
+              static_cast<uint32_t>(
+                  ~( rwRASTERFORMATAUTOMIPMAP | rwRASTERFORMATMIPMAP ) ) )
+    {
+        debug::DebugLogger::LogFormat( debug::LogLevel::Info,
+                                       "rw raster path" );
+        // Create a raster
+        // ...
+        raster = g_pRaster_API.fpCreateRaster(
+            decoded.Width, decoded.Height,
+            static_cast<int32_t>( decoded.Depth ), raster_flags );
+    }
+    else
+    {
+        debug::DebugLogger::LogFormat( debug::LogLevel::Info,
+                                       "weird raster path" );
+    }
+
+    if ( raster == nullptr )
+        return nullptr;
+
+    auto &internalRaster = BackendRasterPlugin::GetData( raster );
+    debug::DebugLogger::LogFormat( debug::LogLevel::Info, "Texture adress: %p",
+                                   static_cast<void *>( &internalRaster ) );
+
+    RasterLoadCmdImpl load_texture_cmd( gRenderClient->GetAssetQueue() );
+
+    uint32_t mip_id = 0;
+
+    assert( internalRaster.mImageId == BackendRasterPlugin::NullRasterId );
+    internalRaster.MipCount      = decoded.Header.mMipLevelCount;
+    internalRaster.BlockSize     = decoded.BlockSize;
+    internalRaster.BytesPerBlock = decoded.BytesPerBlock;
+    internalRaster.Compressed    = decoded.Compressed;
+    internalRaster.HasAlpha      = decoded.HasAlpha;
+    internalRaster.mImageId      = load_texture_cmd.Invoke(
+        decoded.Header,
+        [&]( MemoryWriter &writer, MipLevelHeader &mip_header )
+        {
+            const auto &mip = decoded.MipLevels[mip_id++];
+            writer.Skip( sizeof( MipLevelHeader ) );
+            mip_header = mip.Header;
+            // mip level is read back at once, so it is written in one piece
+            writer.Write( mip.Data, mip.Header.mSize );
+            return true;
+        } );
+    internalRaster.OriginalFormat = decoded.OriginalFormat;
+    if ( decoded.ConvertFromPal )
         raster->cFormat =
             raster->cFormat &
             ~( uint8_t( ( rwRASTERFORMATPAL8 | rwRASTERFORMATPAL4 ) >> 8 ) );
 
     assert( raster->cFormat > 0 );
-    RwTexture *texture = rw_texture.fpCreateTexture( raster );
+    auto      &rw_texture = g_pTexture_API;
+    RwTexture *texture    = rw_texture.fpCreateTexture( raster );
     if ( texture == nullptr )
-        return false;
-    rwTexture::SetFilterMode(
-        texture, ( (uint32_t)nativeTexture.filterAndAddress ) & 0xFFu );
-    rwTexture::SetAddressingU(
-        texture, ( (uint32_t)nativeTexture.filterAndAddress >> 8u ) & 0x0Fu );
-    rwTexture::SetAddressingV(
-        texture, ( (uint32_t)nativeTexture.filterAndAddress >> 12u ) & 0x0Fu );
+        return nullptr;
+    rwTexture::SetFilterMode( texture, decoded.FilterAndAddress & 0xFFu );
+    rwTexture::SetAddressingU( texture,
+                               ( decoded.FilterAndAddress >> 8u ) & 0x0Fu );
+    rwTexture::SetAddressingV( texture,
+                               ( decoded.FilterAndAddress >> 12u ) & 0x0Fu );
     if ( rw_texture.fpTextureSetName )
-        rw_texture.fpTextureSetName( texture, nativeTexture.name );
+        rw_texture.fpTextureSetName( texture, decoded.Name.c_str() );
     if ( rw_texture.fpTextureSetMaskName )
-        rw_texture.fpTextureSetMaskName( texture, nativeTexture.mask );
-    *m_pTexture = texture;
+        rw_texture.fpTextureSetMaskName( texture, decoded.Mask.c_str() );
 
-    debug_output.clear();
-    debug_output << "Texture loading : " << std::dec
-                 << std::chrono::duration_cast<std::chrono::microseconds>(
-                        std::chrono::high_resolution_clock::now() - timestamp )
-                        .count()
-                 << " mcs.";
-    debug::DebugLogger::Log( debug_output.str() );
-
-    return true;
+    return texture;
 }
 } // namespace rh::rw::engine
\ No newline at end of file
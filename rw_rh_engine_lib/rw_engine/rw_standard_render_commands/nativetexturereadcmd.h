@@ -1,16 +1,73 @@
 #pragma once
+#include <rw_engine/rh_backend/raster_backend.h>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
 struct RwStream;
 struct RwTexture;
 
 namespace rh::rw::engine {
+
+/// Mip level ready to be sent to render driver
+struct DecodedMipLevel
+{
+    MipLevelHeader Header{};
+    /// Points either into texture native chunk or into decoded storage
+    const uint8_t *Data = nullptr;
+};
+
+/**
+ * Texture native STRUCT chunk decoded without calling RW API, so textures of
+ * a dictionary can be decoded on worker threads and submitted in order
+ */
+struct DecodedNativeTexture
+{
+    std::string DebugInfo;
+    /// Set if decoding failed, logged on submit
+    std::string Error;
+    std::string Name;
+    std::string Mask;
+    uint32_t    FilterAndAddress = 0;
+
+    uint32_t Width          = 0;
+    uint32_t Height         = 0;
+    uint32_t Depth          = 0;
+    uint32_t RasterType     = 0;
+    uint32_t RasterFormat   = 0;
+    uint32_t OriginalFormat = 0;
+    uint32_t BytesPerBlock  = 0;
+    uint32_t BlockSize      = 4;
+    bool     Compressed     = false;
+    bool     IsCubemap      = false;
+    bool     HasAlpha       = false;
+    bool     ConvertFromPal = false;
+
+    RasterHeader                 Header{};
+    std::vector<DecodedMipLevel> MipLevels;
+    /// Mip levels converted from palette or with fixed alpha
+    std::vector<uint8_t> Storage;
+};
+
 class RwNativeTextureReadCmd
 {
 public:
     RwNativeTextureReadCmd(RwStream *stream, RwTexture **texture);
     bool Execute();
 
+    /**
+     * Decodes texture native STRUCT chunk data, thread safe. Mip levels that
+     * need no conversion point into chunk data, so it must outlive result.
+     * Textures found in asset pack are not decoded, their mip levels point
+     * into the pack.
+     */
+    static bool Decode( std::span<const uint8_t> data,
+                        DecodedNativeTexture &   result );
+    /// Creates raster and texture from decoded data, game thread only
+    static RwTexture *Submit( const DecodedNativeTexture &decoded );
+
 private:
     RwStream *m_pStream;
     RwTexture **m_pTexture;
 };
-} // namespace rw_rh_engine
+} // namespace rw_rh_engine
\ No newline at end of file
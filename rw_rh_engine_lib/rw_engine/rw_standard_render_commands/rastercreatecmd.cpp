@@ -10,10 +10,9 @@ using namespace rh::rw::engine;
 RwRasterCreateCmd::RwRasterCreateCmd( RwRaster *raster, uint32_t flags )
     : m_pRaster( raster ), m_nFlags( flags )
 {
-    rh::debug::DebugLogger::Log(
-        std::to_string( reinterpret_cast<uint32_t>( raster ) ) +
-            " RasterCreateCmd created...",
-        rh::debug::LogLevel::ConstrDestrInfo );
+    rh::debug::DebugLogger::LogFormat( rh::debug::LogLevel::ConstrDestrInfo,
+                                       "%p RasterCreateCmd created...",
+                                       static_cast<void *>( raster ) );
 }
 
 bool RwRasterCreateCmd::Execute()
@@ -0,0 +1,274 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "rw_chunk_index.h"
+#include "rw_stream.h"
+#include <DebugUtils/DebugLogger.h>
+#include <common_headers.h>
+
+#include <algorithm>
+#include <fstream>
+
+namespace rh::rw::engine
+{
+namespace
+{
+constexpr uint64_t gChunkHeaderSize = 3 * sizeof( uint32_t );
+
+/// Chunks that contain a sequence of chunks instead of raw data
+bool IsContainer( uint32_t type )
+{
+    switch ( type )
+    {
+    case rwID_EXTENSION:
+    case rwID_CAMERA:
+    case rwID_TEXTURE:
+    case rwID_MATERIAL:
+    case rwID_MATLIST:
+    case rwID_FRAMELIST:
+    case rwID_GEOMETRY:
+    case rwID_CLUMP:
+    case rwID_LIGHT:
+    case rwID_ATOMIC:
+    case rwID_TEXTURENATIVE:
+    case rwID_TEXDICTIONARY:
+    case rwID_GEOMETRYLIST: return true;
+    default: return false;
+    }
+}
+
+uint64_t LevelKey( int32_t parent, uint32_t type )
+{
+    return ( static_cast<uint64_t>( static_cast<uint32_t>( parent ) ) << 32 ) |
+           type;
+}
+
+/**
+ * Checks that entries form a tree Build could have made from source_size
+ * bytes: every chunk lies inside the source and inside its parent, which
+ * precedes it, and follows the previous chunk on its level
+ */
+bool IsValidIndex( std::span<const RwChunkIndexEntry> entries,
+                   uint64_t                           source_size )
+{
+    // end of the last chunk on each level, parent data start for a level
+    // without chunks yet
+    std::vector<uint64_t> level_end( entries.size() + 1, 0 );
+    for ( size_t i = 0; i < entries.size(); i++ )
+    {
+        const auto &entry = entries[i];
+        if ( entry.Parent < -1 || entry.Parent >= static_cast<int64_t>( i ) )
+            return false;
+        const auto end = entry.DataOffset() + entry.Size;
+        const auto parent_end =
+            entry.Parent < 0 ? source_size
+                             : entries[entry.Parent].DataOffset() +
+                                   entries[entry.Parent].Size;
+        auto &previous_end = level_end[entry.Parent + 1];
+        if ( entry.Offset < previous_end || end > parent_end )
+            return false;
+        previous_end     = end;
+        level_end[i + 1] = entry.DataOffset();
+    }
+    return true;
+}
+} // namespace
+
+uint64_t RwChunkIndexEntry::DataOffset() const
+{
+    return uint64_t{ Offset } + gChunkHeaderSize;
+}
+
+void RwChunkIndex::Build( std::span<const uint8_t> data )
+{
+    mEntries.clear();
+    RwMemoryStream stream( data );
+    IndexLevel( stream, data.size(), -1 );
+    BuildLookup();
+}
+
+void RwChunkIndex::IndexLevel( RwMemoryStream &stream, uint64_t end,
+                               int32_t parent )
+{
+    while ( stream.Position() + gChunkHeaderSize <= end )
+    {
+        const auto offset = stream.Position();
+        uint32_t   type, length, version;
+        if ( !_rwStreamReadChunkHeader( &stream, &type, &length, &version,
+                                        nullptr ) )
+            return;
+        // truncated chunk ends the level and isn't indexed, so every
+        // indexed chunk lies inside its parent
+        const auto data_end = stream.Position() + length;
+        if ( data_end > end )
+            return;
+        mEntries.push_back( { .Type    = type,
+                              .Version = version,
+                              .Offset  = static_cast<uint32_t>( offset ),
+                              .Size    = length,
+                              .Parent  = parent } );
+
+        if ( IsContainer( type ) )
+        {
+            const auto first_child = mEntries.size();
+            IndexLevel( stream, data_end,
+                        static_cast<int32_t>( first_child - 1 ) );
+            // data that isn't a sequence of chunks is not indexed, so
+            // searches inside it walk the headers
+            if ( stream.Position() != data_end )
+                mEntries.resize( first_child );
+        }
+        stream.Skip( data_end - stream.Position() );
+    }
+}
+
+void RwChunkIndex::BuildLookup()
+{
+    mLevels.clear();
+    for ( uint32_t i = 0; i < mEntries.size(); i++ )
+        mLevels[LevelKey( mEntries[i].Parent, mEntries[i].Type )].push_back(
+            i );
+}
+
+const RwChunkIndexEntry *
+RwChunkIndex::FindOnLevel( uint32_t entry, uint32_t type,
+                           bool include_entry ) const
+{
+    const auto level = mLevels.find( LevelKey( mEntries[entry].Parent, type ) );
+    if ( level == mLevels.end() )
+        return nullptr;
+    const auto &ids = level->second;
+    // entries are in stream order, so the next chunk of type on this level
+    // is the first one after entry
+    const auto next = include_entry
+                          ? std::lower_bound( ids.begin(), ids.end(), entry )
+                          : std::upper_bound( ids.begin(), ids.end(), entry );
+    return next != ids.end() ? &mEntries[*next] : nullptr;
+}
+
+bool RwChunkIndex::FindChunk( uint64_t offset, uint32_t type,
+                              const RwChunkIndexEntry *&found ) const
+{
+    const auto entry = std::lower_bound(
+        mEntries.begin(), mEntries.end(), offset,
+        []( const RwChunkIndexEntry &e, uint64_t pos )
+        { return e.Offset < pos; } );
+    if ( entry == mEntries.end() || entry->Offset != offset )
+        return false;
+
+    // header walk leaves a nested level at its end and continues with the
+    // chunks following the enclosing one
+    auto id = static_cast<uint32_t>( entry - mEntries.begin() );
+    found   = FindOnLevel( id, type, true );
+    while ( found == nullptr && mEntries[id].Parent >= 0 )
+    {
+        id    = static_cast<uint32_t>( mEntries[id].Parent );
+        found = FindOnLevel( id, type, false );
+    }
+    return true;
+}
+
+const RwChunkIndexEntry *RwChunkIndex::FindNthChunk( int32_t  parent,
+                                                     uint32_t type,
+                                                     uint64_t n ) const
+{
+    const auto level = mLevels.find( LevelKey( parent, type ) );
+    if ( level == mLevels.end() || n >= level->second.size() )
+        return nullptr;
+    return &mEntries[level->second[n]];
+}
+
+bool RwChunkIndex::Save( const std::filesystem::path   &path,
+                         const RwChunkIndexFileHeader &header ) const
+{
+    // written under temporary name, so an interrupted write never leaves a
+    // truncated index behind
+    auto temp_path = path;
+    temp_path += ".tmp";
+    std::error_code error;
+    {
+        std::ofstream file( temp_path,
+                            std::ios_base::binary | std::ios_base::trunc );
+        if ( !file )
+            return false;
+        auto file_header       = header;
+        file_header.EntryCount = mEntries.size();
+        file.write( reinterpret_cast<const char *>( &file_header ),
+                    sizeof( file_header ) );
+        file.write(
+            reinterpret_cast<const char *>( mEntries.data() ),
+            static_cast<std::streamsize>( mEntries.size() *
+                                          sizeof( RwChunkIndexEntry ) ) );
+        file.flush();
+        if ( !file.good() )
+        {
+            file.close();
+            std::filesystem::remove( temp_path, error );
+            return false;
+        }
+    }
+    std::filesystem::rename( temp_path, path, error );
+    if ( error )
+    {
+        std::filesystem::remove( temp_path, error );
+        return false;
+    }
+    return true;
+}
+
+bool RwChunkIndex::Load( const std::filesystem::path   &path,
+                         const RwChunkIndexFileHeader &expected )
+{
+    std::ifstream file( path, std::ios_base::binary );
+    if ( !file )
+        return false;
+    RwChunkIndexFileHeader header{};
+    file.read( reinterpret_cast<char *>( &header ), sizeof( header ) );
+    if ( !file || header.Magic != expected.Magic ||
+         header.Version != expected.Version ||
+         header.SourceSize != expected.SourceSize ||
+         header.SourceTime != expected.SourceTime )
+        return false;
+
+    // every chunk takes at least a header in the source file
+    if ( header.EntryCount > header.SourceSize / gChunkHeaderSize )
+        return false;
+    mEntries.resize( header.EntryCount );
+    file.read( reinterpret_cast<char *>( mEntries.data() ),
+               static_cast<std::streamsize>( mEntries.size() *
+                                             sizeof( RwChunkIndexEntry ) ) );
+    // cache may be corrupt while source size and time still match, lookups
+    // trust parents and offsets of entries
+    if ( !file || !IsValidIndex( mEntries, header.SourceSize ) )
+    {
+        mEntries.clear();
+        return false;
+    }
+    BuildLookup();
+    return true;
+}
+
+void RwChunkIndex::Open( const std::filesystem::path &path,
+                         std::span<const uint8_t> data, bool write_cache )
+{
+    auto cache_path = path;
+    cache_path += ".chunks";
+
+    std::error_code        error;
+    RwChunkIndexFileHeader header{};
+    header.SourceSize = data.size();
+    header.SourceTime = static_cast<int64_t>(
+        std::filesystem::last_write_time( path, error )
+            .time_since_epoch()
+            .count() );
+    if ( !error && Load( cache_path, header ) )
+        return;
+
+    Build( data );
+    if ( write_cache && !error && !Save( cache_path, header ) )
+        debug::DebugLogger::ErrorFmt( "Failed to write chunk index %s",
+                                      cache_path.string().c_str() );
+}
+
+} // namespace rh::rw::engine
@@ -0,0 +1,113 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace rh::rw::engine
+{
+class RwMemoryStream;
+
+constexpr uint32_t gChunkIndexMagic   = 0x49435752; // RWCI
+constexpr uint32_t gChunkIndexVersion = 1;
+
+struct RwChunkIndexEntry
+{
+    uint32_t Type;
+    /// Unpacked library version, as returned by RwStreamFindChunk
+    uint32_t Version;
+    /// Offset of chunk header in the stream
+    uint32_t Offset;
+    /// Size of chunk data, without header
+    uint32_t Size;
+    /// Index of enclosing chunk, -1 for top level chunks
+    int32_t  Parent;
+
+    [[nodiscard]] uint64_t DataOffset() const;
+};
+
+/// Chunk index cache file header, entries follow it
+struct RwChunkIndexFileHeader
+{
+    uint32_t Magic   = gChunkIndexMagic;
+    uint32_t Version = gChunkIndexVersion;
+    /// Size and modification time of indexed file, cache is stale if they
+    /// changed
+    uint64_t SourceSize = 0;
+    int64_t  SourceTime = 0;
+    uint64_t EntryCount = 0;
+};
+
+/**
+ * Directory of every chunk in a DFF or TXD file, built in one pass over
+ * chunk headers. Chunk search becomes a table lookup instead of a header
+ * walk from the current position, and n-th chunk of a type, e.g. a texture
+ * in a dictionary, is found without walking its siblings.
+ */
+class RwChunkIndex
+{
+  public:
+    /// Indexes chunks of stream memory, nested chunks of known container
+    /// types are indexed as well
+    void Build( std::span<const uint8_t> data );
+
+    /**
+     * Index of a mapped file, loaded from a cache file next to it if it's
+     * up to date. Otherwise index is built and cache is written if
+     * write_cache is set.
+     */
+    void Open( const std::filesystem::path &path,
+               std::span<const uint8_t> data, bool write_cache );
+
+    /// Writes cache file through a temporary file and a rename
+    bool Save( const std::filesystem::path &path,
+               const RwChunkIndexFileHeader &header ) const;
+    /// @return false if cache is stale or its entries are not a valid chunk
+    /// tree of the source file
+    bool Load( const std::filesystem::path &path,
+               const RwChunkIndexFileHeader &expected );
+
+    /**
+     * Finds chunk of type the way a header walk from offset would: among
+     * chunks following offset on the same level, then on enclosing levels
+     * @param found - set to nullptr if there is no such chunk
+     * @return false if offset is not a chunk header offset, stream has to
+     * walk chunk headers itself then
+     */
+    bool FindChunk( uint64_t offset, uint32_t type,
+                    const RwChunkIndexEntry *&found ) const;
+
+    /**
+     * @param parent - index of enclosing chunk, -1 for top level chunks
+     * @return n-th chunk of type directly inside parent, nullptr if there
+     * are less
+     */
+    const RwChunkIndexEntry *FindNthChunk( int32_t parent, uint32_t type,
+                                           uint64_t n ) const;
+
+    [[nodiscard]] std::span<const RwChunkIndexEntry> Entries() const
+    {
+        return mEntries;
+    }
+    /// Position of entry in Entries(), used as parent of its nested chunks
+    [[nodiscard]] int32_t IndexOf( const RwChunkIndexEntry &entry ) const
+    {
+        return static_cast<int32_t>( &entry - mEntries.data() );
+    }
+
+  private:
+    void IndexLevel( RwMemoryStream &stream, uint64_t end, int32_t parent );
+    void BuildLookup();
+    const RwChunkIndexEntry *FindOnLevel( uint32_t entry, uint32_t type,
+                                          bool include_entry ) const;
+
+    std::vector<RwChunkIndexEntry> mEntries;
+    /// entries of each type on each level, in stream order
+    std::unordered_map<uint64_t, std::vector<uint32_t>> mLevels;
+};
+
+} // namespace rh::rw::engine
@@ -0,0 +1,126 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "rw_memory_stream.h"
+#include <DebugUtils/DebugLogger.h>
+#include <algorithm>
+#include <cstring>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rh::rw::engine
+{
+
+uint32_t RwMemoryStream::Read( void *buffer, uint32_t length )
+{
+    const auto size = static_cast<uint32_t>(
+        ( std::min )( uint64_t{ length }, Remaining() ) );
+    std::memcpy( buffer, mData.data() + mPosition, size );
+    mPosition += size;
+    return size;
+}
+
+bool RwMemoryStream::Skip( uint64_t size )
+{
+    if ( size > Remaining() )
+    {
+        mPosition = mData.size();
+        return false;
+    }
+    mPosition += size;
+    return true;
+}
+
+bool RwMemoryStream::Seek( uint64_t position )
+{
+    if ( position > mData.size() )
+    {
+        mPosition = mData.size();
+        return false;
+    }
+    mPosition = position;
+    return true;
+}
+
+RwMappedFile::~RwMappedFile() { Close(); }
+
+bool RwMappedFile::Open( const std::filesystem::path &path )
+{
+    Close();
+    void *   memory = nullptr;
+    uint64_t size   = 0;
+#ifdef _WIN32
+    mFile = CreateFileW( path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                         OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr );
+    LARGE_INTEGER file_size{};
+    if ( mFile != INVALID_HANDLE_VALUE && GetFileSizeEx( mFile, &file_size ) &&
+         file_size.QuadPart > 0 )
+    {
+        size     = static_cast<uint64_t>( file_size.QuadPart );
+        mMapping = CreateFileMapping( mFile, nullptr, PAGE_READONLY, 0, 0,
+                                      nullptr );
+    }
+    if ( mMapping != nullptr )
+        memory = MapViewOfFile( mMapping, FILE_MAP_READ, 0, 0, 0 );
+    if ( memory == nullptr )
+    {
+        debug::DebugLogger::ErrorFmt(
+            "Failed to map file %s, error code:%u", path.string().c_str(),
+            static_cast<uint32_t>( GetLastError() ) );
+        Close();
+        return false;
+    }
+#else
+    int         fd = open( path.c_str(), O_RDONLY );
+    struct stat info
+    {
+    };
+    if ( fd >= 0 && fstat( fd, &info ) == 0 && info.st_size > 0 )
+    {
+        size   = static_cast<uint64_t>( info.st_size );
+        memory = mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    }
+    if ( memory == nullptr || memory == MAP_FAILED )
+    {
+        debug::DebugLogger::ErrorFmt( "Failed to map file %s, error:%s",
+                                      path.string().c_str(),
+                                      std::strerror( errno ) );
+        if ( fd >= 0 )
+            close( fd );
+        return false;
+    }
+    // mapping stays valid after descriptor is closed
+    close( fd );
+#endif
+    mMemory = static_cast<const uint8_t *>( memory );
+    mSize   = size;
+    return true;
+}
+
+void RwMappedFile::Close()
+{
+#ifdef _WIN32
+    if ( mMemory != nullptr )
+        UnmapViewOfFile( mMemory );
+    if ( mMapping != nullptr )
+        CloseHandle( mMapping );
+    if ( mFile != INVALID_HANDLE_VALUE )
+        CloseHandle( mFile );
+    mMapping = nullptr;
+    mFile    = INVALID_HANDLE_VALUE;
+#else
+    if ( mMemory != nullptr )
+        munmap( const_cast<uint8_t *>( mMemory ), mSize );
+#endif
+    mMemory = nullptr;
+    mSize   = 0;
+}
+
+} // namespace rh::rw::engine
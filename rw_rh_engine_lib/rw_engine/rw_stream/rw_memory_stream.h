@@ -0,0 +1,104 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace rh::rw::engine
+{
+class RwChunkIndex;
+
+/**
+ * RwStream over memory, e.g. a mapped DFF or TXD file. Chunk lookup is a
+ * bounds checked pointer bump and arrays may be read without copying them
+ * out of the stream.
+ */
+class RwMemoryStream
+{
+  public:
+    explicit RwMemoryStream( std::span<const uint8_t> data ) : mData( data )
+    {
+    }
+
+    /**
+     * Copies up to length bytes into buffer
+     * @return number of bytes copied, less than length at the end of stream
+     */
+    uint32_t Read( void *buffer, uint32_t length );
+
+    /**
+     * Zero-copy read of count elements, span points into stream memory and
+     * is valid as long as the memory is. Elements are not aligned beyond
+     * the 4 bytes RW chunks are aligned to.
+     * @return empty span if stream has less than count elements left
+     */
+    template <typename T> std::span<const T> ReadSpan( uint64_t count )
+    {
+        if ( count > Remaining() / sizeof( T ) )
+            return {};
+        const auto *data =
+            reinterpret_cast<const T *>( mData.data() + mPosition );
+        mPosition += count * sizeof( T );
+        return { data, count };
+    }
+
+    /// @return false if stream has less than size bytes left
+    bool Skip( uint64_t size );
+    /// @return false if position is past the end of stream
+    bool Seek( uint64_t position );
+
+    [[nodiscard]] uint64_t Remaining() const
+    {
+        return mData.size() - mPosition;
+    }
+    [[nodiscard]] uint64_t Position() const { return mPosition; }
+
+    /// Index of stream chunks, chunk search is a lookup with it
+    void SetChunkIndex( const RwChunkIndex *index ) { mChunkIndex = index; }
+    [[nodiscard]] const RwChunkIndex *GetChunkIndex() const
+    {
+        return mChunkIndex;
+    }
+
+  private:
+    std::span<const uint8_t> mData;
+    uint64_t                 mPosition   = 0;
+    const RwChunkIndex      *mChunkIndex = nullptr;
+};
+
+/**
+ * Read only file mapping, backs RwMemoryStream for files loaded by the
+ * engine itself, so assets are parsed straight from the page cache
+ */
+class RwMappedFile
+{
+  public:
+    RwMappedFile() = default;
+    ~RwMappedFile();
+    RwMappedFile( const RwMappedFile & ) = delete;
+    RwMappedFile &operator=( const RwMappedFile & ) = delete;
+
+    /// @return false if file can't be opened or is empty
+    bool Open( const std::filesystem::path &path );
+    void Close();
+
+    [[nodiscard]] std::span<const uint8_t> Data() const
+    {
+        return { mMemory, mSize };
+    }
+
+  private:
+    const uint8_t *mMemory = nullptr;
+    uint64_t       mSize   = 0;
+#ifdef _WIN32
+    HANDLE mFile    = INVALID_HANDLE_VALUE;
+    HANDLE mMapping = nullptr;
+#endif
+};
+
+} // namespace rh::rw::engine
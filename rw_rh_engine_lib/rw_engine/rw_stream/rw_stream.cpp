@@ -1,4 +1,5 @@
 #include "rw_stream.h"
+#include "rw_chunk_index.h"
 #include <common_headers.h>
 #include <rw_engine/test_heap_allocator.h>
 
@@ -15,11 +16,7 @@
 uint32_t rh::rw::engine::RwStreamRead( void *stream, void *buffer,
                                        uint32_t length )
 {
-    auto *stream_ = static_cast<std::istream *>( stream );
-
-    stream_->read( static_cast<char *>( buffer ), length );
-
-    return static_cast<uint32_t>( stream_->gcount() );
+    return static_cast<RwMemoryStream *>( stream )->Read( buffer, length );
 }
 
 bool rh::rw::engine::RwStreamFindChunk( void *stream, uint32_t type,
@@ -29,8 +26,26 @@ bool rh::rw::engine::RwStreamFindChunk( void *stream, uint32_t type,
     uint32_t readType;
     uint32_t readLength;
     uint32_t readVersion;
-    auto *   stream_ = static_cast<std::istream *>( stream );
+    auto *   stream_ = static_cast<RwMemoryStream *>( stream );
 
+    const rh::rw::engine::RwChunkIndexEntry *chunk = nullptr;
+    if ( const auto *index = stream_->GetChunkIndex();
+         index && index->FindChunk( stream_->Position(), type, chunk ) )
+    {
+        // header walk would consume the rest of the stream
+        if ( chunk == nullptr || !stream_->Seek( chunk->DataOffset() ) )
+        {
+            stream_->Seek( UINT64_MAX );
+            return false;
+        }
+        if ( lengthOut )
+            *lengthOut = chunk->Size;
+        if ( versionOut )
+            *versionOut = chunk->Version;
+        return true;
+    }
+
+    // chunks are skipped in memory, without touching their data
     while ( _rwStreamReadChunkHeader( stream_, &readType, &readLength,
                                       &readVersion, nullptr ) )
     {
@@ -46,8 +61,8 @@ bool rh::rw::engine::RwStreamFindChunk( void *stream, uint32_t type,
             }
             return true;
         }
-        if ( readLength > 0 )
-            stream_->seekg( readLength, std::ios_base::cur );
+        if ( !stream_->Skip( readLength ) )
+            return false;
     }
 
     return false;
@@ -100,7 +115,7 @@ char *rh::rw::engine::_rwStringStreamFindAndRead( char *string, void *stream )
     uint32_t readType;
     uint32_t readLength;
     uint32_t readVersion;
-    auto *   stream_ = static_cast<std::istream *>( stream );
+    auto *   stream_ = static_cast<RwMemoryStream *>( stream );
     while ( _rwStreamReadChunkHeader( stream_, &readType, &readLength,
                                       &readVersion, nullptr ) )
     {
@@ -109,10 +124,8 @@ char *rh::rw::engine::_rwStringStreamFindAndRead( char *string, void *stream )
             return ( StringStreamRead( string, stream, readLength ) );
         }
 
-        if ( readLength > 0 )
-        {
-            stream_->seekg( readLength, std::ios_base::cur );
-        }
+        if ( !stream_->Skip( readLength ) )
+            return nullptr;
     }
     return nullptr;
 }
@@ -124,7 +137,7 @@ struct __rwMark
     uint32_t libraryID;
 };
 
-bool rh::rw::engine::_rwStreamReadChunkHeader( std::istream *stream,
+bool rh::rw::engine::_rwStreamReadChunkHeader( RwMemoryStream *stream,
                                                uint32_t *type, uint32_t *length,
                                                uint32_t *version,
                                                uint32_t *buildNum )
@@ -132,11 +145,9 @@ bool rh::rw::engine::_rwStreamReadChunkHeader( std::istream *stream,
     __rwMark          mark{};
     RwChunkHeaderInfo chunkHdrInfo{};
 
-    if ( stream->eof() || stream->bad() )
+    if ( stream->Read( &mark, sizeof( mark ) ) != sizeof( mark ) )
         return false;
 
-    stream->read( reinterpret_cast<char *>( &mark ), sizeof( mark ) );
-
     chunkHdrInfo.type   = mark.type;
     chunkHdrInfo.length = mark.length;
 
@@ -1,10 +1,12 @@
 #pragma once
-#include <iostream>
+#include "rw_memory_stream.h"
 
 namespace rh::rw::engine {
 
+// stream arguments are RwMemoryStream pointers
+
 bool _rwStreamReadChunkHeader(
-    std::istream *stream, uint32_t *type, uint32_t *length, uint32_t *version, uint32_t *buildNum );
+    RwMemoryStream *stream, uint32_t *type, uint32_t *length, uint32_t *version, uint32_t *buildNum );
 
 char *_rwStringStreamFindAndRead( char *string, void *stream );
 
@@ -12,4 +14,10 @@ bool RwStreamFindChunk( void *stream, uint32_t type, uint32_t *lengthOut, uint32
 
 uint32_t RwStreamRead( void *stream, void *buffer, uint32_t length );
 
+/// Zero-copy read of count elements, see RwMemoryStream::ReadSpan
+template <typename T> std::span<const T> RwStreamReadSpan( void *stream, uint64_t count )
+{
+    return static_cast<RwMemoryStream *>( stream )->ReadSpan<T>( count );
+}
+
 } // namespace rw_rh_engine
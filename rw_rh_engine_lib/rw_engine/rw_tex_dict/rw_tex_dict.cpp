@@ -1,11 +1,16 @@
 #include "rw_tex_dict.h"
 #include "../rw_macro_constexpr.h"
+#include "../rw_stream/rw_chunk_index.h"
 #include "../rw_stream/rw_stream.h"
+#include "../rw_standard_render_commands/nativetexturereadcmd.h"
 #include "../rw_texture/rw_texture.h"
+#include "texture_decode_pool.h"
 #include "rw_engine/system_funcs/rw_device_system_globals.h"
-#include <fstream>
+#include <Engine/EngineConfigBlock.h>
 #include <rw_engine/system_funcs/rw_device_standards.h>
 #include <rw_engine/test_heap_allocator.h>
+#include <DebugUtils/DebugLogger.h>
+#include <vector>
 
 struct _rwStreamTexDictionary
 {
@@ -13,6 +18,58 @@ struct _rwStreamTexDictionary
     uint16_t deviceId;
 };
 
+namespace
+{
+/**
+ * Finds data blocks of count textures with stream chunk index, n-th texture
+ * is a lookup instead of a walk over the chunks before it
+ * @param dict_struct - offset of dictionary struct chunk header
+ * @return false if stream has no index or textures are not indexed, stream
+ * position is left unchanged then
+ */
+bool FindIndexedTextures( rh::rw::engine::RwMemoryStream        &stream,
+                          uint64_t                               dict_struct,
+                          uint32_t                               count,
+                          std::vector<std::span<const uint8_t>> &texture_data )
+{
+    using rh::rw::engine::RwChunkIndexEntry;
+    const auto              *index = stream.GetChunkIndex();
+    const RwChunkIndexEntry *chunk = nullptr;
+    if ( index == nullptr ||
+         !index->FindChunk( dict_struct, rwID_STRUCT, chunk ) ||
+         chunk == nullptr || chunk->Offset != dict_struct )
+        return false;
+
+    const auto                            dictionary = chunk->Parent;
+    const auto                            start      = stream.Position();
+    std::vector<std::span<const uint8_t>> found;
+    found.reserve( count );
+    for ( uint32_t id = 0; id < count; id++ )
+    {
+        const auto *texture =
+            index->FindNthChunk( dictionary, rwID_TEXTURENATIVE, id );
+        if ( texture == nullptr )
+            break;
+        chunk = index->FindNthChunk( index->IndexOf( *texture ), rwID_STRUCT,
+                                     0 );
+        if ( chunk == nullptr || chunk->Version < 0x31000 ||
+             chunk->Version > 0x38002 || !stream.Seek( chunk->DataOffset() ) )
+            break;
+        auto data = stream.ReadSpan<uint8_t>( chunk->Size );
+        if ( data.size() != chunk->Size )
+            break;
+        found.push_back( data );
+    }
+    if ( found.size() != count )
+    {
+        stream.Seek( start );
+        return false;
+    }
+    texture_data = std::move( found );
+    return true;
+}
+} // namespace
+
 RwTexDictionary *rh::rw::engine::RwTexDictionaryCreate()
 {
     RwTexDictionary *dict;
@@ -96,25 +153,59 @@ RwTexDictionary *rh::rw::engine::RwTexDictionaryStreamRead( void *stream )
     uint32_t               lengthOut, versionOut;
     _rwStreamTexDictionary binDict{};
     RwTexDictionary *      result = RwTexDictionaryCreate();
-    RwTexture *            texture;
+
+    auto *     memory_stream = static_cast<RwMemoryStream *>( stream );
+    const auto dict_struct   = memory_stream->Position();
 
     if ( !RwStreamFindChunk( stream, rwID_STRUCT, &lengthOut, &versionOut ) )
         return nullptr;
 
     RwStreamRead( stream, &binDict, sizeof( binDict ) );
 
+    // texture data blocks are found first, decoded on decode pool workers
+    // and then submitted in dictionary order, so RW API is only called from
+    // this thread
+    std::vector<std::span<const uint8_t>> texture_data;
+    texture_data.reserve( binDict.numTextures );
+    // chunk headers are only walked if textures are not indexed
+    if ( FindIndexedTextures( *memory_stream, dict_struct, binDict.numTextures,
+                              texture_data ) )
+        binDict.numTextures = 0;
     while ( binDict.numTextures-- )
     {
         uint32_t size, version;
-        texture = nullptr;
 
         if ( !RwStreamFindChunk( stream, rwID_TEXTURENATIVE, &size, &version ) )
             return nullptr;
+        if ( !RwStreamFindChunk( stream, rwID_STRUCT, &size, &version ) )
+            return nullptr;
+        if ( version < 0x31000 || version > 0x38002 )
+            return nullptr;
+        auto data = RwStreamReadSpan<uint8_t>( stream, size );
+        if ( data.size() != size )
+            return nullptr;
+        texture_data.push_back( data );
+    }
 
-        if ( !gRwDeviceGlobals.Standards[rwSTANDARDNATIVETEXTUREREAD](
-                 static_cast<void *>( stream ), &texture,
-                 static_cast<int32_t>( size ) ) )
+    std::vector<DecodedNativeTexture> decoded( texture_data.size() );
+    std::vector<uint8_t>              decode_result( texture_data.size() );
+    TextureDecodePool::Get().ParallelFor(
+        texture_data.size(),
+        [&]( uint64_t id )
+        {
+            decode_result[id] = RwNativeTextureReadCmd::Decode(
+                texture_data[id], decoded[id] );
+        } );
 
+    for ( size_t id = 0; id < decoded.size(); id++ )
+    {
+        if ( !decode_result[id] )
+        {
+            rh::debug::DebugLogger::Error( decoded[id].Error );
+            return nullptr;
+        }
+        RwTexture *texture = RwNativeTextureReadCmd::Submit( decoded[id] );
+        if ( texture == nullptr )
             return nullptr;
         rh::rw::engine::RwTexDictionaryAddTexture( result, texture );
     }
@@ -125,10 +216,15 @@ RwTexDictionary *rh::rw::engine::RwTexDictionaryStreamRead( void *stream )
 RwTexDictionary *
 rh::rw::engine::GTAReadTexDict( const rh::engine::String &fileName )
 {
-    std::ifstream stream( fileName, std::ios_base::in | std::ios_base::binary );
-
-    if ( !stream )
+    RwMappedFile file;
+    if ( !file.Open( fileName ) )
         return RwTexDictionaryCreate();
+    // mip levels are read straight from file mapping
+    RwMemoryStream stream( file.Data() );
+    RwChunkIndex   chunk_index;
+    chunk_index.Open( fileName, file.Data(),
+                      rh::engine::EngineConfigBlock::It.CacheChunkIndices );
+    stream.SetChunkIndex( &chunk_index );
 
     if ( !RwStreamFindChunk( &stream, 0x16, nullptr, nullptr ) )
         return RwTexDictionaryCreate();
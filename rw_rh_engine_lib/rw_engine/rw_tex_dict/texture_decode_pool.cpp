@@ -0,0 +1,85 @@
+//
+// Created by peter on 16.10.2026.
+//
+
+#include "texture_decode_pool.h"
+#include <algorithm>
+
+namespace rh::rw::engine
+{
+
+TextureDecodePool::TextureDecodePool( uint32_t worker_count )
+{
+    mWorkers.reserve( worker_count );
+    for ( uint32_t i = 0; i < worker_count; i++ )
+        mWorkers.emplace_back( [this]() { WorkerLoop(); } );
+}
+
+TextureDecodePool::~TextureDecodePool()
+{
+    {
+        std::lock_guard lock( mMutex );
+        mStopped = true;
+    }
+    mJobCond.notify_all();
+    for ( auto &worker : mWorkers )
+        worker.join();
+}
+
+TextureDecodePool &TextureDecodePool::Get()
+{
+    // never destroyed, workers may be terminated before static destructors
+    // run on process exit and would never be joined
+    static auto *pool = new TextureDecodePool(
+        ( std::max )( std::thread::hardware_concurrency(), 1u ) - 1 );
+    return *pool;
+}
+
+void TextureDecodePool::ParallelFor(
+    uint64_t count, const std::function<void( uint64_t )> &task )
+{
+    Job job{ .Task = &task, .Count = count };
+    if ( count > 1 && !mWorkers.empty() )
+    {
+        {
+            std::lock_guard lock( mMutex );
+            mJobs.push_back( &job );
+        }
+        mJobCond.notify_all();
+    }
+    RunJob( job );
+
+    // every id is taken once caller is done, job only has to wait for tasks
+    // that are still run by workers
+    std::unique_lock lock( mMutex );
+    std::erase( mJobs, &job );
+    mDoneCond.wait( lock, [&job]() { return job.Workers == 0; } );
+}
+
+void TextureDecodePool::RunJob( Job &job )
+{
+    for ( uint64_t id = job.NextId++; id < job.Count; id = job.NextId++ )
+        ( *job.Task )( id );
+}
+
+void TextureDecodePool::WorkerLoop()
+{
+    std::unique_lock lock( mMutex );
+    for ( ;; )
+    {
+        mJobCond.wait( lock, [this]() { return mStopped || !mJobs.empty(); } );
+        if ( mStopped )
+            return;
+        Job *job = mJobs.front();
+        job->Workers++;
+        lock.unlock();
+        RunJob( *job );
+        lock.lock();
+        // job has no ids left, other workers move on to the next one
+        std::erase( mJobs, job );
+        if ( --job->Workers == 0 )
+            mDoneCond.notify_all();
+    }
+}
+
+} // namespace rh::rw::engine
@@ -0,0 +1,65 @@
+//
+// Created by peter on 16.10.2026.
+//
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rh::rw::engine
+{
+/**
+ * Worker threads that decode textures of dictionaries being read. Threads
+ * are started once and wait for decode jobs, so reading a dictionary doesn't
+ * create threads. Several threads may run jobs at the same time, workers
+ * take them in submission order.
+ */
+class TextureDecodePool
+{
+  public:
+    explicit TextureDecodePool( uint32_t worker_count );
+    ~TextureDecodePool();
+    TextureDecodePool( const TextureDecodePool & )            = delete;
+    TextureDecodePool &operator=( const TextureDecodePool & ) = delete;
+
+    /**
+     * Pool with a worker per hardware thread besides the calling one,
+     * created on first use and kept until process exit
+     */
+    static TextureDecodePool &Get();
+
+    /**
+     * Runs task for every id in [0, count) on workers and calling thread
+     * and returns once every task is done
+     */
+    void ParallelFor( uint64_t                                count,
+                      const std::function<void( uint64_t )> &task );
+
+  private:
+    struct Job
+    {
+        const std::function<void( uint64_t )> *Task;
+        uint64_t                               Count;
+        std::atomic<uint64_t>                  NextId{ 0 };
+        /// workers running tasks of this job, guarded by pool mutex
+        uint32_t Workers = 0;
+    };
+
+    static void RunJob( Job &job );
+    void        WorkerLoop();
+
+    std::mutex              mMutex;
+    std::condition_variable mJobCond;
+    std::condition_variable mDoneCond;
+    /// jobs that may have ids left to take
+    std::deque<Job *>        mJobs;
+    bool                     mStopped = false;
+    std::vector<std::thread> mWorkers;
+};
+
+} // namespace rh::rw::engine
@@ -12,6 +12,16 @@
 #include <rw_engine/rw_rh_convert_funcs.h>
 #include <rw_engine/rw_stream/rw_stream.h>
 
+namespace
+{
+rh::rw::engine::RwTextureReadCallback gTextureReadCallback = nullptr;
+} // namespace
+
+void rh::rw::engine::RwTextureSetReadCallback( RwTextureReadCallback callback )
+{
+    gTextureReadCallback = callback;
+}
+
 RwTexture *rh::rw::engine::RwTextureCreate( RwRaster *raster )
 {
     auto *texture = hAlloc<RwTexture>( "Texture" );
@@ -177,12 +187,15 @@ RwTextureSetAutoMipmapping( TRUE );
     }
 
     /* Get the textures */
-    // if ( !( texture = nullptr /*RwTextureRead( textureName, textureMask )*/ )
-    // )
-    //{
-    RwStreamFindChunk( stream, rwID_EXTENSION, nullptr, nullptr );
-    return nullptr;
-    //}
+    texture = gTextureReadCallback != nullptr
+                  ? gTextureReadCallback( textureName.data(),
+                                          textureMask.data() )
+                  : nullptr;
+    if ( texture == nullptr )
+    {
+        RwStreamFindChunk( stream, rwID_EXTENSION, nullptr, nullptr );
+        return nullptr;
+    }
     //{
     //    /* Skip any extension chunks */
     //    _rwPluginRegistrySkipDataChunks( &textureTKList, stream );
@@ -16,6 +16,14 @@ enum class RwRenderShaderStage : uint32_t {
 
 RwTexture *RwTextureStreamRead( void *stream );
 
+using RwTextureReadCallback = RwTexture *(*)( const char *name,
+                                              const char *mask );
+/**
+ * Sets function used by RwTextureStreamRead to find textures of streamed
+ * materials, without it materials are read untextured
+ */
+void RwTextureSetReadCallback( RwTextureReadCallback callback );
+
 RwTexture *RwTextureCreate( RwRaster *raster );
 
 int32_t RwTextureDestroy( RwTexture *texture );
@@ -6,6 +6,8 @@
 #include "rw_device_system_globals.h"
 #include <Engine/Common/IDeviceState.h>
 #include <ipc/shared_memory_queue_client.h>
+#include <render_driver/gpu_resources/asset_streamer.h>
+#include <render_driver/gpu_resources/content_hash.h>
 #include <render_driver/gpu_resources/resource_mgr.h>
 #include <render_driver/render_driver.h>
 #include <rw_engine/rh_backend/mesh_rendering_backend.h>
@@ -13,6 +15,12 @@
 
 namespace rh::rw::engine
 {
+namespace
+{
+/// emissive triangle count written when client didn't look for them
+constexpr uint64_t gEmissiveTrianglesNotFound = ~0ull;
+} // namespace
+
 LoadMeshCmdImpl::LoadMeshCmdImpl( SharedMemoryTaskQueue &task_queue )
     : TaskQueue( task_queue )
 {
@@ -21,24 +29,14 @@ LoadMeshCmdImpl::LoadMeshCmdImpl( SharedMemoryTaskQueue &task_queue )
 uint64_t LoadMeshCmdImpl::Invoke( const BackendMeshInitData &mesh_data )
 {
     uint64_t result = 0xBADF00D;
-    TaskQueue.ExecuteTask(
+    // large meshes are sent in chunks, so they don't need to fit into
+    // shared memory
+    const uint64_t chunk_size = TaskQueue.TaskChunkSize();
+    TaskQueue.ExecuteChunkedTask(
         SharedMemoryTaskType::MESH_LOAD,
-        [&mesh_data]( MemoryWriter &&memory_writer ) {
+        [&mesh_data, chunk_size]( MemoryWriter &&memory_writer ) {
             // serialize
-            memory_writer.Write( &mesh_data.mVertexCount );
-            memory_writer.Write( &mesh_data.mIndexCount );
-
-            memory_writer.Write( mesh_data.mVertexData,
-                                 mesh_data.mVertexCount );
-            memory_writer.Write( mesh_data.mIndexData, mesh_data.mIndexCount );
-
-            uint32_t split_count = mesh_data.mSplits.size();
-            memory_writer.Write( &split_count );
-            memory_writer.Write( mesh_data.mSplits.data(), split_count );
-
-            uint32_t mat_count = mesh_data.mMaterials.size();
-            memory_writer.Write( &mat_count );
-            memory_writer.Write( mesh_data.mMaterials.data(), mat_count );
+            Serialize( memory_writer, mesh_data, chunk_size );
         },
         [&result]( MemoryReader &&memory_reader ) {
             // deserialize
@@ -47,19 +45,68 @@ uint64_t LoadMeshCmdImpl::Invoke( const BackendMeshInitData &mesh_data )
     return result;
 }
 
-void LoadMeshTaskImpl( void *memory )
+void LoadMeshCmdImpl::Serialize( MemoryWriter &             memory_writer,
+                                 const BackendMeshInitData &mesh_data,
+                                 uint64_t                   split_size )
 {
-    using namespace rh::engine;
-    assert( gRenderDriver );
-    auto &driver    = *gRenderDriver;
-    auto &device    = driver.GetDeviceState();
-    auto &resources = driver.GetResources();
-    auto &mesh_pool = resources.GetMeshPool();
+    memory_writer.Write( &mesh_data.mVertexCount );
+    memory_writer.Write( &mesh_data.mIndexCount );
+
+    memory_writer.WriteSplit( mesh_data.mVertexData, mesh_data.mVertexCount,
+                              split_size );
+    memory_writer.WriteSplit( mesh_data.mIndexData, mesh_data.mIndexCount,
+                              split_size );
 
-    uint64_t     mesh_id = 0;
-    MemoryWriter writer( memory );
-    MemoryReader reader( memory );
+    uint32_t split_count = mesh_data.mSplits.size();
+    memory_writer.Write( &split_count );
+    memory_writer.Write( mesh_data.mSplits.data(), split_count );
 
+    uint32_t mat_count = mesh_data.mMaterials.size();
+    memory_writer.Write( &mat_count );
+    memory_writer.Write( mesh_data.mMaterials.data(), mat_count );
+
+    uint64_t emissive_count = mesh_data.mEmissiveTriangles != nullptr
+                                  ? mesh_data.mEmissiveTriangleCount
+                                  : gEmissiveTrianglesNotFound;
+    memory_writer.Write( &emissive_count );
+    if ( mesh_data.mEmissiveTriangles != nullptr )
+        memory_writer.WriteSplit( mesh_data.mEmissiveTriangles,
+                                  emissive_count, split_size );
+}
+
+uint64_t LoadMeshCmdImpl::PayloadSize( const BackendMeshInitData &mesh_data )
+{
+    return 2 * sizeof( uint64_t ) +
+           mesh_data.mVertexCount * sizeof( VertexDescPosColorUVNormals ) +
+           mesh_data.mIndexCount * sizeof( uint16_t ) + sizeof( uint32_t ) +
+           mesh_data.mSplits.size() * sizeof( GeometrySplit ) +
+           sizeof( uint32_t ) +
+           mesh_data.mMaterials.size() * sizeof( GeometryMaterial ) +
+           sizeof( uint64_t ) +
+           ( mesh_data.mEmissiveTriangles != nullptr
+                 ? mesh_data.mEmissiveTriangleCount * sizeof( PackedLight )
+                 : 0 );
+}
+
+void LoadMeshCmdImpl::ReadPayload( MemoryReader &reader, AssetPayload &payload )
+{
+    const auto vertex_count = payload.Copy<uint64_t>( reader );
+    const auto index_count  = payload.Copy<uint64_t>( reader );
+    payload.CopyArray<VertexDescPosColorUVNormals>( reader, vertex_count );
+    payload.CopyArray<uint16_t>( reader, index_count );
+    const auto split_count = payload.Copy<uint32_t>( reader );
+    payload.CopyArray<GeometrySplit>( reader, split_count );
+    const auto material_count = payload.Copy<uint32_t>( reader );
+    payload.CopyArray<GeometryMaterial>( reader, material_count );
+    const auto emissive_count = payload.Copy<uint64_t>( reader );
+    if ( emissive_count != gEmissiveTrianglesNotFound )
+        payload.CopyArray<PackedLight>( reader, emissive_count );
+}
+
+namespace
+{
+BackendMeshInitData ReadInitData( MemoryReader &reader )
+{
     BackendMeshInitData init_data{};
     init_data.mVertexCount = *reader.Read<uint64_t>();
     init_data.mIndexCount  = *reader.Read<uint64_t>();
@@ -81,29 +128,75 @@ void LoadMeshTaskImpl( void *memory )
     init_data.mMaterials.reserve( material_count );
     std::ranges::copy( materials, std::back_inserter( init_data.mMaterials ) );
 
+    const auto emissive_count = *reader.Read<uint64_t>();
+    if ( emissive_count != gEmissiveTrianglesNotFound )
+    {
+        init_data.mEmissiveTriangles =
+            reader.Read<PackedLight>( emissive_count );
+        init_data.mEmissiveTriangleCount = emissive_count;
+    }
+    return init_data;
+}
+
+BackendMeshData CreateMesh( BackendMeshInitData &&     init_data,
+                            std::vector<PackedLight> &&emissive_triangles )
+{
+    using namespace rh::engine;
+    assert( gRenderDriver );
+    auto &device       = gRenderDriver->GetDeviceState();
+    auto &buffer_cache = gRenderDriver->GetResources().GetMeshBufferCache();
+
+    BackendMeshData backend_mesh_data{};
+    backend_mesh_data.mVertexCount = init_data.mVertexCount;
+    backend_mesh_data.mIndexCount  = init_data.mIndexCount;
+    backend_mesh_data.mSplits      = std::move( init_data.mSplits );
+    backend_mesh_data.mMaterials   = std::move( init_data.mMaterials );
+
+    backend_mesh_data.EmissiveTriangles = std::move( emissive_triangles );
+
+    // identical meshes share buffers, their BLAS is shared as well
+    const uint64_t      vertex_size =
+        init_data.mVertexCount * sizeof( VertexDescPosColorUVNormals );
+    const uint64_t      index_size = init_data.mIndexCount * sizeof( uint16_t );
+    const MeshBufferKey buffer_key{
+        .VertexHash  = HashContent( init_data.mVertexData, vertex_size ),
+        .IndexHash   = HashContent( init_data.mIndexData, index_size ),
+        .VertexCount = init_data.mVertexCount,
+        .IndexCount  = init_data.mIndexCount };
+    if ( buffer_cache.Acquire( buffer_key, backend_mesh_data ) )
+        return backend_mesh_data;
+
     BufferCreateInfo ib_info{};
-    ib_info.mSize  = init_data.mIndexCount * sizeof( uint16_t );
+    ib_info.mSize  = index_size;
     ib_info.mUsage = BufferUsage::IndexBuffer | BufferUsage::StorageBuffer;
-    ib_info.mInitDataPtr = init_data.mIndexData;
+    // init data is only read
+    ib_info.mInitDataPtr = const_cast<uint16_t *>( init_data.mIndexData );
 
     BufferCreateInfo vb_info{};
-    vb_info.mSize =
-        init_data.mVertexCount * sizeof( VertexDescPosColorUVNormals );
+    vb_info.mSize  = vertex_size;
     vb_info.mUsage = BufferUsage::VertexBuffer | BufferUsage::StorageBuffer;
-    vb_info.mInitDataPtr = init_data.mVertexData;
+    vb_info.mInitDataPtr =
+        const_cast<VertexDescPosColorUVNormals *>( init_data.mVertexData );
 
-    BackendMeshData backend_mesh_data{};
     backend_mesh_data.mIndexBuffer =
         new RefCountedBuffer( device.CreateBuffer( ib_info ) );
     backend_mesh_data.mVertexBuffer =
         new RefCountedBuffer( device.CreateBuffer( vb_info ) );
+    buffer_cache.Insert( buffer_key, backend_mesh_data );
+    return backend_mesh_data;
+}
+} // namespace
 
-    backend_mesh_data.mVertexCount = init_data.mVertexCount;
-    backend_mesh_data.mIndexCount  = init_data.mIndexCount;
-    backend_mesh_data.mSplits      = std::move( init_data.mSplits );
-    backend_mesh_data.mMaterials   = std::move( init_data.mMaterials );
+std::vector<PackedLight>
+LoadMeshCmdImpl::FindEmissiveTriangles( const BackendMeshInitData &init_data )
+{
+    if ( init_data.mEmissiveTriangles != nullptr )
+        return { init_data.mEmissiveTriangles,
+                 init_data.mEmissiveTriangles +
+                     init_data.mEmissiveTriangleCount };
 
-    backend_mesh_data.EmissiveTriangles.reserve( init_data.mIndexCount / 3 );
+    std::vector<PackedLight> emissive_triangles;
+    emissive_triangles.reserve( init_data.mIndexCount / 3 );
     for ( auto tri_id = 0; tri_id < init_data.mIndexCount / 3; tri_id++ )
     {
         auto idx_a = init_data.mIndexData[tri_id * 3 + 0],
@@ -126,11 +219,41 @@ void LoadMeshTaskImpl( void *memory )
         tri_light.Triangle.Intensity = init_data.mVertexData[idx_a].emissive;
         //
         if ( init_data.mVertexData[idx_a].emissive > 0 )
-            backend_mesh_data.EmissiveTriangles.push_back( tri_light );
+            emissive_triangles.push_back( tri_light );
     }
 
-    mesh_id = mesh_pool.RequestResource( std::move( backend_mesh_data ) );
+    return emissive_triangles;
+}
+
+std::vector<PackedLight>
+LoadMeshCmdImpl::FindEmissiveTriangles( MemoryReader &&reader )
+{
+    return FindEmissiveTriangles( ReadInitData( reader ) );
+}
+
+BackendMeshData LoadMeshCmdImpl::CreateResource( MemoryReader &&reader )
+{
+    auto init_data          = ReadInitData( reader );
+    auto emissive_triangles = FindEmissiveTriangles( init_data );
+    return CreateMesh( std::move( init_data ),
+                       std::move( emissive_triangles ) );
+}
+
+BackendMeshData
+LoadMeshCmdImpl::CreateResource( MemoryReader &&           reader,
+                                 std::vector<PackedLight> &&emissive_triangles )
+{
+    return CreateMesh( ReadInitData( reader ),
+                       std::move( emissive_triangles ) );
+}
+
+void LoadMeshTaskImpl( MemoryReader &&reader, MemoryWriter &&writer )
+{
+    assert( gRenderDriver );
+    auto &mesh_pool = gRenderDriver->GetResources().GetMeshPool();
 
+    uint64_t mesh_id = mesh_pool.RequestResource(
+        LoadMeshCmdImpl::CreateResource( std::move( reader ) ) );
     writer.Write( &mesh_id );
 }
 
@@ -8,17 +8,46 @@
 #include <cstdint>
 #include <functional>
 #include <span>
+#include <vector>
 
 namespace rh::rw::engine
 {
 class SharedMemoryTaskQueue;
+class MemoryReader;
+class MemoryWriter;
+class AssetPayload;
 struct BackendMeshInitData;
+struct BackendMeshData;
+struct PackedLight;
 class LoadMeshCmdImpl
 {
   public:
     LoadMeshCmdImpl( SharedMemoryTaskQueue &task_queue );
     uint64_t    Invoke( const BackendMeshInitData &init_data );
     static void RegisterCallHandler( SharedMemoryTaskQueue &task_queue );
+    /**
+     * Writes mesh task payload, vertex and index arrays are split into parts
+     * of at most split_size bytes
+     */
+    static void     Serialize( MemoryWriter &             writer,
+                               const BackendMeshInitData &init_data,
+                               uint64_t                   split_size );
+    static uint64_t PayloadSize( const BackendMeshInitData &init_data );
+    /// Copies task payload, so it can be uploaded after the task is done
+    static void ReadPayload( MemoryReader &reader, AssetPayload &payload );
+    /// Emissive triangles of the mesh in task payload, may be called from
+    /// any thread
+    static std::vector<PackedLight>
+    FindEmissiveTriangles( MemoryReader &&reader );
+    /// Emissive triangles of the mesh, found ones are copied if mesh has
+    /// them
+    static std::vector<PackedLight>
+    FindEmissiveTriangles( const BackendMeshInitData &init_data );
+    /// Creates mesh from task payload, render driver thread only
+    static BackendMeshData CreateResource( MemoryReader &&reader );
+    static BackendMeshData
+    CreateResource( MemoryReader &&            reader,
+                    std::vector<PackedLight> &&emissive_triangles );
 
   private:
     SharedMemoryTaskQueue &TaskQueue;
@@ -18,11 +18,11 @@ UnloadMeshCmdImpl::UnloadMeshCmdImpl( SharedMemoryTaskQueue &task_queue )
 
 bool UnloadMeshCmdImpl::Invoke( uint64_t id )
 {
-    TaskQueue.ExecuteTask( SharedMemoryTaskType::MESH_UNLOAD,
-                           [&id]( MemoryWriter &&memory_writer ) {
-                               // serialize
-                               memory_writer.Write( &id );
-                           } );
+    TaskQueue.PostTask( SharedMemoryTaskType::MESH_UNLOAD,
+                        [id]( MemoryWriter &&memory_writer ) {
+                            // serialize
+                            memory_writer.Write( &id );
+                        } );
     return true;
 }
 
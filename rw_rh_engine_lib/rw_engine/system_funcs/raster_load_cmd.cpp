@@ -6,6 +6,8 @@
 
 #include <Engine/Common/IDeviceState.h>
 #include <ipc/shared_memory_queue_client.h>
+#include <render_driver/gpu_resources/asset_streamer.h>
+#include <render_driver/gpu_resources/content_hash.h>
 #include <render_driver/gpu_resources/resource_mgr.h>
 #include <render_driver/render_driver.h>
 #include <rw_engine/rh_backend/raster_backend.h>
@@ -21,7 +23,9 @@ uint64_t RasterLoadCmdImpl::Invoke( const RasterHeader &header,
                                     WriteMipLevelFunc   write_mip_level )
 {
     uint64_t result_raster = BackendRasterPlugin::NullRasterId;
-    TaskQueue.ExecuteTask(
+    // mip chain is sent in chunks, so raster doesn't need to fit into
+    // shared memory; mip level header may be filled after its data
+    TaskQueue.ExecuteChunkedTask(
         SharedMemoryTaskType::RASTER_LOAD,
         [&header, &write_mip_level]( MemoryWriter &&writer ) {
             // serialize
@@ -36,22 +40,32 @@ uint64_t RasterLoadCmdImpl::Invoke( const RasterHeader &header,
     return result_raster;
 }
 
-void LoadTextureTaskImpl( void *memory )
+void RasterLoadCmdImpl::ReadPayload( MemoryReader &reader,
+                                     AssetPayload &payload )
+{
+    const auto header = payload.Copy<RasterHeader>( reader );
+    for ( uint32_t i = 0; i < header.mMipLevelCount; i++ )
+    {
+        const auto mip_level_header = payload.Copy<MipLevelHeader>( reader );
+        payload.CopyArray<char>( reader, mip_level_header.mSize );
+    }
+}
+
+RasterData RasterLoadCmdImpl::CreateResource( MemoryReader &&reader )
 {
     using namespace rh::engine;
     assert( gRenderDriver );
     auto &driver = *gRenderDriver;
 
-    uint64_t     raster_id = 0;
-    MemoryWriter writer( memory );
-    MemoryReader reader( memory );
-
     auto header = *reader.Read<RasterHeader>();
 
     std::vector<ImageBufferInitData> buffer_init_data;
     buffer_init_data.reserve( header.mMipLevelCount );
 
     uint32_t non_zero_mip_lvl = 0;
+    // identical textures embedded into several TXDs share a single image
+    RasterImageKey image_key{
+        .ContentHash = HashContent( &header, sizeof( RasterHeader ) ) };
 
     for ( uint32_t i = 0; i < header.mMipLevelCount; i++ )
     {
@@ -62,11 +76,23 @@ void LoadTextureTaskImpl( void *memory )
         mip_data.mStride = mip_level_header.mStride;
         mip_data.mData   = reader.Read<char>( mip_level_header.mSize );
 
+        image_key.ContentHash =
+            HashContent( &mip_level_header, sizeof( MipLevelHeader ),
+                         image_key.ContentHash );
+        image_key.ContentHash = HashContent( mip_data.mData, mip_data.mSize,
+                                             image_key.ContentHash );
+        image_key.Size += mip_data.mSize;
+
         buffer_init_data.push_back( mip_data );
         if ( mip_data.mSize != 0 )
             non_zero_mip_lvl++;
     }
 
+    auto      &image_cache = driver.GetResources().GetRasterImageCache();
+    RasterData result_data{};
+    if ( image_cache.Acquire( image_key, result_data ) )
+        return result_data;
+
     auto format = static_cast<ImageBufferFormat>( header.mFormat );
     ImageBufferCreateParams image_buffer_ci{ .mDimension = ImageDimensions::d2D,
                                              .mFormat    = format,
@@ -76,11 +102,8 @@ void LoadTextureTaskImpl( void *memory )
                                              .mMipLevels = non_zero_mip_lvl,
                                              .mPreinitData = buffer_init_data };
 
-    auto &device      = driver.GetDeviceState();
-    auto &resources   = driver.GetResources();
-    auto &raster_pool = resources.GetRasterPool();
+    auto &device = driver.GetDeviceState();
 
-    RasterData result_data{};
     result_data.mImageBuffer = device.CreateImageBuffer( image_buffer_ci );
 
     ImageViewCreateInfo shader_view_ci{ .mBuffer = result_data.mImageBuffer,
@@ -89,8 +112,17 @@ void LoadTextureTaskImpl( void *memory )
                                             ImageViewUsage::ShaderResource,
                                         .mLevelCount = non_zero_mip_lvl };
     result_data.mImageView = device.CreateImageView( shader_view_ci );
+    image_cache.Insert( image_key, result_data );
+    return result_data;
+}
+
+void LoadTextureTaskImpl( MemoryReader &&reader, MemoryWriter &&writer )
+{
+    assert( gRenderDriver );
+    auto &raster_pool = gRenderDriver->GetResources().GetRasterPool();
 
-    raster_id = raster_pool.RequestResource( result_data );
+    uint64_t raster_id = raster_pool.RequestResource(
+        RasterLoadCmdImpl::CreateResource( std::move( reader ) ) );
     writer.Write( &raster_id );
 }
 
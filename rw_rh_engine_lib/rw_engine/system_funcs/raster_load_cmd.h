@@ -12,8 +12,11 @@ namespace rh::rw::engine
 {
 class SharedMemoryTaskQueue;
 struct RasterHeader;
+class MemoryReader;
 class MemoryWriter;
+class AssetPayload;
 struct MipLevelHeader;
+struct RasterData;
 class RasterLoadCmdImpl
 {
     using WriteMipLevelFunc =
@@ -24,6 +27,10 @@ class RasterLoadCmdImpl
     uint64_t    Invoke( const RasterHeader &header,
                         WriteMipLevelFunc   write_mip_level );
     static void RegisterCallHandler( SharedMemoryTaskQueue &task_queue );
+    /// Copies task payload, so it can be uploaded after the task is done
+    static void ReadPayload( MemoryReader &reader, AssetPayload &payload );
+    /// Creates raster from task payload, render driver thread only
+    static RasterData CreateResource( MemoryReader &&reader );
 
   private:
     SharedMemoryTaskQueue &TaskQueue;
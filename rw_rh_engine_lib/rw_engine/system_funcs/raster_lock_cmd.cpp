@@ -6,6 +6,7 @@
 #include "rw_device_system_globals.h"
 
 #include <render_client/render_client.h>
+#include <render_driver/gpu_resources/asset_streamer.h>
 #include <render_driver/gpu_resources/resource_mgr.h>
 #include <render_driver/render_driver.h>
 #include <rw_engine/rh_backend/raster_backend.h>
@@ -47,6 +48,9 @@ void RasterLockCallback( void *memory )
     MemoryWriter writer( memory );
 
     RasterLockParams params = *reader.Read<RasterLockParams>();
+    // streamed raster is read back, so it has to be uploaded first
+    if ( raster_pool.IsPending( params.mImageId ) )
+        gRenderDriver->GetAssetStreamer().Flush();
 
     RasterLockResultData result{};
     result.mLockDataStride = 4 * params.mWidth;
@@ -19,11 +19,11 @@ RasterDestroyCmdImpl::RasterDestroyCmdImpl( SharedMemoryTaskQueue &task_queue )
 
 bool RasterDestroyCmdImpl::Invoke( uint64_t raster_id )
 {
-    TaskQueue.ExecuteTask( SharedMemoryTaskType::RASTER_UNLOAD,
-                           [&raster_id]( MemoryWriter &&memory_writer ) {
-                               // serialize
-                               memory_writer.Write( &raster_id );
-                           } );
+    TaskQueue.PostTask( SharedMemoryTaskType::RASTER_UNLOAD,
+                        [raster_id]( MemoryWriter &&memory_writer ) {
+                            // serialize
+                            memory_writer.Write( &raster_id );
+                        } );
     return true;
 }
 
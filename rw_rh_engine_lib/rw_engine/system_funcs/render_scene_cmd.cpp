@@ -4,15 +4,21 @@
 
 #include "render_scene_cmd.h"
 #include "rw_device_system_globals.h"
+#include <DebugUtils/DebugLogger.h>
 #include <Engine/Common/IDeviceState.h>
 #include <Engine/Common/ISwapchain.h>
+#include <Engine/EngineConfigBlock.h>
 #include <data_desc/frame_info.h>
+#include <data_desc/frame_packet.h>
 #include <ipc/shared_memory_queue_client.h>
+#include <ipc/shared_memory_segment_pool.h>
 #include <render_client/imgui_state_recorder.h>
 #include <render_client/render_client.h>
 #include <render_driver/gpu_resources/resource_mgr.h>
 #include <render_driver/render_driver.h>
 
+#include <algorithm>
+
 namespace rh::rw::engine
 {
 
@@ -45,15 +51,66 @@ T ReadChainBlock( MemoryReader &reader )
 void SerializeDrawCalls( MemoryWriter &&writer )
 {
     auto &state = gRenderClient->RenderState;
+    auto &arena = gRenderClient->GetFrameArena();
 
+    // recorded arrays are already in the frame packet, task payload only
+    // references them. Recorders may still grow their arrays while
+    // serializing, so packet header is written last
+    auto &header = writer.Current<FramePacketHeader>();
+    writer.Skip( sizeof( FramePacketHeader ) );
     writer.Write( &state.ImGuiInputState );
     writer.Write( &state.ViewportState );
     writer.Write( &state.SkyState );
-    state.Lights.Serialize( writer );
-    state.Im2D.Serialize( writer );
-    state.Im3D.Serialize( writer );
-    state.MeshDrawCalls.Serialize( writer );
-    state.SkinMeshDrawCalls.Serialize( writer );
+    state.Lights.Serialize( writer, arena );
+    state.Im2D.Serialize( writer, arena );
+    state.Im3D.Serialize( writer, arena );
+    state.MeshDrawCalls.Serialize( writer, arena );
+    state.SkinMeshDrawCalls.Serialize( writer, arena );
+    header = arena.Header();
+}
+
+uint64_t RenderSceneCmd::PublishFrame()
+{
+    auto &         in_flight_frames = gRenderClient->InFlightFrames;
+    const uint32_t max_frames_ahead =
+        rh::engine::EngineConfigBlock::It.MaxFramesAhead;
+
+    // meshes created since the last frame are sent ahead of it, render
+    // driver uploads them between frames
+    if ( auto *mesh_batch = gRenderClient->GetMeshLoadBatch() )
+        mesh_batch->Flush();
+
+    // back-pressure: wait for the oldest frames if driver is too far behind
+    while ( in_flight_frames.size() >= std::max( max_frames_ahead, 1u ) )
+    {
+        TaskQueue.WaitForTask( in_flight_frames.front() );
+        in_flight_frames.pop_front();
+    }
+
+    // frame packet is consumed in place by render driver, so we don't have to
+    // wait for it to be rendered
+    auto frame = TaskQueue.SubmitTask( SharedMemoryTaskType::RENDER,
+                                       SerializeDrawCalls );
+    in_flight_frames.push_back( frame );
+    TaskQueue.TrimOverflowSegments();
+
+    // report high-water mark growth in 1 MB steps
+    constexpr uint64_t report_step     = 1024 * 1024;
+    const auto &       stats           = TaskQueue.GetStats();
+    auto               frame_size      = stats.LastTaskSize;
+    auto &             high_water_mark = gRenderClient->FrameSizeHighWaterMark;
+    if ( frame_size / report_step > high_water_mark / report_step )
+        debug::DebugLogger::LogFmt(
+            "Frame size high-water mark: %llu KB, frames larger than %llu KB "
+            "are spilled into overflow segments, %llu KB of them are mapped",
+            debug::LogLevel::Info,
+            static_cast<unsigned long long>( frame_size / 1024 ),
+            static_cast<unsigned long long>(
+                TaskQueue.MaxInlinePayloadSize() / 1024 ),
+            static_cast<unsigned long long>( stats.OverflowMemorySize /
+                                             1024 ) );
+    high_water_mark = ( std::max )( high_water_mark, frame_size );
+    return frame;
 }
 
 bool RenderSceneCmd::Invoke()
@@ -62,6 +119,9 @@ bool RenderSceneCmd::Invoke()
     auto &      state          = gRenderClient->RenderState;
     static auto key_ctrl_state = 0;
     bool        was_paused     = false;
+    uint64_t    frame          = 0;
+    auto        max_frames_ahead =
+        rh::engine::EngineConfigBlock::It.MaxFramesAhead;
 
     /// Debug Pause Loop, allows to stop execution for a moment and change some
     /// values
@@ -80,8 +140,10 @@ bool RenderSceneCmd::Invoke()
         if ( key_ctrl_state < 0 )
             key_ctrl_state = 0;
 
-        TaskQueue.ExecuteTask( SharedMemoryTaskType::RENDER,
-                               SerializeDrawCalls );
+        frame = PublishFrame();
+        // pause loop has nothing to simulate, so it renders synchronously
+        if ( max_frames_ahead == 0 || state.ImGuiInputState.EnablePause )
+            TaskQueue.WaitForTask( frame );
         if ( state.ImGuiInputState.EnablePause )
         {
             MSG msg;
@@ -114,11 +176,11 @@ bool RenderSceneCmd::Invoke()
                 result = ::ShowCursor( false );
         }
     }
-    gRenderClient->RenderState.Im2D.Flush();
-    gRenderClient->RenderState.Im3D.Flush();
-    gRenderClient->RenderState.MeshDrawCalls.Flush();
-    gRenderClient->RenderState.SkinMeshDrawCalls.Flush();
-    gRenderClient->RenderState.Lights.Flush();
+    // packet stays with render driver until the frame is rendered, next frame
+    // is recorded into another one
+    auto &arena = gRenderClient->GetFrameArena();
+    arena.End( frame );
+    state.BeginFrame( arena );
     return true;
 }
 
@@ -127,14 +189,35 @@ void Render( rh::engine::IWindow &window, rh::engine::IDeviceState &device,
 {
 }
 
-void RenderSceneTaskImpl( void *memory )
+void RenderSceneTaskImpl( MemoryReader &&reader, MemoryWriter && )
 {
     using namespace rh::engine;
     assert( gRenderDriver );
     auto &driver = *gRenderDriver;
 
-    MemoryReader reader( memory );
-    FrameState   state = FrameState::Deserialize( reader );
+    const auto      header = *reader.Read<FramePacketHeader>();
+    FramePacketView packet{};
+    if ( header.SegmentId != gNoOverflowSegment )
+    {
+        auto *segment =
+            driver.GetTaskQueue().ResolveSegment( header.SegmentId );
+        if ( segment == nullptr )
+        {
+            debug::DebugLogger::ErrorFmt(
+                "Failed to resolve frame packet segment %u, frame skipped",
+                header.SegmentId );
+            return;
+        }
+        packet.Base = SharedMemorySegmentPool::Data( segment );
+        packet.Size = ( std::min )( header.Size, segment->Capacity );
+        // only the used part of the packet is captured
+        if ( driver.GetTaskQueue().IsCapturing() )
+            driver.GetTaskQueue().CaptureSegment( header.SegmentId,
+                                                  packet.Base, packet.Size );
+    }
+
+    FrameState state = FrameState::Deserialize(
+        reader, packet, driver.GetMeshInstanceTable() );
 
     driver.DrawFrame( state );
 }
@@ -19,6 +19,9 @@ class RenderSceneCmd
     static void RegisterCallHandler( SharedMemoryTaskQueue &task_queue );
 
   private:
+    /// Publishes current frame packet, waits only if too many frames are
+    /// in flight
+    uint64_t               PublishFrame();
     SharedMemoryTaskQueue &TaskQueue;
 };
 } // namespace rh::rw::engine
\ No newline at end of file
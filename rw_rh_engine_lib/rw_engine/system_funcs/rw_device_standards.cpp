@@ -29,7 +29,7 @@ std::map<RwDeviceStandardFn, RwStandardFunc> GetStandardMap()
           []( void *pOut, void *pInOut, int32_t nI ) -> int32_t
           {
               debug::DebugLogger::Log(
-                  std::string( "RWGAMEHOOKS_LOG: rwSTANDARDNASTANDARD" ) );
+                  "RWGAMEHOOKS_LOG: rwSTANDARDNASTANDARD" );
               return 1;
           } },
         { rwSTANDARDCAMERABEGINUPDATE,
@@ -42,14 +42,14 @@ std::map<RwDeviceStandardFn, RwStandardFunc> GetStandardMap()
           []( void *pOut, void *pInOut, int32_t nI ) -> int32_t
           {
               debug::DebugLogger::Log(
-                  std::string( "RWGAMEHOOKS_LOG: rwSTANDARDRGBTOPIXEL" ) );
+                  "RWGAMEHOOKS_LOG: rwSTANDARDRGBTOPIXEL" );
               return 1;
           } },
         { rwSTANDARDPIXELTORGB,
           []( void *pOut, void *pInOut, int32_t nI ) -> int32_t
           {
               debug::DebugLogger::Log(
-                  std::string( "RWGAMEHOOKS_LOG: rwSTANDARDPIXELTORGB" ) );
+                  "RWGAMEHOOKS_LOG: rwSTANDARDPIXELTORGB" );
               return 1;
           } },
         { rwSTANDARDRASTERCREATE,
@@ -68,7 +68,7 @@ std::map<RwDeviceStandardFn, RwStandardFunc> GetStandardMap()
           []( void *pOut, void *pInOut, int32_t nI ) -> int32_t
           {
               debug::DebugLogger::Log(
-                  std::string( "RWGAMEHOOKS_LOG: rwSTANDARDIMAGEGETRASTER" ) );
+                  "RWGAMEHOOKS_LOG: rwSTANDARDIMAGEGETRASTER" );
               return 1;
           } },
         { rwSTANDARDRASTERSETIMAGE,
@@ -82,8 +82,8 @@ std::map<RwDeviceStandardFn, RwStandardFunc> GetStandardMap()
         { rwSTANDARDTEXTURESETRASTER,
           []( void *pOut, void *pInOut, int32_t nI ) -> int32_t
           {
-              debug::DebugLogger::Log( std::string(
-                  "RWGAMEHOOKS_LOG: rwSTANDARDTEXTURESETRASTER" ) );
+              debug::DebugLogger::Log(
+                  "RWGAMEHOOKS_LOG: rwSTANDARDTEXTURESETRASTER" );
               return 1;
           } },
         { rwSTANDARDIMAGEFINDRASTERFORMAT,
@@ -104,29 +104,29 @@ std::map<RwDeviceStandardFn, RwStandardFunc> GetStandardMap()
         { rwSTANDARDSETRASTERCONTEXT,
           []( void *pOut, void *pInOut, int32_t nI ) -> int32_t
           {
-              debug::DebugLogger::Log( std::string(
-                  "RWGAMEHOOKS_LOG: rwSTANDARDSETRASTERCONTEXT" ) );
+              debug::DebugLogger::Log(
+                  "RWGAMEHOOKS_LOG: rwSTANDARDSETRASTERCONTEXT" );
               return 1;
           } },
         { rwSTANDARDRASTERSUBRASTER,
           []( void *pOut, void *pInOut, int32_t nI ) -> int32_t
           {
               debug::DebugLogger::Log(
-                  std::string( "RWGAMEHOOKS_LOG: rwSTANDARDRASTERSUBRASTER" ) );
+                  "RWGAMEHOOKS_LOG: rwSTANDARDRASTERSUBRASTER" );
               return 1;
           } },
         { rwSTANDARDRASTERCLEARRECT,
           []( void *pOut, void *pInOut, int32_t nI ) -> int32_t
           {
               debug::DebugLogger::Log(
-                  std::string( "RWGAMEHOOKS_LOG: rwSTANDARDRASTERCLEARRECT" ) );
+                  "RWGAMEHOOKS_LOG: rwSTANDARDRASTERCLEARRECT" );
               return 1;
           } },
         { rwSTANDARDRASTERCLEAR,
           []( void *pOut, void *pInOut, int32_t nI ) -> int32_t
           {
               debug::DebugLogger::Log(
-                  std::string( "RWGAMEHOOKS_LOG: rwSTANDARDRASTERCLEAR" ) );
+                  "RWGAMEHOOKS_LOG: rwSTANDARDRASTERCLEAR" );
               return 1;
           } },
         { rwSTANDARDRASTERLOCK,
@@ -146,21 +146,21 @@ std::map<RwDeviceStandardFn, RwStandardFunc> GetStandardMap()
           []( void *pOut, void *pInOut, int32_t nI ) -> int32_t
           {
               debug::DebugLogger::Log(
-                  std::string( "RWGAMEHOOKS_LOG: rwSTANDARDRASTERRENDER" ) );
+                  "RWGAMEHOOKS_LOG: rwSTANDARDRASTERRENDER" );
               return 1;
           } },
         { rwSTANDARDRASTERRENDERSCALED,
           []( void *pOut, void *pInOut, int32_t nI ) -> int32_t
           {
-              debug::DebugLogger::Log( std::string(
-                  "RWGAMEHOOKS_LOG: rwSTANDARDRASTERRENDERSCALED" ) );
+              debug::DebugLogger::Log(
+                  "RWGAMEHOOKS_LOG: rwSTANDARDRASTERRENDERSCALED" );
               return 1;
           } },
         { rwSTANDARDRASTERRENDERFAST,
           []( void *pOut, void *pInOut, int32_t nI ) -> int32_t
           {
-              debug::DebugLogger::Log( std::string(
-                  "RWGAMEHOOKS_LOG: rwSTANDARDRASTERRENDERFAST" ) );
+              debug::DebugLogger::Log(
+                  "RWGAMEHOOKS_LOG: rwSTANDARDRASTERRENDERFAST" );
               return 1;
           } },
         { rwSTANDARDRASTERSHOWRASTER,
@@ -187,22 +187,22 @@ std::map<RwDeviceStandardFn, RwStandardFunc> GetStandardMap()
         { rwSTANDARDRASTERLOCKPALETTE,
           []( void *pOut, void *pInOut, int32_t nI ) -> int32_t
           {
-              debug::DebugLogger::Log( std::string(
-                  "RWGAMEHOOKS_LOG: rwSTANDARDRASTERLOCKPALETTE" ) );
+              debug::DebugLogger::Log(
+                  "RWGAMEHOOKS_LOG: rwSTANDARDRASTERLOCKPALETTE" );
               return 1;
           } },
         { rwSTANDARDRASTERUNLOCKPALETTE,
           []( void *pOut, void *pInOut, int32_t nI ) -> int32_t
           {
-              debug::DebugLogger::Log( std::string(
-                  "RWGAMEHOOKS_LOG: rwSTANDARDRASTERUNLOCKPALETTE" ) );
+              debug::DebugLogger::Log(
+                  "RWGAMEHOOKS_LOG: rwSTANDARDRASTERUNLOCKPALETTE" );
               return 1;
           } },
         { rwSTANDARDNATIVETEXTUREGETSIZE,
           []( void *pOut, void *pInOut, int32_t nI ) -> int32_t
           {
-              debug::DebugLogger::Log( std::string(
-                  "RWGAMEHOOKS_LOG: rwSTANDARDNATIVETEXTUREGETSIZE" ) );
+              debug::DebugLogger::Log(
+                  "RWGAMEHOOKS_LOG: rwSTANDARDNATIVETEXTUREGETSIZE" );
               RwNativeTextureGetSizeCmd cmd(
                   static_cast<RwTexture *>( pInOut ) );
               return cmd.Execute( *static_cast<uint32_t *>( pOut ) );
@@ -210,8 +210,9 @@ std::map<RwDeviceStandardFn, RwStandardFunc> GetStandardMap()
         { rwSTANDARDNATIVETEXTUREREAD,
           []( void *pOut, void *pInOut, int32_t nI ) -> int32_t
           {
-              debug::DebugLogger::Log( std::string(
-                  "RWGAMEHOOKS_LOG: rwSTANDARDNATIVETEXTUREREAD" ) );
+              debug::DebugLogger::LogFormat(
+                  debug::LogLevel::Info,
+                  "RWGAMEHOOKS_LOG: rwSTANDARDNATIVETEXTUREREAD" );
 
               RwNativeTextureReadCmd cmd( static_cast<RwStream *>( pOut ),
                                           static_cast<RwTexture **>( pInOut ) );
@@ -220,8 +221,8 @@ std::map<RwDeviceStandardFn, RwStandardFunc> GetStandardMap()
         { rwSTANDARDNATIVETEXTUREWRITE,
           []( void *pOut, void *pInOut, int32_t nI ) -> int32_t
           {
-              debug::DebugLogger::Log( std::string(
-                  "RWGAMEHOOKS_LOG: rwSTANDARDNATIVETEXTUREWRITE" ) );
+              debug::DebugLogger::Log(
+                  "RWGAMEHOOKS_LOG: rwSTANDARDNATIVETEXTUREWRITE" );
               RwNativeTextureWriteCmd cmd( static_cast<RwStream *>( pOut ),
                                            static_cast<RwTexture *>( pInOut ) );
               return cmd.Execute();
@@ -229,8 +230,8 @@ std::map<RwDeviceStandardFn, RwStandardFunc> GetStandardMap()
         { rwSTANDARDRASTERGETMIPLEVELS,
           []( void *pOut, void *pInOut, int32_t nI ) -> int32_t
           {
-              debug::DebugLogger::Log( std::string(
-                  "RWGAMEHOOKS_LOG: rwSTANDARDRASTERGETMIPLEVELS" ) );
+              debug::DebugLogger::Log(
+                  "RWGAMEHOOKS_LOG: rwSTANDARDRASTERGETMIPLEVELS" );
               return 1;
           } },
         { rwSTANDARDNUMOFSTANDARD,
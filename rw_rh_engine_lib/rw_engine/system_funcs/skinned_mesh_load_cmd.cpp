@@ -5,6 +5,7 @@
 #include "skinned_mesh_load_cmd.h"
 #include <Engine/Common/IDeviceState.h>
 #include <ipc/shared_memory_queue_client.h>
+#include <render_driver/gpu_resources/asset_streamer.h>
 #include <render_driver/gpu_resources/resource_mgr.h>
 #include <render_driver/render_driver.h>
 #include <rw_engine/rh_backend/raster_backend.h>
@@ -21,16 +22,20 @@ SkinnedMeshLoadCmdImpl::SkinnedMeshLoadCmdImpl(
 uint64_t SkinnedMeshLoadCmdImpl::Invoke( const SkinnedMeshInitData &mesh_data )
 {
     uint64_t result = 0xBADF00D;
-    TaskQueue.ExecuteTask(
+    // large meshes are sent in chunks, so they don't need to fit into
+    // shared memory
+    const uint64_t chunk_size = TaskQueue.TaskChunkSize();
+    TaskQueue.ExecuteChunkedTask(
         SharedMemoryTaskType::SKINNED_MESH_LOAD,
-        [&mesh_data]( MemoryWriter &&memory_writer ) {
+        [&mesh_data, chunk_size]( MemoryWriter &&memory_writer ) {
             // serialize
             memory_writer.Write( &mesh_data.mVertexCount );
             memory_writer.Write( &mesh_data.mIndexCount );
 
-            memory_writer.Write( mesh_data.mVertexData,
-                                 mesh_data.mVertexCount );
-            memory_writer.Write( mesh_data.mIndexData, mesh_data.mIndexCount );
+            memory_writer.WriteSplit( mesh_data.mVertexData,
+                                      mesh_data.mVertexCount, chunk_size );
+            memory_writer.WriteSplit( mesh_data.mIndexData,
+                                      mesh_data.mIndexCount, chunk_size );
 
             uint32_t split_count = mesh_data.mSplits.size();
             memory_writer.Write( &split_count );
@@ -43,18 +48,22 @@ uint64_t SkinnedMeshLoadCmdImpl::Invoke( const SkinnedMeshInitData &mesh_data )
     return result;
 }
 
-void SkinnedMeshLoadTaskImpl( void *memory )
+void SkinnedMeshLoadCmdImpl::ReadPayload( MemoryReader &reader,
+                                          AssetPayload &payload )
+{
+    const auto vertex_count = payload.Copy<uint64_t>( reader );
+    const auto index_count  = payload.Copy<uint64_t>( reader );
+    payload.CopyArray<VertexDescPosColorUVNormals>( reader, vertex_count );
+    payload.CopyArray<uint16_t>( reader, index_count );
+    const auto split_count = payload.Copy<uint32_t>( reader );
+    payload.CopyArray<GeometrySplit>( reader, split_count );
+}
+
+SkinMeshData SkinnedMeshLoadCmdImpl::CreateResource( MemoryReader &&reader )
 {
     using namespace rh::engine;
     assert( gRenderDriver );
-    auto &driver    = *gRenderDriver;
-    auto &device    = driver.GetDeviceState();
-    auto &resources = driver.GetResources();
-    auto &mesh_pool = resources.GetSkinMeshPool();
-
-    uint64_t     mesh_id = 0;
-    MemoryWriter writer( memory );
-    MemoryReader reader( memory );
+    auto &device = gRenderDriver->GetDeviceState();
 
     SkinnedMeshInitData init_data{};
     init_data.mVertexCount = *reader.Read<uint64_t>();
@@ -73,13 +82,15 @@ void SkinnedMeshLoadTaskImpl( void *memory )
     BufferCreateInfo ib_info{};
     ib_info.mSize  = init_data.mIndexCount * sizeof( uint16_t );
     ib_info.mUsage = BufferUsage::IndexBuffer | BufferUsage::StorageBuffer;
-    ib_info.mInitDataPtr = init_data.mIndexData;
+    // init data is only read
+    ib_info.mInitDataPtr = const_cast<uint16_t *>( init_data.mIndexData );
 
     BufferCreateInfo vb_info{};
     vb_info.mSize =
         init_data.mVertexCount * sizeof( VertexDescPosColorUVNormals );
     vb_info.mUsage = BufferUsage::VertexBuffer | BufferUsage::StorageBuffer;
-    vb_info.mInitDataPtr = init_data.mVertexData;
+    vb_info.mInitDataPtr =
+        const_cast<VertexDescPosColorUVNormals *>( init_data.mVertexData );
 
     SkinMeshData backend_mesh_data{};
     backend_mesh_data.mIndexBuffer =
@@ -90,8 +101,16 @@ void SkinnedMeshLoadTaskImpl( void *memory )
     backend_mesh_data.mVertexCount = init_data.mVertexCount;
     backend_mesh_data.mIndexCount  = init_data.mIndexCount;
 
-    mesh_id = mesh_pool.RequestResource( backend_mesh_data );
+    return backend_mesh_data;
+}
+
+void SkinnedMeshLoadTaskImpl( MemoryReader &&reader, MemoryWriter &&writer )
+{
+    assert( gRenderDriver );
+    auto &mesh_pool = gRenderDriver->GetResources().GetSkinMeshPool();
 
+    uint64_t mesh_id = mesh_pool.RequestResource(
+        SkinnedMeshLoadCmdImpl::CreateResource( std::move( reader ) ) );
     writer.Write( &mesh_id );
 }
 
@@ -12,13 +12,20 @@
 namespace rh::rw::engine
 {
 class SharedMemoryTaskQueue;
+class MemoryReader;
+class AssetPayload;
 struct SkinnedMeshInitData;
+struct SkinMeshData;
 class SkinnedMeshLoadCmdImpl
 {
   public:
     SkinnedMeshLoadCmdImpl( SharedMemoryTaskQueue &task_queue );
     uint64_t    Invoke( const SkinnedMeshInitData &init_data );
     static void RegisterCallHandler( SharedMemoryTaskQueue &task_queue );
+    /// Copies task payload, so it can be uploaded after the task is done
+    static void ReadPayload( MemoryReader &reader, AssetPayload &payload );
+    /// Creates mesh from task payload, render driver thread only
+    static SkinMeshData CreateResource( MemoryReader &&reader );
 
   private:
     SharedMemoryTaskQueue &TaskQueue;
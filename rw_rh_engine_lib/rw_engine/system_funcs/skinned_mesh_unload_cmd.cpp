@@ -19,11 +19,11 @@ SkinnedMeshUnloadCmdImpl::SkinnedMeshUnloadCmdImpl(
 
 bool SkinnedMeshUnloadCmdImpl::Invoke( uint64_t id )
 {
-    TaskQueue.ExecuteTask( SharedMemoryTaskType::SKINNED_MESH_UNLOAD,
-                           [&id]( MemoryWriter &&memory_writer ) {
-                               // serialize
-                               memory_writer.Write( &id );
-                           } );
+    TaskQueue.PostTask( SharedMemoryTaskType::SKINNED_MESH_UNLOAD,
+                        [id]( MemoryWriter &&memory_writer ) {
+                            // serialize
+                            memory_writer.Write( &id );
+                        } );
     return true;
 }
 